@@ -40,3 +40,7 @@ group ""
 group "Editor"
 	include "GrappleEditor/GrappleEditor.Build.lua"
 group ""
+
+group "Tools"
+	include "GrappleECSBenchmarks/GrappleECSBenchmarks.Build.lua"
+group ""
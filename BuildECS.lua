@@ -0,0 +1,47 @@
+-- Standalone workspace for GrappleECS and its benchmarks.
+-- Doesn't depend on Vulkan, GLFW or ImGui, so it can be built headless, e.g. on Linux:
+--     premake5 --file=BuildECS.lua gmake2 && make config=release GrappleECSBenchmarks
+
+include "dependencies.lua"
+include "BuildTool.lua"
+
+workspace "GrappleECS"
+	architecture "x86_64"
+	startproject "GrappleECSBenchmarks"
+
+	configurations
+	{
+		"Debug",
+		"Release",
+		"Dist",
+	}
+
+	filter { "system:windows", "configurations:not Dist" }
+		disablewarnings
+		{
+			"4251"
+		}
+
+	filter "system:linux"
+		pic "On"
+		links
+		{
+			"pthread",
+			"dl",
+		}
+
+	filter {}
+
+	flags
+	{
+		"MultiProcessorCompile"
+	}
+
+group "Core"
+	include "GrappleCore/GrappleCore.Build.lua"
+	include "GrappleECS/GrappleECS.Build.lua"
+group ""
+
+group "Tools"
+	include "GrappleECSBenchmarks/GrappleECSBenchmarks.Build.lua"
+group ""
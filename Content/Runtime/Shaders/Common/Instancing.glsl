@@ -10,9 +10,33 @@ layout(std140, set = 2, binding = 0) readonly buffer InstaceData
 	InstanceData u_InstanceData[];
 };
 
+// By default instances are fetched from the persistent instance table through a per pass list of slots.
+// Shaders which receive their instance data directly (e.g. decals) define INSTANCE_DATA_NOT_INDEXED
+#ifndef INSTANCE_DATA_NOT_INDEXED
+layout(std430, set = 2, binding = 1) readonly buffer InstanceIndices
+{
+	uint u_InstanceIndices[];
+};
+
+// Index of the instance's material properties in the MaterialTable of the shader
+layout(std430, set = 2, binding = 2) readonly buffer InstanceMaterialIndices
+{
+	uint u_InstanceMaterialIndices[];
+};
+
+uint GetInstanceMaterialIndex()
+{
+	return u_InstanceMaterialIndices[gl_InstanceIndex];
+}
+#endif
+
 mat4 GetInstanceTransform()
 {
+#ifdef INSTANCE_DATA_NOT_INDEXED
 	InstanceData data = u_InstanceData[gl_InstanceIndex];
+#else
+	InstanceData data = u_InstanceData[u_InstanceIndices[gl_InstanceIndex]];
+#endif
 	vec4 translation = vec4(
 		data.PackedTransform0.w,
 		data.PackedTransform1.w,
@@ -0,0 +1,27 @@
+#ifndef VERTEX_FORMAT_H
+#define VERTEX_FORMAT_H
+
+// Set by the pipeline for meshes with MeshVertexFormat::Compact.
+// Positions and UVs are converted by the vertex fetch and the position dequantization is a part of the instance transform,
+// so only normals and tangents, which are octahedral encoded, have to be decoded
+layout(constant_id = 0) const bool VERTEX_FORMAT_COMPACT = false;
+
+vec3 DecodeOctahedral(vec2 encoded)
+{
+	vec3 direction = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+	float t = max(-direction.z, 0.0);
+	direction.x += direction.x >= 0.0 ? -t : t;
+	direction.y += direction.y >= 0.0 ? -t : t;
+	return normalize(direction);
+}
+
+// Expects the vertex input to be declared as vec3, the third component is ignored for compact vertices
+vec3 DecodeVertexDirection(vec3 direction)
+{
+	if (VERTEX_FORMAT_COMPACT)
+		return DecodeOctahedral(direction.xy);
+
+	return direction;
+}
+
+#endif
@@ -11,6 +11,8 @@ Properties =
 #version 450
 
 #include "Common/Camera.glsl"
+
+#define INSTANCE_DATA_NOT_INDEXED
 #include "Common/Instancing.glsl"
 
 layout(location = 0) in vec3 i_Position;
@@ -18,6 +18,7 @@ layout(location = 3) in vec2 i_UV;
 
 #include "Common/Camera.glsl"
 #include "Common/Instancing.glsl"
+#include "Common/VertexFormat.glsl"
 
 struct VertexData
 {
@@ -29,12 +30,14 @@ struct VertexData
 };
 
 layout(location = 0) out VertexData o_Vertex;
+layout(location = 5) flat out uint o_MaterialIndex;
 
 void main()
 {
 	mat4 transform = GetInstanceTransform();
-	o_Vertex.Normal = (transform * vec4(i_Normal, 0.0)).xyz;
-	o_Vertex.Tangent = (transform * vec4(i_Tangent, 0.0)).xyz;
+	o_MaterialIndex = GetInstanceMaterialIndex();
+	o_Vertex.Normal = (transform * vec4(DecodeVertexDirection(i_Normal), 0.0)).xyz;
+	o_Vertex.Tangent = (transform * vec4(DecodeVertexDirection(i_Tangent), 0.0)).xyz;
     
 	vec4 transformed = transform * vec4(i_Position, 1.0);
 	vec4 position = u_Camera.ViewProjection * transformed;
@@ -57,11 +60,16 @@ void main()
 #include "Common/ShadowMapping.glsl"
 #include "Common/Light.glsl"
 
-layout(std140, push_constant) uniform InstanceData
+struct MaterialData
 {
 	vec4 Color;
 	float Roughness;
-} u_Material;
+};
+
+layout(std430, set = 3, binding = 3) readonly buffer MaterialTable
+{
+	MaterialData u_Material[];
+};
 
 
 struct VertexData
@@ -78,6 +86,7 @@ layout(set = 3, binding = 1) uniform sampler2D u_NormalMap;
 layout(set = 3, binding = 2) uniform sampler2D u_RoughnessMap;
 
 layout(location = 0) in VertexData i_Vertex;
+layout(location = 5) flat in uint i_MaterialIndex;
 
 layout(location = 0) out vec4 o_Color;
 layout(location = 1) out vec4 o_Normal;
@@ -107,7 +116,9 @@ vec3 UnpackNormal(vec3 packedNormal)
 
 void main()
 {
-	vec4 color = u_Material.Color * texture(u_Texture, i_Vertex.UV);
+	MaterialData material = u_Material[i_MaterialIndex];
+
+	vec4 color = material.Color * texture(u_Texture, i_Vertex.UV);
 	if (color.a == 0.0f)
 		discard;
 
@@ -125,7 +136,7 @@ void main()
 
 	N = normalize(tbn * sampledNormal);
 
-	float roughness = u_Material.Roughness * texture(u_RoughnessMap, i_Vertex.UV).r;
+	float roughness = material.Roughness * texture(u_RoughnessMap, i_Vertex.UV).r;
 	float shadow = CalculateShadow(vertexNormal, i_Vertex.Position, i_Vertex.ViewSpacePosition);
 
 	vec3 finalColor = CalculateLight(N, V, H, color.rgb,
@@ -5,6 +5,7 @@
 namespace Grapple
 {
 	Ref<AssetManagerBase> s_Instance = nullptr;
+	static uint64_t s_ChangesVersion = 0;
 
 	void AssetManager::Intialize(const Ref<AssetManagerBase>& assetManager)
 	{
@@ -44,4 +45,14 @@ namespace Grapple
 		Grapple_PROFILE_FUNCTION();
 		return s_Instance->IsAssetLoaded(handle);
 	}
-}
+
+	void AssetManager::NotifyAssetsChanged()
+	{
+		s_ChangesVersion++;
+	}
+
+	uint64_t AssetManager::GetChangesVersion()
+	{
+		return s_ChangesVersion;
+	}
+}
\ No newline at end of file
@@ -23,5 +23,12 @@ namespace Grapple
 		static Ref<Asset> GetRawAsset(AssetHandle handle);
 		static bool IsAssetHandleValid(AssetHandle handle);
 		static bool IsAssetLoaded(AssetHandle handle);
+
+		// Called when an asset is imported, loaded, reloaded, replaced, unloaded or modified,
+		// so that the systems which cache assets know when to resolve them again
+		static void NotifyAssetsChanged();
+
+		// Incremented by `NotifyAssetsChanged`
+		static uint64_t GetChangesVersion();
 	};
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "Application.h"
 
 #include "Grapple/Core/Time.h"
+#include "Grapple/Core/JobSystem.h"
 
 #include "GrappleCore/Profiler/Profiler.h"
 
@@ -93,11 +94,14 @@ namespace Grapple
 		Renderer::Shutdown();
 		RendererPrimitives::Clear();
 		GraphicsContext::Shutdown();
+
+		JobSystem::Shutdown();
 	}
 
 	void Application::Run()
 	{
 		InputManager::Initialize();
+		JobSystem::Initialize();
 
 		Renderer::Initialize();
 		DebugRenderer::Initialize();
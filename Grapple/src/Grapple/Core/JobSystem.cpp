@@ -0,0 +1,199 @@
+#include "JobSystem.h"
+
+#include "GrappleCore/Assert.h"
+#include "GrappleCore/Profiler/Profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Grapple
+{
+	struct JobSystemData
+	{
+		std::vector<std::thread> Workers;
+
+		// Serializes `ParallelFor` calls made from different threads
+		std::mutex SubmitMutex;
+
+		// Protects the job description, `Generation`, `ActiveWorkers` and `Running`
+		std::mutex Mutex;
+		std::condition_variable WakeCondition;
+		std::condition_variable DoneCondition;
+
+		uint64_t Generation = 0;
+		uint32_t ActiveWorkers = 0;
+		bool Running = false;
+
+		const JobSystem::RangeFunction* Function = nullptr;
+		size_t Count = 0;
+		size_t BatchSize = 0;
+		size_t BatchesCount = 0;
+
+		std::atomic<size_t> NextBatch = 0;
+		std::atomic<size_t> CompletedBatches = 0;
+	};
+
+	static JobSystemData s_JobSystem;
+
+	static thread_local uint32_t s_ThreadIndex = 0;
+	static thread_local bool s_IsInsideJob = false;
+
+	static void ExecuteBatches(uint32_t threadIndex)
+	{
+		while (true)
+		{
+			size_t batch = s_JobSystem.NextBatch.fetch_add(1, std::memory_order_relaxed);
+			if (batch >= s_JobSystem.BatchesCount)
+				break;
+
+			size_t begin = batch * s_JobSystem.BatchSize;
+			size_t end = std::min(begin + s_JobSystem.BatchSize, s_JobSystem.Count);
+
+			(*s_JobSystem.Function)(begin, end, threadIndex);
+
+			s_JobSystem.CompletedBatches.fetch_add(1, std::memory_order_acq_rel);
+		}
+	}
+
+	static void WorkerThread(uint32_t threadIndex)
+	{
+		std::string name = "Worker " + std::to_string(threadIndex);
+		Grapple_PROFILE_THREAD(name.c_str());
+
+		s_ThreadIndex = threadIndex;
+		s_IsInsideJob = true;
+
+		uint64_t executedGeneration = 0;
+		while (true)
+		{
+			std::unique_lock<std::mutex> lock(s_JobSystem.Mutex);
+			s_JobSystem.WakeCondition.wait(lock, [&executedGeneration]() -> bool
+			{
+				return !s_JobSystem.Running || s_JobSystem.Generation != executedGeneration;
+			});
+
+			if (!s_JobSystem.Running)
+				return;
+
+			// Registering as active while holding the lock guarantees, that the job can't
+			// be replaced until this worker has stopped reading its description
+			executedGeneration = s_JobSystem.Generation;
+
+			// The job has already been completed by other threads
+			if (s_JobSystem.Function == nullptr)
+				continue;
+
+			s_JobSystem.ActiveWorkers++;
+			lock.unlock();
+
+			ExecuteBatches(threadIndex);
+
+			lock.lock();
+			s_JobSystem.ActiveWorkers--;
+			if (s_JobSystem.ActiveWorkers == 0)
+				s_JobSystem.DoneCondition.notify_all();
+		}
+	}
+
+	void JobSystem::Initialize(uint32_t workersCount)
+	{
+		Grapple_PROFILE_FUNCTION();
+		Grapple_CORE_ASSERT(s_JobSystem.Workers.size() == 0);
+
+		if (workersCount == 0)
+		{
+			uint32_t hardwareThreads = std::thread::hardware_concurrency();
+			workersCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+		}
+
+		s_JobSystem.Running = true;
+		s_JobSystem.Workers.reserve(workersCount);
+
+		for (uint32_t i = 0; i < workersCount; i++)
+			s_JobSystem.Workers.emplace_back(WorkerThread, i + 1);
+	}
+
+	void JobSystem::Shutdown()
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		{
+			std::lock_guard<std::mutex> lock(s_JobSystem.Mutex);
+			s_JobSystem.Running = false;
+		}
+
+		s_JobSystem.WakeCondition.notify_all();
+
+		for (std::thread& worker : s_JobSystem.Workers)
+			worker.join();
+
+		s_JobSystem.Workers.clear();
+	}
+
+	uint32_t JobSystem::GetThreadsCount()
+	{
+		return (uint32_t)s_JobSystem.Workers.size() + 1;
+	}
+
+	void JobSystem::ParallelFor(size_t count, size_t batchSize, const RangeFunction& function)
+	{
+		if (count == 0)
+			return;
+
+		batchSize = std::max<size_t>(batchSize, 1);
+		size_t batchesCount = (count + batchSize - 1) / batchSize;
+
+		// Nested calls are executed on the current thread, using the thread index of the outer job
+		if (s_IsInsideJob)
+		{
+			for (size_t begin = 0; begin < count; begin += batchSize)
+				function(begin, std::min(begin + batchSize, count), s_ThreadIndex);
+
+			return;
+		}
+
+		std::lock_guard<std::mutex> submitLock(s_JobSystem.SubmitMutex);
+		s_IsInsideJob = true;
+
+		if (s_JobSystem.Workers.size() == 0 || batchesCount == 1)
+		{
+			for (size_t begin = 0; begin < count; begin += batchSize)
+				function(begin, std::min(begin + batchSize, count), 0);
+
+			s_IsInsideJob = false;
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(s_JobSystem.Mutex);
+			s_JobSystem.Function = &function;
+			s_JobSystem.Count = count;
+			s_JobSystem.BatchSize = batchSize;
+			s_JobSystem.BatchesCount = batchesCount;
+			s_JobSystem.NextBatch.store(0, std::memory_order_relaxed);
+			s_JobSystem.CompletedBatches.store(0, std::memory_order_relaxed);
+			s_JobSystem.Generation++;
+		}
+
+		s_JobSystem.WakeCondition.notify_all();
+
+		ExecuteBatches(0);
+
+		{
+			std::unique_lock<std::mutex> lock(s_JobSystem.Mutex);
+			s_JobSystem.DoneCondition.wait(lock, [batchesCount]() -> bool
+			{
+				return s_JobSystem.CompletedBatches.load(std::memory_order_acquire) == batchesCount && s_JobSystem.ActiveWorkers == 0;
+			});
+
+			s_JobSystem.Function = nullptr;
+		}
+
+		s_IsInsideJob = false;
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "GrappleCore/Core.h"
+
+#include <stdint.h>
+#include <functional>
+
+namespace Grapple
+{
+	// Fixed pool of worker threads for data parallel work.
+	//
+	// `ParallelFor` splits a range into batches, which are processed by the workers and the calling thread.
+	// The calling thread always has thread index 0, so per thread buffers can be indexed with the thread index
+	// and must be sized with `GetThreadsCount()`. Calls made from inside of a job are executed inline.
+	class Grapple_API JobSystem
+	{
+	public:
+		using RangeFunction = std::function<void(size_t begin, size_t end, uint32_t threadIndex)>;
+
+		// Creates `workersCount` worker threads, or one less than the number of hardware threads when 0
+		static void Initialize(uint32_t workersCount = 0);
+		static void Shutdown();
+
+		// Returns the number of threads participating in a `ParallelFor`, including the calling thread
+		static uint32_t GetThreadsCount();
+
+		// Calls `function` for consecutive ranges of at most `batchSize` elements and waits for all of them to complete
+		static void ParallelFor(size_t count, size_t batchSize, const RangeFunction& function);
+	};
+}
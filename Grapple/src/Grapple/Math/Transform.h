@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Grapple/Math/Math.h"
+
 #include <glm/glm.hpp>
 
 namespace Grapple::Math
@@ -22,6 +24,19 @@ namespace Grapple::Math
 			return RotationScale * direction;
 		}
 
+		// Returns an AABB, which encloses the transformed `aabb`
+		AABB TransformAABB(const AABB& aabb) const
+		{
+			glm::vec3 center = RotationScale * aabb.GetCenter() + Translation;
+
+			glm::vec3 localExtents = aabb.GetExtents();
+			glm::vec3 extents = glm::abs(RotationScale[0]) * localExtents.x
+				+ glm::abs(RotationScale[1]) * localExtents.y
+				+ glm::abs(RotationScale[2]) * localExtents.z;
+
+			return AABB(center - extents, center + extents);
+		}
+
 		glm::mat4 ToMatrix4x4() const
 		{
 			return glm::mat4(
@@ -8,9 +8,10 @@ namespace Grapple
 	VulkanBuffer::VulkanBuffer(GPUBufferUsage usage, VkBufferUsageFlags bufferUsage, PipelineDependecy dependecy, size_t size)
 		: m_Usage(usage), m_UsageFlags(bufferUsage), m_PipelineDepency(dependecy), m_Size(size)
 	{
+		// Static buffers can also be copied into other buffers, so that they can be grown without keeping a CPU copy
 		if (usage == GPUBufferUsage::Static)
 		{
-			m_UsageFlags |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+			m_UsageFlags |= VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
 		}
 	}
 
@@ -7,11 +7,14 @@
 #include "Grapple/Platform/Vulkan/VulkanPipeline.h"
 #include "Grapple/Platform/Vulkan/VulkanVertexBuffer.h"
 #include "Grapple/Platform/Vulkan/VulkanIndexBuffer.h"
+#include "Grapple/Platform/Vulkan/VulkanShaderStorageBuffer.h"
 #include "Grapple/Platform/Vulkan/VulkanMaterial.h"
 #include "Grapple/Platform/Vulkan/VulkanGPUTimer.h"
 #include "Grapple/Platform/Vulkan/VulkanComputeShader.h"
 #include "Grapple/Platform/Vulkan/VulkanComputePipeline.h"
 
+#include <cstring>
+
 namespace Grapple
 {
 	VulkanCommandBuffer::VulkanCommandBuffer(VkCommandBuffer commandBuffer)
@@ -76,37 +79,24 @@ namespace Grapple
 		Grapple_PROFILE_FUNCTION();
 		Grapple_CORE_ASSERT(material->GetShader());
 		Ref<VulkanMaterial> vulkanMaterial = As<VulkanMaterial>(std::const_pointer_cast<Material>(material));
-		Ref<VulkanPipeline> pipeline = As<VulkanPipeline>(vulkanMaterial->GetPipeline(m_CurrentRenderPass));
+		Ref<VulkanPipeline> pipeline = As<VulkanPipeline>(vulkanMaterial->GetPipeline(m_CurrentRenderPass, m_CurrentVertexFormat));
 		VkPipelineLayout pipelineLayout = pipeline->GetLayoutHandle();
 		Ref<const ShaderMetadata> metadata = material->GetShader()->GetMetadata();
 
 		{
 			Grapple_PROFILE_SCOPE("PushConstants");
-			for (size_t i = 0; i < metadata->PushConstantsRanges.size(); i++)
-			{
-				const ShaderPushConstantsRange& range = metadata->PushConstantsRanges[i];
-				if (range.Size == 0)
-					continue;
-
-				VkShaderStageFlags stage = 0;
-				switch (range.Stage)
-				{
-				case ShaderStageType::Vertex:
-					stage = VK_SHADER_STAGE_VERTEX_BIT;
-					break;
-				case ShaderStageType::Pixel:
-					stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-					break;
-				}
-
-				vkCmdPushConstants(m_CommandBuffer, pipelineLayout, stage, (uint32_t)range.Offset, (uint32_t)range.Size, material->GetPropertiesBuffer() + range.Offset);
-			}
+			for (const ShaderPushConstantsRange& range : metadata->PushConstantsRanges)
+				PushConstantsRange(pipelineLayout, range, material->GetPropertiesBuffer() + range.Offset);
 		}
 
 		if (m_GlobalDescriptorSetsRequireBinding || pipeline.get() != m_CurrentGraphicsPipeline.get())
 		{
 			BindPipeline(pipeline);
 		}
+		else
+		{
+			Renderer::GetMutableStatistics().PipelineBindsSkipped++;
+		}
 
 		Ref<DescriptorSet> materialDescriptorSet = vulkanMaterial->GetDescriptorSet();
 		if (materialDescriptorSet)
@@ -114,6 +104,8 @@ namespace Grapple
 			vulkanMaterial->UpdateDescriptorSet();
 			BindDescriptorSet(As<VulkanDescriptorSet>(materialDescriptorSet), pipelineLayout, 3);
 		}
+
+		m_CurrentMaterial = material;
 	}
 
 	void VulkanCommandBuffer::PushConstants(const ShaderConstantBuffer& constantBuffer)
@@ -122,31 +114,8 @@ namespace Grapple
 		Ref<const ShaderMetadata> metadata = constantBuffer.GetShader()->GetMetadata();
 
 		VkPipelineLayout pipelineLayout = As<const VulkanPipeline>(m_CurrentGraphicsPipeline)->GetLayoutHandle();
-
-		for (size_t i = 0; i < metadata->PushConstantsRanges.size(); i++)
-		{
-			const ShaderPushConstantsRange& range = metadata->PushConstantsRanges[i];
-			if (range.Size == 0)
-				continue;
-
-			VkShaderStageFlags stage = 0;
-			switch (range.Stage)
-			{
-			case ShaderStageType::Vertex:
-				stage = VK_SHADER_STAGE_VERTEX_BIT;
-				break;
-			case ShaderStageType::Pixel:
-				stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-				break;
-			}
-
-			vkCmdPushConstants(m_CommandBuffer,
-				pipelineLayout,
-				stage,
-				(uint32_t)range.Offset,
-				(uint32_t)range.Size,
-				constantBuffer.GetBuffer() + range.Offset);
-		}
+		for (const ShaderPushConstantsRange& range : metadata->PushConstantsRanges)
+			PushConstantsRange(pipelineLayout, range, constantBuffer.GetBuffer() + range.Offset);
 	}
 
 	void VulkanCommandBuffer::SetViewportAndScisors(Math::Rect viewportRect)
@@ -186,10 +155,15 @@ namespace Grapple
 
 			vkCmdBindPipeline(m_CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkanPipeline->GetHandle());
 
+			m_CurrentMaterial = nullptr;
 			m_UsedPipelines.push_back(pipeline);
 			m_CurrentGraphicsPipeline = pipeline;
 			m_GlobalDescriptorSetsRequireBinding = true;
 		}
+		else
+		{
+			Renderer::GetMutableStatistics().PipelineBindsSkipped++;
+		}
 
 		// Bind global descriptor sets
 
@@ -218,45 +192,54 @@ namespace Grapple
 
 	void VulkanCommandBuffer::BindVertexBuffer(Ref<const VertexBuffer> buffer, uint32_t index)
 	{
-		m_CurrentMesh = nullptr;
-		VkDeviceSize offset = 0;
 		VkBuffer bufferHandle = As<const VulkanVertexBuffer>(buffer)->GetHandle();
-
-		vkCmdBindVertexBuffers(m_CommandBuffer, index, 1, &bufferHandle, &offset);
+		BindVertexBufferHandles(&bufferHandle, 1, index);
 	}
 
 	void VulkanCommandBuffer::BindVertexBuffers(Span<Ref<const VertexBuffer>> vertexBuffers, uint32_t baseBindingIndex)
 	{
 		Grapple_PROFILE_FUNCTION();
+		Grapple_CORE_ASSERT(vertexBuffers.GetSize() <= MAX_VERTEX_BUFFER_BINDINGS);
 
-		m_CurrentMesh = nullptr;
-
-		std::vector<VkDeviceSize> offsets(vertexBuffers.GetSize());
-		std::vector<VkBuffer> buffers(vertexBuffers.GetSize());
+		VkBuffer buffers[MAX_VERTEX_BUFFER_BINDINGS];
 		for (size_t i = 0; i < vertexBuffers.GetSize(); i++)
-		{
-			offsets[i] = 0;
 			buffers[i] = As<const VulkanVertexBuffer>(vertexBuffers[i])->GetHandle();
-		}
 
-		vkCmdBindVertexBuffers(m_CommandBuffer, baseBindingIndex, (uint32_t)vertexBuffers.GetSize(), buffers.data(), offsets.data());
+		BindVertexBufferHandles(buffers, (uint32_t)vertexBuffers.GetSize(), baseBindingIndex);
 	}
 
 	void VulkanCommandBuffer::BindIndexBuffer(Ref<const IndexBuffer> indexBuffer)
 	{
 		Grapple_PROFILE_FUNCTION();
-		vkCmdBindIndexBuffer(m_CommandBuffer,
-			As<const VulkanIndexBuffer>(indexBuffer)->GetHandle(), 0,
-			indexBuffer->GetIndexFormat() == IndexBuffer::IndexFormat::UInt16
-				? VK_INDEX_TYPE_UINT16
-				: VK_INDEX_TYPE_UINT32);
+		VkBuffer bufferHandle = As<const VulkanIndexBuffer>(indexBuffer)->GetHandle();
+		VkIndexType indexType = indexBuffer->GetIndexFormat() == IndexBuffer::IndexFormat::UInt16
+			? VK_INDEX_TYPE_UINT16
+			: VK_INDEX_TYPE_UINT32;
+
+		if (m_CurrentIndexBuffer == bufferHandle && m_CurrentIndexType == indexType)
+		{
+			Renderer::GetMutableStatistics().BufferBindsSkipped++;
+			return;
+		}
+
+		vkCmdBindIndexBuffer(m_CommandBuffer, bufferHandle, 0, indexType);
+
+		m_CurrentIndexBuffer = bufferHandle;
+		m_CurrentIndexType = indexType;
 	}
 
 	void VulkanCommandBuffer::DrawMeshIndexed(const Ref<const Mesh>& mesh, uint32_t baseInstance, uint32_t instanceCount)
 	{
 		Grapple_PROFILE_FUNCTION();
+		// Index buffer also contains indices of the LODs, so only the base sub meshes are drawn
+		if (mesh->GetLODCount() > 1)
+		{
+			DrawMeshIndexed(mesh, 0, (uint32_t)mesh->GetSubMeshes().size(), baseInstance, instanceCount);
+			return;
+		}
+
 		BindMesh(mesh);
-		vkCmdDrawIndexed(m_CommandBuffer, (uint32_t)mesh->GetIndexCount(), instanceCount, 0, 0, baseInstance);
+		vkCmdDrawIndexed(m_CommandBuffer, (uint32_t)mesh->GetIndexCount(), instanceCount, mesh->GetBaseIndex(), (int32_t)mesh->GetBaseVertex(), baseInstance);
 	}
 
 	void VulkanCommandBuffer::DrawMeshIndexed(const Ref<const Mesh>& mesh, uint32_t subMeshIndex, uint32_t baseInstance, uint32_t instanceCount)
@@ -266,7 +249,23 @@ namespace Grapple
 		BindMesh(mesh);
 
 		const auto& subMesh = mesh->GetSubMeshes()[subMeshIndex];
-		vkCmdDrawIndexed(m_CommandBuffer, subMesh.IndicesCount, instanceCount, subMesh.BaseIndex, subMesh.BaseVertex, baseInstance);
+		vkCmdDrawIndexed(m_CommandBuffer,
+			subMesh.IndicesCount, instanceCount,
+			mesh->GetBaseIndex() + subMesh.BaseIndex,
+			(int32_t)(mesh->GetBaseVertex() + subMesh.BaseVertex),
+			baseInstance);
+	}
+
+	void VulkanCommandBuffer::DrawMeshIndexed(const Ref<const Mesh>& mesh, const SubMesh& subMesh, uint32_t baseInstance, uint32_t instanceCount)
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		BindMesh(mesh);
+		vkCmdDrawIndexed(m_CommandBuffer,
+			subMesh.IndicesCount, instanceCount,
+			mesh->GetBaseIndex() + subMesh.BaseIndex,
+			(int32_t)(mesh->GetBaseVertex() + subMesh.BaseVertex),
+			baseInstance);
 	}
 
 	void VulkanCommandBuffer::DrawMeshIndexed(const Ref<const Mesh>& mesh, uint32_t firstSubMesh, uint32_t subMeshCount, uint32_t baseInstance, uint32_t instanceCount)
@@ -277,19 +276,36 @@ namespace Grapple
 
 		const auto& subMeshes = mesh->GetSubMeshes();
 
-		uint32_t lastSubMeshIndex = firstSubMesh + subMeshCount;
-		uint32_t indexCount = 0;
+		// Sub meshes are stored sequentially, however LOD indices may follow the last one
+		const SubMesh& lastSubMesh = subMeshes[firstSubMesh + subMeshCount - 1];
+		uint32_t indexCount = lastSubMesh.BaseIndex + lastSubMesh.IndicesCount - subMeshes[firstSubMesh].BaseIndex;
 
-		if (lastSubMeshIndex == (uint32_t)subMeshes.size())
-		{
-			indexCount = (uint32_t)mesh->GetIndexCount() - subMeshes[firstSubMesh].BaseIndex;
-		}
-		else
+		vkCmdDrawIndexed(m_CommandBuffer,
+			indexCount, instanceCount,
+			mesh->GetBaseIndex() + subMeshes[firstSubMesh].BaseIndex,
+			(int32_t)mesh->GetBaseVertex(),
+			baseInstance);
+	}
+
+	void VulkanCommandBuffer::DrawMeshIndexedIndirect(const Ref<const Mesh>& mesh, const Ref<const ShaderStorageBuffer>& commands, size_t offset, uint32_t drawCount)
+	{
+		Grapple_PROFILE_FUNCTION();
+		static_assert(sizeof(DrawIndexedIndirectCommand) == sizeof(VkDrawIndexedIndirectCommand));
+
+		BindMesh(mesh);
+
+		VkBuffer buffer = As<const VulkanShaderStorageBuffer>(commands)->GetBufferHandle();
+		constexpr uint32_t stride = (uint32_t)sizeof(VkDrawIndexedIndirectCommand);
+
+		if (VulkanContext::GetInstance().GetFeatures().MultiDrawIndirect)
 		{
-			indexCount = subMeshes[lastSubMeshIndex].BaseIndex - subMeshes[firstSubMesh].BaseIndex;
+			vkCmdDrawIndexedIndirect(m_CommandBuffer, buffer, (VkDeviceSize)offset, drawCount, stride);
+			return;
 		}
 
-		vkCmdDrawIndexed(m_CommandBuffer, indexCount, instanceCount, subMeshes[firstSubMesh].BaseIndex, 0, baseInstance);
+		// Without multiDrawIndirect the draw count must be 0 or 1
+		for (uint32_t i = 0; i < drawCount; i++)
+			vkCmdDrawIndexedIndirect(m_CommandBuffer, buffer, (VkDeviceSize)(offset + (size_t)i * stride), 1, stride);
 	}
 
 	void VulkanCommandBuffer::DrawIndexed(uint32_t baseIndex, uint32_t indexCount, uint32_t vertexOffset, uint32_t baseInstance, uint32_t instanceCount)
@@ -414,13 +430,24 @@ namespace Grapple
 		}
 
 		m_CurrentGraphicsPipeline = nullptr;
-		m_CurrentMesh = nullptr;
+		m_CurrentIndexBuffer = VK_NULL_HANDLE;
+		m_CurrentIndexType = VK_INDEX_TYPE_UINT32;
+		m_CurrentMaterial = nullptr;
+		m_CurrentVertexFormat = MeshVertexFormat::Float;
 
 		for (size_t i = 0; i < GLOBAL_DESCRIPTOR_SET_COUNT; i++)
 		{
 			m_GlobalDescriptorSets[i] = nullptr;
 		}
 
+		for (uint32_t i = 0; i < MAX_VERTEX_BUFFER_BINDINGS; i++)
+		{
+			m_CurrentVertexBuffers[i] = VK_NULL_HANDLE;
+		}
+
+		m_PushConstantsLayout = VK_NULL_HANDLE;
+		m_PushedConstants.clear();
+
 		m_UsedPipelines.clear();
 	}
 
@@ -470,6 +497,7 @@ namespace Grapple
 
 		vkCmdEndRenderPass(m_CommandBuffer);
 		m_CurrentRenderPass = nullptr;
+		m_CurrentMaterial = nullptr;
 	}
 
 	void VulkanCommandBuffer::TransitionImageLayout(VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout)
@@ -736,7 +764,10 @@ namespace Grapple
 		Grapple_CORE_ASSERT(index < 4);
 
 		if (m_CurrentDescriptorSets[index].PipelineLayout == pipelineLayout && m_CurrentDescriptorSets[index].Set.get() == descriptorSet.get())
+		{
+			Renderer::GetMutableStatistics().DescriptorSetBindsSkipped++;
 			return;
+		}
 
 		VkDescriptorSet setHandle = descriptorSet->GetHandle();
 		vkCmdBindDescriptorSets(m_CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, index, 1, &setHandle, 0, nullptr);
@@ -754,21 +785,23 @@ namespace Grapple
 
 	void VulkanCommandBuffer::BindMesh(const Ref<const Mesh>& mesh)
 	{
-		if (m_CurrentMesh.get() != mesh.get())
+		if (m_CurrentVertexFormat != mesh->GetVertexFormat())
 		{
-			Ref<const VertexBuffer> vertexBuffers[] =
-			{
-				mesh->GetVertices(),
-				mesh->GetNormals(),
-				mesh->GetTangents(),
-				mesh->GetUVs()
-			};
-
-			BindVertexBuffers(Span(vertexBuffers, 4), 0);
-			BindIndexBuffer(mesh->GetIndexBuffer());
+			m_CurrentVertexFormat = mesh->GetVertexFormat();
 
-			m_CurrentMesh = mesh;
+			// Vertex input layout is a part of the pipeline, so the material's variant for the new format has to be bound
+			if (m_CurrentMaterial != nullptr)
+				ApplyMaterial(m_CurrentMaterial);
 		}
+
+		const GeometryPool& geometryPool = *mesh->GetGeometryPool();
+
+		VkBuffer vertexBuffers[GeometryPool::VertexStreamsCount];
+		for (uint32_t stream = 0; stream < GeometryPool::VertexStreamsCount; stream++)
+			vertexBuffers[stream] = As<const VulkanVertexBuffer>(geometryPool.GetVertexBuffer(mesh->GetVertexFormat(), stream))->GetHandle();
+
+		BindVertexBufferHandles(vertexBuffers, GeometryPool::VertexStreamsCount, 0);
+		BindIndexBuffer(geometryPool.GetIndexBuffer(mesh->GetIndexFormat()));
 	}
 
 	void VulkanCommandBuffer::DepthImagesBarrier(Span<VkImage> images, bool hasStencil,
@@ -815,4 +848,103 @@ namespace Grapple
 	{
 		vkCmdWriteTimestamp(m_CommandBuffer, pipelineStages, timer->GetPoolHandle(), 1);
 	}
+
+	void VulkanCommandBuffer::BindVertexBufferHandles(const VkBuffer* buffers, uint32_t count, uint32_t baseBindingIndex)
+	{
+		Grapple_CORE_ASSERT(baseBindingIndex + count <= MAX_VERTEX_BUFFER_BINDINGS);
+
+		// Only the range between the first and the last changed bindings is rebound
+		uint32_t firstChanged = count;
+		uint32_t lastChanged = 0;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			if (m_CurrentVertexBuffers[baseBindingIndex + i] == buffers[i])
+				continue;
+
+			firstChanged = glm::min(firstChanged, i);
+			lastChanged = i;
+		}
+
+		if (firstChanged == count)
+		{
+			Renderer::GetMutableStatistics().BufferBindsSkipped += count;
+			return;
+		}
+
+		uint32_t changedCount = lastChanged - firstChanged + 1;
+		VkDeviceSize offsets[MAX_VERTEX_BUFFER_BINDINGS] = { 0 };
+		vkCmdBindVertexBuffers(m_CommandBuffer, baseBindingIndex + firstChanged, changedCount, buffers + firstChanged, offsets);
+
+		for (uint32_t i = firstChanged; i <= lastChanged; i++)
+			m_CurrentVertexBuffers[baseBindingIndex + i] = buffers[i];
+
+		Renderer::GetMutableStatistics().BufferBindsSkipped += count - changedCount;
+	}
+
+	void VulkanCommandBuffer::PushConstantsRange(VkPipelineLayout pipelineLayout, const ShaderPushConstantsRange& range, const uint8_t* data)
+	{
+		if (range.Size == 0)
+			return;
+
+		VkShaderStageFlags stages = 0;
+		switch (range.Stage)
+		{
+		case ShaderStageType::Vertex:
+			stages = VK_SHADER_STAGE_VERTEX_BIT;
+			break;
+		case ShaderStageType::Pixel:
+			stages = VK_SHADER_STAGE_FRAGMENT_BIT;
+			break;
+		}
+
+		// Pushed values are only tracked for a single layout, other layouts may not be compatible with it
+		if (m_PushConstantsLayout != pipelineLayout)
+		{
+			m_PushConstantsLayout = pipelineLayout;
+			m_PushedConstants.clear();
+		}
+
+		uint32_t offset = (uint32_t)range.Offset;
+		uint32_t size = (uint32_t)range.Size;
+
+		PushedConstantsRange* pushedRange = nullptr;
+		for (size_t i = 0; i < m_PushedConstants.size();)
+		{
+			PushedConstantsRange& pushed = m_PushedConstants[i];
+			if (pushed.Stages == stages && pushed.Offset == offset && pushed.Size == size)
+			{
+				if (std::memcmp(pushed.Data.data(), data, size) == 0)
+				{
+					Renderer::GetMutableStatistics().PushConstantsSkipped++;
+					return;
+				}
+
+				pushedRange = &pushed;
+				i++;
+				continue;
+			}
+
+			// Overlapping ranges are overwritten by this push, so they can't be compared against anymore
+			bool overlaps = (pushed.Stages & stages) != 0 && pushed.Offset < offset + size && offset < pushed.Offset + pushed.Size;
+			if (overlaps)
+			{
+				m_PushedConstants.erase(m_PushedConstants.begin() + i);
+				continue;
+			}
+
+			i++;
+		}
+
+		vkCmdPushConstants(m_CommandBuffer, pipelineLayout, stages, offset, size, data);
+
+		if (pushedRange == nullptr)
+		{
+			pushedRange = &m_PushedConstants.emplace_back();
+			pushedRange->Stages = stages;
+			pushedRange->Offset = offset;
+			pushedRange->Size = size;
+		}
+
+		pushedRange->Data.assign(data, data + size);
+	}
 }
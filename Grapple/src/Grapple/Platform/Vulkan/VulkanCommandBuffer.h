@@ -44,8 +44,14 @@ namespace Grapple
 
 		void DrawMeshIndexed(const Ref<const Mesh>& mesh, uint32_t baseInstance, uint32_t instanceCount) override;
 		void DrawMeshIndexed(const Ref<const Mesh>& mesh, uint32_t subMeshIndex, uint32_t baseInstance, uint32_t instanceCount) override;
+		void DrawMeshIndexed(const Ref<const Mesh>& mesh, const SubMesh& subMesh, uint32_t baseInstance, uint32_t instanceCount) override;
 		void DrawMeshIndexed(const Ref<const Mesh>& mesh, uint32_t firstSubMesh, uint32_t subMeshCount, uint32_t baseInstance, uint32_t instanceCount);
 
+		void DrawMeshIndexedIndirect(const Ref<const Mesh>& mesh,
+			const Ref<const ShaderStorageBuffer>& commands,
+			size_t offset,
+			uint32_t drawCount) override;
+
 		void DrawIndexed(uint32_t baseIndex,
 			uint32_t indexCount,
 			uint32_t vertexOffset,
@@ -104,11 +110,34 @@ namespace Grapple
 		void EndTimer(Ref<VulkanGPUTimer> timer, VkPipelineStageFlagBits pipelineStages);
 
 		VkCommandBuffer GetHandle() const { return m_CommandBuffer; }
+	private:
+		// Only records the bindings, which differ from the currently bound ones
+		void BindVertexBufferHandles(const VkBuffer* buffers, uint32_t count, uint32_t baseBindingIndex);
+		void PushConstantsRange(VkPipelineLayout pipelineLayout, const ShaderPushConstantsRange& range, const uint8_t* data);
 	private:
 		static constexpr size_t GLOBAL_DESCRIPTOR_SET_COUNT = 3;
+		static constexpr uint32_t MAX_VERTEX_BUFFER_BINDINGS = 8;
 		std::vector<VkImageMemoryBarrier> m_ImageBarriers;
 
-		Ref<const Mesh> m_CurrentMesh = nullptr;
+		VkBuffer m_CurrentVertexBuffers[MAX_VERTEX_BUFFER_BINDINGS] = { VK_NULL_HANDLE };
+		VkBuffer m_CurrentIndexBuffer = VK_NULL_HANDLE;
+		VkIndexType m_CurrentIndexType = VK_INDEX_TYPE_UINT32;
+
+		// Contents of the last vkCmdPushConstants calls, which are still valid for the m_PushConstantsLayout
+		struct PushedConstantsRange
+		{
+			VkShaderStageFlags Stages = 0;
+			uint32_t Offset = 0;
+			uint32_t Size = 0;
+			std::vector<uint8_t> Data;
+		};
+
+		VkPipelineLayout m_PushConstantsLayout = VK_NULL_HANDLE;
+		std::vector<PushedConstantsRange> m_PushedConstants;
+
+		// Material, whose pipeline is currently bound. Its pipeline is switched when a mesh with a different vertex format is bound
+		Ref<const Material> m_CurrentMaterial = nullptr;
+		MeshVertexFormat m_CurrentVertexFormat = MeshVertexFormat::Float;
 
 		Ref<const VulkanDescriptorSet> m_GlobalDescriptorSets[GLOBAL_DESCRIPTOR_SET_COUNT] = { nullptr }; // Slot 3 is material resources
 		bool m_GlobalDescriptorSetsRequireBinding = false;
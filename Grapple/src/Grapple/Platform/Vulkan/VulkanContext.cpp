@@ -90,6 +90,11 @@ namespace Grapple
 			{
 				deviceType = VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU;
 			}
+
+			if (std::strcmp(commandLineArguments.Arguments[i], "--no-indirect-draws") == 0)
+			{
+				m_IndirectDrawsDisabled = true;
+			}
 		}
 
 		std::vector<VkLayerProperties> supportedLayers = EnumerateAvailableLayers();
@@ -486,9 +491,13 @@ namespace Grapple
 		return VK_SUCCESS;
 	}
 
-	Ref<Pipeline> VulkanContext::GetDefaultPipelineForShader(Ref<Shader> shader, Ref<VulkanRenderPass> renderPass)
+	Ref<Pipeline> VulkanContext::GetDefaultPipelineForShader(Ref<Shader> shader, Ref<VulkanRenderPass> renderPass, MeshVertexFormat vertexFormat)
 	{
-		uint64_t key = (uint64_t)shader.get();
+		if (shader->GetMetadata()->Type != ShaderType::Surface)
+			vertexFormat = MeshVertexFormat::Float;
+
+		// Shaders are heap allocated and thus aligned, so the lowest bit of the address is free for the vertex format
+		uint64_t key = (uint64_t)shader.get() | (uint64_t)vertexFormat;
 		auto it = m_DefaultPipelines.find(key);
 
 		if (it != m_DefaultPipelines.end())
@@ -511,6 +520,7 @@ namespace Grapple
 		specifications.DepthClampEnabled = metadata->Features.DepthClampEnabled;
 		specifications.DepthFunction = metadata->Features.DepthFunction;
 		specifications.Blending = metadata->Features.Blending;
+		specifications.VertexFormat = vertexFormat;
 
 		// TODO: Sould be extracted by the ShaderCompiler from shader metadata
 		specifications.DepthBiasSlopeFactor = 1.0f;
@@ -531,6 +541,17 @@ namespace Grapple
 		}
 		case ShaderType::Surface:
 		{
+			if (vertexFormat == MeshVertexFormat::Compact)
+			{
+				specifications.InputLayout = PipelineInputLayout({
+					{ 0, 0, ShaderDataType::UNorm16x4 }, // Position
+					{ 1, 1, ShaderDataType::SNorm16x2 }, // Normal
+					{ 2, 2, ShaderDataType::SNorm16x2 }, // Tangent
+					{ 3, 3, ShaderDataType::Half2 }, // UV
+				});
+				break;
+			}
+
 			specifications.InputLayout = PipelineInputLayout({
 				{ 0, 0, ShaderDataType::Float3 }, // Position
 				{ 1, 1, ShaderDataType::Float3 }, // Normal
@@ -818,12 +839,63 @@ namespace Grapple
 			presentationQueueCreateInfo.pQueuePriorities = &priority;
 		}
 
+		VkPhysicalDeviceVulkan12Features supportedVulkan12Features{};
+		supportedVulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+		VkPhysicalDeviceFeatures2 supportedFeatures{};
+		supportedFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		supportedFeatures.pNext = &supportedVulkan12Features;
+
+		vkGetPhysicalDeviceFeatures2(m_PhysicalDevice, &supportedFeatures);
+
+		// Indirect draws are only useful for the renderer when they can use a non-zero base instance
+		m_Features.MultiDrawIndirect = !m_IndirectDrawsDisabled
+			&& supportedFeatures.features.multiDrawIndirect
+			&& supportedFeatures.features.drawIndirectFirstInstance;
+
+		m_Features.BindlessTextures = supportedVulkan12Features.runtimeDescriptorArray
+			&& supportedVulkan12Features.descriptorBindingPartiallyBound
+			&& supportedVulkan12Features.descriptorBindingSampledImageUpdateAfterBind
+			&& supportedVulkan12Features.descriptorBindingUpdateUnusedWhilePending
+			&& supportedVulkan12Features.shaderSampledImageArrayNonUniformIndexing;
+
+		if (m_Features.BindlessTextures)
+		{
+			VkPhysicalDeviceVulkan12Properties vulkan12Properties{};
+			vulkan12Properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+
+			VkPhysicalDeviceProperties2 properties{};
+			properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+			properties.pNext = &vulkan12Properties;
+
+			vkGetPhysicalDeviceProperties2(m_PhysicalDevice, &properties);
+
+			// Combined image samplers count towards both sampler and sampled image limits
+			m_Features.MaxBindlessTextures = glm::min(
+				glm::min(vulkan12Properties.maxPerStageDescriptorUpdateAfterBindSamplers, vulkan12Properties.maxPerStageDescriptorUpdateAfterBindSampledImages),
+				glm::min(vulkan12Properties.maxDescriptorSetUpdateAfterBindSamplers, vulkan12Properties.maxDescriptorSetUpdateAfterBindSampledImages));
+		}
+
+		Grapple_CORE_INFO("Multi draw indirect supported: {}", m_Features.MultiDrawIndirect);
+		Grapple_CORE_INFO("Bindless textures supported: {} (Max textures: {})", m_Features.BindlessTextures, m_Features.MaxBindlessTextures);
+
 		VkPhysicalDeviceFeatures deviceFeatures = {};
 		deviceFeatures.depthClamp = VK_TRUE;
+		deviceFeatures.multiDrawIndirect = m_Features.MultiDrawIndirect;
+		deviceFeatures.drawIndirectFirstInstance = m_Features.MultiDrawIndirect;
+
+		VkPhysicalDeviceVulkan12Features vulkan12Features{};
+		vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+		vulkan12Features.runtimeDescriptorArray = m_Features.BindlessTextures;
+		vulkan12Features.descriptorBindingPartiallyBound = m_Features.BindlessTextures;
+		vulkan12Features.descriptorBindingSampledImageUpdateAfterBind = m_Features.BindlessTextures;
+		vulkan12Features.descriptorBindingUpdateUnusedWhilePending = m_Features.BindlessTextures;
+		vulkan12Features.shaderSampledImageArrayNonUniformIndexing = m_Features.BindlessTextures;
 
 		VkPhysicalDeviceSynchronization2Features synchronization2{};
 		synchronization2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES;
 		synchronization2.synchronization2 = true;
+		synchronization2.pNext = &vulkan12Features;
 
 		VkDeviceCreateInfo deviceCreateInfo = {};
 		deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
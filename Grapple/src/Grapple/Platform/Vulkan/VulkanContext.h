@@ -92,6 +92,7 @@ namespace Grapple
 		void WaitForDevice() override;
 
 		Ref<CommandBuffer> GetCommandBuffer() const override;
+		const GraphicsContextFeatures& GetFeatures() const override { return m_Features; }
 
 		bool IsValid() const { return m_Device != VK_NULL_HANDLE; }
 
@@ -122,7 +123,8 @@ namespace Grapple
 
 		VkResult SetDebugName(VkObjectType objectType, uint64_t objectHandle, const char* name);
 
-		Ref<Pipeline> GetDefaultPipelineForShader(Ref<Shader> shader, Ref<VulkanRenderPass> renderPass);
+		// Surface shaders have a separate pipeline for each mesh vertex format, other shader types ignore the format
+		Ref<Pipeline> GetDefaultPipelineForShader(Ref<Shader> shader, Ref<VulkanRenderPass> renderPass, MeshVertexFormat vertexFormat = MeshVertexFormat::Float);
 
 		VulkanRenderPassCache& GetRenderPassCache();
 		VulkanStagingBufferPool& GetStagingBufferPool() { return m_StagingBufferPool; }
@@ -170,6 +172,7 @@ namespace Grapple
 		std::function<void(VkImageView)> m_ImageDeletationHandler = nullptr;
 
 		bool m_DebugEnabled = false;
+		bool m_IndirectDrawsDisabled = false;
 
 		PFN_vkCreateDebugUtilsMessengerEXT m_CreateDebugMessenger = nullptr;
 		PFN_vkDestroyDebugUtilsMessengerEXT m_DestroyDebugMessenger = nullptr;
@@ -191,6 +194,8 @@ namespace Grapple
 		std::optional<uint32_t> m_GraphicsQueueFamilyIndex;
 		std::optional<uint32_t> m_PresentQueueFamilyIndex;
 
+		GraphicsContextFeatures m_Features;
+
 		// Empty descriptor
 		Ref<DescriptorSetPool> m_EmptyDescriptorSetPool = nullptr;
 		Ref<DescriptorSetLayout> m_EmptyDescriptorSetLayout = nullptr;
@@ -11,8 +11,10 @@
 
 namespace Grapple
 {
-	VulkanDescriptorSetLayout::VulkanDescriptorSetLayout(const Span<VkDescriptorSetLayoutBinding>& bindings)
+	VulkanDescriptorSetLayout::VulkanDescriptorSetLayout(const Span<VkDescriptorSetLayoutBinding>& bindings, const Span<VkDescriptorBindingFlags>& bindingFlags)
 	{
+		Grapple_CORE_ASSERT(bindingFlags.GetSize() == 0 || bindingFlags.GetSize() == bindings.GetSize());
+
 		for (const auto& binding : bindings)
 		{
 			switch (binding.descriptorType)
@@ -28,11 +30,23 @@ namespace Grapple
 			}
 		}
 
+		for (VkDescriptorBindingFlags flags : bindingFlags)
+		{
+			if (HAS_BIT(flags, VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT))
+				m_UpdateAfterBind = true;
+		}
+
+		VkDescriptorSetLayoutBindingFlagsCreateInfo flagsInfo{};
+		flagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+		flagsInfo.bindingCount = (uint32_t)bindingFlags.GetSize();
+		flagsInfo.pBindingFlags = bindingFlags.GetData();
+
 		VkDescriptorSetLayoutCreateInfo info{};
 		info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-		info.flags = 0;
+		info.flags = m_UpdateAfterBind ? VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT : 0;
 		info.bindingCount = (uint32_t)bindings.GetSize();
 		info.pBindings = bindings.GetData();
+		info.pNext = bindingFlags.GetSize() > 0 ? &flagsInfo : nullptr;
 
 		VK_CHECK_RESULT(vkCreateDescriptorSetLayout(VulkanContext::GetInstance().GetDevice(), &info, nullptr, &m_Layout));
 	}
@@ -225,9 +239,11 @@ namespace Grapple
 
 
 
-	VulkanDescriptorSetPool::VulkanDescriptorSetPool(size_t maxSets, const Span<VkDescriptorSetLayoutBinding>& bindings)
+	VulkanDescriptorSetPool::VulkanDescriptorSetPool(size_t maxSets, const Span<VkDescriptorSetLayoutBinding>& bindings, const Span<VkDescriptorBindingFlags>& bindingFlags)
 		: m_MaxSets(maxSets)
 	{
+		m_Layout = CreateRef<VulkanDescriptorSetLayout>(bindings, bindingFlags);
+
 		std::vector<VkDescriptorPoolSize> sizes(bindings.GetSize());
 		for (size_t i = 0; i < bindings.GetSize(); i++)
 		{
@@ -243,9 +259,10 @@ namespace Grapple
 		info.pNext = nullptr;
 		info.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
 
-		VK_CHECK_RESULT(vkCreateDescriptorPool(VulkanContext::GetInstance().GetDevice(), &info, nullptr, &m_Pool));
+		if (m_Layout->IsUpdateAfterBind())
+			info.flags |= VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
 
-		m_Layout = CreateRef<VulkanDescriptorSetLayout>(bindings);
+		VK_CHECK_RESULT(vkCreateDescriptorPool(VulkanContext::GetInstance().GetDevice(), &info, nullptr, &m_Pool));
 	}
 
 	VulkanDescriptorSetPool::~VulkanDescriptorSetPool()
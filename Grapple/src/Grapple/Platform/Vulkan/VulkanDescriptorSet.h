@@ -13,14 +13,17 @@ namespace Grapple
 	class Grapple_API VulkanDescriptorSetLayout : public DescriptorSetLayout
 	{
 	public:
-		VulkanDescriptorSetLayout(const Span<VkDescriptorSetLayoutBinding>& bindings);
+		// Binding flags are either empty or specified for each binding
+		VulkanDescriptorSetLayout(const Span<VkDescriptorSetLayoutBinding>& bindings, const Span<VkDescriptorBindingFlags>& bindingFlags = {});
 		~VulkanDescriptorSetLayout();
 
 		inline VkDescriptorSetLayout GetHandle() const { return m_Layout; };
 		inline uint32_t GetImageBindingsCount() const { return m_ImageBindings; }
 		inline uint32_t GetBufferBindingsCount() const { return m_BufferBindings; }
+		inline bool IsUpdateAfterBind() const { return m_UpdateAfterBind; }
 	private:
 		VkDescriptorSetLayout m_Layout = VK_NULL_HANDLE;
+		bool m_UpdateAfterBind = false;
 		uint32_t m_ImageBindings = 0;
 		uint32_t m_BufferBindings = 0;
 	};
@@ -59,7 +62,7 @@ namespace Grapple
 	class Grapple_API VulkanDescriptorSetPool : public DescriptorSetPool
 	{
 	public:
-		VulkanDescriptorSetPool(size_t maxSets, const Span<VkDescriptorSetLayoutBinding>& bindings);
+		VulkanDescriptorSetPool(size_t maxSets, const Span<VkDescriptorSetLayoutBinding>& bindings, const Span<VkDescriptorBindingFlags>& bindingFlags = {});
 		~VulkanDescriptorSetPool();
 
 		Ref<DescriptorSet> AllocateSet() override;
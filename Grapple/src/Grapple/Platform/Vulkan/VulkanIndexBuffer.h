@@ -21,6 +21,8 @@ namespace Grapple
 		void SetDebugName(std::string_view debugName) override;
 		const std::string& GetDebugName() const override;
 
+		inline VulkanBuffer& GetBuffer() { return m_Buffer; }
+		inline const VulkanBuffer& GetBuffer() const { return m_Buffer; }
 		inline VkBuffer GetHandle() const { return m_Buffer.GetBuffer(); }
 	private:
 		size_t m_Count = 0;
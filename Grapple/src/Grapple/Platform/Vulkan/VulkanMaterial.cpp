@@ -10,6 +10,7 @@
 #include "Grapple/Platform/Vulkan/VulkanDescriptorSet.h"
 
 #include "Grapple/Renderer/Renderer.h"
+#include "Grapple/Renderer/MaterialDataTable.h"
 #include "Grapple/Renderer2D/Renderer2D.h"
 
 namespace Grapple
@@ -31,8 +32,11 @@ namespace Grapple
 			return;
 		}
 
-		m_Pipeline = nullptr;
+		for (Ref<VulkanPipeline>& pipeline : m_Pipelines)
+			pipeline = nullptr;
+
 		m_Set = nullptr;
+		m_DataTableVersion = 0;
 
 		Ref<VulkanShader> vulkanShader = As<VulkanShader>(shader);
 		auto pool = vulkanShader->GetDescriptorSetPool();
@@ -55,19 +59,23 @@ namespace Grapple
 		m_IsDirty = true;
 	}
 
-	Ref<VulkanPipeline> VulkanMaterial::GetPipeline(const Ref<VulkanRenderPass>& renderPass)
+	Ref<VulkanPipeline> VulkanMaterial::GetPipeline(const Ref<VulkanRenderPass>& renderPass, MeshVertexFormat vertexFormat)
 	{
 		Grapple_PROFILE_FUNCTION();
-		if (m_Pipeline != nullptr && m_Pipeline->GetCompatibleRenderPass().get() == renderPass.get())
-			return m_Pipeline;
+		Ref<VulkanPipeline>& pipeline = m_Pipelines[(size_t)vertexFormat];
+		if (pipeline != nullptr && pipeline->GetCompatibleRenderPass().get() == renderPass.get())
+			return pipeline;
 
-		m_Pipeline = As<VulkanPipeline>(VulkanContext::GetInstance().GetDefaultPipelineForShader(m_Shader, renderPass));
-		return m_Pipeline;
+		pipeline = As<VulkanPipeline>(VulkanContext::GetInstance().GetDefaultPipelineForShader(m_Shader, renderPass, vertexFormat));
+		return pipeline;
 	}
 
 	void VulkanMaterial::UpdateDescriptorSet()
 	{
 		Grapple_PROFILE_FUNCTION();
+		if (m_DataTable && m_DataTable->GetBufferVersion() != m_DataTableVersion)
+			m_IsDirty = true;
+
 		if (!m_IsDirty)
 			return;
 
@@ -90,6 +98,12 @@ namespace Grapple
 			}
 		}
 
+		if (m_DataTable)
+		{
+			m_Set->WriteStorageBuffer(m_DataTable->GetBuffer(), m_Shader->GetMetadata()->MaterialTableBinding);
+			m_DataTableVersion = m_DataTable->GetBufferVersion();
+		}
+
 		m_Set->FlushWrites();
 
 		m_IsDirty = false;
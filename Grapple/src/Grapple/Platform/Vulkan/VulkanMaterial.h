@@ -18,14 +18,18 @@ namespace Grapple
 
 		virtual void SetShader(const Ref<Shader>& shader) override;
 
-		Ref<VulkanPipeline> GetPipeline(const Ref<VulkanRenderPass>& renderPass);
+		Ref<VulkanPipeline> GetPipeline(const Ref<VulkanRenderPass>& renderPass, MeshVertexFormat vertexFormat = MeshVertexFormat::Float);
 		Ref<DescriptorSet> GetDescriptorSet() const { return m_Set; }
 
 		void UpdateDescriptorSet();
 	private:
 		void ReleaseDescriptorSet();
 	private:
-		Ref<VulkanPipeline> m_Pipeline = nullptr;
+		// Indexed by MeshVertexFormat
+		Ref<VulkanPipeline> m_Pipelines[2] = { nullptr };
 		Ref<DescriptorSet> m_Set = nullptr;
+
+		// Version of the MaterialDataTable buffer, which is written to the descriptor set
+		uint32_t m_DataTableVersion = 0;
 	};
 }
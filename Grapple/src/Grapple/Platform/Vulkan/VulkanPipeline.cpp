@@ -198,12 +198,25 @@ namespace Grapple
 		rasterizationState.depthBiasSlopeFactor = m_Specifications.DepthBiasSlopeFactor;
 		rasterizationState.depthBiasConstantFactor = m_Specifications.DepthBiasConstantFactor;
 
+		VkBool32 isVertexFormatCompact = m_Specifications.VertexFormat == MeshVertexFormat::Compact ? VK_TRUE : VK_FALSE;
+
+		VkSpecializationMapEntry vertexFormatEntry{};
+		vertexFormatEntry.constantID = 0;
+		vertexFormatEntry.offset = 0;
+		vertexFormatEntry.size = sizeof(VkBool32);
+
+		VkSpecializationInfo vertexSpecialization{};
+		vertexSpecialization.mapEntryCount = 1;
+		vertexSpecialization.pMapEntries = &vertexFormatEntry;
+		vertexSpecialization.dataSize = sizeof(VkBool32);
+		vertexSpecialization.pData = &isVertexFormatCompact;
+
 		VkPipelineShaderStageCreateInfo stages[2] = {};
 		stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
 		stages[0].module = As<VulkanShader>(m_Specifications.Shader)->GetModuleForStage(ShaderStageType::Vertex);
 		stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
 		stages[0].pName = "main";
-		stages[0].pSpecializationInfo = nullptr;
+		stages[0].pSpecializationInfo = &vertexSpecialization;
 		stages[0].flags = 0;
 
 		stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
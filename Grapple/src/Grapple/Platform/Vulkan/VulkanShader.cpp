@@ -3,6 +3,7 @@
 #include "Grapple/AssetManager/AssetManager.h"
 #include "Grapple/Renderer/ShaderCacheManager.h"
 #include "Grapple/Renderer/Renderer.h"
+#include "Grapple/Renderer/MaterialDataTable.h"
 #include "Grapple/Renderer2D/Renderer2D.h"
 
 #include "Grapple/Platform/Vulkan/VulkanContext.h"
@@ -33,6 +34,13 @@ namespace Grapple
 		case ShaderDataType::Float4:
 			return VK_FORMAT_R32G32B32A32_SFLOAT;
 
+		case ShaderDataType::Half2:
+			return VK_FORMAT_R16G16_SFLOAT;
+		case ShaderDataType::SNorm16x2:
+			return VK_FORMAT_R16G16_SNORM;
+		case ShaderDataType::UNorm16x4:
+			return VK_FORMAT_R16G16B16A16_UNORM;
+
 		case ShaderDataType::Sampler:
 		case ShaderDataType::SamplerArray:
 		case ShaderDataType::Matrix4x4:
@@ -104,6 +112,10 @@ namespace Grapple
 
 		m_DebugName = assetMetadata->Path.filename().replace_extension().generic_string();
 
+		m_MaterialDataTable = nullptr;
+		if (m_Metadata->MaterialDataSize > 0)
+			m_MaterialDataTable = CreateRef<MaterialDataTable>(m_Metadata->MaterialDataSize, fmt::format("{}.MaterialTable", m_DebugName));
+
 		for (ShaderStageModule& stageModule : m_Modules)
 		{
 			auto cachedShader = ShaderCacheManager::GetInstance()->FindCache(Handle, stageModule.Stage);
@@ -0,0 +1,157 @@
+#include "BindlessTextureTable.h"
+
+#include "GrappleCore/Assert.h"
+#include "GrappleCore/Profiler/Profiler.h"
+
+#include "Grapple/Renderer/RendererAPI.h"
+#include "Grapple/Renderer/DescriptorSet.h"
+#include "Grapple/Renderer/Texture.h"
+
+#include "Grapple/Platform/Vulkan/VulkanDescriptorSet.h"
+
+#include <algorithm>
+
+namespace Grapple
+{
+	// Released textures might still be referenced by frames, which are in flight
+	static constexpr uint64_t ReleaseDelayFrames = 3;
+
+	BindlessTextureTable::BindlessTextureTable(uint32_t capacity, std::string_view debugName)
+		: m_Capacity(capacity)
+	{
+		Grapple_CORE_ASSERT(capacity > 0);
+
+		if (RendererAPI::GetAPI() == RendererAPI::API::Vulkan)
+		{
+			VkDescriptorSetLayoutBinding binding{};
+			binding.binding = 0;
+			binding.descriptorCount = capacity;
+			binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+			binding.pImmutableSamplers = nullptr;
+
+			// Only the registered part of the array is ever accessed, and new textures are written
+			// while the set may still be bound by command buffers which don't use them
+			VkDescriptorBindingFlags bindingFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT
+				| VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT
+				| VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+
+			m_DescriptorSetPool = CreateRef<VulkanDescriptorSetPool>(1, Span(&binding, 1), Span(&bindingFlags, 1));
+		}
+
+		Grapple_CORE_ASSERT(m_DescriptorSetPool);
+
+		m_DescriptorSet = m_DescriptorSetPool->AllocateSet();
+		m_DescriptorSet->SetDebugName(debugName);
+
+		m_Slots.reserve(std::min<uint32_t>(capacity, 256));
+	}
+
+	BindlessTextureTable::~BindlessTextureTable()
+	{
+		m_DescriptorSetPool->ReleaseSet(m_DescriptorSet);
+	}
+
+	uint32_t BindlessTextureTable::GetTextureIndex(const Ref<Texture>& texture)
+	{
+		Grapple_CORE_ASSERT(texture);
+
+		auto it = m_TextureToIndex.find(texture.get());
+		if (it != m_TextureToIndex.end())
+		{
+			m_Slots[it->second].LastUsedFrame = m_FrameIndex;
+			return it->second;
+		}
+
+		uint32_t index = InvalidIndex;
+		if (m_FreeIndices.size() > 0)
+		{
+			index = m_FreeIndices.back();
+			m_FreeIndices.pop_back();
+		}
+		else if (m_Slots.size() < (size_t)m_Capacity)
+		{
+			index = (uint32_t)m_Slots.size();
+			m_Slots.emplace_back();
+		}
+		else
+		{
+			return InvalidIndex;
+		}
+
+		Slot& slot = m_Slots[index];
+		slot.Texture = texture;
+		slot.LastUsedFrame = m_FrameIndex;
+
+		m_TextureToIndex.emplace(texture.get(), index);
+		m_PendingWrites.push_back(index);
+		return index;
+	}
+
+	void BindlessTextureTable::BeginFrame()
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		m_FrameIndex++;
+
+		for (uint32_t index = 0; index < (uint32_t)m_Slots.size(); index++)
+		{
+			Slot& slot = m_Slots[index];
+			if (slot.Texture == nullptr || slot.Texture.use_count() > 1)
+				continue;
+
+			if (m_FrameIndex - slot.LastUsedFrame <= ReleaseDelayFrames)
+				continue;
+
+			// The descriptor is left as is, because partially bound descriptors don't have to be valid unless they are used
+			m_TextureToIndex.erase(slot.Texture.get());
+			slot.Texture = nullptr;
+			m_FreeIndices.push_back(index);
+		}
+	}
+
+	void BindlessTextureTable::FlushWrites()
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		if (m_PendingWrites.empty())
+			return;
+
+		// Indices might have been released and registered again before being flushed
+		std::sort(m_PendingWrites.begin(), m_PendingWrites.end());
+		m_PendingWrites.erase(std::unique(m_PendingWrites.begin(), m_PendingWrites.end()), m_PendingWrites.end());
+		m_PendingWrites.erase(std::remove_if(m_PendingWrites.begin(), m_PendingWrites.end(), [this](uint32_t index) -> bool
+		{
+			return m_Slots[index].Texture == nullptr;
+		}), m_PendingWrites.end());
+
+		std::vector<Ref<const Texture>> textures;
+		textures.reserve(m_PendingWrites.size());
+
+		size_t rangeStart = 0;
+		while (rangeStart < m_PendingWrites.size())
+		{
+			size_t rangeEnd = rangeStart + 1;
+			while (rangeEnd < m_PendingWrites.size() && m_PendingWrites[rangeEnd] == m_PendingWrites[rangeEnd - 1] + 1)
+				rangeEnd++;
+
+			textures.clear();
+			for (size_t i = rangeStart; i < rangeEnd; i++)
+				textures.push_back(m_Slots[m_PendingWrites[i]].Texture);
+
+			// Flushed after each range, because the write references the image infos
+			// of the set, which can be reallocated by the following write
+			m_DescriptorSet->WriteImages(Span(textures.data(), textures.size()), m_PendingWrites[rangeStart], 0);
+			m_DescriptorSet->FlushWrites();
+
+			rangeStart = rangeEnd;
+		}
+
+		m_PendingWrites.clear();
+	}
+
+	Ref<const DescriptorSetLayout> BindlessTextureTable::GetDescriptorSetLayout() const
+	{
+		return m_DescriptorSetPool->GetLayout();
+	}
+}
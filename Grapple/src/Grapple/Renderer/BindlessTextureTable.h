@@ -0,0 +1,66 @@
+#pragma once
+
+#include "GrappleCore/Core.h"
+
+#include <stdint.h>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Grapple
+{
+	class Texture;
+	class DescriptorSet;
+	class DescriptorSetPool;
+	class DescriptorSetLayout;
+
+	// Persistent array of textures, which is bound once and addressed by shaders through stable texture indices.
+	//
+	// Textures are registered on first use and keep their index until nothing but the table references them,
+	// so draws using different textures don't have to be split and don't need their own descriptor sets.
+	// Requires GraphicsContextFeatures::BindlessTextures.
+	class Grapple_API BindlessTextureTable
+	{
+	public:
+		static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+		BindlessTextureTable(uint32_t capacity, std::string_view debugName);
+		~BindlessTextureTable();
+
+		// Returns the index of the texture in the array, registers the texture if it isn't in the table yet.
+		// Returns InvalidIndex when the table is full
+		uint32_t GetTextureIndex(const Ref<Texture>& texture);
+
+		// Advances the frame and releases indices of textures, which are only referenced by the table
+		// and haven't been used during the last few frames
+		void BeginFrame();
+
+		// Writes descriptors of the textures registered since the last flush.
+		// The descriptor set is update-after-bind, so this only has to happen before the commands are submitted
+		void FlushWrites();
+
+		inline const Ref<DescriptorSet>& GetDescriptorSet() const { return m_DescriptorSet; }
+		Ref<const DescriptorSetLayout> GetDescriptorSetLayout() const;
+
+		inline uint32_t GetCapacity() const { return m_Capacity; }
+		inline size_t GetTexturesCount() const { return m_TextureToIndex.size(); }
+	private:
+		struct Slot
+		{
+			Ref<Texture> Texture = nullptr;
+			uint64_t LastUsedFrame = 0;
+		};
+
+		uint32_t m_Capacity = 0;
+		uint64_t m_FrameIndex = 0;
+
+		std::vector<Slot> m_Slots;
+		std::vector<uint32_t> m_FreeIndices;
+		std::unordered_map<const Texture*, uint32_t> m_TextureToIndex;
+
+		std::vector<uint32_t> m_PendingWrites;
+
+		Ref<DescriptorSetPool> m_DescriptorSetPool = nullptr;
+		Ref<DescriptorSet> m_DescriptorSet = nullptr;
+	};
+}
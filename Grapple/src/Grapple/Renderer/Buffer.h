@@ -19,6 +19,17 @@ namespace Grapple
 		Dynamic = 1,
 	};
 
+	// Encoding of mesh vertex attributes, each attribute is stored in a separate vertex buffer
+	enum class MeshVertexFormat : uint8_t
+	{
+		// 44 bytes per vertex: float positions, normals, tangents and UVs
+		Float = 0,
+
+		// 20 bytes per vertex: 16 bit normalized positions inside of the mesh's quantization bounds,
+		// 16 bit octahedral normals and tangents and half precision UVs
+		Compact = 1,
+	};
+
 	class Grapple_API VertexBuffer
 	{
 	public:
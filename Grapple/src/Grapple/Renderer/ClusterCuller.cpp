@@ -0,0 +1,72 @@
+#include "ClusterCuller.h"
+
+#include "GrappleCore/Profiler/Profiler.h"
+
+namespace Grapple
+{
+	uint32_t ClusterCuller::Cull(const Mesh& mesh,
+		const SubMesh& subMesh,
+		const Math::Compact3DTransform& transform,
+		const FrustumPlanes& planes,
+		const glm::vec3& viewPosition,
+		bool cullBackFaces,
+		std::vector<MeshIndexRange>& visibleRanges)
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		const glm::mat3& rotationScale = transform.RotationScale;
+		float scale = glm::max(glm::length(rotationScale[0]), glm::max(glm::length(rotationScale[1]), glm::length(rotationScale[2])));
+
+		// Whether a triangle faces the viewer doesn't change under an affine transform, so the cone test is done in the mesh space.
+		// Mirroring transforms flip the winding order, so back faces can't be culled for them
+		float determinant = glm::determinant(rotationScale);
+		cullBackFaces &= determinant > 0.0f;
+
+		glm::vec3 localViewPosition = glm::vec3(0.0f);
+		if (cullBackFaces)
+			localViewPosition = glm::inverse(rotationScale) * (viewPosition - transform.Translation);
+
+		uint32_t visibleIndices = 0;
+		size_t firstRange = visibleRanges.size();
+
+		for (const Meshlet& meshlet : mesh.GetMeshlets(subMesh))
+		{
+			if (cullBackFaces && IsBackFacing(meshlet, localViewPosition))
+				continue;
+
+			glm::vec3 center = rotationScale * meshlet.Center + transform.Translation;
+			float radius = meshlet.Radius * scale;
+
+			bool isInside = true;
+			for (size_t i = 0; i < FrustumPlanes::PlanesCount && isInside; i++)
+				isInside = planes.Planes[i].SignedDistance(center) >= -radius;
+
+			if (!isInside)
+				continue;
+
+			visibleIndices += meshlet.IndicesCount;
+
+			if (visibleRanges.size() > firstRange)
+			{
+				MeshIndexRange& lastRange = visibleRanges.back();
+				if (lastRange.BaseIndex + lastRange.IndicesCount == meshlet.BaseIndex)
+				{
+					lastRange.IndicesCount += meshlet.IndicesCount;
+					continue;
+				}
+			}
+
+			MeshIndexRange& range = visibleRanges.emplace_back();
+			range.BaseIndex = meshlet.BaseIndex;
+			range.IndicesCount = meshlet.IndicesCount;
+		}
+
+		return visibleIndices;
+	}
+
+	bool ClusterCuller::IsBackFacing(const Meshlet& meshlet, const glm::vec3& viewPosition)
+	{
+		glm::vec3 direction = meshlet.Center - viewPosition;
+		return glm::dot(direction, meshlet.ConeAxis) >= meshlet.ConeCutoff * glm::length(direction) + meshlet.Radius;
+	}
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "GrappleCore/Core.h"
+
+#include "Grapple/Math/Transform.h"
+#include "Grapple/Renderer/Mesh.h"
+#include "Grapple/Renderer/RenderData.h"
+
+#include <vector>
+
+namespace Grapple
+{
+	struct MeshIndexRange
+	{
+		uint32_t BaseIndex = 0;
+		uint32_t IndicesCount = 0;
+	};
+
+	// Culls meshlets of a single sub mesh instance on the CPU.
+	// Meshlets are rejected when their bounding sphere is outside of the frustum, or when all of their triangles face away from the viewer.
+	class Grapple_API ClusterCuller
+	{
+	public:
+		// Appends ranges of indices of the visible meshlets, adjacent meshlets are merged into a single range.
+		// Back facing meshlets are only culled when `cullBackFaces` is true, which requires a perspective projection.
+		// Returns the number of visible indices
+		static uint32_t Cull(const Mesh& mesh,
+			const SubMesh& subMesh,
+			const Math::Compact3DTransform& transform,
+			const FrustumPlanes& planes,
+			const glm::vec3& viewPosition,
+			bool cullBackFaces,
+			std::vector<MeshIndexRange>& visibleRanges);
+
+		// Returns true when all triangles of the meshlet face away from the `viewPosition`, which is in the mesh space
+		static bool IsBackFacing(const Meshlet& meshlet, const glm::vec3& viewPosition);
+	};
+}
@@ -12,6 +12,7 @@ namespace Grapple
 	class FrameBuffer;
 	class Material;
 	class Mesh;
+	struct SubMesh;
 	class GPUTimer;
 	class ComputePipeline;
 	class Pipeline;
@@ -19,6 +20,17 @@ namespace Grapple
 	class VertexBuffer;
 	class IndexBuffer;
 	class ShaderConstantBuffer;
+	class ShaderStorageBuffer;
+
+	// Matches the layout of VkDrawIndexedIndirectCommand
+	struct DrawIndexedIndirectCommand
+	{
+		uint32_t IndexCount = 0;
+		uint32_t InstanceCount = 0;
+		uint32_t FirstIndex = 0;
+		int32_t VertexOffset = 0;
+		uint32_t FirstInstance = 0;
+	};
 
 	class CommandBuffer
 	{
@@ -55,6 +67,20 @@ namespace Grapple
 			uint32_t baseInstance,
 			uint32_t instanceCount) = 0;
 
+		// Draws an index range of the mesh, which is used for drawing sub meshes of LODs
+		virtual void DrawMeshIndexed(const Ref<const Mesh>& mesh,
+			const SubMesh& subMesh,
+			uint32_t baseInstance,
+			uint32_t instanceCount) = 0;
+
+		// Draws `drawCount` DrawIndexedIndirectCommands stored in the `commands` buffer starting at `offset`,
+		// using the GeometryPool buffers of the mesh. Commands can draw any mesh, which shares the buffers with it,
+		// so their first index and vertex offset must include the base index and vertex of the drawn mesh
+		virtual void DrawMeshIndexedIndirect(const Ref<const Mesh>& mesh,
+			const Ref<const ShaderStorageBuffer>& commands,
+			size_t offset,
+			uint32_t drawCount) = 0;
+
 		virtual void DrawIndexed(uint32_t baseIndex,
 			uint32_t indexCount,
 			uint32_t vertexOffset,
@@ -0,0 +1,303 @@
+#include "CullingBVH.h"
+
+#include "GrappleCore/Assert.h"
+#include "GrappleCore/Profiler/Profiler.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace Grapple
+{
+	static Math::AABB CombineBounds(const Math::AABB& a, const Math::AABB& b)
+	{
+		return Math::AABB(glm::min(a.Min, b.Min), glm::max(a.Max, b.Max));
+	}
+
+	uint32_t CullingBVH::Insert(const Math::AABB& bounds)
+	{
+		uint32_t leafIndex = 0;
+		if (m_FreeLeaves.size() > 0)
+		{
+			leafIndex = m_FreeLeaves.back();
+			m_FreeLeaves.pop_back();
+		}
+		else
+		{
+			leafIndex = (uint32_t)m_Leaves.size();
+			m_Leaves.emplace_back();
+		}
+
+		Leaf& leaf = m_Leaves[leafIndex];
+		leaf.Bounds = bounds;
+		leaf.Node = InvalidIndex;
+		leaf.IsAlive = true;
+
+		m_LeavesCount++;
+		m_NeedsRebuild = true;
+		return leafIndex;
+	}
+
+	void CullingBVH::Remove(uint32_t leaf)
+	{
+		Grapple_CORE_ASSERT(leaf < m_Leaves.size() && m_Leaves[leaf].IsAlive);
+
+		m_Leaves[leaf].IsAlive = false;
+		m_Leaves[leaf].Node = InvalidIndex;
+		m_FreeLeaves.push_back(leaf);
+
+		m_LeavesCount--;
+		m_NeedsRebuild = true;
+	}
+
+	void CullingBVH::SetBounds(uint32_t leaf, const Math::AABB& bounds)
+	{
+		Grapple_CORE_ASSERT(leaf < m_Leaves.size() && m_Leaves[leaf].IsAlive);
+
+		m_Leaves[leaf].Bounds = bounds;
+
+		if (!m_NeedsRebuild && m_Leaves[leaf].Node != InvalidIndex)
+			MarkDirty(m_Leaves[leaf].Node);
+	}
+
+	void CullingBVH::Update()
+	{
+		if (m_NeedsRebuild)
+			Build();
+		else if (m_DirtyNodes.size() > 0)
+			Refit();
+	}
+
+	void CullingBVH::Clear()
+	{
+		m_Nodes.clear();
+		m_Leaves.clear();
+		m_FreeLeaves.clear();
+		m_LeafOrder.clear();
+		m_DirtyNodes.clear();
+		m_IsNodeDirty.clear();
+
+		m_LeavesCount = 0;
+		m_NeedsRebuild = false;
+	}
+
+	void CullingBVH::Cull(const Math::Plane* planes, size_t planesCount, std::vector<uint32_t>& visibleLeaves) const
+	{
+		Grapple_PROFILE_FUNCTION();
+		Grapple_CORE_ASSERT(planesCount <= 32);
+		Grapple_CORE_ASSERT(!m_NeedsRebuild);
+
+		if (m_Nodes.size() == 0)
+			return;
+
+		struct StackEntry
+		{
+			uint32_t Node;
+			uint32_t PlanesMask;
+		};
+
+		// Max depth of the tree is bounded by log2 of the leaves count
+		StackEntry stack[64];
+		uint32_t stackSize = 0;
+
+		uint32_t allPlanesMask = planesCount == 32 ? UINT32_MAX : (1u << (uint32_t)planesCount) - 1;
+		stack[stackSize++] = { 0, allPlanesMask };
+
+		while (stackSize > 0)
+		{
+			StackEntry entry = stack[--stackSize];
+			const Node& node = m_Nodes[entry.Node];
+
+			glm::vec3 center = node.Bounds.GetCenter();
+			glm::vec3 extents = node.Bounds.Max - center;
+
+			bool culled = false;
+			uint32_t planesMask = entry.PlanesMask;
+			for (uint32_t i = 0; i < (uint32_t)planesCount; i++)
+			{
+				if ((planesMask & (1u << i)) == 0)
+					continue;
+
+				float distance = planes[i].SignedDistance(center);
+				float radius = glm::dot(glm::abs(planes[i].Normal), extents);
+
+				if (distance + radius < 0.0f)
+				{
+					culled = true;
+					break;
+				}
+
+				// Node is fully in front of the plane, so children don't need to be tested against it
+				if (distance - radius >= 0.0f)
+					planesMask &= ~(1u << i);
+			}
+
+			if (culled)
+				continue;
+
+			if (planesMask == 0)
+			{
+				for (uint32_t i = 0; i < node.LeavesCount; i++)
+					visibleLeaves.push_back(m_LeafOrder[node.FirstLeaf + i]);
+
+				continue;
+			}
+
+			if (!node.IsLeaf())
+			{
+				Grapple_CORE_ASSERT(stackSize + 2 <= sizeof(stack) / sizeof(*stack));
+				stack[stackSize++] = { node.Left + 1, planesMask };
+				stack[stackSize++] = { node.Left, planesMask };
+				continue;
+			}
+
+			for (uint32_t i = 0; i < node.LeavesCount; i++)
+			{
+				uint32_t leafIndex = m_LeafOrder[node.FirstLeaf + i];
+				const Math::AABB& bounds = m_Leaves[leafIndex].Bounds;
+
+				glm::vec3 leafCenter = bounds.GetCenter();
+				glm::vec3 leafExtents = bounds.Max - leafCenter;
+
+				bool visible = true;
+				for (uint32_t planeIndex = 0; planeIndex < (uint32_t)planesCount; planeIndex++)
+				{
+					if ((planesMask & (1u << planeIndex)) == 0)
+						continue;
+
+					float distance = planes[planeIndex].SignedDistance(leafCenter);
+					float radius = glm::dot(glm::abs(planes[planeIndex].Normal), leafExtents);
+
+					if (distance + radius < 0.0f)
+					{
+						visible = false;
+						break;
+					}
+				}
+
+				if (visible)
+					visibleLeaves.push_back(leafIndex);
+			}
+		}
+	}
+
+	void CullingBVH::Build()
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		m_NeedsRebuild = false;
+		m_Nodes.clear();
+		m_LeafOrder.clear();
+		m_DirtyNodes.clear();
+
+		for (uint32_t i = 0; i < (uint32_t)m_Leaves.size(); i++)
+		{
+			if (m_Leaves[i].IsAlive)
+				m_LeafOrder.push_back(i);
+		}
+
+		if (m_LeafOrder.size() == 0)
+		{
+			m_IsNodeDirty.clear();
+			return;
+		}
+
+		m_Nodes.reserve(2 * m_LeafOrder.size() / MaxLeavesPerNode + 1);
+		m_Nodes.emplace_back();
+
+		BuildNode(0, 0, (uint32_t)m_LeafOrder.size());
+
+		m_IsNodeDirty.assign(m_Nodes.size(), false);
+	}
+
+	void CullingBVH::BuildNode(uint32_t nodeIndex, uint32_t firstLeaf, uint32_t leavesCount)
+	{
+		Math::AABB bounds = m_Leaves[m_LeafOrder[firstLeaf]].Bounds;
+		Math::AABB centersBounds(bounds.GetCenter(), bounds.GetCenter());
+		for (uint32_t i = 1; i < leavesCount; i++)
+		{
+			const Math::AABB& leafBounds = m_Leaves[m_LeafOrder[firstLeaf + i]].Bounds;
+			bounds = CombineBounds(bounds, leafBounds);
+			centersBounds = CombineBounds(centersBounds, Math::AABB(leafBounds.GetCenter(), leafBounds.GetCenter()));
+		}
+
+		{
+			Node& node = m_Nodes[nodeIndex];
+			node.Bounds = bounds;
+			node.FirstLeaf = firstLeaf;
+			node.LeavesCount = leavesCount;
+		}
+
+		if (leavesCount <= MaxLeavesPerNode)
+		{
+			for (uint32_t i = 0; i < leavesCount; i++)
+				m_Leaves[m_LeafOrder[firstLeaf + i]].Node = nodeIndex;
+
+			return;
+		}
+
+		// Split at the median along the longest axis of the centers bounds
+		glm::vec3 size = centersBounds.GetSize();
+		int32_t axis = 0;
+		if (size.y > size[axis])
+			axis = 1;
+		if (size.z > size[axis])
+			axis = 2;
+
+		uint32_t leftCount = leavesCount / 2;
+		auto begin = m_LeafOrder.begin() + firstLeaf;
+		std::nth_element(begin, begin + leftCount, begin + leavesCount, [this, axis](uint32_t a, uint32_t b) -> bool
+		{
+			return m_Leaves[a].Bounds.GetCenter()[axis] < m_Leaves[b].Bounds.GetCenter()[axis];
+		});
+
+		uint32_t left = (uint32_t)m_Nodes.size();
+		m_Nodes.emplace_back();
+		m_Nodes.emplace_back();
+
+		m_Nodes[nodeIndex].Left = left;
+		m_Nodes[left].Parent = nodeIndex;
+		m_Nodes[left + 1].Parent = nodeIndex;
+
+		BuildNode(left, firstLeaf, leftCount);
+		BuildNode(left + 1, firstLeaf + leftCount, leavesCount - leftCount);
+	}
+
+	void CullingBVH::Refit()
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		// Children are always created after their parents, so refitting in the descending order
+		// guarantees that children are up to date before their parent is refit
+		std::sort(m_DirtyNodes.begin(), m_DirtyNodes.end(), std::greater<uint32_t>());
+
+		for (uint32_t nodeIndex : m_DirtyNodes)
+		{
+			Node& node = m_Nodes[nodeIndex];
+			if (node.IsLeaf())
+			{
+				node.Bounds = m_Leaves[m_LeafOrder[node.FirstLeaf]].Bounds;
+				for (uint32_t i = 1; i < node.LeavesCount; i++)
+					node.Bounds = CombineBounds(node.Bounds, m_Leaves[m_LeafOrder[node.FirstLeaf + i]].Bounds);
+			}
+			else
+			{
+				node.Bounds = CombineBounds(m_Nodes[node.Left].Bounds, m_Nodes[node.Left + 1].Bounds);
+			}
+
+			m_IsNodeDirty[nodeIndex] = false;
+		}
+
+		m_DirtyNodes.clear();
+	}
+
+	void CullingBVH::MarkDirty(uint32_t nodeIndex)
+	{
+		while (nodeIndex != InvalidIndex && !m_IsNodeDirty[nodeIndex])
+		{
+			m_IsNodeDirty[nodeIndex] = true;
+			m_DirtyNodes.push_back(nodeIndex);
+
+			nodeIndex = m_Nodes[nodeIndex].Parent;
+		}
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "GrappleCore/Core.h"
+
+#include "Grapple/Math/Math.h"
+
+#include <vector>
+
+namespace Grapple
+{
+	// Bounding volume hierarchy over a set of AABBs, used for culling objects which persist between frames.
+	//
+	// Leaf ids stay valid until the leaf is removed. Changing the bounds of a leaf only refits its ancestors,
+	// while adding or removing leaves causes the tree to be rebuilt during the next `Update()`.
+	class Grapple_API CullingBVH
+	{
+	public:
+		static constexpr uint32_t InvalidIndex = UINT32_MAX;
+		static constexpr uint32_t MaxLeavesPerNode = 4;
+
+		uint32_t Insert(const Math::AABB& bounds);
+		void Remove(uint32_t leaf);
+		void SetBounds(uint32_t leaf, const Math::AABB& bounds);
+
+		void Update();
+		void Clear();
+
+		// Appends ids of the leaves, which intersect or are in front of all the planes.
+		// Subtrees fully in front of all planes are accepted without testing individual leaves.
+		void Cull(const Math::Plane* planes, size_t planesCount, std::vector<uint32_t>& visibleLeaves) const;
+
+		inline size_t GetLeavesCount() const { return m_LeavesCount; }
+		inline size_t GetNodesCount() const { return m_Nodes.size(); }
+	private:
+		struct Node
+		{
+			Math::AABB Bounds;
+			uint32_t Parent = InvalidIndex;
+
+			// Index of the left child. The right child is always stored right after the left one
+			uint32_t Left = InvalidIndex;
+
+			// Range of `m_LeafOrder` covered by the node
+			uint32_t FirstLeaf = 0;
+			uint32_t LeavesCount = 0;
+
+			inline bool IsLeaf() const { return Left == InvalidIndex; }
+		};
+
+		struct Leaf
+		{
+			Math::AABB Bounds;
+			uint32_t Node = InvalidIndex;
+			bool IsAlive = false;
+		};
+
+		void Build();
+		void BuildNode(uint32_t nodeIndex, uint32_t firstLeaf, uint32_t leavesCount);
+		void Refit();
+		void MarkDirty(uint32_t nodeIndex);
+	private:
+		std::vector<Node> m_Nodes;
+		std::vector<Leaf> m_Leaves;
+		std::vector<uint32_t> m_FreeLeaves;
+		std::vector<uint32_t> m_LeafOrder;
+
+		std::vector<uint32_t> m_DirtyNodes;
+		std::vector<bool> m_IsNodeDirty;
+
+		size_t m_LeavesCount = 0;
+		bool m_NeedsRebuild = false;
+	};
+}
@@ -69,6 +69,14 @@ namespace Grapple
             int32_t remaining = atlasPacker.pack(m_Data.Glyphs.data(), (int32_t)m_Data.Glyphs.size());
             Grapple_CORE_ASSERT(remaining == 0);
 
+            uint32_t maxCodepoint = 0;
+            for (const msdf_atlas::GlyphGeometry& glyph : m_Data.Glyphs)
+                maxCodepoint = glm::max(maxCodepoint, (uint32_t)glyph.getCodepoint());
+
+            m_GlyphTable.assign((size_t)maxCodepoint + 1, nullptr);
+            for (const msdf_atlas::GlyphGeometry& glyph : m_Data.Glyphs)
+                m_GlyphTable[glyph.getCodepoint()] = &glyph;
+
             int32_t width;
             int32_t height;
 
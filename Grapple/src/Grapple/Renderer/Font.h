@@ -31,10 +31,19 @@ namespace Grapple
 		Ref<Texture> GetAtlas() const { return m_FontAtlas; }
 		inline const MSDFData& GetData() const { return m_Data; }
 
+		// Returns null if the font doesn't have a glyph for the codepoint
+		inline const msdf_atlas::GlyphGeometry* FindGlyph(uint32_t codepoint) const
+		{
+			return codepoint < (uint32_t)m_GlyphTable.size() ? m_GlyphTable[codepoint] : nullptr;
+		}
+
 		static Ref<Font> GetDefault();
 		static void SetDefault(const Ref<Font>& font);
 	private:
 		MSDFData m_Data;
 		Ref<Texture> m_FontAtlas;
+
+		// Glyphs indexed by codepoint, which avoids map lookups done by `msdf_atlas::FontGeometry::getGlyph`
+		std::vector<const msdf_atlas::GlyphGeometry*> m_GlyphTable;
 	};
 }
\ No newline at end of file
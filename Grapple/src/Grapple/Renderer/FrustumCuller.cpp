@@ -0,0 +1,258 @@
+#include "FrustumCuller.h"
+
+#include "GrappleCore/Assert.h"
+#include "GrappleCore/Profiler/Profiler.h"
+
+#include <immintrin.h>
+
+namespace Grapple
+{
+	void FrustumCuller::Clear()
+	{
+		m_CenterX.clear();
+		m_CenterY.clear();
+		m_CenterZ.clear();
+
+		m_ExtentX.clear();
+		m_ExtentY.clear();
+		m_ExtentZ.clear();
+	}
+
+	void FrustumCuller::Reserve(size_t count)
+	{
+		m_CenterX.reserve(count);
+		m_CenterY.reserve(count);
+		m_CenterZ.reserve(count);
+
+		m_ExtentX.reserve(count);
+		m_ExtentY.reserve(count);
+		m_ExtentZ.reserve(count);
+	}
+
+	static void TransformBounds(const Math::AABB& localBounds, const Math::Compact3DTransform& transform, glm::vec3& center, glm::vec3& extents)
+	{
+		center = transform.RotationScale * localBounds.GetCenter() + transform.Translation;
+
+		glm::vec3 localExtents = localBounds.GetExtents();
+		extents = glm::abs(transform.RotationScale[0]) * localExtents.x
+			+ glm::abs(transform.RotationScale[1]) * localExtents.y
+			+ glm::abs(transform.RotationScale[2]) * localExtents.z;
+	}
+
+	void FrustumCuller::AddBounds(const Math::AABB& localBounds, const Math::Compact3DTransform& transform)
+	{
+		glm::vec3 center;
+		glm::vec3 extents;
+		TransformBounds(localBounds, transform, center, extents);
+
+		m_CenterX.push_back(center.x);
+		m_CenterY.push_back(center.y);
+		m_CenterZ.push_back(center.z);
+
+		m_ExtentX.push_back(extents.x);
+		m_ExtentY.push_back(extents.y);
+		m_ExtentZ.push_back(extents.z);
+	}
+
+	void FrustumCuller::Resize(size_t count)
+	{
+		m_CenterX.resize(count);
+		m_CenterY.resize(count);
+		m_CenterZ.resize(count);
+
+		m_ExtentX.resize(count);
+		m_ExtentY.resize(count);
+		m_ExtentZ.resize(count);
+	}
+
+	void FrustumCuller::SetBounds(size_t index, const Math::AABB& localBounds, const Math::Compact3DTransform& transform)
+	{
+		Grapple_CORE_ASSERT(index < GetSize());
+
+		glm::vec3 center;
+		glm::vec3 extents;
+		TransformBounds(localBounds, transform, center, extents);
+
+		m_CenterX[index] = center.x;
+		m_CenterY[index] = center.y;
+		m_CenterZ[index] = center.z;
+
+		m_ExtentX[index] = extents.x;
+		m_ExtentY[index] = extents.y;
+		m_ExtentZ[index] = extents.z;
+	}
+
+	void FrustumCuller::SetBounds(size_t index, const Math::AABB& worldBounds)
+	{
+		Grapple_CORE_ASSERT(index < GetSize());
+
+		glm::vec3 center = worldBounds.GetCenter();
+		glm::vec3 extents = worldBounds.GetExtents();
+
+		m_CenterX[index] = center.x;
+		m_CenterY[index] = center.y;
+		m_CenterZ[index] = center.z;
+
+		m_ExtentX[index] = extents.x;
+		m_ExtentY[index] = extents.y;
+		m_ExtentZ[index] = extents.z;
+	}
+
+	void FrustumCuller::Cull(const FrustumPlanes& planes, std::vector<uint32_t>& visibleIndices) const
+	{
+		Cull(planes, 0, GetSize(), visibleIndices);
+	}
+
+	void FrustumCuller::Cull(const FrustumPlanes& planes, size_t firstIndex, size_t count, std::vector<uint32_t>& visibleIndices) const
+	{
+		Grapple_PROFILE_FUNCTION();
+		Grapple_CORE_ASSERT(firstIndex + count <= GetSize());
+
+		// Reserve space for the worst case, so that indices can be written without branching
+		// and then shrink the vector to the actual number of visible objects
+		size_t outputStart = visibleIndices.size();
+		visibleIndices.resize(outputStart + count);
+
+		uint32_t* output = visibleIndices.data() + outputStart;
+		size_t visibleCount = 0;
+
+		const float* centerX = m_CenterX.data();
+		const float* centerY = m_CenterY.data();
+		const float* centerZ = m_CenterZ.data();
+		const float* extentX = m_ExtentX.data();
+		const float* extentY = m_ExtentY.data();
+		const float* extentZ = m_ExtentZ.data();
+
+		size_t index = firstIndex;
+		size_t endIndex = firstIndex + count;
+
+#ifdef __AVX__
+		{
+			__m256 normalX[FrustumPlanes::PlanesCount];
+			__m256 normalY[FrustumPlanes::PlanesCount];
+			__m256 normalZ[FrustumPlanes::PlanesCount];
+			__m256 absNormalX[FrustumPlanes::PlanesCount];
+			__m256 absNormalY[FrustumPlanes::PlanesCount];
+			__m256 absNormalZ[FrustumPlanes::PlanesCount];
+			__m256 offset[FrustumPlanes::PlanesCount];
+
+			for (size_t i = 0; i < FrustumPlanes::PlanesCount; i++)
+			{
+				const Math::Plane& plane = planes.Planes[i];
+				normalX[i] = _mm256_set1_ps(plane.Normal.x);
+				normalY[i] = _mm256_set1_ps(plane.Normal.y);
+				normalZ[i] = _mm256_set1_ps(plane.Normal.z);
+				absNormalX[i] = _mm256_set1_ps(glm::abs(plane.Normal.x));
+				absNormalY[i] = _mm256_set1_ps(glm::abs(plane.Normal.y));
+				absNormalZ[i] = _mm256_set1_ps(glm::abs(plane.Normal.z));
+				offset[i] = _mm256_set1_ps(plane.Offset);
+			}
+
+			const __m256 zero = _mm256_setzero_ps();
+			for (; index + 8 <= endIndex; index += 8)
+			{
+				__m256 cx = _mm256_loadu_ps(centerX + index);
+				__m256 cy = _mm256_loadu_ps(centerY + index);
+				__m256 cz = _mm256_loadu_ps(centerZ + index);
+				__m256 ex = _mm256_loadu_ps(extentX + index);
+				__m256 ey = _mm256_loadu_ps(extentY + index);
+				__m256 ez = _mm256_loadu_ps(extentZ + index);
+
+				__m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+				for (size_t i = 0; i < FrustumPlanes::PlanesCount; i++)
+				{
+					__m256 distance = _mm256_add_ps(
+						_mm256_add_ps(_mm256_mul_ps(cx, normalX[i]), _mm256_mul_ps(cy, normalY[i])),
+						_mm256_add_ps(_mm256_mul_ps(cz, normalZ[i]), offset[i]));
+
+					__m256 radius = _mm256_add_ps(
+						_mm256_add_ps(_mm256_mul_ps(ex, absNormalX[i]), _mm256_mul_ps(ey, absNormalY[i])),
+						_mm256_mul_ps(ez, absNormalZ[i]));
+
+					visible = _mm256_and_ps(visible, _mm256_cmp_ps(_mm256_add_ps(distance, radius), zero, _CMP_GE_OQ));
+				}
+
+				int32_t mask = _mm256_movemask_ps(visible);
+				for (uint32_t i = 0; i < 8; i++)
+				{
+					output[visibleCount] = (uint32_t)index + i;
+					visibleCount += (mask >> i) & 1;
+				}
+			}
+		}
+#endif
+
+		{
+			__m128 normalX[FrustumPlanes::PlanesCount];
+			__m128 normalY[FrustumPlanes::PlanesCount];
+			__m128 normalZ[FrustumPlanes::PlanesCount];
+			__m128 absNormalX[FrustumPlanes::PlanesCount];
+			__m128 absNormalY[FrustumPlanes::PlanesCount];
+			__m128 absNormalZ[FrustumPlanes::PlanesCount];
+			__m128 offset[FrustumPlanes::PlanesCount];
+
+			for (size_t i = 0; i < FrustumPlanes::PlanesCount; i++)
+			{
+				const Math::Plane& plane = planes.Planes[i];
+				normalX[i] = _mm_set1_ps(plane.Normal.x);
+				normalY[i] = _mm_set1_ps(plane.Normal.y);
+				normalZ[i] = _mm_set1_ps(plane.Normal.z);
+				absNormalX[i] = _mm_set1_ps(glm::abs(plane.Normal.x));
+				absNormalY[i] = _mm_set1_ps(glm::abs(plane.Normal.y));
+				absNormalZ[i] = _mm_set1_ps(glm::abs(plane.Normal.z));
+				offset[i] = _mm_set1_ps(plane.Offset);
+			}
+
+			const __m128 zero = _mm_setzero_ps();
+			for (; index + 4 <= endIndex; index += 4)
+			{
+				__m128 cx = _mm_loadu_ps(centerX + index);
+				__m128 cy = _mm_loadu_ps(centerY + index);
+				__m128 cz = _mm_loadu_ps(centerZ + index);
+				__m128 ex = _mm_loadu_ps(extentX + index);
+				__m128 ey = _mm_loadu_ps(extentY + index);
+				__m128 ez = _mm_loadu_ps(extentZ + index);
+
+				__m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+				for (size_t i = 0; i < FrustumPlanes::PlanesCount; i++)
+				{
+					__m128 distance = _mm_add_ps(
+						_mm_add_ps(_mm_mul_ps(cx, normalX[i]), _mm_mul_ps(cy, normalY[i])),
+						_mm_add_ps(_mm_mul_ps(cz, normalZ[i]), offset[i]));
+
+					__m128 radius = _mm_add_ps(
+						_mm_add_ps(_mm_mul_ps(ex, absNormalX[i]), _mm_mul_ps(ey, absNormalY[i])),
+						_mm_mul_ps(ez, absNormalZ[i]));
+
+					visible = _mm_and_ps(visible, _mm_cmpge_ps(_mm_add_ps(distance, radius), zero));
+				}
+
+				int32_t mask = _mm_movemask_ps(visible);
+				for (uint32_t i = 0; i < 4; i++)
+				{
+					output[visibleCount] = (uint32_t)index + i;
+					visibleCount += (mask >> i) & 1;
+				}
+			}
+		}
+
+		// Remaining objects
+		for (; index < endIndex; index++)
+		{
+			bool visible = true;
+			for (size_t i = 0; i < FrustumPlanes::PlanesCount; i++)
+			{
+				const Math::Plane& plane = planes.Planes[i];
+				float distance = centerX[index] * plane.Normal.x + centerY[index] * plane.Normal.y + centerZ[index] * plane.Normal.z + plane.Offset;
+				float radius = extentX[index] * glm::abs(plane.Normal.x) + extentY[index] * glm::abs(plane.Normal.y) + extentZ[index] * glm::abs(plane.Normal.z);
+
+				visible &= distance + radius >= 0.0f;
+			}
+
+			output[visibleCount] = (uint32_t)index;
+			visibleCount += visible ? 1 : 0;
+		}
+
+		visibleIndices.resize(outputStart + visibleCount);
+	}
+}
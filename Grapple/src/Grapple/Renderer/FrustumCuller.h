@@ -0,0 +1,46 @@
+#pragma once
+
+#include "GrappleCore/Core.h"
+
+#include "Grapple/Math/Math.h"
+#include "Grapple/Math/Transform.h"
+#include "Grapple/Renderer/RenderData.h"
+
+#include <vector>
+
+namespace Grapple
+{
+	// Stores world space bounding boxes as separate arrays of centers and extents,
+	// so that several boxes can be tested against the frustum planes with a single instruction.
+	// Uses 8 wide AVX when compiled with AVX enabled and 4 wide SSE otherwise.
+	class Grapple_API FrustumCuller
+	{
+	public:
+		void Clear();
+		void Reserve(size_t count);
+
+		// Transforms local bounds into world space and stores them at the next index
+		void AddBounds(const Math::AABB& localBounds, const Math::Compact3DTransform& transform);
+
+		// Allows bounds to be filled from multiple threads using `SetBounds`, as long as each index is written by a single thread
+		void Resize(size_t count);
+		void SetBounds(size_t index, const Math::AABB& localBounds, const Math::Compact3DTransform& transform);
+		void SetBounds(size_t index, const Math::AABB& worldBounds);
+
+		// Appends indices of boxes, which intersect or are inside of the frustum
+		void Cull(const FrustumPlanes& planes, std::vector<uint32_t>& visibleIndices) const;
+
+		// Same as `Cull`, but only tests boxes in range [firstIndex, firstIndex + count)
+		void Cull(const FrustumPlanes& planes, size_t firstIndex, size_t count, std::vector<uint32_t>& visibleIndices) const;
+
+		inline size_t GetSize() const { return m_CenterX.size(); }
+	private:
+		std::vector<float> m_CenterX;
+		std::vector<float> m_CenterY;
+		std::vector<float> m_CenterZ;
+
+		std::vector<float> m_ExtentX;
+		std::vector<float> m_ExtentY;
+		std::vector<float> m_ExtentZ;
+	};
+}
@@ -0,0 +1,343 @@
+#include "GeometryPool.h"
+
+#include "GrappleCore/Assert.h"
+#include "GrappleCore/Log.h"
+#include "GrappleCore/Profiler/Profiler.h"
+
+#include "Grapple/Platform/Vulkan/VulkanContext.h"
+#include "Grapple/Platform/Vulkan/VulkanCommandBuffer.h"
+#include "Grapple/Platform/Vulkan/VulkanVertexBuffer.h"
+#include "Grapple/Platform/Vulkan/VulkanIndexBuffer.h"
+
+#include <algorithm>
+
+namespace Grapple
+{
+	static constexpr uint32_t InitialVertexCapacity = 1 << 16;
+	static constexpr uint32_t InitialIndexCapacity = 1 << 18;
+
+	// Number of freed allocations, after which a fragmented heap is packed at the start of the next frame
+	static constexpr uint32_t DefragmentationFreesThreshold = 256;
+
+	static const char* s_VertexStreamNames[GeometryPool::VertexStreamsCount] = { "Positions", "Normals", "Tangents", "UVs" };
+
+	GeometryPool::GeometryPool()
+	{
+		m_Heaps[GetVertexHeapIndex(MeshVertexFormat::Float)].VertexFormat = MeshVertexFormat::Float;
+		m_Heaps[GetVertexHeapIndex(MeshVertexFormat::Compact)].VertexFormat = MeshVertexFormat::Compact;
+
+		Heap& indices16 = m_Heaps[GetIndexHeapIndex(IndexBuffer::IndexFormat::UInt16)];
+		indices16.IsIndexHeap = true;
+		indices16.IndexFormat = IndexBuffer::IndexFormat::UInt16;
+
+		Heap& indices32 = m_Heaps[GetIndexHeapIndex(IndexBuffer::IndexFormat::UInt32)];
+		indices32.IsIndexHeap = true;
+		indices32.IndexFormat = IndexBuffer::IndexFormat::UInt32;
+	}
+
+	GeometryPool::~GeometryPool()
+	{
+	}
+
+	GeometryAllocation GeometryPool::AllocateVertices(MeshVertexFormat format, uint32_t count)
+	{
+		return Allocate(GetVertexHeapIndex(format), count);
+	}
+
+	GeometryAllocation GeometryPool::AllocateIndices(IndexBuffer::IndexFormat format, uint32_t count)
+	{
+		return Allocate(GetIndexHeapIndex(format), count);
+	}
+
+	void GeometryPool::Free(GeometryAllocation allocation)
+	{
+		if (!allocation.IsValid())
+			return;
+
+		Entry& entry = m_Entries[allocation.Id];
+		Grapple_CORE_ASSERT(entry.Size > 0);
+
+		Heap& heap = m_Heaps[entry.HeapIndex];
+		heap.Allocator.Free(entry.Offset, entry.Size);
+		heap.FreesSinceRebuild++;
+
+		entry = {};
+		m_FreeEntries.push_back(allocation.Id);
+	}
+
+	uint32_t GeometryPool::GetOffset(GeometryAllocation allocation) const
+	{
+		if (!allocation.IsValid())
+			return 0;
+
+		return m_Entries[allocation.Id].Offset;
+	}
+
+	void GeometryPool::SetVertexData(GeometryAllocation allocation, uint32_t stream, MemorySpan data, uint32_t offset, Ref<CommandBuffer> commandBuffer)
+	{
+		Grapple_PROFILE_FUNCTION();
+		Grapple_CORE_ASSERT(allocation.IsValid());
+
+		const Entry& entry = m_Entries[allocation.Id];
+		const Heap& heap = m_Heaps[entry.HeapIndex];
+		Grapple_CORE_ASSERT(!heap.IsIndexHeap && stream < VertexStreamsCount);
+
+		size_t elementSize = (size_t)GetElementSize(heap, stream);
+		Grapple_CORE_ASSERT(data.GetSize() <= ((size_t)entry.Size - (size_t)offset) * elementSize);
+
+		heap.VertexBuffers[stream]->SetData(data, ((size_t)entry.Offset + (size_t)offset) * elementSize, commandBuffer);
+	}
+
+	void GeometryPool::SetIndexData(GeometryAllocation allocation, MemorySpan data, uint32_t offset, Ref<CommandBuffer> commandBuffer)
+	{
+		Grapple_PROFILE_FUNCTION();
+		Grapple_CORE_ASSERT(allocation.IsValid());
+
+		const Entry& entry = m_Entries[allocation.Id];
+		const Heap& heap = m_Heaps[entry.HeapIndex];
+		Grapple_CORE_ASSERT(heap.IsIndexHeap);
+
+		size_t elementSize = (size_t)GetElementSize(heap, 0);
+		Grapple_CORE_ASSERT(data.GetSize() <= ((size_t)entry.Size - (size_t)offset) * elementSize);
+
+		heap.Indices->SetData(data, ((size_t)entry.Offset + (size_t)offset) * elementSize, commandBuffer);
+	}
+
+	const Ref<VertexBuffer>& GeometryPool::GetVertexBuffer(MeshVertexFormat format, uint32_t stream) const
+	{
+		Grapple_CORE_ASSERT(stream < VertexStreamsCount);
+		return m_Heaps[GetVertexHeapIndex(format)].VertexBuffers[stream];
+	}
+
+	const Ref<IndexBuffer>& GeometryPool::GetIndexBuffer(IndexBuffer::IndexFormat format) const
+	{
+		return m_Heaps[GetIndexHeapIndex(format)].Indices;
+	}
+
+	void GeometryPool::BeginFrame()
+	{
+		Grapple_PROFILE_FUNCTION();
+		m_FrameIndex++;
+
+		// The command buffers of the previous frames have completed, so buffers replaced during them are no longer referenced
+		m_RetiredBuffers.erase(std::remove_if(m_RetiredBuffers.begin(), m_RetiredBuffers.end(), [this](const RetiredBuffers& buffers) -> bool
+		{
+			return buffers.FrameIndex < m_FrameIndex;
+		}), m_RetiredBuffers.end());
+
+		Defragment();
+	}
+
+	void GeometryPool::Defragment()
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		for (uint32_t heapIndex = 0; heapIndex < HeapsCount; heapIndex++)
+		{
+			const Heap& heap = m_Heaps[heapIndex];
+			if (heap.FreesSinceRebuild >= DefragmentationFreesThreshold && heap.Allocator.GetFreeRangesCount() > 1)
+				Rebuild(heapIndex, heap.Allocator.GetCapacity());
+		}
+	}
+
+	uint32_t GeometryPool::GetVertexStride(MeshVertexFormat format, uint32_t stream)
+	{
+		Grapple_CORE_ASSERT(stream < VertexStreamsCount);
+
+		// Positions, normals, tangents and UVs
+		static constexpr uint32_t floatStrides[VertexStreamsCount] = { 12, 12, 12, 8 };
+		static constexpr uint32_t compactStrides[VertexStreamsCount] = { 8, 4, 4, 4 };
+
+		return format == MeshVertexFormat::Compact ? compactStrides[stream] : floatStrides[stream];
+	}
+
+	GeometryAllocation GeometryPool::Allocate(uint32_t heapIndex, uint32_t count)
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		if (count == 0)
+			return {};
+
+		Heap& heap = m_Heaps[heapIndex];
+		uint32_t offset = heap.Allocator.Allocate(count);
+
+		if (offset == RangeAllocator::InvalidOffset)
+		{
+			// Packing the allocations might be enough, otherwise the capacity is doubled until the allocation fits
+			uint32_t capacity = heap.Allocator.GetCapacity();
+			uint32_t usedSize = capacity - heap.Allocator.GetFreeSize();
+
+			uint32_t newCapacity = std::max(capacity, heap.IsIndexHeap ? InitialIndexCapacity : InitialVertexCapacity);
+			while (newCapacity - usedSize < count)
+				newCapacity *= 2;
+
+			Rebuild(heapIndex, newCapacity);
+
+			offset = heap.Allocator.Allocate(count);
+			Grapple_CORE_ASSERT(offset != RangeAllocator::InvalidOffset);
+		}
+
+		GeometryAllocation allocation{};
+		if (m_FreeEntries.size() > 0)
+		{
+			allocation.Id = m_FreeEntries.back();
+			m_FreeEntries.pop_back();
+		}
+		else
+		{
+			allocation.Id = (uint32_t)m_Entries.size();
+			m_Entries.emplace_back();
+		}
+
+		Entry& entry = m_Entries[allocation.Id];
+		entry.Offset = offset;
+		entry.Size = count;
+		entry.HeapIndex = heapIndex;
+
+		return allocation;
+	}
+
+	void GeometryPool::Rebuild(uint32_t heapIndex, uint32_t capacity)
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		Heap& heap = m_Heaps[heapIndex];
+		uint32_t streamsCount = GetStreamsCount(heap);
+
+		std::vector<uint32_t> liveEntries;
+		for (uint32_t entryIndex = 0; entryIndex < (uint32_t)m_Entries.size(); entryIndex++)
+		{
+			if (m_Entries[entryIndex].Size > 0 && m_Entries[entryIndex].HeapIndex == heapIndex)
+				liveEntries.push_back(entryIndex);
+		}
+
+		std::sort(liveEntries.begin(), liveEntries.end(), [this](uint32_t a, uint32_t b) -> bool
+		{
+			return m_Entries[a].Offset < m_Entries[b].Offset;
+		});
+
+		VulkanBuffer* oldBuffers[VertexStreamsCount] = {};
+		VulkanBuffer* newBuffers[VertexStreamsCount] = {};
+
+		Ref<VertexBuffer> newVertexBuffers[VertexStreamsCount] = {};
+		Ref<IndexBuffer> newIndices = nullptr;
+
+		if (heap.IsIndexHeap)
+		{
+			newIndices = IndexBuffer::Create(heap.IndexFormat, (size_t)capacity, GPUBufferUsage::Static);
+			newIndices->SetDebugName(heap.IndexFormat == IndexBuffer::IndexFormat::UInt16 ? "GeometryPool.Indices16" : "GeometryPool.Indices32");
+
+			newBuffers[0] = &As<VulkanIndexBuffer>(newIndices)->GetBuffer();
+			if (heap.Indices)
+				oldBuffers[0] = &As<VulkanIndexBuffer>(heap.Indices)->GetBuffer();
+		}
+		else
+		{
+			const char* formatName = heap.VertexFormat == MeshVertexFormat::Compact ? "Compact" : "Float";
+			for (uint32_t stream = 0; stream < streamsCount; stream++)
+			{
+				newVertexBuffers[stream] = VertexBuffer::Create((size_t)capacity * (size_t)GetElementSize(heap, stream), GPUBufferUsage::Static);
+				newVertexBuffers[stream]->SetDebugName(fmt::format("GeometryPool.{}.{}", formatName, s_VertexStreamNames[stream]));
+
+				newBuffers[stream] = &As<VulkanVertexBuffer>(newVertexBuffers[stream])->GetBuffer();
+				if (heap.VertexBuffers[stream])
+					oldBuffers[stream] = &As<VulkanVertexBuffer>(heap.VertexBuffers[stream])->GetBuffer();
+			}
+		}
+
+		uint32_t packedSize = 0;
+		for (uint32_t entryIndex : liveEntries)
+			packedSize += m_Entries[entryIndex].Size;
+
+		Grapple_CORE_ASSERT(packedSize <= capacity);
+
+		if (oldBuffers[0] != nullptr)
+		{
+			// Old buffers are only read by the copy, so it doesn't have to wait for the frames, which use them
+			Ref<VulkanCommandBuffer> commandBuffer = VulkanContext::GetInstance().BeginTemporaryCommandBuffer();
+
+			for (uint32_t stream = 0; stream < streamsCount; stream++)
+			{
+				size_t elementSize = (size_t)GetElementSize(heap, stream);
+
+				oldBuffers[stream]->EnsureAllocated();
+				newBuffers[stream]->EnsureAllocated();
+
+				uint32_t destinationOffset = 0;
+				for (uint32_t entryIndex : liveEntries)
+				{
+					const Entry& entry = m_Entries[entryIndex];
+					commandBuffer->CopyBuffer(oldBuffers[stream]->GetBuffer(),
+						newBuffers[stream]->GetBuffer(),
+						(size_t)entry.Size * elementSize,
+						(size_t)entry.Offset * elementSize,
+						(size_t)destinationOffset * elementSize);
+
+					destinationOffset += entry.Size;
+				}
+
+				VkBufferMemoryBarrier barrier{};
+				barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+				barrier.buffer = newBuffers[stream]->GetBuffer();
+				barrier.offset = 0;
+				barrier.size = VK_WHOLE_SIZE;
+				barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+				barrier.dstAccessMask = heap.IsIndexHeap ? VK_ACCESS_INDEX_READ_BIT : VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+				barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+
+				commandBuffer->AddBufferBarrier(Span(&barrier, 1), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT);
+			}
+
+			VulkanContext::GetInstance().EndTemporaryCommandBuffer(commandBuffer);
+		}
+
+		uint32_t offset = 0;
+		for (uint32_t entryIndex : liveEntries)
+		{
+			m_Entries[entryIndex].Offset = offset;
+			offset += m_Entries[entryIndex].Size;
+		}
+
+		Grapple_CORE_INFO("GeometryPool: Rebuilt heap {} with capacity {} -> {}, used {}", heapIndex, heap.Allocator.GetCapacity(), capacity, packedSize);
+
+		if (oldBuffers[0] != nullptr)
+		{
+			// Draws recorded earlier in the current frame may still use the old buffers
+			RetiredBuffers& retired = m_RetiredBuffers.emplace_back();
+			retired.Indices = heap.Indices;
+			retired.FrameIndex = m_FrameIndex;
+			for (uint32_t stream = 0; stream < VertexStreamsCount; stream++)
+				retired.VertexBuffers[stream] = heap.VertexBuffers[stream];
+		}
+
+		heap.Allocator.Reset(capacity, packedSize);
+		heap.FreesSinceRebuild = 0;
+		heap.Indices = newIndices;
+		for (uint32_t stream = 0; stream < VertexStreamsCount; stream++)
+			heap.VertexBuffers[stream] = newVertexBuffers[stream];
+	}
+
+	uint32_t GeometryPool::GetElementSize(const Heap& heap, uint32_t stream) const
+	{
+		if (heap.IsIndexHeap)
+			return (uint32_t)IndexBuffer::GetIndexFormatSize(heap.IndexFormat);
+
+		return GetVertexStride(heap.VertexFormat, stream);
+	}
+
+	uint32_t GeometryPool::GetStreamsCount(const Heap& heap) const
+	{
+		return heap.IsIndexHeap ? 1 : VertexStreamsCount;
+	}
+
+	uint32_t GeometryPool::GetVertexHeapIndex(MeshVertexFormat format)
+	{
+		return format == MeshVertexFormat::Compact ? 1 : 0;
+	}
+
+	uint32_t GeometryPool::GetIndexHeapIndex(IndexBuffer::IndexFormat format)
+	{
+		return format == IndexBuffer::IndexFormat::UInt16 ? 2 : 3;
+	}
+}
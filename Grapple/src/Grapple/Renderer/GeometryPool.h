@@ -0,0 +1,120 @@
+#pragma once
+
+#include "GrappleCore/Core.h"
+
+#include "Grapple/Renderer/Buffer.h"
+#include "Grapple/Renderer/RangeAllocator.h"
+
+#include <vector>
+
+namespace Grapple
+{
+	class CommandBuffer;
+
+	struct GeometryAllocation
+	{
+		inline bool IsValid() const { return Id != UINT32_MAX; }
+
+		uint32_t Id = UINT32_MAX;
+	};
+
+	// Sub allocates vertices and indices of all meshes from a few large buffers.
+	//
+	// Vertices of each MeshVertexFormat are stored in a heap of four vertex buffers (positions, normals, tangents and UVs),
+	// which share vertex offsets, and indices of each index format are stored in a heap with a single index buffer.
+	// Meshes with the same formats are drawn without rebinding buffers, by offsetting their first index and vertex.
+	//
+	// When a heap runs out of space, it is rebuilt with all allocations packed at the start of new buffers, which also removes
+	// the fragmentation. Offsets of allocations can change between frames, so they should be queried when recording draws.
+	// Replaced buffers are kept alive until the frame, during which they were replaced, has finished executing,
+	// because draws recorded earlier in that frame still reference them.
+	class Grapple_API GeometryPool
+	{
+	public:
+		static constexpr uint32_t VertexStreamsCount = 4;
+
+		GeometryPool();
+		~GeometryPool();
+
+		// Returns an invalid allocation for empty ranges
+		GeometryAllocation AllocateVertices(MeshVertexFormat format, uint32_t count);
+		GeometryAllocation AllocateIndices(IndexBuffer::IndexFormat format, uint32_t count);
+		void Free(GeometryAllocation allocation);
+
+		// Returns the offset of the allocation in vertices or indices
+		uint32_t GetOffset(GeometryAllocation allocation) const;
+
+		// `offset` is in vertices or indices relative to the start of the allocation
+		void SetVertexData(GeometryAllocation allocation, uint32_t stream, MemorySpan data, uint32_t offset, Ref<CommandBuffer> commandBuffer);
+		void SetIndexData(GeometryAllocation allocation, MemorySpan data, uint32_t offset, Ref<CommandBuffer> commandBuffer);
+
+		const Ref<VertexBuffer>& GetVertexBuffer(MeshVertexFormat format, uint32_t stream) const;
+		const Ref<IndexBuffer>& GetIndexBuffer(IndexBuffer::IndexFormat format) const;
+
+		// Must be called at the start of a frame, once the previous frame has finished executing on the GPU.
+		// Releases buffers replaced during the previous frames and defragments the heaps
+		void BeginFrame();
+
+		// Packs allocations of heaps, which had many allocations freed since they were last rebuilt
+		// and whose free space is split into several ranges
+		void Defragment();
+
+		static uint32_t GetVertexStride(MeshVertexFormat format, uint32_t stream);
+	private:
+		struct Heap
+		{
+			RangeAllocator Allocator;
+
+			// Either all vertex buffers or the index buffer are used
+			Ref<VertexBuffer> VertexBuffers[VertexStreamsCount] = {};
+			Ref<IndexBuffer> Indices = nullptr;
+
+			bool IsIndexHeap = false;
+			MeshVertexFormat VertexFormat = MeshVertexFormat::Float;
+			IndexBuffer::IndexFormat IndexFormat = IndexBuffer::IndexFormat::UInt32;
+
+			// Number of freed allocations since the heap was last rebuilt
+			uint32_t FreesSinceRebuild = 0;
+		};
+
+		// Buffers of a heap, which were replaced by a rebuild
+		struct RetiredBuffers
+		{
+			Ref<VertexBuffer> VertexBuffers[VertexStreamsCount] = {};
+			Ref<IndexBuffer> Indices = nullptr;
+
+			// Frame during which the buffers were replaced
+			uint64_t FrameIndex = 0;
+		};
+
+		struct Entry
+		{
+			uint32_t Offset = 0;
+
+			// Entries with the size of 0 are free
+			uint32_t Size = 0;
+			uint32_t HeapIndex = 0;
+		};
+
+		GeometryAllocation Allocate(uint32_t heapIndex, uint32_t count);
+
+		// Moves all allocations of the heap to the start of new buffers with the given capacity
+		void Rebuild(uint32_t heapIndex, uint32_t capacity);
+
+		uint32_t GetElementSize(const Heap& heap, uint32_t stream) const;
+		uint32_t GetStreamsCount(const Heap& heap) const;
+
+		static uint32_t GetVertexHeapIndex(MeshVertexFormat format);
+		static uint32_t GetIndexHeapIndex(IndexBuffer::IndexFormat format);
+	private:
+		static constexpr uint32_t HeapsCount = 4;
+
+		Heap m_Heaps[HeapsCount];
+
+		std::vector<Entry> m_Entries;
+		std::vector<uint32_t> m_FreeEntries;
+
+		std::vector<RetiredBuffers> m_RetiredBuffers;
+		uint64_t m_FrameIndex = 0;
+	};
+}
@@ -7,6 +7,21 @@
 
 namespace Grapple
 {
+	// Optional features, which depend on the device the context was created for
+	struct GraphicsContextFeatures
+	{
+		// Multiple indirect draws can be issued with a single call and use non-zero base instance.
+		// Disabled with the `--no-indirect-draws` command line argument
+		bool MultiDrawIndirect = false;
+
+		// Sampled images can be non-uniformly indexed from a large, partially bound array,
+		// whose descriptors can be written after the array was bound
+		bool BindlessTextures = false;
+
+		// Max number of textures in a single bindless texture array
+		uint32_t MaxBindlessTextures = 0;
+	};
+
 	class Grapple_API GraphicsContext
 	{
 	public:
@@ -19,6 +34,8 @@ namespace Grapple
 
 		virtual void WaitForDevice() = 0;
 		virtual Ref<CommandBuffer> GetCommandBuffer() const = 0;
+
+		virtual const GraphicsContextFeatures& GetFeatures() const = 0;
 	public:
 		static GraphicsContext& GetInstance();
 		static bool IsInitialized();
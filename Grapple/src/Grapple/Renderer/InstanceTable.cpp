@@ -0,0 +1,133 @@
+#include "InstanceTable.h"
+
+#include "GrappleCore/Assert.h"
+#include "GrappleCore/Profiler/Profiler.h"
+
+#include "Grapple/Renderer/ShaderStorageBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Grapple
+{
+	// Clean slots between two dirty ones are uploaded as well if the gap is smaller than this,
+	// because each upload also records a pair of buffer barriers
+	static constexpr uint32_t MaxCoalescedGap = 8;
+	static constexpr size_t MinBufferCapacity = 16;
+
+	uint32_t InstanceTable::AllocateSlot()
+	{
+		uint32_t slot = 0;
+		if (m_FreeSlots.size() > 0)
+		{
+			slot = m_FreeSlots.back();
+			m_FreeSlots.pop_back();
+		}
+		else
+		{
+			slot = (uint32_t)m_Instances.size();
+			m_Instances.emplace_back();
+			m_IsSlotDirty.push_back(false);
+			m_SlotAllocationIds.push_back(0);
+		}
+
+		m_SlotAllocationIds[slot] = m_NextAllocationId++;
+		return slot;
+	}
+
+	void InstanceTable::ReleaseSlot(uint32_t slot)
+	{
+		Grapple_CORE_ASSERT(slot < m_Instances.size());
+		m_FreeSlots.push_back(slot);
+	}
+
+	void InstanceTable::SetTransform(uint32_t slot, const Math::Compact3DTransform& transform)
+	{
+		Grapple_CORE_ASSERT(slot < m_Instances.size());
+
+		InstanceData data;
+		data.PackedTransform[0] = glm::vec4(transform.RotationScale[0], transform.Translation.x);
+		data.PackedTransform[1] = glm::vec4(transform.RotationScale[1], transform.Translation.y);
+		data.PackedTransform[2] = glm::vec4(transform.RotationScale[2], transform.Translation.z);
+
+		// The CPU copy always matches the GPU buffer, unless the slot is already marked as dirty
+		InstanceData& stored = m_Instances[slot];
+		if (std::memcmp(&stored, &data, sizeof(InstanceData)) == 0)
+			return;
+
+		stored = data;
+		MarkDirty(slot);
+	}
+
+	void InstanceTable::Clear()
+	{
+		m_Instances.clear();
+		m_FreeSlots.clear();
+		m_DirtySlots.clear();
+		m_IsSlotDirty.clear();
+		m_SlotAllocationIds.clear();
+	}
+
+	void InstanceTable::FlushUploads(const Ref<CommandBuffer>& commandBuffer)
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		size_t requiredSize = std::max(m_Instances.size(), MinBufferCapacity) * sizeof(InstanceData);
+		if (m_Buffer == nullptr)
+		{
+			m_Buffer = ShaderStorageBuffer::Create(requiredSize);
+			m_Buffer->SetDebugName("InstanceTable");
+			m_BufferVersion++;
+		}
+		else if (requiredSize > m_Buffer->GetSize())
+		{
+			// Contents are lost when resizing, so the whole table has to be uploaded
+			m_Buffer->Resize(std::max(requiredSize, m_Buffer->GetSize() * 2));
+			m_BufferVersion++;
+
+			m_DirtySlots.clear();
+			for (uint32_t slot = 0; slot < (uint32_t)m_Instances.size(); slot++)
+			{
+				m_IsSlotDirty[slot] = true;
+				m_DirtySlots.push_back(slot);
+			}
+		}
+
+		if (m_DirtySlots.size() == 0)
+			return;
+
+		std::sort(m_DirtySlots.begin(), m_DirtySlots.end());
+
+		size_t rangeStart = 0;
+		while (rangeStart < m_DirtySlots.size())
+		{
+			size_t rangeEnd = rangeStart + 1;
+			while (rangeEnd < m_DirtySlots.size() && m_DirtySlots[rangeEnd] - m_DirtySlots[rangeEnd - 1] <= MaxCoalescedGap)
+				rangeEnd++;
+
+			uint32_t firstSlot = m_DirtySlots[rangeStart];
+			uint32_t lastSlot = m_DirtySlots[rangeEnd - 1];
+
+			m_Buffer->SetData(
+				MemorySpan(m_Instances.data() + firstSlot, (size_t)(lastSlot - firstSlot + 1)),
+				(size_t)firstSlot * sizeof(InstanceData),
+				commandBuffer);
+
+			rangeStart = rangeEnd;
+		}
+
+		for (uint32_t slot : m_DirtySlots)
+			m_IsSlotDirty[slot] = false;
+
+		m_DirtySlots.clear();
+	}
+
+	void InstanceTable::MarkDirty(uint32_t slot)
+	{
+		if (m_IsSlotDirty[slot])
+			return;
+
+		m_IsSlotDirty[slot] = true;
+		m_DirtySlots.push_back(slot);
+	}
+}
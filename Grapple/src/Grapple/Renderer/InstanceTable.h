@@ -0,0 +1,67 @@
+#pragma once
+
+#include "GrappleCore/Core.h"
+
+#include "Grapple/Math/Transform.h"
+
+#include <glm/glm.hpp>
+
+#include <stdint.h>
+#include <vector>
+
+namespace Grapple
+{
+	class CommandBuffer;
+	class ShaderStorageBuffer;
+
+	// GPU resident table of instance transforms, in which each renderable owns a stable slot.
+	//
+	// Keeps a CPU copy of the table, so that only slots whose transform has changed are uploaded.
+	// Dirty slots are uploaded as coalesced ranges by `FlushUploads`, which must be called before
+	// any pass reads the table. Passes index into the table through per pass lists of slots.
+	class Grapple_API InstanceTable
+	{
+	public:
+		struct InstanceData
+		{
+			glm::vec4 PackedTransform[3];
+		};
+
+		static constexpr uint32_t InvalidSlot = UINT32_MAX;
+
+		uint32_t AllocateSlot();
+		void ReleaseSlot(uint32_t slot);
+
+		// Marks the slot as dirty only if the transform is different from the stored one
+		void SetTransform(uint32_t slot, const Math::Compact3DTransform& transform);
+
+		void Clear();
+
+		// Uploads all dirty slots. Recreates the GPU buffer in case the table has grown, which changes the buffer version
+		void FlushUploads(const Ref<CommandBuffer>& commandBuffer);
+
+		inline const Ref<ShaderStorageBuffer>& GetBuffer() const { return m_Buffer; }
+
+		// Changes every time the GPU buffer is recreated, so that passes know when to update their descriptor sets
+		inline uint32_t GetBufferVersion() const { return m_BufferVersion; }
+
+		inline size_t GetSlotsCount() const { return m_Instances.size(); }
+
+		// Unique for every allocation of a slot, so that per slot data kept by passes can be discarded once the slot is reused
+		inline uint64_t GetSlotAllocationId(uint32_t slot) const { return m_SlotAllocationIds[slot]; }
+		inline size_t GetDirtySlotsCount() const { return m_DirtySlots.size(); }
+	private:
+		void MarkDirty(uint32_t slot);
+	private:
+		std::vector<InstanceData> m_Instances;
+		std::vector<uint32_t> m_FreeSlots;
+		std::vector<uint64_t> m_SlotAllocationIds;
+		uint64_t m_NextAllocationId = 1;
+
+		std::vector<uint32_t> m_DirtySlots;
+		std::vector<bool> m_IsSlotDirty;
+
+		Ref<ShaderStorageBuffer> m_Buffer = nullptr;
+		uint32_t m_BufferVersion = 0;
+	};
+}
@@ -6,7 +6,7 @@
 #include "Grapple/Renderer/Texture.h"
 #include "Grapple/Renderer/RendererAPI.h"
 #include "Grapple/Renderer/Renderer.h"
-#include "Grapple/Renderer/Texture.h"
+#include "Grapple/Renderer/MaterialDataTable.h"
 
 #include "Grapple/Platform/Vulkan/VulkanMaterial.h"
 
@@ -99,15 +99,66 @@ namespace Grapple
 		}
 
 		m_Textures.resize(samplers, nullptr);
+		UpdateTexturesSortKey();
+
 		m_ConstantBuffer.SetShader(m_Shader);
+
+		m_DataTable = m_Shader->GetMaterialDataTable();
+		if (m_DataTable)
+			m_DataTableSlot = m_DataTable->AllocateSlot(m_ConstantBuffer);
+	}
+
+	void Material::ReleaseDataTableSlot()
+	{
+		if (m_DataTable)
+			m_DataTable->ReleaseSlot(m_DataTableSlot);
+
+		m_DataTable = nullptr;
+		m_DataTableSlot = UINT32_MAX;
 	}
 
 	Material::~Material()
 	{
+		ReleaseDataTableSlot();
+	}
+
+	void Material::MarkPropertiesDirty()
+	{
+		if (m_DataTable)
+			m_DataTable->MarkDirty(m_DataTableSlot);
+	}
+
+	bool Material::CanShareBatch(const Material* a, const Material* b)
+	{
+		if (a == b)
+			return true;
+
+		if (a == nullptr || b == nullptr || a->m_Shader.get() != b->m_Shader.get())
+			return false;
+
+		if (!a->UsesDataTable() || !b->UsesDataTable())
+			return false;
+
+		// Textures are bound through the descriptor set of the batch's first material
+		return a->m_Textures == b->m_Textures;
+	}
+
+	void Material::UpdateTexturesSortKey()
+	{
+		size_t hash = 0;
+		for (const Ref<Texture>& texture : m_Textures)
+		{
+			AssetHandle handle = texture != nullptr ? texture->Handle : NULL_ASSET_HANDLE;
+			hash = hash * 31 + std::hash<AssetHandle>()(handle);
+		}
+
+		uint64_t hash64 = (uint64_t)hash;
+		m_TexturesSortKey = (uint16_t)(hash64 ^ (hash64 >> 16) ^ (hash64 >> 32) ^ (hash64 >> 48));
 	}
 
 	void Material::SetShader(const Ref<Shader>& shader)
 	{
+		ReleaseDataTableSlot();
 		m_Textures.clear();
 		m_Shader = shader;
 		Initialize();
@@ -140,5 +191,7 @@ namespace Grapple
 
 		m_Textures[properties[propertyIndex].SamplerIndex] = texture;
 		m_IsDirty = true;
+
+		UpdateTexturesSortKey();
 	}
 }
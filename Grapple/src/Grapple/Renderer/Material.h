@@ -7,11 +7,13 @@
 #include "Grapple/Renderer/RendererAPI.h"
 #include "Grapple/Renderer/ShaderMetadata.h"
 #include "Grapple/Renderer/ShaderConstantBuffer.h"
+#include "Grapple/Renderer/SortId.h"
 
 namespace Grapple
 {
 	class Texture;
 	class FrameBuffer;
+	class MaterialDataTable;
 	class Grapple_API Material : public Asset
 	{
 	public:
@@ -26,9 +28,11 @@ namespace Grapple
 		inline Ref<Shader> GetShader() const { return m_Shader; }
 		virtual void SetShader(const Ref<Shader>& shader);
 
+		// The returned reference can be written to, so the properties are marked as changed
 		template<typename T>
 		T& GetPropertyValue(uint32_t index)
 		{
+			MarkPropertiesDirty();
 			return m_ConstantBuffer.GetProperty<T>(index);
 		}
 
@@ -42,28 +46,68 @@ namespace Grapple
 		void WritePropertyValue(uint32_t index, const T& value)
 		{
 			m_ConstantBuffer.SetProperty<T>(index, value);
+			MarkPropertiesDirty();
 		}
 
 		const Ref<Texture>& GetTextureProperty(uint32_t propertyIndex) const;
 		void SetTextureProperty(uint32_t propertyIndex, Ref<Texture> texture);
 
-		inline uint8_t* GetPropertiesBuffer() { return m_ConstantBuffer.GetBuffer(); }
+		inline uint8_t* GetPropertiesBuffer()
+		{
+			MarkPropertiesDirty();
+			return m_ConstantBuffer.GetBuffer();
+		}
+
 		inline const uint8_t* GetPropertiesBuffer() const { return m_ConstantBuffer.GetBuffer(); }
 
-		inline ShaderConstantBuffer& GetConstantBuffer() { return m_ConstantBuffer; }
+		inline ShaderConstantBuffer& GetConstantBuffer()
+		{
+			MarkPropertiesDirty();
+			return m_ConstantBuffer;
+		}
+
 		inline const ShaderConstantBuffer& GetConstantBuffer() const { return m_ConstantBuffer; }
+
+		// Schedules an upload of the properties to the shader's MaterialDataTable
+		void MarkPropertiesDirty();
+
+		// Slot of the material's properties in the shader's MaterialDataTable
+		inline uint32_t GetDataTableSlot() const { return m_DataTableSlot; }
+		inline const Ref<MaterialDataTable>& GetDataTable() const { return m_DataTable; }
+
+		// Materials, whose properties are stored in the MaterialDataTable, bind the same resources
+		// as other such materials of the same shader, which have the same textures
+		inline bool UsesDataTable() const { return m_DataTable != nullptr; }
+
+		// Derived from the handles of the bound textures, so that materials with the same textures are sorted together.
+		// Different texture sets can have the same key, which only affects the grouping of draws
+		inline uint16_t GetTexturesSortKey() const { return m_TexturesSortKey; }
+
+		inline uint16_t GetSortId() const { return m_SortId.GetValue(); }
+
+		// Instances using materials with the same shader and textures, whose properties are stored in the MaterialDataTable,
+		// can be drawn in a single batch, because each reads its own properties
+		static bool CanShareBatch(const Material* a, const Material* b);
 	public:
 		static Ref<Material> Create();
 		static Ref<Material> Create(Ref<Shader> shader);
 		static Ref<Material> Create(AssetHandle shaderHandle);
 	private:
 		void Initialize();
+		void ReleaseDataTableSlot();
+		void UpdateTexturesSortKey();
 	protected:
 		Ref<Shader> m_Shader;
 
 		ShaderConstantBuffer m_ConstantBuffer;
 		std::vector<Ref<Texture>> m_Textures;
 
+		Ref<MaterialDataTable> m_DataTable = nullptr;
+		uint32_t m_DataTableSlot = UINT32_MAX;
+		uint16_t m_TexturesSortKey = 0;
+
 		bool m_IsDirty = false;
+	private:
+		SortId m_SortId = SortId(SortIdType::Material);
 	};
 }
\ No newline at end of file
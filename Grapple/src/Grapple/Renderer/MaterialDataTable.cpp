@@ -0,0 +1,127 @@
+#include "MaterialDataTable.h"
+
+#include "GrappleCore/Assert.h"
+#include "GrappleCore/Profiler/Profiler.h"
+
+#include "Grapple/Renderer/ShaderStorageBuffer.h"
+#include "Grapple/Renderer/ShaderConstantBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Grapple
+{
+	// Clean slots between two dirty ones are uploaded as well if the gap is smaller than this,
+	// because each upload also records a pair of buffer barriers
+	static constexpr uint32_t MaxCoalescedGap = 8;
+	static constexpr size_t MinSlotsCapacity = 16;
+
+	MaterialDataTable::MaterialDataTable(size_t stride, std::string_view debugName)
+		: m_Stride(stride)
+	{
+		Grapple_CORE_ASSERT(stride > 0);
+
+		// The buffer is created up front, so that material descriptor sets can reference it before the first upload
+		m_Buffer = ShaderStorageBuffer::Create(MinSlotsCapacity * m_Stride);
+		m_Buffer->SetDebugName(debugName);
+		m_BufferVersion++;
+	}
+
+	uint32_t MaterialDataTable::AllocateSlot(const ShaderConstantBuffer& constantBuffer)
+	{
+		uint32_t slot = 0;
+		if (m_FreeSlots.size() > 0)
+		{
+			slot = m_FreeSlots.back();
+			m_FreeSlots.pop_back();
+		}
+		else
+		{
+			slot = (uint32_t)m_Sources.size();
+			m_Sources.emplace_back();
+			m_IsSlotDirty.push_back(false);
+			m_Data.resize(m_Data.size() + m_Stride, 0);
+		}
+
+		m_Sources[slot] = &constantBuffer;
+		MarkDirty(slot);
+		return slot;
+	}
+
+	void MaterialDataTable::ReleaseSlot(uint32_t slot)
+	{
+		Grapple_CORE_ASSERT(slot < m_Sources.size());
+		m_Sources[slot] = nullptr;
+		m_FreeSlots.push_back(slot);
+	}
+
+	void MaterialDataTable::MarkDirty(uint32_t slot)
+	{
+		Grapple_CORE_ASSERT(slot < m_Sources.size());
+		if (m_IsSlotDirty[slot])
+			return;
+
+		m_IsSlotDirty[slot] = true;
+		m_DirtySlots.push_back(slot);
+	}
+
+	void MaterialDataTable::FlushUploads(const Ref<CommandBuffer>& commandBuffer)
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		size_t requiredSize = std::max(m_Sources.size(), MinSlotsCapacity) * m_Stride;
+		if (requiredSize > m_Buffer->GetSize())
+		{
+			// Contents are lost when resizing, so the whole table has to be uploaded
+			m_Buffer->Resize(std::max(requiredSize, m_Buffer->GetSize() * 2));
+			m_BufferVersion++;
+
+			for (uint32_t slot = 0; slot < (uint32_t)m_Sources.size(); slot++)
+				MarkDirty(slot);
+		}
+
+		if (m_DirtySlots.size() == 0)
+			return;
+
+		std::sort(m_DirtySlots.begin(), m_DirtySlots.end());
+
+		// Materials write their properties into their own constant buffers, which are only read here
+		for (uint32_t slot : m_DirtySlots)
+		{
+			const ShaderConstantBuffer* source = m_Sources[slot];
+			uint8_t* destination = m_Data.data() + (size_t)slot * m_Stride;
+			if (source == nullptr || source->GetBuffer() == nullptr)
+			{
+				std::memset(destination, 0, m_Stride);
+				continue;
+			}
+
+			size_t size = std::min(source->GetBufferSize(), m_Stride);
+			std::memcpy(destination, source->GetBuffer(), size);
+			std::memset(destination + size, 0, m_Stride - size);
+		}
+
+		size_t rangeStart = 0;
+		while (rangeStart < m_DirtySlots.size())
+		{
+			size_t rangeEnd = rangeStart + 1;
+			while (rangeEnd < m_DirtySlots.size() && m_DirtySlots[rangeEnd] - m_DirtySlots[rangeEnd - 1] <= MaxCoalescedGap)
+				rangeEnd++;
+
+			uint32_t firstSlot = m_DirtySlots[rangeStart];
+			uint32_t lastSlot = m_DirtySlots[rangeEnd - 1];
+
+			m_Buffer->SetData(
+				MemorySpan(m_Data.data() + (size_t)firstSlot * m_Stride, (size_t)(lastSlot - firstSlot + 1) * m_Stride),
+				(size_t)firstSlot * m_Stride,
+				commandBuffer);
+
+			rangeStart = rangeEnd;
+		}
+
+		for (uint32_t slot : m_DirtySlots)
+			m_IsSlotDirty[slot] = false;
+
+		m_DirtySlots.clear();
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "GrappleCore/Core.h"
+
+#include <stdint.h>
+#include <string_view>
+#include <vector>
+
+namespace Grapple
+{
+	class CommandBuffer;
+	class ShaderConstantBuffer;
+	class ShaderStorageBuffer;
+
+	// GPU resident table of material properties of a single shader, in which each material owns a slot.
+	//
+	// Slots reference the constant buffers of their materials, which are only copied into the table
+	// when the slot is marked as dirty. Shaders index into the table through per instance material indices,
+	// so switching between materials of the same shader doesn't require pushing their properties.
+	class Grapple_API MaterialDataTable
+	{
+	public:
+		static constexpr uint32_t InvalidSlot = UINT32_MAX;
+
+		MaterialDataTable(size_t stride, std::string_view debugName);
+
+		// The constant buffer must outlive the slot
+		uint32_t AllocateSlot(const ShaderConstantBuffer& constantBuffer);
+		void ReleaseSlot(uint32_t slot);
+
+		void MarkDirty(uint32_t slot);
+
+		// Uploads all dirty slots. Recreates the GPU buffer in case the table has grown, which changes the buffer version
+		void FlushUploads(const Ref<CommandBuffer>& commandBuffer);
+
+		inline const Ref<ShaderStorageBuffer>& GetBuffer() const { return m_Buffer; }
+
+		// Changes every time the GPU buffer is recreated, so that materials know when to update their descriptor sets
+		inline uint32_t GetBufferVersion() const { return m_BufferVersion; }
+
+		inline size_t GetStride() const { return m_Stride; }
+		inline size_t GetSlotsCount() const { return m_Sources.size(); }
+		inline size_t GetDirtySlotsCount() const { return m_DirtySlots.size(); }
+	private:
+		size_t m_Stride = 0;
+
+		std::vector<const ShaderConstantBuffer*> m_Sources;
+		std::vector<uint32_t> m_FreeSlots;
+
+		std::vector<uint32_t> m_DirtySlots;
+		std::vector<bool> m_IsSlotDirty;
+
+		// Copy of the uploaded data, so that dirty slots can be uploaded as coalesced ranges
+		std::vector<uint8_t> m_Data;
+
+		Ref<ShaderStorageBuffer> m_Buffer = nullptr;
+		uint32_t m_BufferVersion = 0;
+	};
+}
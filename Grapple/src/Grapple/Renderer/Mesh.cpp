@@ -3,21 +3,48 @@
 #include "GrappleCore/Profiler/Profiler.h"
 
 #include "Grapple/Renderer/RendererAPI.h"
+#include "Grapple/Renderer/Renderer.h"
 #include "Grapple/Renderer/GraphicsContext.h"
 
 #include "Grapple/Platform/Vulkan/VulkanContext.h"
 
+#include <glm/gtc/packing.hpp>
+#include <glm/gtc/type_precision.hpp>
+
 namespace Grapple
 {
 	Grapple_SERIALIZABLE_IMPL(Mesh);
 	Grapple_IMPL_ASSET(Mesh);
 
+	// Projects the direction onto an octahedron and unfolds it onto a square, decoded by `DecodeOctahedral` in Common/VertexFormat.glsl
+	static glm::vec2 EncodeOctahedral(glm::vec3 direction)
+	{
+		float length = glm::abs(direction.x) + glm::abs(direction.y) + glm::abs(direction.z);
+		if (length == 0.0f)
+			return glm::vec2(0.0f);
+
+		direction /= length;
+
+		glm::vec2 encoded = glm::vec2(direction.x, direction.y);
+		if (direction.z < 0.0f)
+		{
+			encoded = (1.0f - glm::abs(glm::vec2(direction.y, direction.x)))
+				* glm::vec2(direction.x >= 0.0f ? 1.0f : -1.0f, direction.y >= 0.0f ? 1.0f : -1.0f);
+		}
+
+		return encoded;
+	}
+
 	Mesh::Mesh(size_t vertexBufferSize, IndexBuffer::IndexFormat indexFormat, size_t indexBufferSize)
 		: Asset(AssetType::Mesh),
 		m_VertexBufferSize(vertexBufferSize),
 		m_IndexFormat(indexFormat),
-		m_IndexBufferSize(indexBufferSize)
+		m_IndexBufferSize(indexBufferSize),
+		m_IndicesCount(indexBufferSize)
 	{
+		m_GeometryPool = Renderer::GetGeometryPool();
+		m_VertexAllocation = m_GeometryPool->AllocateVertices(m_VertexFormat, (uint32_t)vertexBufferSize);
+		m_IndexAllocation = m_GeometryPool->AllocateIndices(m_IndexFormat, (uint32_t)indexBufferSize);
 	}
 
 	Mesh::Mesh(MemorySpan indices,
@@ -25,9 +52,11 @@ namespace Grapple
 		Span<glm::vec3> vertices,
 		Span<glm::vec3> normals,
 		Span<glm::vec3> tangents,
-		Span<glm::vec2> uvs)
+		Span<glm::vec2> uvs,
+		MeshVertexFormat vertexFormat)
 		: Asset(AssetType::Mesh),
 		m_IndexFormat(indexFormat),
+		m_VertexFormat(vertexFormat),
 		m_VertexBufferSize(vertices.GetSize()),
 		m_VertexBufferOffset(0),
 		m_IndexBufferSize(indices.GetSize()),
@@ -38,32 +67,79 @@ namespace Grapple
 		Grapple_CORE_ASSERT(vertices.GetSize() == tangents.GetSize());
 		Grapple_CORE_ASSERT(vertices.GetSize() == uvs.GetSize());
 
-		if (RendererAPI::GetAPI() == RendererAPI::API::Vulkan)
+		MemorySpan positionsData = MemorySpan(vertices.GetData(), vertices.GetSize());
+		MemorySpan normalsData = MemorySpan(normals.GetData(), normals.GetSize());
+		MemorySpan tangentsData = MemorySpan(tangents.GetData(), tangents.GetSize());
+		MemorySpan uvsData = MemorySpan(uvs.GetData(), uvs.GetSize());
+
+		std::vector<glm::u16vec4> compactPositions;
+		std::vector<uint32_t> compactNormals;
+		std::vector<uint32_t> compactTangents;
+		std::vector<uint32_t> compactUVs;
+
+		if (m_VertexFormat == MeshVertexFormat::Compact && vertices.GetSize() > 0)
 		{
-			Ref<CommandBuffer> commandBuffer = VulkanContext::GetInstance().BeginTemporaryCommandBuffer();
+			Grapple_PROFILE_SCOPE("EncodeCompactVertices");
+
+			glm::vec3 boundsMin = vertices[0];
+			glm::vec3 boundsMax = vertices[0];
+			for (size_t i = 1; i < vertices.GetSize(); i++)
+			{
+				boundsMin = glm::min(boundsMin, vertices[i]);
+				boundsMax = glm::max(boundsMax, vertices[i]);
+			}
+
+			// A single scale for all axes keeps the dequantization free of non uniform scaling, which would skew normals
+			glm::vec3 size = boundsMax - boundsMin;
+			m_PositionOffset = boundsMin;
+			m_PositionScale = glm::max(glm::max(size.x, size.y), glm::max(size.z, 1e-6f));
+
+			compactPositions.resize(vertices.GetSize());
+			compactNormals.resize(vertices.GetSize());
+			compactTangents.resize(vertices.GetSize());
+			compactUVs.resize(vertices.GetSize());
+
+			for (size_t i = 0; i < vertices.GetSize(); i++)
+			{
+				glm::vec3 position = glm::clamp((vertices[i] - m_PositionOffset) / m_PositionScale, glm::vec3(0.0f), glm::vec3(1.0f));
+
+				compactPositions[i] = glm::u16vec4(glm::round(position * 65535.0f), 65535.0f);
+				compactNormals[i] = glm::packSnorm2x16(EncodeOctahedral(normals[i]));
+				compactTangents[i] = glm::packSnorm2x16(EncodeOctahedral(tangents[i]));
+				compactUVs[i] = glm::packHalf2x16(uvs[i]);
+			}
+
+			positionsData = MemorySpan::FromVector(compactPositions);
+			normalsData = MemorySpan::FromVector(compactNormals);
+			tangentsData = MemorySpan::FromVector(compactTangents);
+			uvsData = MemorySpan::FromVector(compactUVs);
+		}
 
-			m_Vertices = VertexBuffer::Create(sizeof(glm::vec3) * vertices.GetSize(), vertices.GetData(), commandBuffer);
-			m_Normals = VertexBuffer::Create(sizeof(glm::vec3) * normals.GetSize(), normals.GetData(), commandBuffer);
-			m_Tangents = VertexBuffer::Create(sizeof(glm::vec3) * tangents.GetSize(), tangents.GetData(), commandBuffer);
-			m_UVs = VertexBuffer::Create(sizeof(glm::vec2) * uvs.GetSize(), uvs.GetData(), commandBuffer);
+		m_IndicesCount = indices.GetSize() / IndexBuffer::GetIndexFormatSize(m_IndexFormat);
 
-			m_IndexBuffer = IndexBuffer::Create(m_IndexFormat, indices, commandBuffer);
+		m_GeometryPool = Renderer::GetGeometryPool();
+		m_VertexAllocation = m_GeometryPool->AllocateVertices(m_VertexFormat, (uint32_t)vertices.GetSize());
+		m_IndexAllocation = m_GeometryPool->AllocateIndices(m_IndexFormat, (uint32_t)m_IndicesCount);
 
-			VulkanContext::GetInstance().EndTemporaryCommandBuffer(As<VulkanCommandBuffer>(commandBuffer));
-		}
-		else
+		if (m_VertexAllocation.IsValid() && m_IndexAllocation.IsValid())
 		{
-			m_Vertices = VertexBuffer::Create(sizeof(glm::vec3) * vertices.GetSize(), vertices.GetData());
-			m_Normals = VertexBuffer::Create(sizeof(glm::vec3) * normals.GetSize(), normals.GetData());
-			m_Tangents = VertexBuffer::Create(sizeof(glm::vec3) * tangents.GetSize(), tangents.GetData());
-			m_UVs = VertexBuffer::Create(sizeof(glm::vec2) * uvs.GetSize(), uvs.GetData());
+			Ref<CommandBuffer> commandBuffer = VulkanContext::GetInstance().BeginTemporaryCommandBuffer();
 
-			m_IndexBuffer = IndexBuffer::Create(m_IndexFormat, indices);
+			m_GeometryPool->SetVertexData(m_VertexAllocation, 0, positionsData, 0, commandBuffer);
+			m_GeometryPool->SetVertexData(m_VertexAllocation, 1, normalsData, 0, commandBuffer);
+			m_GeometryPool->SetVertexData(m_VertexAllocation, 2, tangentsData, 0, commandBuffer);
+			m_GeometryPool->SetVertexData(m_VertexAllocation, 3, uvsData, 0, commandBuffer);
+
+			m_GeometryPool->SetIndexData(m_IndexAllocation, indices, 0, commandBuffer);
+
+			VulkanContext::GetInstance().EndTemporaryCommandBuffer(As<VulkanCommandBuffer>(commandBuffer));
 		}
 	}
 
 	Mesh::~Mesh()
 	{
+		m_GeometryPool->Free(m_VertexAllocation);
+		m_GeometryPool->Free(m_IndexAllocation);
 	}
 
 	void Mesh::AddSubMesh(const Span<glm::vec3>& vertices,
@@ -96,31 +172,17 @@ namespace Grapple
 			subMesh.Bounds.Max = glm::max(subMesh.Bounds.Max, vertices[i]);
 		}
 
-		if (!m_IndexBuffer)
-			m_IndexBuffer = IndexBuffer::Create(m_IndexFormat, m_IndexBufferSize, GPUBufferUsage::Static);
-
-		if (!m_Vertices)
-			m_Vertices = VertexBuffer::Create(m_VertexBufferSize * sizeof(glm::vec3), GPUBufferUsage::Static);
-
-		if (!m_Normals)
-			m_Normals = VertexBuffer::Create(m_VertexBufferSize * sizeof(glm::vec3), GPUBufferUsage::Static);
-
-		if (!m_Tangents)
-			m_Tangents = VertexBuffer::Create(m_VertexBufferSize * sizeof(glm::vec3), GPUBufferUsage::Static);
-
-		if (!m_UVs)
-			m_UVs = VertexBuffer::Create(m_VertexBufferSize * sizeof(glm::vec2), GPUBufferUsage::Static);
-
 		if (RendererAPI::GetAPI() == RendererAPI::API::Vulkan)
 		{
 			Ref<CommandBuffer> commandBuffer = VulkanContext::GetInstance().BeginTemporaryCommandBuffer();
 
-			m_Vertices->SetData(MemorySpan(const_cast<glm::vec3*>(vertices.GetData()), vertices.GetSize()), m_VertexBufferOffset * sizeof(glm::vec3), commandBuffer);
-			m_Normals->SetData(MemorySpan(const_cast<glm::vec3*>(normals.GetData()), normals.GetSize()), m_VertexBufferOffset * sizeof(glm::vec3), commandBuffer);
-			m_Tangents->SetData(MemorySpan(const_cast<glm::vec3*>(tangents.GetData()), tangents.GetSize()), m_VertexBufferOffset * sizeof(glm::vec3), commandBuffer);
-			m_UVs->SetData(MemorySpan(const_cast<glm::vec2*>(uvs.GetData()), uvs.GetSize()), m_VertexBufferOffset * sizeof(glm::vec2), commandBuffer);
+			uint32_t vertexOffset = (uint32_t)m_VertexBufferOffset;
+			m_GeometryPool->SetVertexData(m_VertexAllocation, 0, MemorySpan(const_cast<glm::vec3*>(vertices.GetData()), vertices.GetSize()), vertexOffset, commandBuffer);
+			m_GeometryPool->SetVertexData(m_VertexAllocation, 1, MemorySpan(const_cast<glm::vec3*>(normals.GetData()), normals.GetSize()), vertexOffset, commandBuffer);
+			m_GeometryPool->SetVertexData(m_VertexAllocation, 2, MemorySpan(const_cast<glm::vec3*>(tangents.GetData()), tangents.GetSize()), vertexOffset, commandBuffer);
+			m_GeometryPool->SetVertexData(m_VertexAllocation, 3, MemorySpan(const_cast<glm::vec2*>(uvs.GetData()), uvs.GetSize()), vertexOffset, commandBuffer);
 
-			m_IndexBuffer->SetData(indices, m_IndexBufferOffset, commandBuffer);
+			m_GeometryPool->SetIndexData(m_IndexAllocation, indices, (uint32_t)(m_IndexBufferOffset / indexSize), commandBuffer);
 
 			VulkanContext::GetInstance().EndTemporaryCommandBuffer(As<VulkanCommandBuffer>(commandBuffer));
 		}
@@ -150,6 +212,50 @@ namespace Grapple
 		m_SubMeshes.push_back(subMesh);
 	}
 
+	void Mesh::AddLOD(MeshLOD lod)
+	{
+		Grapple_CORE_ASSERT(lod.SubMeshes.size() == m_SubMeshes.size());
+		Grapple_CORE_ASSERT(GetLODCount() < MaxLODCount);
+		Grapple_CORE_ASSERT(m_LODs.size() == 0 || lod.ScreenSize < m_LODs.back().ScreenSize);
+
+		m_LODs.push_back(std::move(lod));
+	}
+
+	void Mesh::SetMeshlets(std::vector<Meshlet> meshlets)
+	{
+		for (const SubMesh& subMesh : m_SubMeshes)
+			Grapple_CORE_ASSERT((size_t)subMesh.FirstMeshlet + (size_t)subMesh.MeshletsCount <= meshlets.size());
+
+		m_Meshlets = std::move(meshlets);
+	}
+
+	uint32_t Mesh::SelectLOD(float screenSize) const
+	{
+		uint32_t lod = 0;
+		while (lod < (uint32_t)m_LODs.size() && screenSize < m_LODs[lod].ScreenSize)
+			lod++;
+
+		return lod;
+	}
+
+	void Mesh::SetOccluderGeometry(std::vector<glm::vec3> vertices, std::vector<uint32_t> indices)
+	{
+		Grapple_CORE_ASSERT(indices.size() % 3 == 0);
+
+		m_OccluderVertices = std::move(vertices);
+		m_OccluderIndices = std::move(indices);
+	}
+
+	Math::Compact3DTransform Mesh::GetVertexTransform(const Math::Compact3DTransform& transform) const
+	{
+		if (m_VertexFormat == MeshVertexFormat::Float)
+			return transform;
+
+		return Math::Compact3DTransform(
+			transform.RotationScale * m_PositionScale,
+			transform.RotationScale * m_PositionOffset + transform.Translation);
+	}
+
 	Ref<Mesh> Mesh::Create(size_t vertexBufferSize, IndexBuffer::IndexFormat indexFormat, size_t indexBufferSize)
 	{
 		Grapple_PROFILE_FUNCTION();
@@ -169,14 +275,15 @@ namespace Grapple
 		Span<glm::vec3> vertices,
 		Span<glm::vec3> normals,
 		Span<glm::vec3> tangents,
-		Span<glm::vec2> uvs)
+		Span<glm::vec2> uvs,
+		MeshVertexFormat vertexFormat)
 	{
 		Grapple_PROFILE_FUNCTION();
 
 		switch (RendererAPI::GetAPI())
 		{
 		case RendererAPI::API::Vulkan:
-			return CreateRef<Mesh>(indices, indexFormat, vertices, normals, tangents, uvs);
+			return CreateRef<Mesh>(indices, indexFormat, vertices, normals, tangents, uvs, vertexFormat);
 		}
 
 		Grapple_CORE_ASSERT(false);
@@ -2,7 +2,10 @@
 
 #include "Grapple/AssetManager/Asset.h"
 #include "Grapple/Renderer/Buffer.h"
+#include "Grapple/Renderer/GeometryPool.h"
+#include "Grapple/Renderer/SortId.h"
 #include "Grapple/Math/Math.h"
+#include "Grapple/Math/Transform.h"
 
 #include "GrappleCore/Collections/Span.h"
 #include "GrappleCore/Serialization/Metadata.h"
@@ -16,12 +19,51 @@ namespace Grapple
 		uint32_t BaseIndex = 0;
 		uint32_t IndicesCount = 0;
 		uint32_t BaseVertex = 0;
+
+		// Range in the mesh's list of meshlets, empty for sub meshes, which weren't split into meshlets
+		uint32_t FirstMeshlet = 0;
+		uint32_t MeshletsCount = 0;
+	};
+
+	// Cluster of a sub mesh's triangles, whose indices are stored contiguously in the index buffer,
+	// so that the visible meshlets of a sub mesh can be drawn as a few ranges of indices
+	struct Meshlet
+	{
+		static constexpr uint32_t MaxVertices = 64;
+		static constexpr uint32_t MaxTriangles = 124;
+
+		// Bounding sphere in mesh space
+		glm::vec3 Center = glm::vec3(0.0f);
+		float Radius = 0.0f;
+
+		// Outward normals of all triangles lie inside of the cone around the axis. All of the triangles face away from a viewer at `position`,
+		// when dot(Center - position, ConeAxis) >= ConeCutoff * distance(Center, position) + Radius. A cutoff of 1 never passes the test
+		glm::vec3 ConeAxis = glm::vec3(0.0f);
+		float ConeCutoff = 1.0f;
+
+		uint32_t BaseIndex = 0;
+		uint32_t IndicesCount = 0;
+	};
+
+	// Simplified version of all sub meshes of a mesh, which reuses the vertices of the base level of detail
+	struct MeshLOD
+	{
+		// The LOD is used when the projected size of the mesh is smaller than this fraction of the viewport height
+		float ScreenSize = 0.0f;
+		std::vector<SubMesh> SubMeshes;
 	};
 
 	enum class MeshRenderFlags : uint8_t
 	{
 		None = 0,
 		DontCastShadows = 1,
+
+		// Transform is expected to rarely change, the mesh is culled using a persistent BVH
+		Static = 2,
+
+		// The mesh hides objects behind it during occlusion culling. Meshes without occluder geometry
+		// are rasterized as their sub mesh bounds, so the flag should only be used for solid box-like meshes
+		Occluder = 4,
 	};
 
 	Grapple_IMPL_ENUM_BITFIELD(MeshRenderFlags);
@@ -41,7 +83,8 @@ namespace Grapple
 			Span<glm::vec3> vertices,
 			Span<glm::vec3> normals,
 			Span<glm::vec3> tangents,
-			Span<glm::vec2> uvs);
+			Span<glm::vec2> uvs,
+			MeshVertexFormat vertexFormat = MeshVertexFormat::Float);
 
 		~Mesh();
 
@@ -53,22 +96,70 @@ namespace Grapple
 
 		void AddSubMesh(const SubMesh& subMesh);
 
+		// Adds the next level of detail. Sub meshes of the LOD must reference indices, which were uploaded when creating the mesh
+		void AddLOD(MeshLOD lod);
+
+		// Returns the index of the coarsest LOD, whose screen size is larger than the projected size of the mesh
+		uint32_t SelectLOD(float screenSize) const;
+
+		// Sets meshlets of all sub meshes, which are referenced by the `FirstMeshlet` and `MeshletsCount` of the base LOD sub meshes
+		void SetMeshlets(std::vector<Meshlet> meshlets);
+
+		// Sets a low poly triangle list used for occlusion culling, which must be contained inside of the mesh
+		void SetOccluderGeometry(std::vector<glm::vec3> vertices, std::vector<uint32_t> indices);
+
 		constexpr size_t GetVertexBufferSize() const { return m_VertexBufferSize; }
 		constexpr size_t GetIndexBufferSize() const { return m_IndexBufferSize; }
 
-		inline size_t GetIndexCount() const { return m_IndexBuffer->GetCount(); }
+		inline size_t GetIndexCount() const { return m_IndicesCount; }
+
+		// Vertices and indices are stored in the buffers of the GeometryPool.
+		// Offsets are added to the base vertex and index of sub meshes and can change, when the pool is defragmented
+		inline uint32_t GetBaseVertex() const { return m_GeometryPool->GetOffset(m_VertexAllocation); }
+		inline uint32_t GetBaseIndex() const { return m_GeometryPool->GetOffset(m_IndexAllocation); }
+		inline const Ref<GeometryPool>& GetGeometryPool() const { return m_GeometryPool; }
 
-		inline Ref<IndexBuffer> GetIndexBuffer() const { return m_IndexBuffer; }
-		inline Ref<VertexBuffer> GetVertices() const { return m_Vertices; }
-		inline Ref<VertexBuffer> GetNormals() const { return m_Normals; }
-		inline Ref<VertexBuffer> GetTangents() const { return m_Tangents; }
-		inline Ref<VertexBuffer> GetUVs() const { return m_UVs; }
+		// Meshes with the same vertex and index formats are stored in the same buffers, so they can be drawn without rebinding them
+		inline bool SharesBuffersWith(const Mesh& other) const
+		{
+			return m_VertexFormat == other.m_VertexFormat && m_IndexFormat == other.m_IndexFormat;
+		}
 
 		inline const Math::AABB& GetBounds() const { return m_Bounds; }
 
 		inline const std::vector<SubMesh>& GetSubMeshes() const { return m_SubMeshes; }
+
+		// LOD 0 is the base mesh, which isn't stored in the list of LODs
+		inline uint32_t GetLODCount() const { return (uint32_t)m_LODs.size() + 1; }
+		inline const std::vector<MeshLOD>& GetLODs() const { return m_LODs; }
+
+		inline const SubMesh& GetSubMesh(uint32_t subMeshIndex, uint32_t lod) const
+		{
+			return lod == 0 ? m_SubMeshes[subMeshIndex] : m_LODs[lod - 1].SubMeshes[subMeshIndex];
+		}
+
+		inline const std::vector<Meshlet>& GetMeshlets() const { return m_Meshlets; }
+		inline Span<const Meshlet> GetMeshlets(const SubMesh& subMesh) const
+		{
+			return Span<const Meshlet>(m_Meshlets.data() + subMesh.FirstMeshlet, (size_t)subMesh.MeshletsCount);
+		}
+
 		inline IndexBuffer::IndexFormat GetIndexFormat() const { return m_IndexFormat; }
+		inline MeshVertexFormat GetVertexFormat() const { return m_VertexFormat; }
+
+		// Positions of compact meshes are dequantized by the instance transform.
+		// Returns the transform, which maps positions stored in the vertex buffer to the space of `transform`
+		Math::Compact3DTransform GetVertexTransform(const Math::Compact3DTransform& transform) const;
+
+		inline bool HasOccluderGeometry() const { return m_OccluderIndices.size() > 0; }
+		inline const std::vector<glm::vec3>& GetOccluderVertices() const { return m_OccluderVertices; }
+		inline const std::vector<uint32_t>& GetOccluderIndices() const { return m_OccluderIndices; }
+
+		inline uint16_t GetSortId() const { return m_SortId.GetValue(); }
 	public:
+		// LOD index must fit into 3 bits of the draw sort key
+		static constexpr uint32_t MaxLODCount = 8;
+
 		static Ref<Mesh> Create( size_t vertexBufferSize, IndexBuffer::IndexFormat indexFormat, size_t indexBufferSize);
 
 		static Ref<Mesh> Create(MemorySpan indices,
@@ -76,9 +167,15 @@ namespace Grapple
 			Span<glm::vec3> vertices,
 			Span<glm::vec3> normals,
 			Span<glm::vec3> tangents,
-			Span<glm::vec2> uvs);
+			Span<glm::vec2> uvs,
+			MeshVertexFormat vertexFormat = MeshVertexFormat::Float);
 	protected:
 		IndexBuffer::IndexFormat m_IndexFormat;
+		MeshVertexFormat m_VertexFormat = MeshVertexFormat::Float;
+
+		// Maps normalized positions of MeshVertexFormat::Compact to mesh space
+		glm::vec3 m_PositionOffset = glm::vec3(0.0f);
+		float m_PositionScale = 1.0f;
 
 		Math::AABB m_Bounds;
 
@@ -88,12 +185,19 @@ namespace Grapple
 		size_t m_VertexBufferOffset = 0;
 		size_t m_IndexBufferOffset = 0;
 
-		Ref<IndexBuffer> m_IndexBuffer = nullptr;
-		Ref<VertexBuffer> m_Vertices = nullptr;
-		Ref<VertexBuffer> m_Normals = nullptr;
-		Ref<VertexBuffer> m_Tangents = nullptr;
-		Ref<VertexBuffer> m_UVs = nullptr;
+		size_t m_IndicesCount = 0;
+
+		Ref<GeometryPool> m_GeometryPool = nullptr;
+		GeometryAllocation m_VertexAllocation;
+		GeometryAllocation m_IndexAllocation;
 
 		std::vector<SubMesh> m_SubMeshes;
+		std::vector<MeshLOD> m_LODs;
+		std::vector<Meshlet> m_Meshlets;
+
+		std::vector<glm::vec3> m_OccluderVertices;
+		std::vector<uint32_t> m_OccluderIndices;
+	private:
+		SortId m_SortId = SortId(SortIdType::Mesh);
 	};
 }
\ No newline at end of file
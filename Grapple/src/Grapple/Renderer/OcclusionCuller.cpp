@@ -0,0 +1,287 @@
+#include "OcclusionCuller.h"
+
+#include "GrappleCore/Assert.h"
+#include "GrappleCore/Profiler/Profiler.h"
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace Grapple
+{
+	// Pairs of triangles for each face of a box, using the corners order of `Math::AABB::GetCorners`
+	static constexpr uint32_t s_BoxIndices[] =
+	{
+		0, 2, 3, 0, 3, 1,
+		4, 6, 7, 4, 7, 5,
+		0, 1, 5, 0, 5, 4,
+		2, 3, 7, 2, 7, 6,
+		0, 2, 6, 0, 6, 4,
+		1, 3, 7, 1, 7, 5,
+	};
+
+	OcclusionCuller::OcclusionCuller()
+	{
+		size_t offset = 0;
+		uint32_t width = Width;
+		uint32_t height = Height;
+		while (true)
+		{
+			Level& level = m_Levels.emplace_back();
+			level.Width = width;
+			level.Height = height;
+			level.Offset = offset;
+
+			offset += (size_t)width * (size_t)height;
+
+			if (width == 1 && height == 1)
+				break;
+
+			width = std::max(width / 2, 1u);
+			height = std::max(height / 2, 1u);
+		}
+
+		m_Depth.resize(offset, 1.0f);
+	}
+
+	void OcclusionCuller::BeginFrame(const glm::mat4& viewProjection)
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		m_ViewProjection = viewProjection;
+		m_RasterizedTrianglesCount = 0;
+
+		std::fill(m_Depth.begin(), m_Depth.begin() + (size_t)Width * (size_t)Height, 1.0f);
+	}
+
+	void OcclusionCuller::RasterizeBox(const Math::AABB& localBounds, const Math::Compact3DTransform& transform)
+	{
+		glm::vec3 corners[8];
+		localBounds.GetCorners(corners);
+
+		glm::vec4 clipSpaceCorners[8];
+		for (size_t i = 0; i < 8; i++)
+			clipSpaceCorners[i] = m_ViewProjection * glm::vec4(transform.RotationScale * corners[i] + transform.Translation, 1.0f);
+
+		for (size_t i = 0; i < sizeof(s_BoxIndices) / sizeof(*s_BoxIndices); i += 3)
+		{
+			RasterizeTriangle(
+				clipSpaceCorners[s_BoxIndices[i + 0]],
+				clipSpaceCorners[s_BoxIndices[i + 1]],
+				clipSpaceCorners[s_BoxIndices[i + 2]]);
+		}
+	}
+
+	void OcclusionCuller::RasterizeTriangles(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices, const Math::Compact3DTransform& transform)
+	{
+		Grapple_CORE_ASSERT(indices.size() % 3 == 0);
+
+		m_ClipSpaceVertices.resize(vertices.size());
+		for (size_t i = 0; i < vertices.size(); i++)
+			m_ClipSpaceVertices[i] = m_ViewProjection * glm::vec4(transform.RotationScale * vertices[i] + transform.Translation, 1.0f);
+
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			RasterizeTriangle(
+				m_ClipSpaceVertices[indices[i + 0]],
+				m_ClipSpaceVertices[indices[i + 1]],
+				m_ClipSpaceVertices[indices[i + 2]]);
+		}
+	}
+
+	void OcclusionCuller::RasterizeTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c)
+	{
+		// Clipping against the near plane would only shrink the occluder, so such triangles are skipped entirely
+		if (a.z < 0.0f || b.z < 0.0f || c.z < 0.0f)
+			return;
+
+		glm::vec2 size = glm::vec2((float)Width, (float)Height);
+		glm::vec3 v0 = glm::vec3((glm::vec2(a) / a.w * 0.5f + 0.5f) * size, a.z / a.w);
+		glm::vec3 v1 = glm::vec3((glm::vec2(b) / b.w * 0.5f + 0.5f) * size, b.z / b.w);
+		glm::vec3 v2 = glm::vec3((glm::vec2(c) / c.w * 0.5f + 0.5f) * size, c.z / c.w);
+
+		float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+		if (std::abs(area) < 1e-6f)
+			return;
+
+		// Both windings are rasterized, because occluders are closed and the nearest depth is kept
+		if (area < 0.0f)
+		{
+			std::swap(v1, v2);
+			area = -area;
+		}
+
+		glm::vec2 boundsMin = glm::min(glm::min(glm::vec2(v0), glm::vec2(v1)), glm::vec2(v2));
+		glm::vec2 boundsMax = glm::max(glm::max(glm::vec2(v0), glm::vec2(v1)), glm::vec2(v2));
+
+		if (boundsMax.x < 0.0f || boundsMax.y < 0.0f || boundsMin.x > size.x || boundsMin.y > size.y)
+			return;
+
+		// Clamped before converting to integers, because vertices close to the camera plane project very far
+		boundsMin = glm::clamp(glm::floor(boundsMin), glm::vec2(0.0f), size - 1.0f);
+		boundsMax = glm::clamp(glm::ceil(boundsMax), glm::vec2(0.0f), size - 1.0f);
+
+		int32_t minX = (int32_t)boundsMin.x;
+		int32_t minY = (int32_t)boundsMin.y;
+		int32_t maxX = (int32_t)boundsMax.x;
+		int32_t maxY = (int32_t)boundsMax.y;
+
+		// Pixels are processed in groups of 4, the width is a multiple of 4 so groups never cross the row end
+		minX &= ~3;
+
+		// Edge functions in form of A * x + B * y + C, which are positive inside of the triangle
+		float edgeA[3];
+		float edgeB[3];
+		float edgeC[3];
+
+		const glm::vec3* vertices[] = { &v1, &v2, &v0 };
+		const glm::vec3* nextVertices[] = { &v2, &v0, &v1 };
+		for (size_t i = 0; i < 3; i++)
+		{
+			const glm::vec3& start = *vertices[i];
+			const glm::vec3& end = *nextVertices[i];
+
+			edgeA[i] = start.y - end.y;
+			edgeB[i] = end.x - start.x;
+			edgeC[i] = -(edgeA[i] * start.x + edgeB[i] * start.y);
+		}
+
+		// Edges 1 and 2 are opposite to v1 and v2, so they are the barycentric weights of v1 and v2 scaled by the area
+		float inverseArea = 1.0f / area;
+		float depthDeltaB = (v1.z - v0.z) * inverseArea;
+		float depthDeltaC = (v2.z - v0.z) * inverseArea;
+
+		float depthA = depthDeltaB * edgeA[1] + depthDeltaC * edgeA[2];
+		float depthB = depthDeltaB * edgeB[1] + depthDeltaC * edgeB[2];
+		float depthC = v0.z + depthDeltaB * edgeC[1] + depthDeltaC * edgeC[2];
+
+		const __m128 pixelOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+		const __m128 zero = _mm_setzero_ps();
+
+		__m128 edgeA0 = _mm_set1_ps(edgeA[0]);
+		__m128 edgeA1 = _mm_set1_ps(edgeA[1]);
+		__m128 edgeA2 = _mm_set1_ps(edgeA[2]);
+		__m128 depthAVector = _mm_set1_ps(depthA);
+
+		float* depthBuffer = m_Depth.data();
+		for (int32_t y = minY; y <= maxY; y++)
+		{
+			float pixelY = (float)y + 0.5f;
+
+			__m128 rowEdge0 = _mm_set1_ps(edgeB[0] * pixelY + edgeC[0]);
+			__m128 rowEdge1 = _mm_set1_ps(edgeB[1] * pixelY + edgeC[1]);
+			__m128 rowEdge2 = _mm_set1_ps(edgeB[2] * pixelY + edgeC[2]);
+			__m128 rowDepth = _mm_set1_ps(depthB * pixelY + depthC);
+
+			float* row = depthBuffer + (size_t)y * Width;
+			for (int32_t x = minX; x <= maxX; x += 4)
+			{
+				__m128 pixelX = _mm_add_ps(_mm_set1_ps((float)x), pixelOffsets);
+
+				__m128 edge0 = _mm_add_ps(_mm_mul_ps(edgeA0, pixelX), rowEdge0);
+				__m128 edge1 = _mm_add_ps(_mm_mul_ps(edgeA1, pixelX), rowEdge1);
+				__m128 edge2 = _mm_add_ps(_mm_mul_ps(edgeA2, pixelX), rowEdge2);
+
+				__m128 inside = _mm_and_ps(
+					_mm_and_ps(_mm_cmpge_ps(edge0, zero), _mm_cmpge_ps(edge1, zero)),
+					_mm_cmpge_ps(edge2, zero));
+
+				if (_mm_movemask_ps(inside) == 0)
+					continue;
+
+				__m128 depth = _mm_add_ps(_mm_mul_ps(depthAVector, pixelX), rowDepth);
+				__m128 previousDepth = _mm_loadu_ps(row + x);
+				__m128 nearestDepth = _mm_min_ps(previousDepth, depth);
+
+				_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearestDepth), _mm_andnot_ps(inside, previousDepth)));
+			}
+		}
+
+		m_RasterizedTrianglesCount++;
+	}
+
+	void OcclusionCuller::BuildHierarchy()
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		for (size_t levelIndex = 1; levelIndex < m_Levels.size(); levelIndex++)
+		{
+			const Level& source = m_Levels[levelIndex - 1];
+			const Level& destination = m_Levels[levelIndex];
+
+			const float* sourceDepth = m_Depth.data() + source.Offset;
+			float* destinationDepth = m_Depth.data() + destination.Offset;
+
+			for (uint32_t y = 0; y < destination.Height; y++)
+			{
+				uint32_t y0 = std::min(y * 2, source.Height - 1);
+				uint32_t y1 = std::min(y * 2 + 1, source.Height - 1);
+
+				for (uint32_t x = 0; x < destination.Width; x++)
+				{
+					uint32_t x0 = std::min(x * 2, source.Width - 1);
+					uint32_t x1 = std::min(x * 2 + 1, source.Width - 1);
+
+					destinationDepth[y * destination.Width + x] = std::max(
+						std::max(sourceDepth[y0 * source.Width + x0], sourceDepth[y0 * source.Width + x1]),
+						std::max(sourceDepth[y1 * source.Width + x0], sourceDepth[y1 * source.Width + x1]));
+				}
+			}
+		}
+	}
+
+	bool OcclusionCuller::IsOccluded(const Math::AABB& bounds) const
+	{
+		glm::vec3 corners[8];
+		bounds.GetCorners(corners);
+
+		glm::vec2 min = glm::vec2(FLT_MAX);
+		glm::vec2 max = glm::vec2(-FLT_MAX);
+		float minDepth = FLT_MAX;
+
+		for (size_t i = 0; i < 8; i++)
+		{
+			glm::vec4 clipSpace = m_ViewProjection * glm::vec4(corners[i], 1.0f);
+
+			// Bounds cross the near plane
+			if (clipSpace.z < 0.0f)
+				return false;
+
+			glm::vec3 projected = glm::vec3(clipSpace) / clipSpace.w;
+			min = glm::min(min, glm::vec2(projected));
+			max = glm::max(max, glm::vec2(projected));
+			minDepth = std::min(minDepth, projected.z);
+		}
+
+		if (max.x < -1.0f || max.y < -1.0f || min.x > 1.0f || min.y > 1.0f)
+			return false;
+
+		glm::vec2 size = glm::vec2((float)Width, (float)Height);
+		glm::vec2 screenMin = glm::clamp((min * 0.5f + 0.5f) * size, glm::vec2(0.0f), size - 1.0f);
+		glm::vec2 screenMax = glm::clamp((max * 0.5f + 0.5f) * size, glm::vec2(0.0f), size - 1.0f);
+
+		uint32_t x0 = (uint32_t)screenMin.x;
+		uint32_t y0 = (uint32_t)screenMin.y;
+		uint32_t x1 = (uint32_t)screenMax.x;
+		uint32_t y1 = (uint32_t)screenMax.y;
+
+		// Find the finest level, at which the rect covers at most 2x2 texels
+		size_t levelIndex = 0;
+		while (levelIndex + 1 < m_Levels.size() && ((x1 >> levelIndex) - (x0 >> levelIndex) > 1 || (y1 >> levelIndex) - (y0 >> levelIndex) > 1))
+			levelIndex++;
+
+		const Level& level = m_Levels[levelIndex];
+		const float* depth = m_Depth.data() + level.Offset;
+
+		float maxDepth = 0.0f;
+		for (uint32_t y = y0 >> levelIndex; y <= std::min(y1 >> levelIndex, level.Height - 1); y++)
+		{
+			for (uint32_t x = x0 >> levelIndex; x <= std::min(x1 >> levelIndex, level.Width - 1); x++)
+				maxDepth = std::max(maxDepth, depth[y * level.Width + x]);
+		}
+
+		return minDepth > maxDepth;
+	}
+}
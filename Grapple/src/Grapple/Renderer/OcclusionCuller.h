@@ -0,0 +1,65 @@
+#pragma once
+
+#include "GrappleCore/Core.h"
+
+#include "Grapple/Math/Math.h"
+#include "Grapple/Math/Transform.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+namespace Grapple
+{
+	// Software occlusion culling on the CPU.
+	//
+	// Occluder triangles are rasterized into a low resolution depth buffer, which is then reduced into
+	// a hierarchical depth pyramid, where each texel stores the farthest depth of the pixels it covers.
+	// Bounding boxes are tested against the pyramid level, at which their screen rect covers at most 2x2 texels.
+	//
+	// Depth is expected to be in [0, 1] range with 0 being the near plane. Only pixels, whose centers are inside
+	// of a triangle are written and triangles crossing the near plane are skipped, so that occluders never
+	// cover more than they would when rasterized at the full resolution.
+	class Grapple_API OcclusionCuller
+	{
+	public:
+		static constexpr uint32_t Width = 256;
+		static constexpr uint32_t Height = 128;
+
+		OcclusionCuller();
+
+		void BeginFrame(const glm::mat4& viewProjection);
+
+		// Rasterizes a box defined by local bounds and a transform
+		void RasterizeBox(const Math::AABB& localBounds, const Math::Compact3DTransform& transform);
+
+		// Rasterizes an indexed triangle list with the given transform
+		void RasterizeTriangles(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices, const Math::Compact3DTransform& transform);
+
+		// Must be called after all of the occluders were rasterized and before testing bounds
+		void BuildHierarchy();
+
+		// Returns true when world space bounds are completely hidden behind the rasterized occluders.
+		// Safe to call from multiple threads after `BuildHierarchy`
+		bool IsOccluded(const Math::AABB& bounds) const;
+
+		inline uint32_t GetRasterizedTrianglesCount() const { return m_RasterizedTrianglesCount; }
+	private:
+		struct Level
+		{
+			uint32_t Width = 0;
+			uint32_t Height = 0;
+			size_t Offset = 0;
+		};
+
+		void RasterizeTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c);
+	private:
+		glm::mat4 m_ViewProjection = glm::mat4(1.0f);
+		uint32_t m_RasterizedTrianglesCount = 0;
+		std::vector<glm::vec4> m_ClipSpaceVertices;
+
+		// Level 0 is the rasterized depth buffer, each next level is half the size of the previous one
+		std::vector<Level> m_Levels;
+		std::vector<float> m_Depth;
+	};
+}
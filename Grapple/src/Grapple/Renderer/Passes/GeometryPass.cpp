@@ -1,19 +1,22 @@
 #include "GeometryPass.h"
 
+#include "Grapple/Core/JobSystem.h"
+
 #include "Grapple/Renderer/GraphicsContext.h"
 #include "Grapple/Renderer/Renderer.h"
 #include "Grapple/Renderer/Viewport.h"
 #include "Grapple/Renderer/ShaderStorageBuffer.h"
 #include "Grapple/Renderer/GPUTimer.h"
 #include "Grapple/Renderer/SceneSubmition.h"
+#include "Grapple/Renderer/MaterialDataTable.h"
 
 #include "Grapple/Renderer2D/Renderer2D.h"
 
-#include "Grapple/Math/SIMD.h"
-
 #include "Grapple/Platform/Vulkan/VulkanCommandBuffer.h"
 #include "Grapple/Platform/Vulkan/VulkanContext.h"
 
+#include <algorithm>
+
 namespace Grapple
 {
 	GeometryPass::GeometryPass(RendererStatistics& statistics)
@@ -21,12 +24,25 @@ namespace Grapple
 	{
 		Grapple_PROFILE_FUNCTION();
 		constexpr size_t maxInstances = 16;
-		m_InstanceStorageBuffer = ShaderStorageBuffer::Create(maxInstances * sizeof(InstanceData));
+		m_InstanceIndicesBuffer = ShaderStorageBuffer::Create(maxInstances * sizeof(uint32_t));
+		m_InstanceMaterialIndicesBuffer = ShaderStorageBuffer::Create(maxInstances * sizeof(uint32_t));
+		m_InstanceMaterialIndicesBuffer->SetDebugName("GeometryPass.InstanceMaterialIndices");
 
 		m_InstanceDataDescriptor = Renderer::GetInstanceDataDescriptorSetPool()->AllocateSet();
-		m_InstanceDataDescriptor->WriteStorageBuffer(m_InstanceStorageBuffer, 0);
+		m_InstanceDataDescriptor->WriteStorageBuffer(m_InstanceIndicesBuffer, 1);
+		m_InstanceDataDescriptor->WriteStorageBuffer(m_InstanceMaterialIndicesBuffer, 2);
 		m_InstanceDataDescriptor->FlushWrites();
 
+		const GraphicsContextFeatures& features = GraphicsContext::GetInstance().GetFeatures();
+		m_UseIndirectDraws = features.MultiDrawIndirect;
+
+		if (m_UseIndirectDraws)
+		{
+			constexpr size_t maxCommands = 16;
+			m_IndirectCommandsBuffer = ShaderStorageBuffer::Create(maxCommands * sizeof(DrawIndexedIndirectCommand));
+			m_IndirectCommandsBuffer->SetDebugName("GeometryPass.IndirectCommands");
+		}
+
 		m_Timer = GPUTimer::Create();
 	}
 
@@ -51,6 +67,8 @@ namespace Grapple
 		m_VisibleObjects.clear();
 
 		CullObjects(context);
+		CullOccludedObjects(context);
+		SelectLODs(context);
 
 		m_Statistics.GeometryPassTime += m_Timer->GetElapsedTime().value_or(0.0f); // Read the time from the previous frame
 		m_Statistics.ObjectsVisible += (uint32_t)m_VisibleObjects.size();
@@ -59,35 +77,68 @@ namespace Grapple
 
 		{
 			Grapple_PROFILE_SCOPE("Sort");
-			std::sort(m_VisibleObjects.begin(), m_VisibleObjects.end(), [&opaqueGeometry](uint32_t a, uint32_t b) -> bool
+
+			// LOD replaces the upper 3 bits of the quantized distance, so that instances of the same LOD are grouped together
+			constexpr uint32_t lodShift = RendererSubmitionQueue::SortKeyDepthBits - 3;
+			constexpr uint64_t depthMask = (1ull << RendererSubmitionQueue::SortKeyDepthBits) - 1;
+
+			m_SortEntries.resize(m_VisibleObjects.size());
+			for (size_t i = 0; i < m_VisibleObjects.size(); i++)
 			{
-				return opaqueGeometry[a].SortKey < opaqueGeometry[b].SortKey;
-			});
+				uint64_t sortKey = opaqueGeometry[m_VisibleObjects[i]].SortKey;
+				m_SortEntries[i].Key = (sortKey & ~depthMask) | ((uint64_t)m_VisibleLODs[i] << lodShift) | ((sortKey & depthMask) >> 3);
+				m_SortEntries[i].Index = m_VisibleObjects[i];
+			}
+
+			RadixSort(m_SortEntries, m_SortScratchBuffer);
+
+			for (size_t i = 0; i < m_SortEntries.size(); i++)
+			{
+				m_VisibleObjects[i] = m_SortEntries[i].Index;
+				m_VisibleLODs[i] = (uint8_t)((m_SortEntries[i].Key >> lodShift) & 0x7);
+			}
 		}
 
-		m_InstanceBuffer.clear();
+		CullClusters(context);
 
+		m_InstanceIndices.resize(m_VisibleObjects.size());
+		m_InstanceMaterialIndices.resize(m_VisibleObjects.size());
+
+		// Transforms and material properties are already in the InstanceTable and MaterialDataTables,
+		// so only the slots of visible objects are uploaded
 		{
 			Grapple_PROFILE_SCOPE("FillInstacesData");
-			for (uint32_t objectIndex : m_VisibleObjects)
+			JobSystem::ParallelFor(m_VisibleObjects.size(), 4096, [this, &opaqueGeometry](size_t begin, size_t end, uint32_t threadIndex)
 			{
-				auto& instanceData = m_InstanceBuffer.emplace_back();
-				const auto& transform = opaqueGeometry[objectIndex].Transform;
-				instanceData.PackedTransform[0] = glm::vec4(transform.RotationScale[0], transform.Translation.x);
-				instanceData.PackedTransform[1] = glm::vec4(transform.RotationScale[1], transform.Translation.y);
-				instanceData.PackedTransform[2] = glm::vec4(transform.RotationScale[2], transform.Translation.z);
-			}
+				for (size_t instanceIndex = begin; instanceIndex < end; instanceIndex++)
+				{
+					const auto& object = opaqueGeometry[m_VisibleObjects[instanceIndex]];
+					m_InstanceIndices[instanceIndex] = object.InstanceSlot;
+					m_InstanceMaterialIndices[instanceIndex] = object.Material != nullptr ? object.Material->GetDataTableSlot() : 0;
+				}
+			});
 		}
 
-		size_t instanceDataSize = sizeof(InstanceData) * m_InstanceBuffer.size();
-		if (instanceDataSize > m_InstanceStorageBuffer->GetSize())
+		size_t instanceIndicesSize = sizeof(uint32_t) * m_InstanceIndices.size();
+		if (instanceIndicesSize > m_InstanceIndicesBuffer->GetSize())
 		{
-			m_InstanceStorageBuffer->Resize(instanceDataSize);
-			m_InstanceDataDescriptor->WriteStorageBuffer(m_InstanceStorageBuffer, 0);
+			m_InstanceIndicesBuffer->Resize(instanceIndicesSize);
+			m_InstanceMaterialIndicesBuffer->Resize(instanceIndicesSize);
+			m_InstanceDataDescriptor->WriteStorageBuffer(m_InstanceIndicesBuffer, 1);
+			m_InstanceDataDescriptor->WriteStorageBuffer(m_InstanceMaterialIndicesBuffer, 2);
 			m_InstanceDataDescriptor->FlushWrites();
 		}
 
-		m_InstanceStorageBuffer->SetData(MemorySpan::FromVector(m_InstanceBuffer), 0, commandBuffer);
+		UpdateInstanceDataDescriptor(opaqueGeometry.GetInstanceTable());
+
+		m_InstanceIndicesBuffer->SetData(MemorySpan::FromVector(m_InstanceIndices), 0, commandBuffer);
+		m_InstanceMaterialIndicesBuffer->SetData(MemorySpan::FromVector(m_InstanceMaterialIndices), 0, commandBuffer);
+
+		CollectBatches(opaqueGeometry);
+		FlushMaterialTables(commandBuffer);
+
+		if (m_UseIndirectDraws)
+			BuildIndirectCommands(commandBuffer);
 
 		Ref<FrameBuffer> renderTarget = context.GetRenderTarget();
 
@@ -95,81 +146,511 @@ namespace Grapple
 		commandBuffer->BeginRenderTarget(renderTarget);
 		commandBuffer->SetViewportAndScisors(Math::Rect(glm::vec2(0.0f, 0.0f), (glm::vec2)renderTarget->GetSize()));
 
-		Batch batch{};
+		if (m_UseIndirectDraws)
+		{
+			DrawBuckets(commandBuffer);
+		}
+		else
+		{
+			for (const Batch& batch : m_Batches)
+				FlushBatch(commandBuffer, batch);
+		}
 
-		for (uint32_t currentInstance = 0; currentInstance < (uint32_t)m_VisibleObjects.size(); currentInstance++)
+		commandBuffer->EndRenderTarget();
+		commandBuffer->StopTimer(m_Timer);
+	}
+
+	std::optional<float> GeometryPass::GetElapsedTime() const
+	{
+		return m_Timer->GetElapsedTime();
+	}
+
+	void GeometryPass::UpdateInstanceDataDescriptor(const InstanceTable& instanceTable)
+	{
+		if (instanceTable.GetBufferVersion() == m_InstanceTableVersion)
+			return;
+
+		m_InstanceDataDescriptor->WriteStorageBuffer(instanceTable.GetBuffer(), 0);
+		m_InstanceDataDescriptor->FlushWrites();
+		m_InstanceTableVersion = instanceTable.GetBufferVersion();
+	}
+
+	void GeometryPass::FlushMaterialTables(const Ref<CommandBuffer>& commandBuffer)
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		// Batches are sorted by shader, so each table is usually flushed once
+		const MaterialDataTable* lastTable = nullptr;
+		for (const Batch& batch : m_Batches)
 		{
-			uint32_t objectIndex = m_VisibleObjects[currentInstance];
-			const auto& object = opaqueGeometry[objectIndex];
+			if (batch.Material == nullptr || batch.Material->GetDataTable() == nullptr)
+				continue;
+
+			const Ref<MaterialDataTable>& table = batch.Material->GetDataTable();
+			if (table.get() == lastTable)
+				continue;
+
+			table->FlushUploads(commandBuffer);
+			lastTable = table.get();
+		}
+	}
 
-			if (batch.Mesh.get() != object.Mesh.get()
-				|| batch.SubMesh != object.SubMeshIndex)
+	void GeometryPass::CullObjects(const RenderGraphContext& context)
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		const RenderView& cameraView = context.GetRenderView();
+
+		FrustumPlanes planes{};
+		planes.SetFromViewAndProjection(cameraView.View, cameraView.InverseViewProjection, cameraView.ViewDirection);
+
+		const RendererSubmitionQueue& opaqueGeometry = context.GetSceneSubmition().OpaqueGeometrySubmitions;
+
+		const std::vector<uint32_t>& dynamicItems = opaqueGeometry.GetDynamicItems();
+
+		{
+			Grapple_PROFILE_SCOPE("ComputeBounds");
+
+			m_FrustumCuller.Resize(dynamicItems.size());
+			JobSystem::ParallelFor(dynamicItems.size(), 1024, [this, &opaqueGeometry, &dynamicItems](size_t begin, size_t end, uint32_t threadIndex)
 			{
-				batch.InstanceCount = currentInstance - batch.BaseInstance;
+				for (size_t i = begin; i < end; i++)
+					m_FrustumCuller.SetBounds(i, opaqueGeometry[dynamicItems[i]].Bounds);
+			});
+		}
 
-				FlushBatch(commandBuffer, batch);
+		{
+			Grapple_PROFILE_SCOPE("CullDynamicObjects");
 
-				batch.BaseInstance = currentInstance;
-				batch.InstanceCount = 0;
-				batch.Mesh = object.Mesh;
-				batch.SubMesh = object.SubMeshIndex;
-			}
+			m_ThreadVisibleObjects.resize(JobSystem::GetThreadsCount());
+			for (auto& visibleObjects : m_ThreadVisibleObjects)
+				visibleObjects.clear();
 
-			if (object.Material.get() != batch.Material.get())
+			JobSystem::ParallelFor(dynamicItems.size(), 4096, [this, &planes, &dynamicItems](size_t begin, size_t end, uint32_t threadIndex)
 			{
-				batch.InstanceCount = currentInstance - batch.BaseInstance;
+				std::vector<uint32_t>& visibleObjects = m_ThreadVisibleObjects[threadIndex];
+				size_t firstVisible = visibleObjects.size();
 
-				FlushBatch(commandBuffer, batch);
-				batch.BaseInstance = currentInstance;
-				batch.InstanceCount = 0;
-				batch.Material = object.Material;
+				m_FrustumCuller.Cull(planes, begin, end - begin, visibleObjects);
+
+				// Culler returns indices into the dynamic items list
+				for (size_t i = firstVisible; i < visibleObjects.size(); i++)
+					visibleObjects[i] = dynamicItems[visibleObjects[i]];
+			});
+
+			for (const auto& visibleObjects : m_ThreadVisibleObjects)
+				m_VisibleObjects.insert(m_VisibleObjects.end(), visibleObjects.begin(), visibleObjects.end());
+		}
+
+		opaqueGeometry.GetStaticGeometry().CullSubMeshes(planes.Planes, FrustumPlanes::PlanesCount, m_VisibleObjects);
+	}
+
+	void GeometryPass::CullOccludedObjects(const RenderGraphContext& context)
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		const RenderView& cameraView = context.GetRenderView();
+		const RendererSubmitionQueue& opaqueGeometry = context.GetSceneSubmition().OpaqueGeometrySubmitions;
+
+		m_Occluders.clear();
+		for (uint32_t visibleIndex = 0; visibleIndex < (uint32_t)m_VisibleObjects.size(); visibleIndex++)
+		{
+			const auto& item = opaqueGeometry[m_VisibleObjects[visibleIndex]];
+			if (!HAS_BIT(item.Flags, MeshRenderFlags::Occluder))
+				continue;
+
+			// Occluder geometry covers the whole mesh, so it is only rasterized for the first sub mesh
+			if (item.Mesh->HasOccluderGeometry() && item.SubMeshIndex != 0)
+				continue;
+
+			float distanceSquared = glm::max(glm::distance2(item.Bounds.GetCenter(), cameraView.Position), cameraView.Near * cameraView.Near);
+
+			Occluder& occluder = m_Occluders.emplace_back();
+			occluder.VisibleIndex = visibleIndex;
+			occluder.ScreenSize = glm::length2(item.Bounds.GetSize()) / distanceSquared;
+		}
+
+		if (m_Occluders.size() == 0)
+			return;
+
+		// Only the occluders covering the largest part of the screen are rasterized
+		constexpr size_t maxOccluders = 64;
+		if (m_Occluders.size() > maxOccluders)
+		{
+			std::nth_element(m_Occluders.begin(), m_Occluders.begin() + maxOccluders, m_Occluders.end(), [](const Occluder& a, const Occluder& b) -> bool
+			{
+				return a.ScreenSize > b.ScreenSize;
+			});
+
+			m_Occluders.resize(maxOccluders);
+		}
+
+		m_OcclusionResults.assign(m_VisibleObjects.size(), 0);
+
+		{
+			Grapple_PROFILE_SCOPE("RasterizeOccluders");
+
+			m_OcclusionCuller.BeginFrame(cameraView.ViewProjection);
+			for (const Occluder& occluder : m_Occluders)
+			{
+				const auto& item = opaqueGeometry[m_VisibleObjects[occluder.VisibleIndex]];
+				if (item.Mesh->HasOccluderGeometry())
+					m_OcclusionCuller.RasterizeTriangles(item.Mesh->GetOccluderVertices(), item.Mesh->GetOccluderIndices(), item.Transform);
+				else
+					m_OcclusionCuller.RasterizeBox(item.Mesh->GetSubMeshes()[item.SubMeshIndex].Bounds, item.Transform);
+
+				// Occluders are not tested, so that they don't get hidden by their own depth
+				m_OcclusionResults[occluder.VisibleIndex] = 2;
 			}
+
+			m_OcclusionCuller.BuildHierarchy();
 		}
 
-		batch.InstanceCount = (uint32_t)m_VisibleObjects.size() - batch.BaseInstance;
-		FlushBatch(commandBuffer, batch);
+		m_Statistics.OccludersRasterized += (uint32_t)m_Occluders.size();
 
-		commandBuffer->EndRenderTarget();
-		commandBuffer->StopTimer(m_Timer);
+		if (m_OcclusionCuller.GetRasterizedTrianglesCount() == 0)
+			return;
+
+		{
+			Grapple_PROFILE_SCOPE("TestBounds");
+			JobSystem::ParallelFor(m_VisibleObjects.size(), 1024, [this, &opaqueGeometry](size_t begin, size_t end, uint32_t threadIndex)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					if (m_OcclusionResults[i] == 0 && m_OcclusionCuller.IsOccluded(opaqueGeometry[m_VisibleObjects[i]].Bounds))
+						m_OcclusionResults[i] = 1;
+				}
+			});
+		}
+
+		size_t visibleCount = 0;
+		for (size_t i = 0; i < m_VisibleObjects.size(); i++)
+		{
+			if (m_OcclusionResults[i] != 1)
+				m_VisibleObjects[visibleCount++] = m_VisibleObjects[i];
+		}
+
+		m_Statistics.ObjectsOccluded += (uint32_t)(m_VisibleObjects.size() - visibleCount);
+		m_VisibleObjects.resize(visibleCount);
 	}
 
-	std::optional<float> GeometryPass::GetElapsedTime() const
+	void GeometryPass::SelectLODs(const RenderGraphContext& context)
 	{
-		return m_Timer->GetElapsedTime();
+		Grapple_PROFILE_FUNCTION();
+
+		// Projected size has to change by this fraction past the LOD threshold before the LOD is switched
+		constexpr float hysteresis = 0.1f;
+
+		const RenderView& cameraView = context.GetRenderView();
+		const RendererSubmitionQueue& opaqueGeometry = context.GetSceneSubmition().OpaqueGeometrySubmitions;
+		const InstanceTable& instanceTable = opaqueGeometry.GetInstanceTable();
+
+		size_t slotsCount = instanceTable.GetSlotsCount();
+		if (m_InstanceLODs.size() < slotsCount)
+			m_InstanceLODs.resize(slotsCount);
+
+		m_VisibleLODs.resize(m_VisibleObjects.size());
+
+		// Converts radius divided by distance into a fraction of the viewport height
+		float projectionScale = glm::abs(cameraView.Projection[1][1]) * context.GetViewport().GetLODBias();
+		bool isOrthographic = cameraView.Projection[3][3] == 1.0f;
+
+		JobSystem::ParallelFor(m_VisibleObjects.size(), 1024, [this, &opaqueGeometry, &instanceTable, &cameraView, projectionScale, isOrthographic, hysteresis](size_t begin, size_t end, uint32_t threadIndex)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				const auto& item = opaqueGeometry[m_VisibleObjects[i]];
+				const Mesh& mesh = *item.Mesh;
+				if (mesh.GetLODCount() == 1)
+				{
+					m_VisibleLODs[i] = 0;
+					continue;
+				}
+
+				// All sub meshes of an instance use the bounds of the whole mesh, so they always select the same LOD
+				const Math::Compact3DTransform& transform = item.Transform;
+				float scale = glm::max(glm::length(transform.RotationScale[0]), glm::max(glm::length(transform.RotationScale[1]), glm::length(transform.RotationScale[2])));
+				float radius = glm::length(mesh.GetBounds().GetExtents()) * scale;
+
+				float screenSize = radius * projectionScale;
+				if (!isOrthographic)
+				{
+					glm::vec3 center = transform.RotationScale * mesh.GetBounds().GetCenter() + transform.Translation;
+					screenSize /= glm::max(glm::distance(center, cameraView.Position), cameraView.Near);
+				}
+
+				uint32_t lod = mesh.SelectLOD(screenSize);
+
+				// Slots of objects without an id and of removed objects are reused, in which case there is no previous LOD
+				const InstanceLOD& previous = m_InstanceLODs[item.InstanceSlot];
+				uint32_t previousLOD = lod;
+				if (previous.SlotAllocationId == instanceTable.GetSlotAllocationId(item.InstanceSlot))
+					previousLOD = previous.LOD;
+
+				// Only switch to a coarser LOD once the mesh got noticeably smaller than the threshold and vice versa
+				if (lod > previousLOD)
+					lod = glm::max(mesh.SelectLOD(screenSize * (1.0f + hysteresis)), previousLOD);
+				else if (lod < previousLOD)
+					lod = glm::min(mesh.SelectLOD(screenSize * (1.0f - hysteresis)), previousLOD);
+
+				m_VisibleLODs[i] = (uint8_t)lod;
+			}
+		});
+
+		for (size_t i = 0; i < m_VisibleObjects.size(); i++)
+		{
+			uint32_t slot = opaqueGeometry[m_VisibleObjects[i]].InstanceSlot;
+
+			InstanceLOD& instanceLOD = m_InstanceLODs[slot];
+			instanceLOD.SlotAllocationId = instanceTable.GetSlotAllocationId(slot);
+			instanceLOD.LOD = m_VisibleLODs[i];
+		}
 	}
 
-	void GeometryPass::CullObjects(const RenderGraphContext& context)
+	void GeometryPass::CullClusters(const RenderGraphContext& context)
 	{
 		Grapple_PROFILE_FUNCTION();
 
-		Math::AABB objectAABB;
+		// Drawing an instance as ranges of meshlets prevents it from being instanced, so only large sub meshes are cluster culled
+		constexpr uint32_t minMeshletsCount = 16;
 
 		const RenderView& cameraView = context.GetRenderView();
+		const RendererSubmitionQueue& opaqueGeometry = context.GetSceneSubmition().OpaqueGeometrySubmitions;
 
 		FrustumPlanes planes{};
 		planes.SetFromViewAndProjection(cameraView.View, cameraView.InverseViewProjection, cameraView.ViewDirection);
 
-		const RendererSubmitionQueue& opaqueGeometry = context.GetSceneSubmition().OpaqueGeometrySubmitions;
+		// Meshlet cones are tested against the view position, which doesn't work for orthographic projections
+		bool isOrthographic = cameraView.Projection[3][3] == 1.0f;
+
+		m_VisibleClusterRanges.assign(m_VisibleObjects.size(), ClusterRanges{});
+		m_ClusterRanges.clear();
+
+		m_ThreadClusterRanges.resize(JobSystem::GetThreadsCount());
+		for (auto& ranges : m_ThreadClusterRanges)
+			ranges.clear();
+
+		JobSystem::ParallelFor(m_VisibleObjects.size(), 256, [this, &opaqueGeometry, &planes, &cameraView, isOrthographic, minMeshletsCount](size_t begin, size_t end, uint32_t threadIndex)
+		{
+			std::vector<MeshIndexRange>& ranges = m_ThreadClusterRanges[threadIndex];
+			for (size_t i = begin; i < end; i++)
+			{
+				const auto& item = opaqueGeometry[m_VisibleObjects[i]];
+				const SubMesh& subMesh = item.Mesh->GetSubMesh(item.SubMeshIndex, m_VisibleLODs[i]);
+				if (subMesh.MeshletsCount < minMeshletsCount)
+					continue;
+
+				const Material* material = item.Material.get();
+				bool cullBackFaces = !isOrthographic
+					&& material != nullptr
+					&& material->GetShader() != nullptr
+					&& material->GetShader()->GetFeatures().Culling == CullingMode::Back;
+
+				size_t firstRange = ranges.size();
+				uint32_t visibleIndices = ClusterCuller::Cull(*item.Mesh, subMesh, item.Transform, planes, cameraView.Position, cullBackFaces, ranges);
+
+				ClusterRanges& result = m_VisibleClusterRanges[i];
+				if (visibleIndices == 0)
+				{
+					result.Culled = true;
+				}
+				else if (visibleIndices == subMesh.IndicesCount)
+				{
+					// All meshlets are visible, so the instance is drawn as a part of a regular batch
+					ranges.resize(firstRange);
+				}
+				else
+				{
+					result.ThreadIndex = threadIndex;
+					result.FirstRange = (uint32_t)firstRange;
+					result.RangesCount = (uint32_t)(ranges.size() - firstRange);
+				}
+			}
+		});
+
+		size_t visibleCount = 0;
+		for (size_t i = 0; i < m_VisibleObjects.size(); i++)
+		{
+			ClusterRanges result = m_VisibleClusterRanges[i];
+			if (result.Culled || result.RangesCount > 0)
+			{
+				const auto& item = opaqueGeometry[m_VisibleObjects[i]];
+				uint32_t culledIndices = item.Mesh->GetSubMesh(item.SubMeshIndex, m_VisibleLODs[i]).IndicesCount;
+
+				const std::vector<MeshIndexRange>& threadRanges = m_ThreadClusterRanges[result.ThreadIndex];
+				for (uint32_t rangeIndex = 0; rangeIndex < result.RangesCount; rangeIndex++)
+					culledIndices -= threadRanges[result.FirstRange + rangeIndex].IndicesCount;
+
+				m_Statistics.ObjectsClusterCulled++;
+				m_Statistics.TrianglesCulledByClusters += culledIndices / 3;
+
+				if (result.Culled)
+					continue;
+
+				uint32_t firstRange = (uint32_t)m_ClusterRanges.size();
+				m_ClusterRanges.insert(m_ClusterRanges.end(),
+					threadRanges.begin() + result.FirstRange,
+					threadRanges.begin() + result.FirstRange + result.RangesCount);
+
+				result.FirstRange = firstRange;
+			}
+
+			m_VisibleObjects[visibleCount] = m_VisibleObjects[i];
+			m_VisibleLODs[visibleCount] = m_VisibleLODs[i];
+			m_VisibleClusterRanges[visibleCount] = result;
+			visibleCount++;
+		}
+
+		m_VisibleObjects.resize(visibleCount);
+		m_VisibleLODs.resize(visibleCount);
+		m_VisibleClusterRanges.resize(visibleCount);
+	}
+
+	void GeometryPass::CollectBatches(const RendererSubmitionQueue& opaqueGeometry)
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		m_Batches.clear();
+
+		Batch batch{};
+		for (uint32_t currentInstance = 0; currentInstance < (uint32_t)m_VisibleObjects.size(); currentInstance++)
+		{
+			const auto& object = opaqueGeometry[m_VisibleObjects[currentInstance]];
+			const ClusterRanges& clusterRanges = m_VisibleClusterRanges[currentInstance];
+
+			// Instances with culled meshlets draw different ranges of indices, so they can't be instanced
+			if (currentInstance > 0
+				&& batch.RangesCount == 0
+				&& clusterRanges.RangesCount == 0
+				&& batch.Mesh.get() == object.Mesh.get()
+				&& batch.SubMesh == object.SubMeshIndex
+				&& batch.LOD == m_VisibleLODs[currentInstance]
+				&& Material::CanShareBatch(batch.Material.get(), object.Material.get()))
+			{
+				continue;
+			}
+
+			if (currentInstance > 0)
+			{
+				batch.InstanceCount = currentInstance - batch.BaseInstance;
+				m_Batches.push_back(batch);
+			}
+
+			batch.Mesh = object.Mesh;
+			batch.Material = object.Material;
+			batch.SubMesh = object.SubMeshIndex;
+			batch.LOD = m_VisibleLODs[currentInstance];
+			batch.BaseInstance = currentInstance;
+			batch.FirstRange = clusterRanges.FirstRange;
+			batch.RangesCount = clusterRanges.RangesCount;
+		}
+
+		if (m_VisibleObjects.size() > 0)
+		{
+			batch.InstanceCount = (uint32_t)m_VisibleObjects.size() - batch.BaseInstance;
+			m_Batches.push_back(batch);
+		}
+	}
+
+	void GeometryPass::BuildIndirectCommands(const Ref<CommandBuffer>& commandBuffer)
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		// Batches are sorted by material, however meshes stored in the same GeometryPool buffers don't have to be adjacent.
+		// Reorder batches of each material by the buffers and then by mesh, so that they can share a single indirect draw
+		size_t materialStart = 0;
+		for (size_t i = 1; i <= m_Batches.size(); i++)
+		{
+			if (i < m_Batches.size() && Material::CanShareBatch(m_Batches[i].Material.get(), m_Batches[materialStart].Material.get()))
+				continue;
+
+			std::sort(m_Batches.begin() + materialStart, m_Batches.begin() + i, [](const Batch& a, const Batch& b) -> bool
+			{
+				if (a.Mesh->GetVertexFormat() != b.Mesh->GetVertexFormat())
+					return a.Mesh->GetVertexFormat() < b.Mesh->GetVertexFormat();
+				if (a.Mesh->GetIndexFormat() != b.Mesh->GetIndexFormat())
+					return a.Mesh->GetIndexFormat() < b.Mesh->GetIndexFormat();
+				if (a.Mesh.get() != b.Mesh.get())
+					return a.Mesh.get() < b.Mesh.get();
+				if (a.SubMesh != b.SubMesh)
+					return a.SubMesh < b.SubMesh;
+				return a.LOD < b.LOD;
+			});
+
+			materialStart = i;
+		}
+
+		m_Buckets.clear();
+		m_IndirectCommands.clear();
 
-		for (size_t i = 0; i < opaqueGeometry.GetSize(); i++)
+		for (const Batch& batch : m_Batches)
 		{
-			const auto& object = opaqueGeometry[i];
-			objectAABB = Math::SIMD::TransformAABB(object.Mesh->GetSubMeshes()[object.SubMeshIndex].Bounds, object.Transform.ToMatrix4x4());
+			const SubMesh& subMesh = batch.Mesh->GetSubMesh(batch.SubMesh, batch.LOD);
+			uint32_t baseIndex = batch.Mesh->GetBaseIndex();
+			uint32_t baseVertex = batch.Mesh->GetBaseVertex();
 
-			bool intersects = true;
-			for (size_t i = 0; i < planes.PlanesCount; i++)
+			uint32_t firstCommand = (uint32_t)m_IndirectCommands.size();
+			uint32_t commandsCount = glm::max(batch.RangesCount, 1u);
+			for (uint32_t i = 0; i < commandsCount; i++)
 			{
-				if (!objectAABB.IntersectsOrInFrontOfPlane(planes.Planes[i]))
+				DrawIndexedIndirectCommand& command = m_IndirectCommands.emplace_back();
+				command.IndexCount = subMesh.IndicesCount;
+				command.InstanceCount = batch.InstanceCount;
+				command.FirstIndex = baseIndex + subMesh.BaseIndex;
+				command.VertexOffset = (int32_t)(baseVertex + subMesh.BaseVertex);
+				command.FirstInstance = batch.BaseInstance;
+
+				if (batch.RangesCount > 0)
 				{
-					intersects = false;
-					break;
+					const MeshIndexRange& range = m_ClusterRanges[batch.FirstRange + i];
+					command.IndexCount = range.IndicesCount;
+					command.FirstIndex = baseIndex + range.BaseIndex;
 				}
 			}
 
-			if (intersects)
+			if (m_Buckets.size() > 0
+				&& m_Buckets.back().Mesh->SharesBuffersWith(*batch.Mesh)
+				&& Material::CanShareBatch(m_Buckets.back().Material.get(), batch.Material.get()))
 			{
-				m_VisibleObjects.push_back((uint32_t)i);
+				m_Buckets.back().CommandsCount += commandsCount;
+				continue;
 			}
+
+			IndirectBucket& bucket = m_Buckets.emplace_back();
+			bucket.Mesh = batch.Mesh;
+			bucket.Material = batch.Material;
+			bucket.FirstCommand = firstCommand;
+			bucket.CommandsCount = commandsCount;
+		}
+
+		if (m_IndirectCommands.size() == 0)
+			return;
+
+		size_t commandsSize = sizeof(DrawIndexedIndirectCommand) * m_IndirectCommands.size();
+		if (commandsSize > m_IndirectCommandsBuffer->GetSize())
+			m_IndirectCommandsBuffer->Resize(commandsSize);
+
+		m_IndirectCommandsBuffer->SetData(MemorySpan::FromVector(m_IndirectCommands), 0, commandBuffer);
+	}
+
+	void GeometryPass::DrawBuckets(const Ref<CommandBuffer>& commandBuffer)
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		for (const IndirectBucket& bucket : m_Buckets)
+		{
+			size_t commandsOffset = sizeof(DrawIndexedIndirectCommand) * (size_t)bucket.FirstCommand;
+
+			ApplyBatchMaterial(commandBuffer, bucket.Material);
+			commandBuffer->DrawMeshIndexedIndirect(bucket.Mesh, m_IndirectCommandsBuffer, commandsOffset, bucket.CommandsCount);
+
+			m_Statistics.IndirectDrawCallCount++;
+		}
+
+		for (const Batch& batch : m_Batches)
+		{
+			m_Statistics.DrawCallCount += glm::max(batch.RangesCount, 1u);
+			m_Statistics.DrawCallsSavedByInstancing += batch.InstanceCount - 1;
 		}
 	}
 
@@ -180,14 +661,36 @@ namespace Grapple
 		if (batch.InstanceCount == 0)
 			return;
 
-		m_Statistics.DrawCallCount++;
 		m_Statistics.DrawCallsSavedByInstancing += batch.InstanceCount - 1;
 
-		if (batch.Material == nullptr || batch.Material->GetShader() == nullptr)
+		ApplyBatchMaterial(commandBuffer, batch.Material);
+
+		const SubMesh& subMesh = batch.Mesh->GetSubMesh(batch.SubMesh, batch.LOD);
+		if (batch.RangesCount == 0)
+		{
+			m_Statistics.DrawCallCount++;
+			commandBuffer->DrawMeshIndexed(batch.Mesh, subMesh, batch.BaseInstance, batch.InstanceCount);
+			return;
+		}
+
+		// Visible meshlets are drawn as parts of the sub mesh
+		SubMesh visiblePart = subMesh;
+		for (uint32_t i = 0; i < batch.RangesCount; i++)
+		{
+			const MeshIndexRange& range = m_ClusterRanges[batch.FirstRange + i];
+			visiblePart.BaseIndex = range.BaseIndex;
+			visiblePart.IndicesCount = range.IndicesCount;
+
+			m_Statistics.DrawCallCount++;
+			commandBuffer->DrawMeshIndexed(batch.Mesh, visiblePart, batch.BaseInstance, batch.InstanceCount);
+		}
+	}
+
+	void GeometryPass::ApplyBatchMaterial(const Ref<CommandBuffer>& commandBuffer, const Ref<const Material>& material)
+	{
+		if (material == nullptr || material->GetShader() == nullptr)
 			commandBuffer->ApplyMaterial(Renderer::GetErrorMaterial());
 		else
-			commandBuffer->ApplyMaterial(batch.Material);
-
-		commandBuffer->DrawMeshIndexed(batch.Mesh, batch.SubMesh, batch.BaseInstance, batch.InstanceCount);
+			commandBuffer->ApplyMaterial(material);
 	}
 }
@@ -1,7 +1,12 @@
 #pragma once
 
+#include "Grapple/Renderer/CommandBuffer.h"
 #include "Grapple/Renderer/RendererSubmitionQueue.h"
 #include "Grapple/Renderer/RendererStatistics.h"
+#include "Grapple/Renderer/FrustumCuller.h"
+#include "Grapple/Renderer/ClusterCuller.h"
+#include "Grapple/Renderer/OcclusionCuller.h"
+#include "Grapple/Renderer/RadixSort.h"
 
 #include "Grapple/Renderer/RenderGraph/RenderGraphPass.h"
 
@@ -29,25 +34,105 @@ namespace Grapple
 			Ref<const Mesh> Mesh = nullptr;
 			Ref<const Material> Material = nullptr;
 			uint32_t SubMesh = 0;
+			uint32_t LOD = 0;
 			uint32_t BaseInstance = 0;
 			uint32_t InstanceCount = 0;
+
+			// Ranges of visible meshlets in `m_ClusterRanges`, the whole sub mesh is drawn when there are none
+			uint32_t FirstRange = 0;
+			uint32_t RangesCount = 0;
+		};
+
+		// Result of cluster culling of a visible object
+		struct ClusterRanges
+		{
+			// Index of the thread, whose list the ranges were written to, before they are gathered into `m_ClusterRanges`
+			uint32_t ThreadIndex = 0;
+			uint32_t FirstRange = 0;
+			uint32_t RangesCount = 0;
+			bool Culled = false;
+		};
+
+		struct Occluder
+		{
+			// Index in the visible objects list
+			uint32_t VisibleIndex = 0;
+			float ScreenSize = 0.0f;
 		};
 
-		struct InstanceData
+		// Consecutive batches, which can share a material and the GeometryPool buffers and are drawn with a single indirect draw call.
+		// The mesh of the first batch is only used for binding the buffers
+		struct IndirectBucket
 		{
-			glm::vec4 PackedTransform[3];
+			Ref<const Mesh> Mesh = nullptr;
+			Ref<const Material> Material = nullptr;
+			uint32_t FirstCommand = 0;
+			uint32_t CommandsCount = 0;
 		};
-	
+
+		void UpdateInstanceDataDescriptor(const InstanceTable& instanceTable);
+		void FlushMaterialTables(const Ref<CommandBuffer>& commandBuffer);
 		void CullObjects(const RenderGraphContext& context);
+		void CullOccludedObjects(const RenderGraphContext& context);
+		void SelectLODs(const RenderGraphContext& context);
+		void CullClusters(const RenderGraphContext& context);
+		void CollectBatches(const RendererSubmitionQueue& opaqueGeometry);
+		void BuildIndirectCommands(const Ref<CommandBuffer>& commandBuffer);
+		void DrawBuckets(const Ref<CommandBuffer>& commandBuffer);
 		void FlushBatch(const Ref<CommandBuffer>& commandBuffer, const Batch& batch);
+		void ApplyBatchMaterial(const Ref<CommandBuffer>& commandBuffer, const Ref<const Material>& material);
 	private:
 		Ref<GPUTimer> m_Timer = nullptr;
 
 		RendererStatistics& m_Statistics;
+		FrustumCuller m_FrustumCuller;
 		std::vector<uint32_t> m_VisibleObjects;
-		std::vector<InstanceData> m_InstanceBuffer;
+		std::vector<std::vector<uint32_t>> m_ThreadVisibleObjects;
+
+		OcclusionCuller m_OcclusionCuller;
+		std::vector<Occluder> m_Occluders;
+
+		// Per visible object: 0 - visible, 1 - occluded, 2 - occluder, which is always kept
+		std::vector<uint8_t> m_OcclusionResults;
+
+		// LOD of each visible object
+		std::vector<uint8_t> m_VisibleLODs;
+
+		struct InstanceLOD
+		{
+			// Allocation of the instance slot, which selected the LOD
+			uint64_t SlotAllocationId = 0;
+			uint8_t LOD = 0;
+		};
+
+		// LODs selected during the previous frame indexed by instance slot, used for hysteresis.
+		// Ignored once the slot is allocated to a different object
+		std::vector<InstanceLOD> m_InstanceLODs;
+
+		// Visible meshlets of objects, which are drawn as ranges of their sub mesh's indices. Indexed the same way as the visible objects
+		std::vector<ClusterRanges> m_VisibleClusterRanges;
+		std::vector<MeshIndexRange> m_ClusterRanges;
+		std::vector<std::vector<MeshIndexRange>> m_ThreadClusterRanges;
+
+		std::vector<SortEntry> m_SortEntries;
+		std::vector<SortEntry> m_SortScratchBuffer;
+
+		// Slots in the InstanceTable for each drawn instance
+		std::vector<uint32_t> m_InstanceIndices;
+		Ref<ShaderStorageBuffer> m_InstanceIndicesBuffer = nullptr;
+
+		// Slots in the MaterialDataTable of each drawn instance's material
+		std::vector<uint32_t> m_InstanceMaterialIndices;
+		Ref<ShaderStorageBuffer> m_InstanceMaterialIndicesBuffer = nullptr;
 
-		Ref<ShaderStorageBuffer> m_InstanceStorageBuffer = nullptr;
 		Ref<DescriptorSet> m_InstanceDataDescriptor = nullptr;
+		uint32_t m_InstanceTableVersion = 0;
+
+		std::vector<Batch> m_Batches;
+
+		bool m_UseIndirectDraws = false;
+		std::vector<IndirectBucket> m_Buckets;
+		std::vector<DrawIndexedIndirectCommand> m_IndirectCommands;
+		Ref<ShaderStorageBuffer> m_IndirectCommandsBuffer = nullptr;
 	};
 }
@@ -7,6 +7,7 @@
 #include "Grapple/Renderer/ShaderStorageBuffer.h"
 #include "Grapple/Renderer/CommandBuffer.h"
 #include "Grapple/Renderer/GPUTimer.h"
+#include "Grapple/Renderer/SceneSubmition.h"
 
 #include "Grapple/Renderer/Passes/ShadowPass.h"
 
@@ -20,11 +21,11 @@ namespace Grapple
 {
 	ShadowCascadePass::ShadowCascadePass(RendererStatistics& statistics,
 		const ShadowCascadeData& cascadeData,
-		const std::vector<Math::Compact3DTransform>& filteredTransforms,
+		const std::vector<uint32_t>& filteredInstances,
 		const std::vector<VisibleSubMeshRange>& visibleSubMeshRanges)
 		: m_Statistics(statistics),
 		m_CascadeData(cascadeData),
-		m_FilteredTransforms(filteredTransforms),
+		m_FilteredInstances(filteredInstances),
 		m_VisibleSubMeshRanges(visibleSubMeshRanges)
 	{
 		Grapple_PROFILE_FUNCTION();
@@ -37,9 +38,9 @@ namespace Grapple
 		m_CameraDescriptor->FlushWrites();
 
 		constexpr size_t maxInstanceCount = 16;
-		m_InstanceBuffer = ShaderStorageBuffer::Create(maxInstanceCount * sizeof(InstanceData));
+		m_InstanceIndicesBuffer = ShaderStorageBuffer::Create(maxInstanceCount * sizeof(uint32_t));
 		m_InstanceBufferDescriptor = Renderer::GetInstanceDataDescriptorSetPool()->AllocateSet();
-		m_InstanceBufferDescriptor->WriteStorageBuffer(m_InstanceBuffer, 0);
+		m_InstanceBufferDescriptor->WriteStorageBuffer(m_InstanceIndicesBuffer, 1);
 		m_InstanceBufferDescriptor->FlushWrites();
 	}
 
@@ -70,39 +71,29 @@ namespace Grapple
 		{
 			Grapple_PROFILE_SCOPE("FillInstanceData");
 
-			m_InstanceDataBuffer.clear();
+			m_InstanceIndices.clear();
 
 			for (const auto& batch : m_CascadeData.Batches)
 			{
 				for (uint32_t i = 0; i < batch.Count; i++)
-				{
-					auto& instanceData = m_InstanceDataBuffer.emplace_back();
-					const auto& transform = m_FilteredTransforms[batch.FirstEntryIndex + i];
-					instanceData.PackedTransform[0] = glm::vec4(transform.RotationScale[0], transform.Translation.x);
-					instanceData.PackedTransform[1] = glm::vec4(transform.RotationScale[1], transform.Translation.y);
-					instanceData.PackedTransform[2] = glm::vec4(transform.RotationScale[2], transform.Translation.z);
-				}
+					m_InstanceIndices.push_back(m_FilteredInstances[batch.FirstEntryIndex + i]);
 			}
 
 			for (const auto& visibleMesh : m_CascadeData.PartiallyVisible)
-			{
-				auto& instanceData = m_InstanceDataBuffer.emplace_back();
-				const auto& transform = visibleMesh.Transform;
-				instanceData.PackedTransform[0] = glm::vec4(transform.RotationScale[0], transform.Translation.x);
-				instanceData.PackedTransform[1] = glm::vec4(transform.RotationScale[1], transform.Translation.y);
-				instanceData.PackedTransform[2] = glm::vec4(transform.RotationScale[2], transform.Translation.z);
-			}
+				m_InstanceIndices.push_back(visibleMesh.InstanceSlot);
 		}
 
-		size_t instanceDataSize = sizeof(InstanceData) * m_InstanceDataBuffer.size();
-		if (instanceDataSize > m_InstanceBuffer->GetSize())
+		size_t instanceIndicesSize = sizeof(uint32_t) * m_InstanceIndices.size();
+		if (instanceIndicesSize > m_InstanceIndicesBuffer->GetSize())
 		{
-			m_InstanceBuffer->Resize(instanceDataSize);
-			m_InstanceBufferDescriptor->WriteStorageBuffer(m_InstanceBuffer, 0);
+			m_InstanceIndicesBuffer->Resize(instanceIndicesSize);
+			m_InstanceBufferDescriptor->WriteStorageBuffer(m_InstanceIndicesBuffer, 1);
 			m_InstanceBufferDescriptor->FlushWrites();
 		}
 
-		m_InstanceBuffer->SetData(MemorySpan::FromVector(m_InstanceDataBuffer), 0, commandBuffer);
+		UpdateInstanceDataDescriptor(context.GetSceneSubmition().OpaqueGeometrySubmitions.GetInstanceTable());
+
+		m_InstanceIndicesBuffer->SetData(MemorySpan::FromVector(m_InstanceIndices), 0, commandBuffer);
 
 		commandBuffer->StartTimer(m_Timer);
 
@@ -117,6 +108,16 @@ namespace Grapple
 		commandBuffer->StopTimer(m_Timer);
 	}
 
+	void ShadowCascadePass::UpdateInstanceDataDescriptor(const InstanceTable& instanceTable)
+	{
+		if (instanceTable.GetBufferVersion() == m_InstanceTableVersion)
+			return;
+
+		m_InstanceBufferDescriptor->WriteStorageBuffer(instanceTable.GetBuffer(), 0);
+		m_InstanceBufferDescriptor->FlushWrites();
+		m_InstanceTableVersion = instanceTable.GetBufferVersion();
+	}
+
 	void ShadowCascadePass::DrawCascade(const RenderGraphContext& context, const Ref<CommandBuffer>& commandBuffer)
 	{
 		Grapple_PROFILE_FUNCTION();
@@ -23,18 +23,13 @@ namespace Grapple
 
 		ShadowCascadePass(RendererStatistics& statistics,
 			const ShadowCascadeData& cascadeData,
-			const std::vector<Math::Compact3DTransform>& filteredTransforms,
+			const std::vector<uint32_t>& filteredInstances,
 			const std::vector<VisibleSubMeshRange>& visibleSubMeshRanges);
 
 		~ShadowCascadePass();
 
 		void OnRender(const RenderGraphContext& context, Ref<CommandBuffer> commandBuffer) override;
 	public:
-		struct InstanceData
-		{
-			glm::vec4 PackedTransform[3];
-		};
-
 		struct Batch
 		{
 			Ref<const Mesh> Mesh = nullptr;
@@ -44,11 +39,12 @@ namespace Grapple
 		};
 	private:
 		void DrawCascade(const RenderGraphContext& context, const Ref<CommandBuffer>& commandBuffer);
+		void UpdateInstanceDataDescriptor(const InstanceTable& instanceTable);
 	private:
 		RendererStatistics& m_Statistics;
 
 		const ShadowCascadeData& m_CascadeData;
-		const std::vector<Math::Compact3DTransform>& m_FilteredTransforms;
+		const std::vector<uint32_t>& m_FilteredInstances;
 		const std::vector<VisibleSubMeshRange>& m_VisibleSubMeshRanges;
 
 		Ref<GPUTimer> m_Timer = nullptr;
@@ -56,9 +52,11 @@ namespace Grapple
 		Ref<UniformBuffer> m_CameraBuffer = nullptr;
 		Ref<DescriptorSet> m_CameraDescriptor = nullptr;
 
-		Ref<ShaderStorageBuffer> m_InstanceBuffer = nullptr;
-		Ref<DescriptorSet> m_InstanceBufferDescriptor = nullptr;
+		// Slots in the InstanceTable for each drawn instance
+		std::vector<uint32_t> m_InstanceIndices;
+		Ref<ShaderStorageBuffer> m_InstanceIndicesBuffer = nullptr;
 
-		std::vector<InstanceData> m_InstanceDataBuffer;
+		Ref<DescriptorSet> m_InstanceBufferDescriptor = nullptr;
+		uint32_t m_InstanceTableVersion = 0;
 	};
 }
@@ -12,11 +12,16 @@
 
 #include "Grapple/Math/SIMD.h"
 
+#include "Grapple/Core/JobSystem.h"
+
 #include "Grapple/Platform/Vulkan/VulkanCommandBuffer.h"
 #include "Grapple/Platform/Vulkan/VulkanContext.h"
 
 #include "GrappleCore/Profiler/Profiler.h"
 
+#include <algorithm>
+#include <cfloat>
+
 namespace Grapple
 {
 	ShadowPass::ShadowPass()
@@ -43,7 +48,7 @@ namespace Grapple
 				cascadeData.PartiallyVisible.clear();
 			}
 
-			m_FilteredTransforms.clear();
+			m_FilteredInstances.clear();
 			m_VisibleSubMeshRanges.clear();
 
 			ComputeShaderProjectionsAndCullObjects(context);
@@ -162,47 +167,6 @@ namespace Grapple
 		context.GetViewport().GlobalResources.ShadowDataBuffer->SetData(&m_ShadowData, sizeof(m_ShadowData), 0);
 	}
 
-	enum class CullResult
-	{
-		NotVisible,
-		PartiallyVisible,
-		FullyVisible,
-	};
-
-	inline static CullResult CullAABB(const Math::AABB& aabb, const Math::Plane* planes, const Math::Compact3DTransform& transform)
-	{
-		Math::AABB transformedAABB = Math::SIMD::TransformAABB(aabb, transform.ToMatrix4x4());
-
-		__m128 min = _mm_loadu_ps(glm::value_ptr(glm::vec4(aabb.Min, 0.0f)));
-		__m128 max = _mm_loadu_ps(glm::value_ptr(glm::vec4(aabb.Max, 0.0f)));
-
-		// Calculate AABB extents
-		__m128 extents = _mm_sub_ps(max, min);
-
-		// Calculate AABB center
-		float scale = 0.5f;
-		__m128 halfScale = _mm_load_ps1(&scale);
-		__m128 center = _mm_mul_ps(_mm_add_ps(min, max), halfScale);
-
-		size_t inFrontCount = 0;
-		bool intersects = true;
-		for (size_t i = 0; i < 4; i++)
-		{
-			Math::Plane plane = planes[i];
-
-			__m128 planeNormal = _mm_loadu_ps(glm::value_ptr(glm::vec4(plane.Normal, 0.0f)));
-			float projectedDistance = Math::SIMD::Dot(Math::SIMD::Abs(planeNormal), extents);
-			float signedDistance = glm::abs(Math::SIMD::Dot(planeNormal, center));
-
-			inFrontCount += (projectedDistance <= signedDistance) ? 1 : 0;
-
-			if (-projectedDistance > signedDistance) // No intersection and not in front
-				return CullResult::NotVisible;
-		}
-
-		return inFrontCount == 4 ? CullResult::FullyVisible : CullResult::PartiallyVisible;
-	}
-
 	void ShadowPass::ComputeShaderProjectionsAndCullObjects(const RenderGraphContext& context)
 	{
 		Grapple_PROFILE_FUNCTION();
@@ -256,7 +220,7 @@ namespace Grapple
 					for (uint32_t objectIndex : perCascadeObjects[cascadeIndex])
 					{
 						const auto& object = m_OpaqueObjects[objectIndex];
-						Math::AABB objectAABB = object.Mesh->GetSubMeshes()[object.SubMeshIndex].Bounds.Transformed(object.Transform);
+						const Math::AABB& objectAABB = object.Bounds;
 
 						glm::vec3 center = objectAABB.GetCenter();
 						glm::vec3 extents = objectAABB.Max - center;
@@ -325,95 +289,257 @@ namespace Grapple
 	{
 		Grapple_PROFILE_FUNCTION();
 		const ShadowSettings& shadowSettings = Renderer::GetShadowSettings();
-		const auto& submitedBatches = context.GetSceneSubmition().OpaqueGeometrySubmitions.GetShadowPassBatches();
+		const RendererSubmitionQueue& opaqueGeometry = context.GetSceneSubmition().OpaqueGeometrySubmitions;
+		uint32_t cascadesCount = (uint32_t)glm::min<int32_t>(shadowSettings.Cascades, (int32_t)MaxCascades);
+
+		PrepareCascadeBounds(context.GetSceneSubmition().DirectionalLight.LightBasis, cascadesCount);
+		CollectShadowCasters(opaqueGeometry);
 
-		for (size_t batchIndex = 0; batchIndex < submitedBatches.size(); batchIndex++)
+		// Bounds of every caster are tested against all cascades at once
 		{
-			const RendererSubmitionQueue::ShadowPassBatch& batch = submitedBatches[batchIndex];
-			for (size_t cascadeIndex = 0; cascadeIndex < (size_t)shadowSettings.Cascades; cascadeIndex++)
+			Grapple_PROFILE_SCOPE("ComputeCascadeMasks");
+
+			m_CasterMasks.resize(m_Casters.size());
+			JobSystem::ParallelFor(m_Casters.size(), 2048, [this](size_t begin, size_t end, uint32_t threadIndex)
 			{
-				ShadowCascadeData& cascadeData = m_CascadeData[cascadeIndex];
-				FilteredShadowPassBatch filteredBatch{};
-				filteredBatch.Mesh = batch.Mesh;
-				filteredBatch.FirstEntryIndex = (uint32_t)m_FilteredTransforms.size();
+				for (size_t i = begin; i < end; i++)
+					m_CasterMasks[i] = (uint8_t)ComputeCascadeMask(m_Casters[i].Bounds);
+			});
+		}
 
-				for (size_t submitionIndex = 0; submitionIndex < batch.Submitions.size(); submitionIndex++)
-				{
-					CullResult result = CullAABB(
-						filteredBatch.Mesh->GetBounds(),
-						cascadeData.FrustumPlanes,
-						batch.Submitions[submitionIndex].Transform);
+		BuildCascadeLists(opaqueGeometry, cascadesCount);
+	}
 
-					if (result == CullResult::PartiallyVisible && filteredBatch.Mesh->GetSubMeshes().size() == 1)
-						result = CullResult::FullyVisible;
+	void ShadowPass::PrepareCascadeBounds(const Math::Basis& lightBasis, uint32_t cascadesCount)
+	{
+		m_LightRight = lightBasis.Right;
+		m_LightUp = lightBasis.Up;
 
-					if (result == CullResult::FullyVisible)
-					{
-						m_FilteredTransforms.push_back(batch.Submitions[submitionIndex].Transform);
-						filteredBatch.Count++;
-					}
-					else if (result == CullResult::PartiallyVisible)
-					{
-						PartiallyVisibleMesh partiallyVisibleMesh{};
-						partiallyVisibleMesh.Mesh = filteredBatch.Mesh;
-						partiallyVisibleMesh.Transform = batch.Submitions[submitionIndex].Transform;
+		for (uint32_t cascadeIndex = 0; cascadeIndex < (uint32_t)MaxCascades; cascadeIndex++)
+		{
+			const ShadowCascadeData& cascadeData = m_CascadeData[cascadeIndex];
+			if (cascadeIndex < cascadesCount)
+			{
+				m_CascadeCenterX[cascadeIndex] = glm::dot(m_LightRight, cascadeData.BoundingSphereCenter);
+				m_CascadeCenterY[cascadeIndex] = glm::dot(m_LightUp, cascadeData.BoundingSphereCenter);
+				m_CascadeRadius[cascadeIndex] = cascadeData.BoundingSphereRadius;
+			}
+			else
+			{
+				// Unused cascades can't be intersected by anything
+				m_CascadeCenterX[cascadeIndex] = 0.0f;
+				m_CascadeCenterY[cascadeIndex] = 0.0f;
+				m_CascadeRadius[cascadeIndex] = -FLT_MAX;
+			}
+		}
+	}
 
-						CullSubMeshes(partiallyVisibleMesh, batch.Submitions[submitionIndex].Transform, cascadeData.FrustumPlanes);
+	uint32_t ShadowPass::ComputeCascadeMask(const Math::AABB& bounds) const
+	{
+		glm::vec3 center = bounds.GetCenter();
+		glm::vec3 extents = bounds.GetExtents();
 
-						if (partiallyVisibleMesh.SubMeshRangeCount > 0)
-						{
-							cascadeData.PartiallyVisible.push_back(partiallyVisibleMesh);
-						}
-					}
-				}
+		// Project the box onto the light's right and up axes
+		__m128 x = _mm_set1_ps(glm::dot(m_LightRight, center));
+		__m128 y = _mm_set1_ps(glm::dot(m_LightUp, center));
+		__m128 extentX = _mm_set1_ps(glm::dot(glm::abs(m_LightRight), extents));
+		__m128 extentY = _mm_set1_ps(glm::dot(glm::abs(m_LightUp), extents));
 
-				if (filteredBatch.Count > 0)
-				{
-					cascadeData.Batches.push_back(filteredBatch);
-				}
+		__m128 distanceX = Math::SIMD::Abs(_mm_sub_ps(x, _mm_loadu_ps(m_CascadeCenterX)));
+		__m128 distanceY = Math::SIMD::Abs(_mm_sub_ps(y, _mm_loadu_ps(m_CascadeCenterY)));
+		__m128 radius = _mm_loadu_ps(m_CascadeRadius);
+
+		__m128 intersects = _mm_and_ps(
+			_mm_cmple_ps(distanceX, _mm_add_ps(radius, extentX)),
+			_mm_cmple_ps(distanceY, _mm_add_ps(radius, extentY)));
+
+		__m128 contained = _mm_and_ps(
+			_mm_cmple_ps(_mm_add_ps(distanceX, extentX), radius),
+			_mm_cmple_ps(_mm_add_ps(distanceY, extentY), radius));
+
+		return (uint32_t)_mm_movemask_ps(intersects) | ((uint32_t)_mm_movemask_ps(contained) << 4);
+	}
+
+	void ShadowPass::CollectShadowCasters(const RendererSubmitionQueue& opaqueGeometry)
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		m_Casters.clear();
+		m_CasterGroups.clear();
+
+		for (const RendererSubmitionQueue::ShadowPassBatch& batch : opaqueGeometry.GetShadowPassBatches())
+		{
+			ShadowCasterGroup& group = m_CasterGroups.emplace_back();
+			group.Mesh = batch.Mesh;
+			group.FirstCaster = (uint32_t)m_Casters.size();
+			group.CastersCount = (uint32_t)batch.Submitions.size();
+
+			for (const auto& submition : batch.Submitions)
+			{
+				ShadowCaster& caster = m_Casters.emplace_back();
+				caster.Bounds = submition.Bounds;
+				caster.InstanceSlot = submition.InstanceSlot;
+				caster.FirstItem = submition.FirstItem;
 			}
 		}
+
+		// Static casters are culled once against the area covered by all of the cascades
+		const StaticGeometry& staticGeometry = opaqueGeometry.GetStaticGeometry();
+
+		float minX = FLT_MAX;
+		float maxX = -FLT_MAX;
+		float minY = FLT_MAX;
+		float maxY = -FLT_MAX;
+		for (size_t cascadeIndex = 0; cascadeIndex < MaxCascades; cascadeIndex++)
+		{
+			if (m_CascadeRadius[cascadeIndex] < 0.0f)
+				continue;
+
+			minX = glm::min(minX, m_CascadeCenterX[cascadeIndex] - m_CascadeRadius[cascadeIndex]);
+			maxX = glm::max(maxX, m_CascadeCenterX[cascadeIndex] + m_CascadeRadius[cascadeIndex]);
+			minY = glm::min(minY, m_CascadeCenterY[cascadeIndex] - m_CascadeRadius[cascadeIndex]);
+			maxY = glm::max(maxY, m_CascadeCenterY[cascadeIndex] + m_CascadeRadius[cascadeIndex]);
+		}
+
+		if (minX > maxX)
+			return;
+
+		Math::Plane planes[4] =
+		{
+			Math::Plane::TroughPoint(m_LightRight * minX, m_LightRight),
+			Math::Plane::TroughPoint(m_LightRight * maxX, -m_LightRight),
+			Math::Plane::TroughPoint(m_LightUp * maxY, -m_LightUp),
+			Math::Plane::TroughPoint(m_LightUp * minY, m_LightUp),
+		};
+
+		m_VisibleStaticObjects.clear();
+		staticGeometry.CullShadowCasters(planes, 4, m_VisibleStaticObjects);
+
+		// Group objects by mesh, so that they can be drawn using instancing
+		std::sort(m_VisibleStaticObjects.begin(), m_VisibleStaticObjects.end(), [&staticGeometry](uint32_t a, uint32_t b) -> bool
+		{
+			return staticGeometry.GetObject(a).Mesh.get() < staticGeometry.GetObject(b).Mesh.get();
+		});
+
+		for (uint32_t objectId : m_VisibleStaticObjects)
+		{
+			const StaticGeometry::Object& object = staticGeometry.GetObject(objectId);
+			if (m_CasterGroups.size() == 0 || m_CasterGroups.back().Mesh.get() != object.Mesh.get())
+			{
+				ShadowCasterGroup& group = m_CasterGroups.emplace_back();
+				group.Mesh = object.Mesh;
+				group.FirstCaster = (uint32_t)m_Casters.size();
+			}
+
+			ShadowCaster& caster = m_Casters.emplace_back();
+			caster.Bounds = object.Bounds;
+			caster.InstanceSlot = object.InstanceSlot;
+			caster.FirstItem = object.FirstItem;
+
+			m_CasterGroups.back().CastersCount++;
+		}
 	}
 
-	void ShadowPass::CullSubMeshes(PartiallyVisibleMesh& mesh, const Math::Compact3DTransform& transform, const Math::Plane* frustumPlanes)
+	void ShadowPass::BuildCascadeLists(const RendererSubmitionQueue& opaqueGeometry, uint32_t cascadesCount)
 	{
 		Grapple_PROFILE_FUNCTION();
 
-		mesh.FirstSubMeshRange = (uint32_t)m_VisibleSubMeshRanges.size();
+		for (const ShadowCasterGroup& group : m_CasterGroups)
+		{
+			for (uint32_t cascadeIndex = 0; cascadeIndex < cascadesCount; cascadeIndex++)
+				m_CascadeInstances[cascadeIndex].clear();
+
+			bool hasSingleSubMesh = group.Mesh->GetSubMeshes().size() == 1;
+			for (uint32_t casterIndex = group.FirstCaster; casterIndex < group.FirstCaster + group.CastersCount; casterIndex++)
+			{
+				uint32_t mask = m_CasterMasks[casterIndex];
+				uint32_t intersected = mask & 0xf;
+
+				// Partially visible meshes with a single sub mesh are drawn the same way as the fully visible ones
+				uint32_t contained = hasSingleSubMesh ? intersected : (mask >> 4);
+				uint32_t partiallyVisible = intersected & ~contained;
+
+				const ShadowCaster& caster = m_Casters[casterIndex];
+				for (uint32_t cascadeIndex = 0; cascadeIndex < cascadesCount; cascadeIndex++)
+				{
+					if (contained & (1u << cascadeIndex))
+						m_CascadeInstances[cascadeIndex].push_back(caster.InstanceSlot);
+				}
 
-		VisibleSubMeshRange currentRange{};
-		currentRange.Start = UINT32_MAX;
-		currentRange.Count = 0;
+				if (partiallyVisible != 0)
+					CullSubMeshes(opaqueGeometry, caster, group.Mesh, partiallyVisible);
+			}
+
+			for (uint32_t cascadeIndex = 0; cascadeIndex < cascadesCount; cascadeIndex++)
+			{
+				const std::vector<uint32_t>& instances = m_CascadeInstances[cascadeIndex];
+				if (instances.size() == 0)
+					continue;
 
-		const auto& subMeshes = mesh.Mesh->GetSubMeshes();
-		uint32_t subMeshCount = (uint32_t)subMeshes.size();
+				FilteredShadowPassBatch& batch = m_CascadeData[cascadeIndex].Batches.emplace_back();
+				batch.Mesh = group.Mesh;
+				batch.FirstEntryIndex = (uint32_t)m_FilteredInstances.size();
+				batch.Count = (uint32_t)instances.size();
+
+				m_FilteredInstances.insert(m_FilteredInstances.end(), instances.begin(), instances.end());
+			}
+		}
+	}
+
+	void ShadowPass::CullSubMeshes(const RendererSubmitionQueue& opaqueGeometry,
+		const ShadowCaster& caster,
+		const Ref<const Mesh>& mesh,
+		uint32_t cascadesMask)
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		// World space bounds of sub meshes are shared with the geometry pass
+		uint32_t subMeshCount = (uint32_t)mesh->GetSubMeshes().size();
+		m_SubMeshMasks.resize(subMeshCount);
 		for (uint32_t i = 0; i < subMeshCount; i++)
+			m_SubMeshMasks[i] = (uint8_t)(ComputeCascadeMask(opaqueGeometry[caster.FirstItem + i].Bounds) & cascadesMask);
+
+		for (uint32_t cascadeIndex = 0; cascadeIndex < (uint32_t)MaxCascades; cascadeIndex++)
 		{
-			CullResult result = CullAABB(subMeshes[i].Bounds, frustumPlanes, transform);
-			if (result == CullResult::NotVisible)
+			uint32_t cascadeBit = 1u << cascadeIndex;
+			if ((cascadesMask & cascadeBit) == 0)
 				continue;
 
-			if (currentRange.Start == UINT32_MAX || i != currentRange.GetEnd() + 1)
+			PartiallyVisibleMesh partiallyVisibleMesh{};
+			partiallyVisibleMesh.Mesh = mesh;
+			partiallyVisibleMesh.InstanceSlot = caster.InstanceSlot;
+			partiallyVisibleMesh.FirstSubMeshRange = (uint32_t)m_VisibleSubMeshRanges.size();
+
+			VisibleSubMeshRange currentRange{};
+			for (uint32_t i = 0; i < subMeshCount; i++)
 			{
+				if ((m_SubMeshMasks[i] & cascadeBit) == 0)
+					continue;
+
+				if (currentRange.Count > 0 && i == currentRange.GetEnd() + 1)
+				{
+					currentRange.Count++;
+					continue;
+				}
+
 				if (currentRange.Count > 0)
 				{
 					m_VisibleSubMeshRanges.push_back(currentRange);
-					mesh.SubMeshRangeCount++;
+					partiallyVisibleMesh.SubMeshRangeCount++;
 				}
 
 				currentRange.Start = i;
 				currentRange.Count = 1;
 			}
-			else
+
+			if (currentRange.Count > 0)
 			{
-				currentRange.Count++;
+				m_VisibleSubMeshRanges.push_back(currentRange);
+				partiallyVisibleMesh.SubMeshRangeCount++;
 			}
-		}
 
-		if (currentRange.Count > 0)
-		{
-			m_VisibleSubMeshRanges.push_back(currentRange);
-			mesh.SubMeshRangeCount++;
+			if (partiallyVisibleMesh.SubMeshRangeCount > 0)
+				m_CascadeData[cascadeIndex].PartiallyVisible.push_back(partiallyVisibleMesh);
 		}
 	}
 }
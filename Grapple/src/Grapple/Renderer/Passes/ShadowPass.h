@@ -32,7 +32,7 @@ namespace Grapple
 	struct PartiallyVisibleMesh
 	{
 		Ref<const Mesh> Mesh = nullptr;
-		Math::Compact3DTransform Transform;
+		uint32_t InstanceSlot = 0;
 		uint32_t FirstSubMeshRange = 0;
 		uint32_t SubMeshRangeCount = 0;
 	};
@@ -89,22 +89,65 @@ namespace Grapple
 
 		inline Ref<Sampler> GetCompareSampler() const { return m_CompareSampler; }
 		inline const ShadowCascadeData& GetCascadeData(size_t index) const { return m_CascadeData[index]; }
-		inline const std::vector<Math::Compact3DTransform>& GetFilteredTransforms() const { return m_FilteredTransforms; }
+		inline const std::vector<uint32_t>& GetFilteredInstances() const { return m_FilteredInstances; }
 		inline const std::vector<VisibleSubMeshRange>& GetVisibleSubMeshIndices() const { return m_VisibleSubMeshRanges; }
 	private:
+		struct ShadowCaster
+		{
+			// World space bounds of the whole mesh
+			Math::AABB Bounds;
+			uint32_t InstanceSlot = 0;
+
+			// Index of the first sub mesh item in the RendererSubmitionQueue
+			uint32_t FirstItem = 0;
+		};
+
+		// Consecutive shadow casters, which share the same mesh
+		struct ShadowCasterGroup
+		{
+			Ref<const Mesh> Mesh = nullptr;
+			uint32_t FirstCaster = 0;
+			uint32_t CastersCount = 0;
+		};
+
 		void CalculateShadowMappingParameters(const RenderGraphContext& context);
 		void ComputeShaderProjectionsAndCullObjects(const RenderGraphContext& context);
 		void FilterSubmitions(const RenderGraphContext& context);
-
-		void CullSubMeshes(PartiallyVisibleMesh& mesh,
-			const Math::Compact3DTransform& transform,
-			const Math::Plane* frustumPlanes);
+		void PrepareCascadeBounds(const Math::Basis& lightBasis, uint32_t cascadesCount);
+		void CollectShadowCasters(const RendererSubmitionQueue& opaqueGeometry);
+		void BuildCascadeLists(const RendererSubmitionQueue& opaqueGeometry, uint32_t cascadesCount);
+
+		// Returns a mask of cascades intersected by the bounds in the low 4 bits
+		// and a mask of cascades, which fully contain the bounds, in the high 4 bits
+		uint32_t ComputeCascadeMask(const Math::AABB& bounds) const;
+
+		void CullSubMeshes(const RendererSubmitionQueue& opaqueGeometry,
+			const ShadowCaster& caster,
+			const Ref<const Mesh>& mesh,
+			uint32_t cascadesMask);
 	private:
 		ShadowData m_ShadowData;
 		Ref<Sampler> m_CompareSampler = nullptr;
 
 		ShadowCascadeData m_CascadeData[MaxCascades];
-		std::vector<Math::Compact3DTransform> m_FilteredTransforms;
+
+		// InstanceTable slots of fully visible meshes, referenced by the cascade batches
+		std::vector<uint32_t> m_FilteredInstances;
 		std::vector<VisibleSubMeshRange> m_VisibleSubMeshRanges;
+		std::vector<uint32_t> m_VisibleStaticObjects;
+
+		// Cascades are squares in the plane perpendicular to the light direction,
+		// stored as separate arrays so that an object can be tested against all of them at once
+		glm::vec3 m_LightRight = glm::vec3(0.0f);
+		glm::vec3 m_LightUp = glm::vec3(0.0f);
+		float m_CascadeCenterX[MaxCascades] = { 0.0f };
+		float m_CascadeCenterY[MaxCascades] = { 0.0f };
+		float m_CascadeRadius[MaxCascades] = { 0.0f };
+
+		std::vector<ShadowCaster> m_Casters;
+		std::vector<ShadowCasterGroup> m_CasterGroups;
+		std::vector<uint8_t> m_CasterMasks;
+		std::vector<uint8_t> m_SubMeshMasks;
+		std::vector<uint32_t> m_CascadeInstances[MaxCascades];
 	};
 }
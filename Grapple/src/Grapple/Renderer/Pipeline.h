@@ -48,6 +48,9 @@ namespace Grapple
 		PipelineInputLayout InputLayout;
 		Ref<Shader> Shader;
 
+		// Exposed to shaders as the `VERTEX_FORMAT_COMPACT` specialization constant
+		MeshVertexFormat VertexFormat = MeshVertexFormat::Float;
+
 		CullingMode Culling = CullingMode::Back;
 		BlendMode Blending = BlendMode::Opaque;
 		PrimitiveTopology Topology = PrimitiveTopology::Triangles;
@@ -0,0 +1,63 @@
+#include "RadixSort.h"
+
+#include "GrappleCore/Profiler/Profiler.h"
+
+#include <utility>
+
+namespace Grapple
+{
+	void RadixSort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch)
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		constexpr size_t DigitBits = 8;
+		constexpr size_t BucketsCount = 1 << DigitBits;
+		constexpr size_t PassesCount = sizeof(uint64_t) * 8 / DigitBits;
+
+		size_t count = entries.size();
+		if (count <= 1)
+			return;
+
+		// Histograms for all passes are built in a single pass over the keys
+		uint32_t histograms[PassesCount][BucketsCount] = {};
+		for (const SortEntry& entry : entries)
+		{
+			for (size_t pass = 0; pass < PassesCount; pass++)
+				histograms[pass][(entry.Key >> (pass * DigitBits)) & (BucketsCount - 1)]++;
+		}
+
+		scratch.resize(count);
+
+		SortEntry* source = entries.data();
+		SortEntry* destination = scratch.data();
+
+		for (size_t pass = 0; pass < PassesCount; pass++)
+		{
+			uint32_t* histogram = histograms[pass];
+			size_t shift = pass * DigitBits;
+
+			// All keys have the same digit, so the order doesn't change
+			if (histogram[(source[0].Key >> shift) & (BucketsCount - 1)] == (uint32_t)count)
+				continue;
+
+			uint32_t offset = 0;
+			for (size_t bucket = 0; bucket < BucketsCount; bucket++)
+			{
+				uint32_t bucketSize = histogram[bucket];
+				histogram[bucket] = offset;
+				offset += bucketSize;
+			}
+
+			for (size_t i = 0; i < count; i++)
+			{
+				const SortEntry& entry = source[i];
+				destination[histogram[(entry.Key >> shift) & (BucketsCount - 1)]++] = entry;
+			}
+
+			std::swap(source, destination);
+		}
+
+		if (source != entries.data())
+			entries.swap(scratch);
+	}
+}
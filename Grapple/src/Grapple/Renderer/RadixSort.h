@@ -0,0 +1,20 @@
+#pragma once
+
+#include "GrappleCore/Core.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace Grapple
+{
+	struct SortEntry
+	{
+		uint64_t Key = 0;
+		uint32_t Index = 0;
+	};
+
+	// Stable LSD radix sort of entries by key, processing 8 bits per pass.
+	// Passes in which all the keys have the same digit are skipped, so keys with few distinct high bits are cheaper to sort.
+	// `scratch` is used as a temporary buffer, and is kept by the caller to avoid reallocations.
+	Grapple_API void RadixSort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch);
+}
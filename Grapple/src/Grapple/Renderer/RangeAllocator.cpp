@@ -0,0 +1,104 @@
+#include "RangeAllocator.h"
+
+#include "GrappleCore/Assert.h"
+
+#include <algorithm>
+
+namespace Grapple
+{
+	RangeAllocator::RangeAllocator(uint32_t capacity)
+	{
+		Reset(capacity, 0);
+	}
+
+	uint32_t RangeAllocator::Allocate(uint32_t size)
+	{
+		Grapple_CORE_ASSERT(size > 0);
+
+		size_t bestFit = m_FreeRanges.size();
+		for (size_t i = 0; i < m_FreeRanges.size(); i++)
+		{
+			if (m_FreeRanges[i].Size < size)
+				continue;
+
+			if (bestFit == m_FreeRanges.size() || m_FreeRanges[i].Size < m_FreeRanges[bestFit].Size)
+			{
+				bestFit = i;
+				if (m_FreeRanges[i].Size == size)
+					break;
+			}
+		}
+
+		if (bestFit == m_FreeRanges.size())
+			return InvalidOffset;
+
+		FreeRange& range = m_FreeRanges[bestFit];
+		uint32_t offset = range.Offset;
+
+		range.Offset += size;
+		range.Size -= size;
+		if (range.Size == 0)
+			m_FreeRanges.erase(m_FreeRanges.begin() + bestFit);
+
+		m_FreeSize -= size;
+		return offset;
+	}
+
+	void RangeAllocator::Free(uint32_t offset, uint32_t size)
+	{
+		Grapple_CORE_ASSERT(size > 0);
+		Grapple_CORE_ASSERT((uint64_t)offset + (uint64_t)size <= (uint64_t)m_Capacity);
+
+		auto next = std::lower_bound(m_FreeRanges.begin(), m_FreeRanges.end(), offset, [](const FreeRange& range, uint32_t offset) -> bool
+		{
+			return range.Offset < offset;
+		});
+
+		Grapple_CORE_ASSERT(next == m_FreeRanges.end() || offset + size <= next->Offset);
+
+		m_FreeSize += size;
+
+		bool mergesWithNext = next != m_FreeRanges.end() && offset + size == next->Offset;
+		bool mergesWithPrevious = next != m_FreeRanges.begin() && (next - 1)->Offset + (next - 1)->Size == offset;
+
+		if (mergesWithPrevious && mergesWithNext)
+		{
+			(next - 1)->Size += size + next->Size;
+			m_FreeRanges.erase(next);
+		}
+		else if (mergesWithPrevious)
+		{
+			(next - 1)->Size += size;
+		}
+		else if (mergesWithNext)
+		{
+			next->Offset = offset;
+			next->Size += size;
+		}
+		else
+		{
+			m_FreeRanges.insert(next, FreeRange{ offset, size });
+		}
+	}
+
+	void RangeAllocator::Reset(uint32_t capacity, uint32_t usedSize)
+	{
+		Grapple_CORE_ASSERT(usedSize <= capacity);
+
+		m_Capacity = capacity;
+		m_FreeSize = capacity - usedSize;
+		m_FreeRanges.clear();
+
+		if (m_FreeSize > 0)
+			m_FreeRanges.push_back(FreeRange{ usedSize, m_FreeSize });
+	}
+
+	uint32_t RangeAllocator::GetLargestFreeRange() const
+	{
+		uint32_t largest = 0;
+		for (const FreeRange& range : m_FreeRanges)
+			largest = std::max(largest, range.Size);
+
+		return largest;
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "GrappleCore/Core.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace Grapple
+{
+	// Allocates ranges of a linear address space, like elements of a GPU buffer.
+	//
+	// Free ranges are stored in a list sorted by offset, allocations use the smallest free range,
+	// which is large enough and freed ranges are merged with adjacent free ranges.
+	class Grapple_API RangeAllocator
+	{
+	public:
+		static constexpr uint32_t InvalidOffset = UINT32_MAX;
+
+		RangeAllocator() = default;
+		RangeAllocator(uint32_t capacity);
+
+		// Returns `InvalidOffset` when there is no free range large enough
+		uint32_t Allocate(uint32_t size);
+		void Free(uint32_t offset, uint32_t size);
+
+		// Resets the allocator to a new capacity, where the range [0, usedSize) is allocated.
+		// Used after compacting all allocations to the start of the address space
+		void Reset(uint32_t capacity, uint32_t usedSize);
+
+		inline uint32_t GetCapacity() const { return m_Capacity; }
+		inline uint32_t GetFreeSize() const { return m_FreeSize; }
+		inline size_t GetFreeRangesCount() const { return m_FreeRanges.size(); }
+		uint32_t GetLargestFreeRange() const;
+	private:
+		struct FreeRange
+		{
+			uint32_t Offset = 0;
+			uint32_t Size = 0;
+		};
+
+		uint32_t m_Capacity = 0;
+		uint32_t m_FreeSize = 0;
+		std::vector<FreeRange> m_FreeRanges;
+	};
+}
@@ -14,6 +14,7 @@
 #include "Grapple/Renderer/ShaderStorageBuffer.h"
 #include "Grapple/Renderer/GPUTimer.h"
 #include "Grapple/Renderer/DescriptorSet.h"
+#include "Grapple/Renderer/GeometryPool.h"
 
 #include "Grapple/Renderer/Passes/GeometryPass.h"
 #include "Grapple/Renderer/Passes/ShadowPass.h"
@@ -49,7 +50,9 @@ namespace Grapple
 		Ref<Material> ErrorMaterial = nullptr;
 		Ref<Material> DepthOnlyMeshMaterial = nullptr;
 		
+		// Statistics of the frame being rendered and of the last completed frame
 		RendererStatistics Statistics;
+		RendererStatistics LastFrameStatistics;
 
 		RendererSubmitionQueue OpaqueQueue;
 		std::vector<DecalSubmitionData> Decals;
@@ -67,6 +70,8 @@ namespace Grapple
 
 		// Decals
 		Ref<DescriptorSetPool> DecalsDescriptorSetPool = nullptr;
+
+		Ref<GeometryPool> Geometry = nullptr;
 	};
 	
 	RendererData s_RendererData;
@@ -90,6 +95,8 @@ namespace Grapple
 
 	void Renderer::Initialize()
 	{
+		s_RendererData.Geometry = CreateRef<GeometryPool>();
+
 		{
 			uint32_t whiteTextureData = 0xffffffff;
 			s_RendererData.WhiteTexture = Texture::Create(1, 1, &whiteTextureData, TextureFormat::RGBA8);
@@ -190,14 +197,20 @@ namespace Grapple
 			}
 
 			{
-				VkDescriptorSetLayoutBinding instanceDataBinding{};
-				instanceDataBinding.binding = 0;
-				instanceDataBinding.descriptorCount = 1;
-				instanceDataBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-				instanceDataBinding.pImmutableSamplers = nullptr;
-				instanceDataBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-
-				s_RendererData.InstanceDataDescriptorSetPool = CreateRef<VulkanDescriptorSetPool>(32, Span(&instanceDataBinding, 1));
+				// 0 - Instance data
+				// 1 - Indices into the instance data, used by passes which draw from the InstanceTable
+				// 2 - Indices into the MaterialDataTable of each instance's material
+				VkDescriptorSetLayoutBinding instanceDataBindings[3] = {};
+				for (uint32_t i = 0; i < 3; i++)
+				{
+					instanceDataBindings[i].binding = i;
+					instanceDataBindings[i].descriptorCount = 1;
+					instanceDataBindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+					instanceDataBindings[i].pImmutableSamplers = nullptr;
+					instanceDataBindings[i].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+				}
+
+				s_RendererData.InstanceDataDescriptorSetPool = CreateRef<VulkanDescriptorSetPool>(32, Span(instanceDataBindings, 3));
 			}
 
 			// Decals descriptor set
@@ -220,12 +233,12 @@ namespace Grapple
 
 	const RendererStatistics& Renderer::GetStatistics()
 	{
-		return s_RendererData.Statistics;
+		return s_RendererData.LastFrameStatistics;
 	}
 
-	void Renderer::ClearStatistics()
+	RendererStatistics& Renderer::GetMutableStatistics()
 	{
-		s_RendererData.Statistics = {};
+		return s_RendererData.Statistics;
 	}
 
 	void Renderer::SetMainViewport(Viewport& viewport)
@@ -241,10 +254,13 @@ namespace Grapple
 	void Renderer::BeginFrame()
 	{
 		s_RendererData.RenderGraphRebuildIsRequired = false;
+		s_RendererData.Geometry->BeginFrame();
 	}
 
 	void Renderer::EndFrame()
 	{
+		s_RendererData.LastFrameStatistics = s_RendererData.Statistics;
+		s_RendererData.Statistics = {};
 	}
 
 	SceneSubmition& Renderer::GetCurrentSceneSubmition()
@@ -276,6 +292,7 @@ namespace Grapple
 		Grapple_PROFILE_FUNCTION();
 
 		Grapple_CORE_ASSERT(s_RendererData.Submition);
+		s_RendererData.Submition->OpaqueGeometrySubmitions.FinishSubmitions();
 		s_RendererData.Submition = nullptr;
 
 		s_RendererData.PointLights.clear();
@@ -367,6 +384,11 @@ namespace Grapple
 		return s_RendererData.InstanceDataDescriptorSetPool;
 	}
 
+	Ref<GeometryPool> Renderer::GetGeometryPool()
+	{
+		return s_RendererData.Geometry;
+	}
+
 	const ShadowSettings& Renderer::GetShadowSettings()
 	{
 		return s_RendererData.ShadowMappingSettings;
@@ -445,7 +467,7 @@ namespace Grapple
 			Ref<ShadowCascadePass> cascadePass = CreateRef<ShadowCascadePass>(
 				s_RendererData.Statistics,
 				shadowPass->GetCascadeData((size_t)cascadeIndex),
-				shadowPass->GetFilteredTransforms(),
+				shadowPass->GetFilteredInstances(),
 				shadowPass->GetVisibleSubMeshIndices());
 
 			viewport.Graph.AddPass(cascadePassSpec, cascadePass);
@@ -135,14 +135,18 @@ namespace Grapple
 	class DescriptorSet;
 	class DescriptorSetLayout;
 	class DescriptorSetPool;
+	class GeometryPool;
 	class Grapple_API Renderer
 	{
 	public:
 		static void Initialize();
 		static void Shutdown();
 
+		// Statistics of the last completed frame
 		static const RendererStatistics& GetStatistics();
-		static void ClearStatistics();
+
+		// Statistics of the frame being rendered, which are moved to the last frame statistics at the end of the frame
+		static RendererStatistics& GetMutableStatistics();
 
 		static void SetMainViewport(Viewport& viewport);
 		static void SetCurrentViewport(Viewport& viewport);
@@ -182,6 +186,8 @@ namespace Grapple
 		static Ref<DescriptorSetPool> GetCameraDescriptorSetPool();
 		static Ref<DescriptorSetPool> GetInstanceDataDescriptorSetPool();
 
+		static Ref<GeometryPool> GetGeometryPool();
+
 		static const ShadowSettings& GetShadowSettings();
 		static void SetShadowSettings(const ShadowSettings& settings);
 
@@ -9,9 +9,26 @@ namespace Grapple
 		uint32_t DrawCallCount = 0;
 		uint32_t DrawCallsSavedByInstancing = 0;
 
+		// Number of recorded indirect draw calls, each of them can execute multiple draws
+		uint32_t IndirectDrawCallCount = 0;
+
 		uint32_t ObjectsSubmitted = 0;
 		uint32_t ObjectsVisible = 0;
 
+		// Objects, which passed frustum culling, but were hidden by occluders
+		uint32_t ObjectsOccluded = 0;
+		uint32_t OccludersRasterized = 0;
+
+		// Sub mesh instances, which had some of their meshlets culled, and the number of triangles in the culled meshlets
+		uint32_t ObjectsClusterCulled = 0;
+		uint32_t TrianglesCulledByClusters = 0;
+
+		// Redundant state changes, which were filtered out by the command buffer
+		uint32_t PipelineBindsSkipped = 0;
+		uint32_t DescriptorSetBindsSkipped = 0;
+		uint32_t BufferBindsSkipped = 0;
+		uint32_t PushConstantsSkipped = 0;
+
 		float ShadowPassTime = 0.0f;
 		float GeometryPassTime = 0.0f;
 	};
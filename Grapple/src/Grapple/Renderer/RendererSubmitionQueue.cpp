@@ -3,40 +3,150 @@
 #include "GrappleCore/Profiler/Profiler.h"
 
 #include "Grapple/AssetManager/AssetManager.h"
+#include "Grapple/Renderer/Shader.h"
+
+#include <cstring>
 
 namespace Grapple
 {
-	void RendererSubmitionQueue::Submit(Ref<const Mesh> mesh, Span<AssetHandle> materialHandles, const Math::Compact3DTransform& transform, MeshRenderFlags flags)
+	void RendererSubmitionQueue::Submit(Ref<const Mesh> mesh,
+		Span<AssetHandle> materialHandles,
+		const Math::Compact3DTransform& transform,
+		MeshRenderFlags flags,
+		uint32_t objectId)
 	{
 		Grapple_PROFILE_FUNCTION();
 		
+		if (IsDuplicateStaticSubmition(flags, objectId))
+			return;
+
 		const auto& subMeshes = mesh->GetSubMeshes();
+		bool castsShadows = !HAS_BIT(flags, MeshRenderFlags::DontCastShadows);
+		uint32_t instanceSlot = AllocateInstanceSlot(objectId, mesh->GetVertexTransform(transform));
+
+		if (IsStaticSubmition(flags, objectId))
+		{
+			m_StaticGeometry.Submit(objectId, mesh, transform, (uint32_t)m_Buffer.size(), instanceSlot, castsShadows);
+
+			for (size_t subMeshIndex = 0; subMeshIndex < subMeshes.size(); subMeshIndex++)
+			{
+				AddItem(mesh, (uint32_t)subMeshIndex,
+					AssetManager::GetAsset<Material>(materialHandles[subMeshIndex]),
+					transform,
+					transform.TransformAABB(subMeshes[subMeshIndex].Bounds),
+					flags, instanceSlot);
+			}
+
+			return;
+		}
 
-		if (!HAS_BIT(flags, MeshRenderFlags::DontCastShadows))
-			SubmitForShadowPass(mesh, transform);
+		if (castsShadows)
+			SubmitForShadowPass(mesh, transform.TransformAABB(mesh->GetBounds()), instanceSlot);
 
 		for (size_t subMeshIndex = 0; subMeshIndex < subMeshes.size(); subMeshIndex++)
 		{
-			Submit(mesh, (uint32_t)subMeshIndex, AssetManager::GetAsset<Material>(materialHandles[subMeshIndex]), transform, flags);
+			m_DynamicItems.push_back((uint32_t)m_Buffer.size());
+			AddItem(mesh, (uint32_t)subMeshIndex,
+				AssetManager::GetAsset<Material>(materialHandles[subMeshIndex]),
+				transform,
+				transform.TransformAABB(subMeshes[subMeshIndex].Bounds),
+				flags, instanceSlot);
 		}
 	}
 
-	void RendererSubmitionQueue::Submit(Ref<const Mesh> mesh, Ref<const Material> material, const Math::Compact3DTransform& transform, MeshRenderFlags flags)
+	void RendererSubmitionQueue::Submit(Ref<const Mesh> mesh,
+		Ref<const Material> material,
+		const Math::Compact3DTransform& transform,
+		MeshRenderFlags flags,
+		uint32_t objectId)
 	{
 		Grapple_PROFILE_FUNCTION();
 		
+		if (IsDuplicateStaticSubmition(flags, objectId))
+			return;
+
 		const auto& subMeshes = mesh->GetSubMeshes();
+		bool castsShadows = !HAS_BIT(flags, MeshRenderFlags::DontCastShadows);
+		uint32_t instanceSlot = AllocateInstanceSlot(objectId, mesh->GetVertexTransform(transform));
 
-		if (!HAS_BIT(flags, MeshRenderFlags::DontCastShadows))
-			SubmitForShadowPass(mesh, transform);
+		if (IsStaticSubmition(flags, objectId))
+		{
+			m_StaticGeometry.Submit(objectId, mesh, transform, (uint32_t)m_Buffer.size(), instanceSlot, castsShadows);
+
+			for (size_t subMeshIndex = 0; subMeshIndex < subMeshes.size(); subMeshIndex++)
+			{
+				AddItem(mesh, (uint32_t)subMeshIndex, material, transform, transform.TransformAABB(subMeshes[subMeshIndex].Bounds), flags, instanceSlot);
+			}
+
+			return;
+		}
+
+		if (castsShadows)
+			SubmitForShadowPass(mesh, transform.TransformAABB(mesh->GetBounds()), instanceSlot);
 
 		for (size_t subMeshIndex = 0; subMeshIndex < subMeshes.size(); subMeshIndex++)
 		{
-			Submit(mesh, (uint32_t)subMeshIndex, material, transform, flags);
+			m_DynamicItems.push_back((uint32_t)m_Buffer.size());
+			AddItem(mesh, (uint32_t)subMeshIndex, material, transform, transform.TransformAABB(subMeshes[subMeshIndex].Bounds), flags, instanceSlot);
 		}
 	}
 
-	void RendererSubmitionQueue::SubmitForShadowPass(const Ref<const Mesh>& mesh, const Math::Compact3DTransform& transform)
+	void RendererSubmitionQueue::Submit(const Ref<const Mesh>& mesh,
+		Span<const Ref<const Material>> materials,
+		Span<const Math::AABB> subMeshBounds,
+		const Math::Compact3DTransform& transform,
+		MeshRenderFlags flags,
+		uint32_t objectId)
+	{
+		Grapple_PROFILE_FUNCTION();
+		Grapple_CORE_ASSERT(subMeshBounds.GetSize() == mesh->GetSubMeshes().size());
+
+		if (IsDuplicateStaticSubmition(flags, objectId))
+			return;
+
+		bool castsShadows = !HAS_BIT(flags, MeshRenderFlags::DontCastShadows);
+		bool isStatic = IsStaticSubmition(flags, objectId);
+		uint32_t instanceSlot = AllocateInstanceSlot(objectId, mesh->GetVertexTransform(transform));
+
+		if (isStatic)
+			m_StaticGeometry.Submit(objectId, mesh, transform, (uint32_t)m_Buffer.size(), instanceSlot, castsShadows);
+		else if (castsShadows && subMeshBounds.GetSize() > 0)
+		{
+			Math::AABB bounds = subMeshBounds[0];
+			for (size_t subMeshIndex = 1; subMeshIndex < subMeshBounds.GetSize(); subMeshIndex++)
+			{
+				bounds.Min = glm::min(bounds.Min, subMeshBounds[subMeshIndex].Min);
+				bounds.Max = glm::max(bounds.Max, subMeshBounds[subMeshIndex].Max);
+			}
+
+			SubmitForShadowPass(mesh, bounds, instanceSlot);
+		}
+
+		for (size_t subMeshIndex = 0; subMeshIndex < subMeshBounds.GetSize(); subMeshIndex++)
+		{
+			Ref<const Material> material = nullptr;
+			if (materials.GetSize() == 1)
+				material = materials[0];
+			else if (subMeshIndex < materials.GetSize())
+				material = materials[subMeshIndex];
+
+			if (!isStatic)
+				m_DynamicItems.push_back((uint32_t)m_Buffer.size());
+
+			AddItem(mesh, (uint32_t)subMeshIndex, material, transform, subMeshBounds[subMeshIndex], flags, instanceSlot);
+		}
+	}
+
+	bool RendererSubmitionQueue::IsDuplicateStaticSubmition(MeshRenderFlags flags, uint32_t objectId) const
+	{
+		if (!IsStaticSubmition(flags, objectId) || !m_StaticGeometry.IsSubmitted(objectId))
+			return false;
+
+		Grapple_CORE_ERROR("Static object {0} was submitted multiple times during a frame", objectId);
+		return true;
+	}
+
+	void RendererSubmitionQueue::SubmitForShadowPass(const Ref<const Mesh>& mesh, const Math::AABB& bounds, uint32_t instanceSlot)
 	{
 		Grapple_PROFILE_FUNCTION();
 
@@ -62,16 +172,129 @@ namespace Grapple
 			batch = &(*batchIterator);
 		}
 
-		glm::vec3 center = transform.RotationScale * mesh->GetBounds().GetCenter() + transform.Translation;
-
 		ShadowPassMeshSubmition& submition = batch->Submitions.emplace_back();
-		submition.Transform = transform;
-		submition.SortKey = glm::distance2(center, m_CameraPosition);
+		submition.Bounds = bounds;
+		submition.InstanceSlot = instanceSlot;
+		submition.FirstItem = (uint32_t)m_Buffer.size();
+		submition.SortKey = glm::distance2(bounds.GetCenter(), m_CameraPosition);
+	}
+
+	void RendererSubmitionQueue::AddItem(const Ref<const Mesh>& mesh,
+		uint32_t subMesh,
+		const Ref<const Material>& material,
+		const Math::Compact3DTransform& transform,
+		const Math::AABB& bounds,
+		MeshRenderFlags flags,
+		uint32_t instanceSlot)
+	{
+		Item& object = m_Buffer.emplace_back();
+		object.Material = material;
+		object.Flags = flags;
+		object.Mesh = mesh;
+		object.SubMeshIndex = subMesh;
+		object.Transform = transform;
+		object.Bounds = bounds;
+		object.InstanceSlot = instanceSlot;
+		object.SortKey = ComputeSortKey(mesh, subMesh, material, glm::distance2(bounds.GetCenter(), m_CameraPosition));
+	}
+
+	uint64_t RendererSubmitionQueue::ComputeSortKey(const Ref<const Mesh>& mesh, uint32_t subMesh, const Ref<const Material>& material, float distanceSquared)
+	{
+		uint64_t shaderId = SortId::Shared;
+		uint64_t materialId = SortId::Shared;
+		if (material != nullptr)
+		{
+			if (material->GetShader() != nullptr)
+				shaderId = material->GetShader()->GetSortId();
+
+			// Materials, which can share batches, are keyed by their textures, so that their instances are sorted together.
+			// All materials of a shader either use its MaterialDataTable or not, so the two kinds of keys are never compared
+			if (material->UsesDataTable())
+				materialId = material->GetTexturesSortKey();
+			else
+				materialId = material->GetSortId();
+		}
+
+		uint64_t meshId = mesh->GetSortId();
+
+		// Bit patterns of non negative floats are ordered the same way as the values,
+		// so the upper bits give a logarithmically quantized distance
+		uint32_t distanceBits = 0;
+		std::memcpy(&distanceBits, &distanceSquared, sizeof(distanceBits));
+		uint64_t depth = (uint64_t)((distanceBits & 0x7fffffff) >> (31 - SortKeyDepthBits));
+
+		return (shaderId << 48)
+			| (materialId << 32)
+			| (meshId << 16)
+			| ((uint64_t)(subMesh & SortKeySubMeshMask) << SortKeyDepthBits)
+			| depth;
+	}
+
+	uint32_t RendererSubmitionQueue::AllocateInstanceSlot(uint32_t objectId, const Math::Compact3DTransform& transform)
+	{
+		if (objectId == InvalidObjectId)
+		{
+			uint32_t slot = m_InstanceTable.AllocateSlot();
+			m_InstanceTable.SetTransform(slot, transform);
+			m_TransientInstanceSlots.push_back(slot);
+			return slot;
+		}
+
+		if (objectId >= (uint32_t)m_ObjectInstanceSlots.size())
+			m_ObjectInstanceSlots.resize((size_t)objectId + 1);
+
+		ObjectInstanceSlot& objectSlot = m_ObjectInstanceSlots[objectId];
+		if (objectSlot.Slot == InstanceTable::InvalidSlot)
+		{
+			objectSlot.Slot = m_InstanceTable.AllocateSlot();
+			m_PersistentSlotsCount++;
+		}
+
+		if (objectSlot.LastSubmittedFrame != m_FrameIndex)
+		{
+			objectSlot.LastSubmittedFrame = m_FrameIndex;
+			m_SubmittedObjectsCount++;
+		}
+
+		m_InstanceTable.SetTransform(objectSlot.Slot, transform);
+		return objectSlot.Slot;
 	}
 
 	void RendererSubmitionQueue::Clear()
 	{
 		m_ShadowPassBatches.clear();
 		m_Buffer.clear();
+		m_DynamicItems.clear();
+
+		// Transient slots were already uploaded and used by the previous frame
+		for (uint32_t slot : m_TransientInstanceSlots)
+			m_InstanceTable.ReleaseSlot(slot);
+
+		m_TransientInstanceSlots.clear();
+
+		m_FrameIndex++;
+		m_SubmittedObjectsCount = 0;
+
+		m_StaticGeometry.BeginFrame();
+	}
+
+	void RendererSubmitionQueue::FinishSubmitions()
+	{
+		Grapple_PROFILE_FUNCTION();
+		m_StaticGeometry.EndFrame();
+
+		// Every object with a slot was submitted, so there is nothing to release
+		if (m_SubmittedObjectsCount == m_PersistentSlotsCount)
+			return;
+
+		for (ObjectInstanceSlot& objectSlot : m_ObjectInstanceSlots)
+		{
+			if (objectSlot.Slot != InstanceTable::InvalidSlot && objectSlot.LastSubmittedFrame != m_FrameIndex)
+			{
+				m_InstanceTable.ReleaseSlot(objectSlot.Slot);
+				objectSlot.Slot = InstanceTable::InvalidSlot;
+				m_PersistentSlotsCount--;
+			}
+		}
 	}
 }
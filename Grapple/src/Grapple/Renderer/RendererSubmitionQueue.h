@@ -4,6 +4,8 @@
 
 #include "Grapple/Renderer/Mesh.h"
 #include "Grapple/Renderer/Material.h"
+#include "Grapple/Renderer/StaticGeometry.h"
+#include "Grapple/Renderer/InstanceTable.h"
 #include "Grapple/Math/Transform.h"
 
 #include <glm/glm.hpp>
@@ -19,7 +21,12 @@ namespace Grapple
 	public:
 		struct ShadowPassMeshSubmition
 		{
-			Math::Compact3DTransform Transform;
+			// World space bounds of the whole mesh
+			Math::AABB Bounds;
+			uint32_t InstanceSlot = InstanceTable::InvalidSlot;
+
+			// Index of the item of the first sub mesh, sub meshes are stored sequentially
+			uint32_t FirstItem = 0;
 			float SortKey = 0.0f;
 		};
 
@@ -37,13 +44,48 @@ namespace Grapple
 			Math::Compact3DTransform Transform;
 			MeshRenderFlags Flags = MeshRenderFlags::None;
 
-			float SortKey = 0.0f;
+			// World space bounds of the sub mesh
+			Math::AABB Bounds;
+
+			// Slot of the item's transform in the InstanceTable, shared by all sub meshes of a mesh
+			uint32_t InstanceSlot = InstanceTable::InvalidSlot;
+
+			// Packed as shader (16 bits), material (16 bits), mesh (16 bits), sub mesh (6 bits) and quantized camera distance (10 bits),
+			// so that sorting by the key groups items which can be instanced together and then orders them front to back
+			uint64_t SortKey = 0;
 		};
 
-		void Submit(Ref<const Mesh> mesh, Span<AssetHandle> materialHandles, const Math::Compact3DTransform& transform, MeshRenderFlags flags);
-		void Submit(Ref<const Mesh> mesh, Ref<const Material> material, const Math::Compact3DTransform& transform, MeshRenderFlags flags);
+		static constexpr uint32_t SortKeyDepthBits = 10;
+		static constexpr uint32_t SortKeySubMeshMask = 0x3f;
+
+		static constexpr uint32_t InvalidObjectId = UINT32_MAX;
+
+		// `objectId` must identify the same object between frames and is required for meshes with `MeshRenderFlags::Static`,
+		// otherwise the mesh is treated as dynamic. Objects with an id keep their instance slot between frames,
+		// so that their transform is only uploaded when it changes
+		void Submit(Ref<const Mesh> mesh,
+			Span<AssetHandle> materialHandles,
+			const Math::Compact3DTransform& transform,
+			MeshRenderFlags flags,
+			uint32_t objectId = InvalidObjectId);
+
+		void Submit(Ref<const Mesh> mesh,
+			Ref<const Material> material,
+			const Math::Compact3DTransform& transform,
+			MeshRenderFlags flags,
+			uint32_t objectId = InvalidObjectId);
 
-		void SubmitForShadowPass(const Ref<const Mesh>& mesh, const Math::Compact3DTransform& transform);
+		// Submits a mesh, whose materials and world space sub mesh bounds were resolved beforehand.
+		// A single material is used for all of the sub meshes, otherwise materials are indexed by sub mesh
+		void Submit(const Ref<const Mesh>& mesh,
+			Span<const Ref<const Material>> materials,
+			Span<const Math::AABB> subMeshBounds,
+			const Math::Compact3DTransform& transform,
+			MeshRenderFlags flags,
+			uint32_t objectId = InvalidObjectId);
+
+		// Must be called before the items of the mesh are added
+		void SubmitForShadowPass(const Ref<const Mesh>& mesh, const Math::AABB& bounds, uint32_t instanceSlot);
 
 		void Submit(const Ref<const Mesh>& mesh,
 			uint32_t subMesh,
@@ -51,29 +93,79 @@ namespace Grapple
 			const Math::Compact3DTransform& transform,
 			MeshRenderFlags flags)
 		{
-			Item& object = m_Buffer.emplace_back();
-			object.Material = material;
-			object.Flags = flags;
-			object.Mesh = mesh;
-			object.SubMeshIndex = subMesh;
-			object.Transform = transform;
-
-			glm::vec3 center = mesh->GetSubMeshes()[subMesh].Bounds.GetCenter();
-			center = object.Transform.RotationScale * center + object.Transform.Translation;
-			object.SortKey = glm::distance2(center, m_CameraPosition);
+			uint32_t instanceSlot = AllocateInstanceSlot(InvalidObjectId, mesh->GetVertexTransform(transform));
+
+			m_DynamicItems.push_back((uint32_t)m_Buffer.size());
+			AddItem(mesh, subMesh, material, transform, transform.TransformAABB(mesh->GetSubMeshes()[subMesh].Bounds), flags, instanceSlot);
 		}
 
 		inline size_t GetSize() const { return m_Buffer.size(); }
 		inline Item& operator[](size_t index) { return m_Buffer[index]; }
 		inline const Item& operator[](size_t index) const { return m_Buffer[index]; }
 
+		// Indices of items, which are not culled through the static geometry BVH
+		inline const std::vector<uint32_t>& GetDynamicItems() const { return m_DynamicItems; }
+		inline const StaticGeometry& GetStaticGeometry() const { return m_StaticGeometry; }
+
+		inline InstanceTable& GetInstanceTable() { return m_InstanceTable; }
+		inline const InstanceTable& GetInstanceTable() const { return m_InstanceTable; }
+
+		// Returns the instance slot of an object submitted during the current frame
+		inline uint32_t GetObjectInstanceSlot(uint32_t objectId) const { return m_ObjectInstanceSlots[objectId].Slot; }
+
 		inline const std::vector<ShadowPassBatch>& GetShadowPassBatches() const { return m_ShadowPassBatches; }
 
 		inline void SetCameraPosition(glm::vec3 cameraPosition) { m_CameraPosition = cameraPosition; }
 		void Clear();
+
+		// Must be called after all the meshes were submitted.
+		// Updates the static geometry and releases instance slots of objects, which weren't submitted during the frame
+		void FinishSubmitions();
+	private:
+		bool IsStaticSubmition(MeshRenderFlags flags, uint32_t objectId) const
+		{
+			return HAS_BIT(flags, MeshRenderFlags::Static) && objectId != InvalidObjectId;
+		}
+
+		// Static objects own a single set of items and a BVH entry, so repeated submitions during a frame are rejected
+		bool IsDuplicateStaticSubmition(MeshRenderFlags flags, uint32_t objectId) const;
+
+		void AddItem(const Ref<const Mesh>& mesh,
+			uint32_t subMesh,
+			const Ref<const Material>& material,
+			const Math::Compact3DTransform& transform,
+			const Math::AABB& bounds,
+			MeshRenderFlags flags,
+			uint32_t instanceSlot);
+
+		// Returns the persistent slot of the object or allocates a slot for the current frame when `objectId` is invalid.
+		// `transform` maps the vertices stored in the mesh to world space, see `Mesh::GetVertexTransform`
+		uint32_t AllocateInstanceSlot(uint32_t objectId, const Math::Compact3DTransform& transform);
+
+		uint64_t ComputeSortKey(const Ref<const Mesh>& mesh, uint32_t subMesh, const Ref<const Material>& material, float distanceSquared);
 	private:
 		glm::vec3 m_CameraPosition = glm::vec3(0.0f);
 		std::vector<Item> m_Buffer;
+		std::vector<uint32_t> m_DynamicItems;
+
+		StaticGeometry m_StaticGeometry;
+
+		struct ObjectInstanceSlot
+		{
+			uint32_t Slot = InstanceTable::InvalidSlot;
+			uint64_t LastSubmittedFrame = 0;
+		};
+
+		uint64_t m_FrameIndex = 0;
+		InstanceTable m_InstanceTable;
+
+		// Indexed by object id
+		std::vector<ObjectInstanceSlot> m_ObjectInstanceSlots;
+		size_t m_SubmittedObjectsCount = 0;
+		size_t m_PersistentSlotsCount = 0;
+
+		// Slots of objects without an id, which are released at the start of the next frame
+		std::vector<uint32_t> m_TransientInstanceSlots;
 
 		std::vector<ShadowPassBatch> m_ShadowPassBatches;
 	};
@@ -5,6 +5,7 @@
 #include "Grapple/AssetManager/Asset.h"
 #include "Grapple/Renderer/RendererAPI.h"
 #include "Grapple/Renderer/ShaderMetadata.h"
+#include "Grapple/Renderer/SortId.h"
 
 #include <glm/glm.hpp>
 
@@ -13,6 +14,7 @@
 
 namespace Grapple
 {
+	class MaterialDataTable;
 	class Grapple_API Shader : public Asset
 	{
 	public:
@@ -32,7 +34,16 @@ namespace Grapple
 		virtual const ShaderOutputs& GetOutputs() const = 0;
 		virtual ShaderFeatures GetFeatures() const = 0;
 		virtual std::optional<uint32_t> GetPropertyIndex(std::string_view name) const = 0;
+
+		// Table of the properties of materials, which use this shader. Null if the shader doesn't store the properties in a table
+		inline const Ref<MaterialDataTable>& GetMaterialDataTable() const { return m_MaterialDataTable; }
+
+		inline uint16_t GetSortId() const { return m_SortId.GetValue(); }
 	public:
 		static Ref<Shader> Create();
+	protected:
+		Ref<MaterialDataTable> m_MaterialDataTable = nullptr;
+	private:
+		SortId m_SortId = SortId(SortIdType::Shader);
 	};
 }
\ No newline at end of file
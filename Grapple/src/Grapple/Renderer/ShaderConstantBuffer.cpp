@@ -84,6 +84,8 @@ namespace Grapple
 			m_BufferSize = glm::max(range.Offset + range.Size, m_BufferSize);
 		}
 
+		m_BufferSize = glm::max(metadata->MaterialDataSize, m_BufferSize);
+
 		if (m_BufferSize > 0)
 		{
 			m_Buffer = new uint8_t[m_BufferSize];
@@ -136,6 +136,11 @@ namespace Grapple
 		case ShaderDataType::Sampler:
 		case ShaderDataType::StorageImage:
 			return 4;
+		case ShaderDataType::Half2:
+		case ShaderDataType::SNorm16x2:
+			return 2 * 2;
+		case ShaderDataType::UNorm16x4:
+			return 2 * 4;
 		}
 
 		return 0;
@@ -156,6 +161,11 @@ namespace Grapple
 			return 4;
 		case ShaderDataType::Matrix4x4:
 			return 16;
+		case ShaderDataType::Half2:
+		case ShaderDataType::SNorm16x2:
+			return 2;
+		case ShaderDataType::UNorm16x4:
+			return 4;
 		}
 
 		return 0;
@@ -82,6 +82,11 @@ namespace Grapple
 		StorageImage,
 
 		Matrix4x4,
+
+		// Vertex attribute only types, which are converted to floats when fetched
+		Half2,
+		SNorm16x2,
+		UNorm16x4,
 	};
 
 	Grapple_API uint32_t ShaderDataTypeSize(ShaderDataType dataType);
@@ -212,5 +217,11 @@ namespace Grapple
 		std::vector<ShaderStageType> Stages;
 		std::vector<ShaderPushConstantsRange> PushConstantsRanges;
 		std::vector<VertexShaderInput> VertexShaderInputs;
+
+		// Material properties, declared as an element of a `MaterialTable` storage buffer in the material descriptor set,
+		// are stored in the shader's MaterialDataTable instead of push constants.
+		// Size of a single table entry and the binding of the table, zero size if the shader doesn't use the table
+		size_t MaterialDataSize = 0;
+		uint32_t MaterialTableBinding = UINT32_MAX;
 	};
 }
\ No newline at end of file
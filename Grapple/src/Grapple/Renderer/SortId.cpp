@@ -0,0 +1,52 @@
+#include "SortId.h"
+
+#include "GrappleCore/Assert.h"
+
+#include <mutex>
+#include <vector>
+
+namespace Grapple
+{
+	struct SortIdPool
+	{
+		std::mutex Mutex;
+		std::vector<uint16_t> FreeIds;
+		uint16_t NextId = 0;
+	};
+
+	static SortIdPool& GetSortIdPool(SortIdType type)
+	{
+		static SortIdPool s_Pools[3];
+
+		size_t index = (size_t)type;
+		Grapple_CORE_ASSERT(index < 3);
+		return s_Pools[index];
+	}
+
+	SortId::SortId(SortIdType type)
+		: m_Type(type)
+	{
+		SortIdPool& pool = GetSortIdPool(type);
+		std::lock_guard lock(pool.Mutex);
+
+		if (!pool.FreeIds.empty())
+		{
+			m_Value = pool.FreeIds.back();
+			pool.FreeIds.pop_back();
+		}
+		else if (pool.NextId != Shared)
+		{
+			m_Value = pool.NextId++;
+		}
+	}
+
+	SortId::~SortId()
+	{
+		if (m_Value == Shared)
+			return;
+
+		SortIdPool& pool = GetSortIdPool(m_Type);
+		std::lock_guard lock(pool.Mutex);
+		pool.FreeIds.push_back(m_Value);
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "GrappleCore/Core.h"
+
+#include <stdint.h>
+
+namespace Grapple
+{
+	enum class SortIdType : uint8_t
+	{
+		Shader,
+		Material,
+		Mesh,
+	};
+
+	// Compact id, used for building draw sort keys. The id is allocated when the owner is created
+	// and recycled when it's destroyed, ids of different types are allocated independently.
+	//
+	// Once all the ids of a type are in use, new owners share `SortId::Shared`, which only affects the grouping of draws
+	class Grapple_API SortId
+	{
+	public:
+		static constexpr uint16_t Shared = UINT16_MAX;
+
+		SortId(SortIdType type);
+		~SortId();
+
+		SortId(const SortId&) = delete;
+		SortId& operator=(const SortId&) = delete;
+
+		inline uint16_t GetValue() const { return m_Value; }
+	private:
+		SortIdType m_Type;
+		uint16_t m_Value = Shared;
+	};
+}
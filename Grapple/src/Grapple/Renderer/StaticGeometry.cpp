@@ -0,0 +1,169 @@
+#include "StaticGeometry.h"
+
+#include "GrappleCore/Assert.h"
+#include "GrappleCore/Profiler/Profiler.h"
+
+#include "Grapple/Renderer/Mesh.h"
+
+namespace Grapple
+{
+	void StaticGeometry::BeginFrame()
+	{
+		m_FrameIndex++;
+		m_SubmittedObjectsCount = 0;
+	}
+
+	void StaticGeometry::Submit(uint32_t objectId, const Ref<const Mesh>& mesh, const Math::Compact3DTransform& transform, uint32_t firstItem, uint32_t instanceSlot, bool castsShadows)
+	{
+		if (objectId >= (uint32_t)m_Objects.size())
+			m_Objects.resize((size_t)objectId + 1);
+
+		Object& object = m_Objects[objectId];
+		Grapple_CORE_ASSERT(!object.IsAlive || object.LastSubmittedFrame != m_FrameIndex, "Static objects can only be submitted once per frame");
+
+		bool castedShadows = object.ShadowCasterLeaf != CullingBVH::InvalidIndex;
+		if (!object.IsAlive
+			|| object.Mesh.get() != mesh.get()
+			|| object.SubMeshLeaves.size() != mesh->GetSubMeshes().size()
+			|| castedShadows != castsShadows)
+		{
+			if (object.IsAlive)
+				RemoveObject(objectId);
+
+			AddObject(objectId, mesh, transform, castsShadows);
+		}
+		else if (object.Transform.RotationScale != transform.RotationScale || object.Transform.Translation != transform.Translation)
+		{
+			object.Transform = transform;
+			UpdateObjectBounds(object);
+		}
+
+		object.FirstItem = firstItem;
+		object.InstanceSlot = instanceSlot;
+		object.LastSubmittedFrame = m_FrameIndex;
+		m_SubmittedObjectsCount++;
+	}
+
+	void StaticGeometry::EndFrame()
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		// Every alive object was submitted once, so there is nothing to remove
+		if (m_SubmittedObjectsCount != m_AliveObjectsCount)
+		{
+			for (uint32_t objectId = 0; objectId < (uint32_t)m_Objects.size(); objectId++)
+			{
+				if (m_Objects[objectId].IsAlive && m_Objects[objectId].LastSubmittedFrame != m_FrameIndex)
+					RemoveObject(objectId);
+			}
+		}
+
+		m_SubMeshesTree.Update();
+		m_ShadowCastersTree.Update();
+	}
+
+	void StaticGeometry::Clear()
+	{
+		m_Objects.clear();
+		m_SubMeshLeaves.clear();
+		m_ShadowCasterLeaves.clear();
+
+		m_SubMeshesTree.Clear();
+		m_ShadowCastersTree.Clear();
+
+		m_SubmittedObjectsCount = 0;
+		m_AliveObjectsCount = 0;
+	}
+
+	void StaticGeometry::CullSubMeshes(const Math::Plane* planes, size_t planesCount, std::vector<uint32_t>& visibleItems) const
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		size_t firstVisible = visibleItems.size();
+		m_SubMeshesTree.Cull(planes, planesCount, visibleItems);
+
+		// Replace leaf ids with indices of the submitted items
+		for (size_t i = firstVisible; i < visibleItems.size(); i++)
+		{
+			const SubMeshLeaf& leaf = m_SubMeshLeaves[visibleItems[i]];
+			visibleItems[i] = m_Objects[leaf.ObjectId].FirstItem + leaf.SubMeshIndex;
+		}
+	}
+
+	void StaticGeometry::CullShadowCasters(const Math::Plane* planes, size_t planesCount, std::vector<uint32_t>& visibleObjects) const
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		size_t firstVisible = visibleObjects.size();
+		m_ShadowCastersTree.Cull(planes, planesCount, visibleObjects);
+
+		for (size_t i = firstVisible; i < visibleObjects.size(); i++)
+			visibleObjects[i] = m_ShadowCasterLeaves[visibleObjects[i]];
+	}
+
+	void StaticGeometry::AddObject(uint32_t objectId, const Ref<const Mesh>& mesh, const Math::Compact3DTransform& transform, bool castsShadows)
+	{
+		Object& object = m_Objects[objectId];
+		object.Mesh = mesh;
+		object.Transform = transform;
+		object.Bounds = transform.TransformAABB(mesh->GetBounds());
+		object.IsAlive = true;
+
+		const auto& subMeshes = mesh->GetSubMeshes();
+		object.SubMeshLeaves.resize(subMeshes.size());
+
+		for (uint32_t subMeshIndex = 0; subMeshIndex < (uint32_t)subMeshes.size(); subMeshIndex++)
+		{
+			uint32_t leaf = m_SubMeshesTree.Insert(transform.TransformAABB(subMeshes[subMeshIndex].Bounds));
+			if (leaf >= (uint32_t)m_SubMeshLeaves.size())
+				m_SubMeshLeaves.resize((size_t)leaf + 1);
+
+			m_SubMeshLeaves[leaf].ObjectId = objectId;
+			m_SubMeshLeaves[leaf].SubMeshIndex = subMeshIndex;
+			object.SubMeshLeaves[subMeshIndex] = leaf;
+		}
+
+		if (castsShadows)
+		{
+			uint32_t leaf = m_ShadowCastersTree.Insert(object.Bounds);
+			if (leaf >= (uint32_t)m_ShadowCasterLeaves.size())
+				m_ShadowCasterLeaves.resize((size_t)leaf + 1);
+
+			m_ShadowCasterLeaves[leaf] = objectId;
+			object.ShadowCasterLeaf = leaf;
+		}
+
+		m_AliveObjectsCount++;
+	}
+
+	void StaticGeometry::RemoveObject(uint32_t objectId)
+	{
+		Object& object = m_Objects[objectId];
+		Grapple_CORE_ASSERT(object.IsAlive);
+
+		for (uint32_t leaf : object.SubMeshLeaves)
+			m_SubMeshesTree.Remove(leaf);
+
+		if (object.ShadowCasterLeaf != CullingBVH::InvalidIndex)
+			m_ShadowCastersTree.Remove(object.ShadowCasterLeaf);
+
+		object.Mesh = nullptr;
+		object.SubMeshLeaves.clear();
+		object.ShadowCasterLeaf = CullingBVH::InvalidIndex;
+		object.IsAlive = false;
+
+		m_AliveObjectsCount--;
+	}
+
+	void StaticGeometry::UpdateObjectBounds(Object& object)
+	{
+		object.Bounds = object.Transform.TransformAABB(object.Mesh->GetBounds());
+
+		const auto& subMeshes = object.Mesh->GetSubMeshes();
+		for (size_t subMeshIndex = 0; subMeshIndex < object.SubMeshLeaves.size(); subMeshIndex++)
+			m_SubMeshesTree.SetBounds(object.SubMeshLeaves[subMeshIndex], object.Transform.TransformAABB(subMeshes[subMeshIndex].Bounds));
+
+		if (object.ShadowCasterLeaf != CullingBVH::InvalidIndex)
+			m_ShadowCastersTree.SetBounds(object.ShadowCasterLeaf, object.Bounds);
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "GrappleCore/Core.h"
+
+#include "Grapple/Math/Math.h"
+#include "Grapple/Math/Transform.h"
+#include "Grapple/Renderer/CullingBVH.h"
+
+#include <vector>
+
+namespace Grapple
+{
+	class Mesh;
+
+	// Keeps bounds of static meshes in persistent BVHs, so that culling cost depends on the number
+	// of visible objects rather than on the total number of static objects.
+	//
+	// Static meshes are still submitted every frame, which links each object to its current submitted items.
+	// Objects whose transform changed are refit, while objects that were not submitted during a frame are removed.
+	class Grapple_API StaticGeometry
+	{
+	public:
+		struct Object
+		{
+			Ref<const Mesh> Mesh = nullptr;
+			Math::Compact3DTransform Transform;
+
+			// World space bounds of the whole mesh
+			Math::AABB Bounds;
+
+			// Index of the first submitted item in the RendererSubmitionQueue, sub meshes are stored sequentially
+			uint32_t FirstItem = 0;
+			uint32_t InstanceSlot = 0;
+			uint32_t ShadowCasterLeaf = CullingBVH::InvalidIndex;
+			uint64_t LastSubmittedFrame = 0;
+
+			std::vector<uint32_t> SubMeshLeaves;
+			bool IsAlive = false;
+		};
+
+		void BeginFrame();
+		void Submit(uint32_t objectId, const Ref<const Mesh>& mesh, const Math::Compact3DTransform& transform, uint32_t firstItem, uint32_t instanceSlot, bool castsShadows);
+		void EndFrame();
+
+		void Clear();
+
+		inline bool IsSubmitted(uint32_t objectId) const
+		{
+			return objectId < (uint32_t)m_Objects.size() && m_Objects[objectId].IsAlive && m_Objects[objectId].LastSubmittedFrame == m_FrameIndex;
+		}
+
+		// Appends indices of visible sub mesh items in the RendererSubmitionQueue
+		void CullSubMeshes(const Math::Plane* planes, size_t planesCount, std::vector<uint32_t>& visibleItems) const;
+
+		// Appends ids of objects, which cast shadows and whose mesh bounds are visible
+		void CullShadowCasters(const Math::Plane* planes, size_t planesCount, std::vector<uint32_t>& visibleObjects) const;
+
+		inline const Object& GetObject(uint32_t objectId) const { return m_Objects[objectId]; }
+		inline size_t GetObjectsCount() const { return m_AliveObjectsCount; }
+	private:
+		struct SubMeshLeaf
+		{
+			uint32_t ObjectId = 0;
+			uint32_t SubMeshIndex = 0;
+		};
+
+		void AddObject(uint32_t objectId, const Ref<const Mesh>& mesh, const Math::Compact3DTransform& transform, bool castsShadows);
+		void RemoveObject(uint32_t objectId);
+		void UpdateObjectBounds(Object& object);
+	private:
+		uint64_t m_FrameIndex = 0;
+		size_t m_SubmittedObjectsCount = 0;
+		size_t m_AliveObjectsCount = 0;
+
+		// Indexed by object id
+		std::vector<Object> m_Objects;
+
+		CullingBVH m_SubMeshesTree;
+		CullingBVH m_ShadowCastersTree;
+
+		// Indexed by leaf ids of the corresponding trees
+		std::vector<SubMeshLeaf> m_SubMeshLeaves;
+		std::vector<uint32_t> m_ShadowCasterLeaves;
+	};
+}
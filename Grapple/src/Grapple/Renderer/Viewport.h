@@ -54,6 +54,10 @@ namespace Grapple
 
 		inline bool IsDebugRenderingEnabled() const { return m_DebugRenderingEnabled; }
 		void SetDebugRenderingEnabled(bool enabled);
+
+		// Multiplies projected sizes of meshes when selecting their LODs, values below 1 select coarser LODs
+		inline float GetLODBias() const { return m_LODBias; }
+		inline void SetLODBias(float bias) { m_LODBias = bias; }
 	public:
 		RenderData FrameData;
 
@@ -71,6 +75,8 @@ namespace Grapple
 		bool m_ShadowMappingEnabled = true;
 		bool m_DebugRenderingEnabled = false;
 
+		float m_LODBias = 1.0f;
+
 		bool m_ShouldResizeRenderGraphTextures = false;
 
 		TextureFormat m_ColorTextureFormat = TextureFormat::RGB8;
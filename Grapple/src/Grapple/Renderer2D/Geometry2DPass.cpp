@@ -8,6 +8,7 @@
 #include "Grapple/Renderer/Texture.h"
 #include "Grapple/Renderer/Buffer.h"
 #include "Grapple/Renderer/CommandBuffer.h"
+#include "Grapple/Renderer/BindlessTextureTable.h"
 #include "Grapple/Platform/Vulkan/VulkanVertexBuffer.h"
 
 #include "Grapple/Platform/Vulkan/VulkanCommandBuffer.h"
@@ -46,6 +47,12 @@ namespace Grapple
 		commandBuffer->BindVertexBuffers(Span((Ref<const VertexBuffer>*)&m_VertexBuffer, 1), 0);
 		commandBuffer->BindIndexBuffer(m_IndexBuffer);
 
+		if (m_FrameData.BindlessTextures)
+		{
+			m_FrameData.BindlessTextures->FlushWrites();
+			commandBuffer->SetGlobalDescriptorSet(m_FrameData.BindlessTextures->GetDescriptorSet(), 1);
+		}
+
 		for (const auto& batch : m_FrameData.QuadBatches)
 		{
 			if (batch.Count == 0)
@@ -77,14 +84,19 @@ namespace Grapple
 			Ref<VulkanCommandBuffer> vulkanCommandBuffer = As<VulkanCommandBuffer>(commandBuffer);
 			Ref<FrameBuffer> renderTarget = context.GetRenderTarget();
 
-			Ref<DescriptorSet> descriptorSet = m_FrameData.QuadDescriptorSetsPool->AllocateSet();
-			descriptorSet->SetDebugName("QuadsDescriptorSet");
-			descriptorSet->WriteImages(Span((Ref<const Texture>*)batch.Textures, Renderer2DLimits::MaxTexturesCount), 0, 0);
-			descriptorSet->FlushWrites();
+			// The bindless texture array is bound once for all batches
+			if (!m_FrameData.BindlessTextures)
+			{
+				Ref<DescriptorSet> descriptorSet = m_FrameData.QuadDescriptorSetsPool->AllocateSet();
+				descriptorSet->SetDebugName("QuadsDescriptorSet");
+				descriptorSet->WriteImages(Span((Ref<const Texture>*)batch.Textures, Renderer2DLimits::MaxTexturesCount), 0, 0);
+				descriptorSet->FlushWrites();
+
+				m_UsedSets.push_back(descriptorSet);
 
-			m_UsedSets.push_back(descriptorSet);
+				commandBuffer->SetGlobalDescriptorSet(descriptorSet, 1);
+			}
 
-			commandBuffer->SetGlobalDescriptorSet(descriptorSet, 1);
 			commandBuffer->ApplyMaterial(batch.Material);
 
 			commandBuffer->SetViewportAndScisors(Math::Rect(glm::vec2(0.0f), (glm::vec2)renderTarget->GetSize()));
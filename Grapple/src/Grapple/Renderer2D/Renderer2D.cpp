@@ -5,16 +5,21 @@
 
 #include "Grapple/Math/Math.h"
 
+#include "Grapple/Core/JobSystem.h"
+
 #include "Grapple/AssetManager/AssetManager.h"
 
 #include "Grapple/Renderer/Viewport.h"
 #include "Grapple/Renderer/Renderer.h"
 #include "Grapple/Renderer/ShaderLibrary.h"
 #include "Grapple/Renderer/Pipeline.h"
+#include "Grapple/Renderer/GraphicsContext.h"
+#include "Grapple/Renderer/BindlessTextureTable.h"
 
 #include "Grapple/Renderer2D/Renderer2DFrameData.h"
 #include "Grapple/Renderer2D/Geometry2DPass.h"
 #include "Grapple/Renderer2D/TextPass.h"
+#include "Grapple/Renderer2D/TextLayout.h"
 
 #include "Grapple/Project/Project.h"
 
@@ -23,7 +28,11 @@
 #include "Grapple/Platform/Vulkan/VulkanDescriptorSet.h"
 
 #include <algorithm>
-#include <cctype>
+#include <cstddef>
+#include <cstring>
+
+#include <glm/gtc/type_ptr.hpp>
+#include <immintrin.h>
 
 namespace Grapple
 {
@@ -42,6 +51,16 @@ namespace Grapple
 
 		glm::vec3 QuadVertices[4] = { glm::vec3(0.0f) };
 		glm::vec2 QuadUV[4] = { glm::vec2(0.0f) };
+
+		// Consecutive quads usually share a texture, so the last looked up bindless index is cached
+		const Texture* LastBindlessTexture = nullptr;
+		uint32_t LastBindlessTextureIndex = 0;
+
+		// Texture index of each sprite drawn by DrawSprites
+		std::vector<uint32_t> SpriteTextureIndices;
+
+		// Used by DrawString, which doesn't have a persistent layout of the text
+		TextLayout StringLayout;
 	};
 
 	Renderer2DData s_Renderer2DData;
@@ -86,6 +105,13 @@ namespace Grapple
 
 		if (RendererAPI::GetAPI() == RendererAPI::API::Vulkan)
 		{
+			const GraphicsContextFeatures& features = GraphicsContext::GetInstance().GetFeatures();
+			if (features.BindlessTextures)
+			{
+				uint32_t capacity = glm::min(features.MaxBindlessTextures, Renderer2DLimits::MaxBindlessTexturesCount);
+				s_Renderer2DData.FrameData.BindlessTextures = CreateRef<BindlessTextureTable>(capacity, "QuadsBindlessTextures");
+			}
+
 			{
 				VkDescriptorSetLayoutBinding bindings[1] = {};
 				bindings[0].binding = 0;
@@ -112,7 +138,8 @@ namespace Grapple
 
 	static void ReloadShaders()
 	{
-		std::optional<AssetHandle> quadShaderHandle = ShaderLibrary::FindShader("QuadShader");
+		std::optional<AssetHandle> quadShaderHandle = ShaderLibrary::FindShader(
+			s_Renderer2DData.FrameData.BindlessTextures ? "QuadShaderBindless" : "QuadShader");
 
 		if (!quadShaderHandle || !AssetManager::IsAssetHandleValid(quadShaderHandle.value()))
 			Grapple_CORE_ERROR("Renderer 2D: Failed to find Quad shader");
@@ -144,7 +171,7 @@ namespace Grapple
 	static QuadsBatch& BeginQuadBatch()
 	{
 		// Fill remaining texture slots of the previous batch with white textures
-		if (s_Renderer2DData.FrameData.QuadBatches.size() > 0)
+		if (s_Renderer2DData.FrameData.QuadBatches.size() > 0 && !s_Renderer2DData.FrameData.BindlessTextures)
 		{
 			FillRemainingTextureSlots(s_Renderer2DData.FrameData.QuadBatches.back());
 		}
@@ -152,16 +179,126 @@ namespace Grapple
 		return s_Renderer2DData.FrameData.QuadBatches.emplace_back();
 	}
 
+	// Starts a new batch, which continues the last one with the same material
+	static QuadsBatch& SplitQuadBatch()
+	{
+		Ref<Material> material = s_Renderer2DData.FrameData.QuadBatches.back().Material;
+		uint32_t start = s_Renderer2DData.FrameData.QuadBatches.back().GetEnd();
+
+		QuadsBatch& batch = BeginQuadBatch();
+		batch.Material = material;
+		batch.Start = start;
+		return batch;
+	}
+
 	void Renderer2D::Shutdown()
 	{
 		s_Renderer2DData = {};
 	}
 
+	static uint32_t GetBindlessTextureIndex(const Ref<Texture>& texture)
+	{
+		if (texture.get() == s_Renderer2DData.LastBindlessTexture)
+			return s_Renderer2DData.LastBindlessTextureIndex;
+
+		uint32_t index = s_Renderer2DData.FrameData.BindlessTextures->GetTextureIndex(texture);
+		if (index == BindlessTextureTable::InvalidIndex)
+		{
+			Grapple_CORE_ERROR("Renderer 2D: Bindless texture table is full");
+			return 0;
+		}
+
+		s_Renderer2DData.LastBindlessTexture = texture.get();
+		s_Renderer2DData.LastBindlessTextureIndex = index;
+		return index;
+	}
+
+	// Returns the texture index for a quad added to the last batch, which might start a new batch
+	// in case the last one doesn't have any free texture slots left
+	static uint32_t GetQuadTextureIndex(const Ref<Texture>& texture)
+	{
+		if (s_Renderer2DData.FrameData.BindlessTextures)
+			return GetBindlessTextureIndex(texture);
+
+		if (s_Renderer2DData.FrameData.QuadBatches.back().TexturesCount == Renderer2DLimits::MaxTexturesCount)
+			SplitQuadBatch();
+
+		return s_Renderer2DData.FrameData.QuadBatches.back().GetTextureIndex(texture);
+	}
+
+	// Corners of a quad are computed from the X and Y axes of the transform,
+	// the positions are written as 4 floats, so the color must directly follow the position
+	static_assert(offsetof(QuadVertex, Color) == sizeof(glm::vec3));
+
+	static void GenerateSpriteVertices(const SpriteInstance& sprite, uint32_t textureIndex, QuadVertex* vertices)
+	{
+		glm::vec2 uvMin = glm::vec2(0.0f);
+		glm::vec2 uvMax = glm::vec2(1.0f);
+
+		if (sprite.Sprite)
+		{
+			uvMin = sprite.Sprite->UVMin;
+			uvMax = sprite.Sprite->UVMax;
+		}
+
+		if (HAS_BIT(sprite.Flags, SpriteRenderFlags::FlipX))
+			std::swap(uvMin.x, uvMax.x);
+		if (HAS_BIT(sprite.Flags, SpriteRenderFlags::FlipY))
+			std::swap(uvMin.y, uvMax.y);
+
+		// DrawSprite applies the tiling both to the sprite UVs and to the quad UVs
+		glm::vec2 uvScale = sprite.Tiling * sprite.Tiling;
+		uvMin *= uvScale;
+		uvMax *= uvScale;
+
+		glm::vec2 uvs[4] =
+		{
+			uvMin,
+			glm::vec2(uvMin.x, uvMax.y),
+			uvMax,
+			glm::vec2(uvMax.x, uvMin.y),
+		};
+
+		const float* matrix = glm::value_ptr(sprite.Transform);
+		__m128 halfScale = _mm_set1_ps(0.5f);
+		__m128 halfAxisX = _mm_mul_ps(_mm_loadu_ps(matrix), halfScale);
+		__m128 halfAxisY = _mm_mul_ps(_mm_loadu_ps(matrix + 4), halfScale);
+		__m128 origin = _mm_loadu_ps(matrix + 12);
+
+		// (-0.5, -0.5), (-0.5, 0.5), (0.5, 0.5), (0.5, -0.5)
+		__m128 corners[4] =
+		{
+			_mm_sub_ps(_mm_sub_ps(origin, halfAxisX), halfAxisY),
+			_mm_add_ps(_mm_sub_ps(origin, halfAxisX), halfAxisY),
+			_mm_add_ps(_mm_add_ps(origin, halfAxisX), halfAxisY),
+			_mm_sub_ps(_mm_add_ps(origin, halfAxisX), halfAxisY),
+		};
+
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			QuadVertex& vertex = vertices[i];
+
+			// The W component overlaps with the color, which is written afterwards
+			_mm_storeu_ps(glm::value_ptr(vertex.Position), corners[i]);
+
+			vertex.Color = sprite.Color;
+			vertex.UV = uvs[i];
+			vertex.TextureIndex = textureIndex;
+			vertex.EntityIndex = sprite.EntityIndex;
+		}
+	}
+
 	void Renderer2D::BeginFrame()
 	{
 		Grapple_PROFILE_FUNCTION();
 
 		s_Renderer2DData.FrameData.QuadBatches.clear();
+
+		if (s_Renderer2DData.FrameData.BindlessTextures)
+		{
+			s_Renderer2DData.LastBindlessTexture = nullptr;
+			s_Renderer2DData.FrameData.BindlessTextures->BeginFrame();
+		}
 	}
 
 	void Renderer2D::EndFrame()
@@ -179,7 +316,7 @@ namespace Grapple
 	void Renderer2D::End()
 	{
 		// Make sure that all empty texture slots of the last batch are filled with white textures
-		if (s_Renderer2DData.FrameData.QuadBatches.size() > 0)
+		if (s_Renderer2DData.FrameData.QuadBatches.size() > 0 && !s_Renderer2DData.FrameData.BindlessTextures)
 		{
 			FillRemainingTextureSlots(s_Renderer2DData.FrameData.QuadBatches.back());
 		}
@@ -224,18 +361,23 @@ namespace Grapple
 
 	void Renderer2D::SetMaterial(const Ref<Material>& material)
 	{
-		Grapple_CORE_ASSERT(s_Renderer2DData.FrameData.QuadBatches.size() > 0);
-		Grapple_CORE_ASSERT(material);
+		// Null material switches back to the default one
+		const Ref<Material>& newMaterial = material != nullptr ? material : s_Renderer2DData.DefaultMaterial;
+		Grapple_CORE_ASSERT(newMaterial);
 
-		size_t lastBatchIndex = s_Renderer2DData.FrameData.QuadBatches.size() - 1;
-		QuadsBatch& batch = BeginQuadBatch();
-		batch.Material = material;
-		batch.Count = 0;
+		s_Renderer2DData.CurrentMaterial = newMaterial;
+
+		if (s_Renderer2DData.FrameData.QuadBatches.size() > 0 && s_Renderer2DData.FrameData.QuadBatches.back().Material == newMaterial)
+			return;
 
+		uint32_t start = 0;
 		if (s_Renderer2DData.FrameData.QuadBatches.size() > 0)
-			batch.Start = s_Renderer2DData.FrameData.QuadBatches[lastBatchIndex].GetEnd();
+			start = s_Renderer2DData.FrameData.QuadBatches.back().GetEnd();
 
-		s_Renderer2DData.CurrentMaterial = material;
+		QuadsBatch& batch = BeginQuadBatch();
+		batch.Material = newMaterial;
+		batch.Start = start;
+		batch.Count = 0;
 	}
 
 	Ref<Material> Renderer2D::GetMaterial()
@@ -373,14 +515,10 @@ namespace Grapple
 			Grapple_CORE_ASSERT(false);
 		}
 
-		if (s_Renderer2DData.FrameData.QuadBatches.back().TexturesCount == Renderer2DLimits::MaxTexturesCount)
-		{
-			BeginQuadBatch();
-		}
+		uint32_t textureIndex = GetQuadTextureIndex(texture == nullptr ? Renderer::GetWhiteTexture() : texture);
 
 		QuadsBatch& currentBatch = s_Renderer2DData.FrameData.QuadBatches.back();
 		size_t vertexIndex = s_Renderer2DData.FrameData.QuadCount * 4;
-		uint32_t textureIndex = currentBatch.GetTextureIndex(texture == nullptr ? Renderer::GetWhiteTexture() : texture);
 
 		for (uint32_t i = 0; i < 4; i++)
 		{
@@ -397,147 +535,122 @@ namespace Grapple
 		s_Renderer2DData.Stats.QuadsCount++;
 	}
 
-	void Renderer2D::DrawString(std::string_view text, const glm::mat4& transform, const Ref<Font>& font, const glm::vec4& color, int32_t entityIndex)
+	void Renderer2D::DrawSprites(Span<const SpriteInstance> sprites)
 	{
 		Grapple_PROFILE_FUNCTION();
 
-		if (s_Renderer2DData.FrameData.TextBatches.empty() || s_Renderer2DData.FrameData.TextBatches.back().Font.get() != font.get())
+		if (sprites.IsEmpty())
+			return;
+
+		if (s_Renderer2DData.FrameData.QuadBatches.size() == 0)
 		{
-			TextBatch& batch = s_Renderer2DData.FrameData.TextBatches.emplace_back();
-			batch.Start = (uint32_t)s_Renderer2DData.FrameData.TextQuadCount;
-			batch.Count = 0;
-			batch.Font = font;
+			QuadsBatch& batch = BeginQuadBatch();
+			batch.Material = s_Renderer2DData.DefaultMaterial;
 		}
 
-		TextBatch& batch = s_Renderer2DData.FrameData.TextBatches.back();
-
-		const auto& msdfData = font->GetData();
-		const auto& geometry = msdfData.Geometry;
-		const auto& metrics = msdfData.Geometry.getMetrics();
-
-		float kerningOffset = 0.0f;
-		float lineHeightOffset = 0.0f;
-
-		const Ref<Texture>& fontAtlas = font->GetAtlas();
-		glm::vec2 texelSize = glm::vec2(1.0f / fontAtlas->GetWidth(), 1.0f / fontAtlas->GetHeight());
-		glm::vec2 position = glm::vec2(0.0f);
-
-		float fontScale = 1.0f / (float)(metrics.ascenderY - metrics.descenderY);
-		position.y = -fontScale * (float)metrics.ascenderY;
-
-		const msdf_atlas::GlyphGeometry* errorGlyph = geometry.getGlyph('?');
-		const msdf_atlas::GlyphGeometry* spaceGlyph = geometry.getGlyph(' ');
-		
-		struct Rect
+		size_t spritesCount = sprites.GetSize();
+		size_t availableQuads = s_Renderer2DData.Limits.MaxQuadCount - s_Renderer2DData.FrameData.QuadCount;
+		if (spritesCount > availableQuads)
 		{
-			double Top;
-			double Right;
-			double Bottom;
-			double Left;
-		};
+			Grapple_CORE_ASSERT(false);
+			spritesCount = availableQuads;
+		}
 
-		for (size_t charIndex = 0; charIndex < text.size(); charIndex++)
+		// Textures are resolved on the calling thread, because they decide where batches are split
 		{
-			if (text[charIndex] == 0)
-				break;
+			Grapple_PROFILE_SCOPE("ResolveTextures");
 
-			const msdf_atlas::GlyphGeometry* glyph = geometry.getGlyph(text[charIndex]);
+			Ref<Texture> whiteTexture = Renderer::GetWhiteTexture();
+			std::vector<uint32_t>& textureIndices = s_Renderer2DData.SpriteTextureIndices;
+			textureIndices.resize(spritesCount);
 
-			if (!glyph)
-				glyph = errorGlyph;
-			if (!glyph)
-				return;
+			const Texture* lastTexture = nullptr;
+			uint32_t lastTextureIndex = 0;
+			size_t lastBatchIndex = s_Renderer2DData.FrameData.QuadBatches.size() - 1;
 
-			if (text[charIndex] == '\r')
-				continue;
-			else if (text[charIndex] == '\t')
-				glyph = spaceGlyph;
-			else if (text[charIndex] == '\n')
-			{
-				position.x = 0;
-				position.y -= fontScale * (float)metrics.lineHeight + lineHeightOffset;
-				continue;
-			}
-			else if (!std::isspace(text[charIndex]))
+			for (size_t i = 0; i < spritesCount; i++)
 			{
-				Rect atlasBounds;
-				Rect planeBounds;
-				glyph->getQuadAtlasBounds(atlasBounds.Left, atlasBounds.Bottom, atlasBounds.Right, atlasBounds.Top);
-				glyph->getQuadPlaneBounds(planeBounds.Left, planeBounds.Bottom, planeBounds.Right, planeBounds.Top);
+				const Sprite* sprite = sprites[i].Sprite;
+				const Ref<Texture>& texture = sprite != nullptr && sprite->GetTexture() != nullptr ? sprite->GetTexture() : whiteTexture;
 
-				glm::vec2 min = glm::vec2(planeBounds.Left, planeBounds.Bottom);
-				glm::vec2 max = glm::vec2(planeBounds.Right, planeBounds.Top);
+				// Consecutive sprites often share a texture
+				if (texture.get() != lastTexture || lastBatchIndex != s_Renderer2DData.FrameData.QuadBatches.size() - 1)
+				{
+					lastTextureIndex = GetQuadTextureIndex(texture);
+					lastTexture = texture.get();
+					lastBatchIndex = s_Renderer2DData.FrameData.QuadBatches.size() - 1;
+				}
 
-				min = min * fontScale + position;
-				max = max * fontScale + position;
+				textureIndices[i] = lastTextureIndex;
+				s_Renderer2DData.FrameData.QuadBatches.back().Count++;
+			}
+		}
 
-				atlasBounds.Left *= texelSize.x;
-				atlasBounds.Right *= texelSize.x;
-				atlasBounds.Top *= texelSize.y;
-				atlasBounds.Bottom *= texelSize.y;
+		// The vertex range of all the sprites is reserved up front, so that each job writes to its own part of it
+		size_t firstVertex = s_Renderer2DData.FrameData.QuadCount * 4;
+		s_Renderer2DData.FrameData.QuadCount += spritesCount;
+		s_Renderer2DData.Stats.QuadsCount += (uint32_t)spritesCount;
 
-				size_t textVertexIndex = s_Renderer2DData.FrameData.TextQuadCount * 4;
+		{
+			Grapple_PROFILE_SCOPE("GenerateVertices");
 
-				{
-					TextVertex& vertex = s_Renderer2DData.FrameData.TextVertices[textVertexIndex + 0];
-					vertex.Position = transform * glm::vec4(min, 0.0f, 1.0f);
-					vertex.Color = color;
-					vertex.UV = glm::vec2((float)atlasBounds.Left, (float)atlasBounds.Bottom);
-					vertex.EntityIndex = entityIndex;
-				}
+			QuadVertex* vertices = s_Renderer2DData.FrameData.QuadVertices.data() + firstVertex;
+			const uint32_t* textureIndices = s_Renderer2DData.SpriteTextureIndices.data();
 
-				{
-					TextVertex& vertex = s_Renderer2DData.FrameData.TextVertices[textVertexIndex + 1];
-					vertex.Position = transform * glm::vec4(min.x, max.y, 0.0f, 1.0f);
-					vertex.Color = color;
-					vertex.UV = glm::vec2((float)atlasBounds.Left, (float)atlasBounds.Top);
-					vertex.EntityIndex = entityIndex;
-				}
+			JobSystem::ParallelFor(spritesCount, 2048, [sprites, vertices, textureIndices](size_t begin, size_t end, uint32_t threadIndex)
+			{
+				Grapple_PROFILE_SCOPE("GenerateSpriteVertices");
+				for (size_t i = begin; i < end; i++)
+					GenerateSpriteVertices(sprites[i], textureIndices[i], vertices + i * 4);
+			});
+		}
+	}
 
-				{
-					TextVertex& vertex = s_Renderer2DData.FrameData.TextVertices[textVertexIndex + 2];
-					vertex.Position = transform * glm::vec4(max, 0.0f, 1.0f);
-					vertex.Color = color;
-					vertex.UV = glm::vec2((float)atlasBounds.Right, (float)atlasBounds.Top);
-					vertex.EntityIndex = entityIndex;
-				}
+	void Renderer2D::DrawString(std::string_view text, const glm::mat4& transform, const Ref<Font>& font, const glm::vec4& color, int32_t entityIndex)
+	{
+		Grapple_PROFILE_FUNCTION();
 
-				{
-					TextVertex& vertex = s_Renderer2DData.FrameData.TextVertices[textVertexIndex + 3];
-					vertex.Position = transform * glm::vec4(max.x, min.y, 0.0f, 1.0f);
-					vertex.Color = color;
-					vertex.UV = glm::vec2((float)atlasBounds.Right, (float)atlasBounds.Bottom);
-					vertex.EntityIndex = entityIndex;
-				}
+		s_Renderer2DData.StringLayout.Update(text, font);
+		DrawTextLayout(s_Renderer2DData.StringLayout, transform, color, entityIndex);
+	}
 
-				batch.Count++;
-				s_Renderer2DData.FrameData.TextQuadCount++;
-				s_Renderer2DData.Stats.QuadsCount++;
+	void Renderer2D::DrawTextLayout(TextLayout& layout, const glm::mat4& transform, const glm::vec4& color, int32_t entityIndex)
+	{
+		Grapple_PROFILE_FUNCTION();
 
-				Grapple_CORE_ASSERT(s_Renderer2DData.FrameData.TextQuadCount < s_Renderer2DData.Limits.MaxQuadCount);
-			}
+		const Ref<const Font>& font = layout.GetFont();
+		if (!font || layout.GetQuads().empty())
+			return;
 
-			if (charIndex + 1 < text.size())
-			{
-				double advance = 0.0;
+		if (s_Renderer2DData.FrameData.TextBatches.empty() || s_Renderer2DData.FrameData.TextBatches.back().Font.get() != font.get())
+		{
+			TextBatch& batch = s_Renderer2DData.FrameData.TextBatches.emplace_back();
+			batch.Start = (uint32_t)s_Renderer2DData.FrameData.TextQuadCount;
+			batch.Count = 0;
+			batch.Font = font;
+		}
+
+		TextBatch& batch = s_Renderer2DData.FrameData.TextBatches.back();
 
-				// TODO: properly handle tabs
-				char currentChar = text[charIndex];
-				if (currentChar == '\t')
-					currentChar = ' ';
+		const std::vector<TextVertex>& vertices = layout.GetVertices(transform, color, entityIndex);
+		uint32_t quadsCount = (uint32_t)layout.GetQuads().size();
 
-				geometry.getAdvance(advance, currentChar, text[charIndex + 1]);
+		Grapple_CORE_ASSERT(s_Renderer2DData.FrameData.TextQuadCount + quadsCount < s_Renderer2DData.Limits.MaxQuadCount);
 
-				if (text[charIndex] == '\t')
-					advance *= 4.0;
+		std::memcpy(&s_Renderer2DData.FrameData.TextVertices[s_Renderer2DData.FrameData.TextQuadCount * 4],
+			vertices.data(),
+			vertices.size() * sizeof(TextVertex));
 
-				position.x += fontScale * (float)advance + kerningOffset;
-			}
-		}
+		batch.Count += quadsCount;
+		s_Renderer2DData.FrameData.TextQuadCount += quadsCount;
+		s_Renderer2DData.Stats.QuadsCount += quadsCount;
 	}
 
 	Ref<const DescriptorSetLayout> Renderer2D::GetDescriptorSetLayout()
 	{
+		if (s_Renderer2DData.FrameData.BindlessTextures)
+			return s_Renderer2DData.FrameData.BindlessTextures->GetDescriptorSetLayout();
+
 		return s_Renderer2DData.FrameData.QuadDescriptorSetsPool->GetLayout();
 	}
 
@@ -2,6 +2,8 @@
 
 #include "Grapple.h"
 
+#include "GrappleCore/Collections/Span.h"
+
 #include "Grapple/Renderer/Material.h"
 #include "Grapple/Renderer/Font.h"
 
@@ -29,10 +31,23 @@ namespace Grapple
 
 	Grapple_IMPL_ENUM_BITFIELD(SpriteRenderFlags);
 
+	// Sprite drawn by `Renderer2D::DrawSprites`, equivalent to the arguments of `Renderer2D::DrawSprite`.
+	// The sprite must stay alive until the sprites are drawn
+	struct SpriteInstance
+	{
+		glm::mat4 Transform = glm::mat4(1.0f);
+		glm::vec4 Color = glm::vec4(1.0f);
+		glm::vec2 Tiling = glm::vec2(1.0f);
+		const Sprite* Sprite = nullptr;
+		SpriteRenderFlags Flags = SpriteRenderFlags::None;
+		int32_t EntityIndex = INT32_MAX;
+	};
+
 	struct Renderer2DLimits;
 
 	class Viewport;
 	class DescriptorSetLayout;
+	class TextLayout;
 	class Grapple_API Renderer2D
 	{
 	public:
@@ -83,6 +98,9 @@ namespace Grapple
 			SpriteRenderFlags flags = SpriteRenderFlags::None,
 			int32_t entityIndex = INT32_MAX);
 
+		// Draws sprites using the current material. Vertices are generated in parallel by the JobSystem
+		static void DrawSprites(Span<const SpriteInstance> sprites);
+
 		// Text
 
 		static void DrawString(
@@ -92,6 +110,12 @@ namespace Grapple
 			const glm::vec4& color = glm::vec4(1.0f),
 			int32_t entityIndex = INT32_MAX);
 
+		// Draws a cached text layout, which only gets transformed again when the transform, color or entity index changes
+		static void DrawTextLayout(TextLayout& layout,
+			const glm::mat4& transform,
+			const glm::vec4& color = glm::vec4(1.0f),
+			int32_t entityIndex = INT32_MAX);
+
 		static Ref<const DescriptorSetLayout> GetDescriptorSetLayout();
 
 		static const Renderer2DLimits& GetLimits();
@@ -13,11 +13,15 @@ namespace Grapple
 	class Material;
 	class DescriptorSet;
 	class DescriptorSetPool;
+	class BindlessTextureTable;
 
 	struct Renderer2DLimits
 	{
 		static constexpr uint32_t MaxTexturesCount = 32;
 
+		// Upper bound of the size of the bindless texture array, used when the device supports it
+		static constexpr uint32_t MaxBindlessTexturesCount = 16384;
+
 		uint32_t MaxQuadCount = 0;
 	};
 
@@ -89,6 +93,10 @@ namespace Grapple
 		Ref<DescriptorSetPool> QuadDescriptorSetsPool = nullptr;
 		std::vector<Ref<DescriptorSet>> UsedQuadDescriptorSets;
 
+		// When present, quads address textures through indices in the table instead of
+		// per batch texture arrays, so batches are only split when the material changes
+		Ref<BindlessTextureTable> BindlessTextures = nullptr;
+
 		// Text
 		size_t TextQuadCount = 0;
 		std::vector<TextVertex> TextVertices;
@@ -0,0 +1,153 @@
+#include "TextLayout.h"
+
+#include "GrappleCore/Profiler/Profiler.h"
+
+#include "Grapple/Renderer/Font.h"
+
+#include <cctype>
+
+namespace Grapple
+{
+	bool TextLayout::Update(std::string_view text, const Ref<const Font>& font)
+	{
+		if (m_Font.get() == font.get() && text == m_Text)
+			return false;
+
+		m_Text = text;
+		m_Font = font;
+
+		Build();
+		return true;
+	}
+
+	const std::vector<TextVertex>& TextLayout::GetVertices(const glm::mat4& transform, const glm::vec4& color, int32_t entityIndex)
+	{
+		if (!m_VerticesDirty && m_Transform == transform && m_Color == color && m_EntityIndex == entityIndex)
+			return m_Vertices;
+
+		Grapple_PROFILE_FUNCTION();
+
+		m_Transform = transform;
+		m_Color = color;
+		m_EntityIndex = entityIndex;
+		m_VerticesDirty = false;
+
+		m_Vertices.resize(m_Quads.size() * 4);
+		for (size_t i = 0; i < m_Quads.size(); i++)
+		{
+			const TextGlyphQuad& quad = m_Quads[i];
+			TextVertex* vertices = &m_Vertices[i * 4];
+
+			vertices[0].Position = transform * glm::vec4(quad.Min, 0.0f, 1.0f);
+			vertices[0].UV = quad.UVMin;
+
+			vertices[1].Position = transform * glm::vec4(quad.Min.x, quad.Max.y, 0.0f, 1.0f);
+			vertices[1].UV = glm::vec2(quad.UVMin.x, quad.UVMax.y);
+
+			vertices[2].Position = transform * glm::vec4(quad.Max, 0.0f, 1.0f);
+			vertices[2].UV = quad.UVMax;
+
+			vertices[3].Position = transform * glm::vec4(quad.Max.x, quad.Min.y, 0.0f, 1.0f);
+			vertices[3].UV = glm::vec2(quad.UVMax.x, quad.UVMin.y);
+
+			for (size_t j = 0; j < 4; j++)
+			{
+				vertices[j].Color = color;
+				vertices[j].EntityIndex = entityIndex;
+			}
+		}
+
+		return m_Vertices;
+	}
+
+	void TextLayout::Build()
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		m_Quads.clear();
+		m_VerticesDirty = true;
+
+		if (!m_Font)
+			return;
+
+		const auto& msdfData = m_Font->GetData();
+		const auto& geometry = msdfData.Geometry;
+		const auto& metrics = msdfData.Geometry.getMetrics();
+
+		float kerningOffset = 0.0f;
+		float lineHeightOffset = 0.0f;
+
+		const Ref<Texture>& fontAtlas = m_Font->GetAtlas();
+		glm::vec2 texelSize = glm::vec2(1.0f / fontAtlas->GetWidth(), 1.0f / fontAtlas->GetHeight());
+		glm::vec2 position = glm::vec2(0.0f);
+
+		float fontScale = 1.0f / (float)(metrics.ascenderY - metrics.descenderY);
+		position.y = -fontScale * (float)metrics.ascenderY;
+
+		const msdf_atlas::GlyphGeometry* errorGlyph = m_Font->FindGlyph('?');
+		const msdf_atlas::GlyphGeometry* spaceGlyph = m_Font->FindGlyph(' ');
+
+		struct Rect
+		{
+			double Top;
+			double Right;
+			double Bottom;
+			double Left;
+		};
+
+		std::string_view text = m_Text;
+		for (size_t charIndex = 0; charIndex < text.size(); charIndex++)
+		{
+			if (text[charIndex] == 0)
+				break;
+
+			const msdf_atlas::GlyphGeometry* glyph = m_Font->FindGlyph(text[charIndex]);
+
+			if (!glyph)
+				glyph = errorGlyph;
+			if (!glyph)
+				return;
+
+			if (text[charIndex] == '\r')
+				continue;
+			else if (text[charIndex] == '\t')
+				glyph = spaceGlyph;
+			else if (text[charIndex] == '\n')
+			{
+				position.x = 0;
+				position.y -= fontScale * (float)metrics.lineHeight + lineHeightOffset;
+				continue;
+			}
+			else if (!std::isspace(text[charIndex]))
+			{
+				Rect atlasBounds;
+				Rect planeBounds;
+				glyph->getQuadAtlasBounds(atlasBounds.Left, atlasBounds.Bottom, atlasBounds.Right, atlasBounds.Top);
+				glyph->getQuadPlaneBounds(planeBounds.Left, planeBounds.Bottom, planeBounds.Right, planeBounds.Top);
+
+				TextGlyphQuad& quad = m_Quads.emplace_back();
+				quad.Min = glm::vec2(planeBounds.Left, planeBounds.Bottom) * fontScale + position;
+				quad.Max = glm::vec2(planeBounds.Right, planeBounds.Top) * fontScale + position;
+				quad.UVMin = glm::vec2((float)atlasBounds.Left, (float)atlasBounds.Bottom) * texelSize;
+				quad.UVMax = glm::vec2((float)atlasBounds.Right, (float)atlasBounds.Top) * texelSize;
+			}
+
+			if (charIndex + 1 < text.size())
+			{
+				double advance = 0.0;
+
+				// TODO: properly handle tabs
+				char currentChar = text[charIndex];
+				if (currentChar == '\t')
+					currentChar = ' ';
+
+				geometry.getAdvance(advance, currentChar, text[charIndex + 1]);
+
+				if (text[charIndex] == '\t')
+					advance *= 4.0;
+
+				position.x += fontScale * (float)advance + kerningOffset;
+			}
+		}
+	}
+}
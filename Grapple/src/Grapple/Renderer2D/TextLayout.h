@@ -0,0 +1,52 @@
+#pragma once
+
+#include "GrappleCore/Core.h"
+
+#include "Grapple/Renderer2D/Renderer2DFrameData.h"
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Grapple
+{
+	class Font;
+
+	// Glyph quad in the local space of the text
+	struct TextGlyphQuad
+	{
+		glm::vec2 Min = glm::vec2(0.0f);
+		glm::vec2 Max = glm::vec2(0.0f);
+		glm::vec2 UVMin = glm::vec2(0.0f);
+		glm::vec2 UVMax = glm::vec2(0.0f);
+	};
+
+	// Caches the glyph quads of a text laid out with a font, as well as the vertices of the quads
+	// produced by the last used transform, so unchanged text doesn't have to be laid out every frame
+	class Grapple_API TextLayout
+	{
+	public:
+		// Lays out the text again only when either the text or the font has changed. Returns true if it did
+		bool Update(std::string_view text, const Ref<const Font>& font);
+
+		// Returns the vertices of the glyph quads, which are only recomputed when any of the arguments has changed
+		const std::vector<TextVertex>& GetVertices(const glm::mat4& transform, const glm::vec4& color, int32_t entityIndex);
+
+		inline const Ref<const Font>& GetFont() const { return m_Font; }
+		inline const std::vector<TextGlyphQuad>& GetQuads() const { return m_Quads; }
+	private:
+		void Build();
+	private:
+		std::string m_Text;
+		Ref<const Font> m_Font = nullptr;
+		std::vector<TextGlyphQuad> m_Quads;
+
+		bool m_VerticesDirty = true;
+		glm::mat4 m_Transform = glm::mat4(1.0f);
+		glm::vec4 m_Color = glm::vec4(1.0f);
+		int32_t m_EntityIndex = INT32_MAX;
+		std::vector<TextVertex> m_Vertices;
+	};
+}
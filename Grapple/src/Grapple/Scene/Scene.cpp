@@ -99,6 +99,7 @@ namespace Grapple
 		//       be done regardless of the pause state
 		m_World.Entities.ClearQueuedForDeletion();
 		m_World.Entities.ClearCreatedEntitiesQueryResult();
+		m_World.PlotMemoryStatistics();
 
 		UpdateEnvironmentSettings();
 	}
@@ -108,6 +109,7 @@ namespace Grapple
 		m_World.GetSystemsManager().ExecuteSystem<TransformPropagationSystem>();
 		m_World.Entities.ClearQueuedForDeletion();
 		m_World.Entities.ClearCreatedEntitiesQueryResult();
+		m_World.PlotMemoryStatistics();
 
 		UpdateEnvironmentSettings();
 	}
@@ -133,15 +135,7 @@ namespace Grapple
 
 	void Scene::UpdateEnvironmentSettings()
 	{
-		for (EntityView view : m_EnvironmentQuery)
-		{
-			auto environments = view.View<const Environment>();
-
-			for (EntityViewElement entity : view)
-			{
-				Renderer::SetShadowSettings(environments[entity].ShadowSettings);
-				return;
-			}
-		}
+		if (const Environment* environment = m_EnvironmentQuery.TryGetFirstEntityComponent<const Environment>())
+			Renderer::SetShadowSettings(environment->ShadowSettings);
 	}
 }
\ No newline at end of file
@@ -5,6 +5,8 @@
 #include "Grapple/Scene/Scene.h"
 #include "Grapple/Scene/Components.h"
 
+#include "Grapple/Core/JobSystem.h"
+
 #include "Grapple/DebugRenderer/DebugRenderer.h"
 
 #include "Grapple/AssetManager/AssetManager.h"
@@ -18,6 +20,7 @@
 #include "Grapple/Scene/Transform.h"
 
 #include <algorithm>
+#include <cstring>
 
 namespace Grapple
 {
@@ -37,10 +40,12 @@ namespace Grapple
 		World& world = m_Scene->GetECSWorld();
 		SystemsManager& systemsManager = world.GetSystemsManager();
 
-		if (std::optional<Entity> cameraEntity = m_CameraQuery.TryGetFirstEntityId())
+		const TransformComponent* cameraTransform = m_CameraQuery.TryGetFirstEntityComponent<const TransformComponent>();
+		const CameraComponent* cameraComponent = m_CameraQuery.TryGetFirstEntityComponent<const CameraComponent>();
+		if (cameraTransform && cameraComponent)
 		{
-			const TransformComponent& transform = world.GetEntityComponent<const TransformComponent>(*cameraEntity);
-			const CameraComponent& camera = world.GetEntityComponent<const CameraComponent>(*cameraEntity);
+			const TransformComponent& transform = *cameraTransform;
+			const CameraComponent& camera = *cameraComponent;
 
 			m_SceneSubmition.Camera.NearPlane = camera.Near;
 			m_SceneSubmition.Camera.FarPlane = camera.Far;
@@ -61,10 +66,12 @@ namespace Grapple
 			m_SceneSubmition.Camera.Transform = Math::Compact3DTransform(transform.GetTransformationMatrix());
 		}
 
-		if (std::optional<Entity> directionalLightEntity = m_DirectionalLightQuery.TryGetFirstEntityId())
+		const TransformComponent* lightTransform = m_DirectionalLightQuery.TryGetFirstEntityComponent<const TransformComponent>();
+		const DirectionalLight* lightComponent = m_DirectionalLightQuery.TryGetFirstEntityComponent<const DirectionalLight>();
+		if (lightTransform && lightComponent)
 		{
-			const TransformComponent& transform = world.GetEntityComponent<const TransformComponent>(*directionalLightEntity);
-			const DirectionalLight& directionalLight = world.GetEntityComponent<const DirectionalLight>(*directionalLightEntity);
+			const TransformComponent& transform = *lightTransform;
+			const DirectionalLight& directionalLight = *lightComponent;
 
 			glm::vec3 direction = transform.TransformDirection(glm::vec3(0.0f, 0.0f, -1.0f));
 			glm::vec3 right = transform.TransformDirection(glm::vec3(1.0f, 0.0f, 0.0f));
@@ -78,12 +85,10 @@ namespace Grapple
 			light.LightBasis.Up = glm::cross(right, direction);
 		}
 
-		if (std::optional<Entity> environmentEntity = m_EnvironmentQuery.TryGetFirstEntityId())
+		if (const Environment* environment = m_EnvironmentQuery.TryGetFirstEntityComponent<const Environment>())
 		{
-			const Environment& environment = world.GetEntityComponent<const Environment>(*environmentEntity);
-
-			m_SceneSubmition.Environment.EnvironmentColor = environment.EnvironmentColor;
-			m_SceneSubmition.Environment.EnvironmentColorIntensity = environment.EnvironmentColorIntensity;
+			m_SceneSubmition.Environment.EnvironmentColor = environment->EnvironmentColor;
+			m_SceneSubmition.Environment.EnvironmentColorIntensity = environment->EnvironmentColorIntensity;
 		}
 
 #if 0
@@ -202,7 +207,12 @@ namespace Grapple
 
 		PrepareViewportForRendering(viewport, *renderView);
 
-		viewport.Graph.Execute(GraphicsContext::GetInstance().GetCommandBuffer(), m_SceneSubmition, *renderView);
+		Ref<CommandBuffer> commandBuffer = GraphicsContext::GetInstance().GetCommandBuffer();
+
+		// Uploads only happen for the first viewport, because the table doesn't change between viewports
+		m_SceneSubmition.OpaqueGeometrySubmitions.GetInstanceTable().FlushUploads(commandBuffer);
+
+		viewport.Graph.Execute(commandBuffer, m_SceneSubmition, *renderView);
 	}
 
 	void SceneRenderer::InitializeQueries()
@@ -297,73 +307,221 @@ namespace Grapple
 	void SpriteRendererSystem::OnUpdate(World& world, SystemExecutionContext& context)
 	{
 		RenderQuads(world, context);
-		RenderText(context);
+		RenderText(world, context);
 	}
 
 	void SpriteRendererSystem::RenderQuads(World& world, SystemExecutionContext& context)
 	{
-		m_SortedEntities.clear();
-		m_SortedEntities.reserve(m_SpritesQuery.GetEntitiesCount());
+		Grapple_PROFILE_FUNCTION();
 
-		const SpriteLayer defaultSpriteLayer = 0;
-		const MaterialComponent defaultMaterial = NULL_ASSET_HANDLE;
+		m_Chunks.clear();
 
+		size_t entitiesCount = 0;
 		for (EntityView view : m_SpritesQuery)
 		{
-			ComponentView<TransformComponent> transforms = view.View<TransformComponent>();
-			ComponentView<SpriteComponent> sprites = view.View<SpriteComponent>();
-			auto layers = view.ViewOptional<const SpriteLayer>();
-			auto materials = view.ViewOptional<const MaterialComponent>();
+			const EntityStorage& storage = world.Entities.GetEntityStorage(view.GetArchetype());
+			size_t entitiesPerChunk = storage.GetEntitiesPerChunkCount();
 
-			for (EntityViewIterator entityIterator = view.begin(); entityIterator != view.end(); ++entityIterator)
+			for (size_t chunkIndex = 0; chunkIndex < storage.GetChunksCount(); chunkIndex++)
 			{
-				TransformComponent& transform = transforms[*entityIterator];
-				SpriteComponent& sprite = sprites[*entityIterator];
+				ChunkRange& chunk = m_Chunks.emplace_back();
+				chunk.Storage = &storage;
+				chunk.Transforms = view.View<const TransformComponent>();
+				chunk.Sprites = view.View<const SpriteComponent>();
+				chunk.Layers = view.ViewOptional<const SpriteLayer>();
+				chunk.Materials = view.ViewOptional<const MaterialComponent>();
+				chunk.FirstEntity = chunkIndex * entitiesPerChunk;
+				chunk.EntitiesCount = storage.GetEntitiesCountInChunk(chunkIndex);
+				chunk.FirstOutput = entitiesCount;
+
+				entitiesCount += chunk.EntitiesCount;
+			}
+		}
 
-				auto entity = view.GetEntity(entityIterator.GetEntityIndex());
-				if (!entity)
-					continue;
+		m_Instances.resize(entitiesCount);
+		m_SortData.resize(entitiesCount);
+
+		// Extracts the draw data of each sprite, so that components don't have to be accessed again after sorting
+		{
+			Grapple_PROFILE_SCOPE("ExtractSprites");
+			JobSystem::ParallelFor(m_Chunks.size(), 4, [this, &world](size_t begin, size_t end, uint32_t threadIndex)
+			{
+				Grapple_PROFILE_SCOPE("ExtractChunks");
 
-				const SpriteLayer& layer = layers.GetOrDefault(*entityIterator, defaultSpriteLayer);
-				const MaterialComponent& material = materials.GetOrDefault(*entityIterator, defaultMaterial);
+				const SpriteLayer defaultSpriteLayer = 0;
+				const MaterialComponent defaultMaterial = NULL_ASSET_HANDLE;
 
-				m_SortedEntities.push_back({ entity.value(), layer.Layer, material.Material });
-			}
+				for (size_t chunkIndex = begin; chunkIndex < end; chunkIndex++)
+				{
+					const ChunkRange& chunk = m_Chunks[chunkIndex];
+					const std::vector<uint32_t>& registryIndices = chunk.Storage->GetEntityIndices();
+
+					for (size_t i = 0; i < chunk.EntitiesCount; i++)
+					{
+						size_t entityIndex = chunk.FirstEntity + i;
+						size_t outputIndex = chunk.FirstOutput + i;
+						EntityViewElement entity(chunk.Storage->GetEntityData(entityIndex));
+
+						std::optional<Entity> id = entityIndex < registryIndices.size()
+							? world.Entities.FindEntityByRegistryIndex(registryIndices[entityIndex])
+							: std::optional<Entity>{};
+
+						SpriteSortData& sortData = m_SortData[outputIndex];
+						sortData.IsValid = id.has_value();
+						if (!id)
+							continue;
+
+						const SpriteComponent& sprite = chunk.Sprites[entity];
+
+						SpriteInstance& instance = m_Instances[outputIndex];
+						instance.Transform = chunk.Transforms[entity].GetTransformationMatrix();
+						instance.Color = sprite.Color;
+						instance.Tiling = sprite.Tilling;
+						instance.Sprite = sprite.Sprite.get();
+						instance.Flags = sprite.Flags;
+						instance.EntityIndex = id->GetIndex();
+
+						sortData.SortingLayer = chunk.Layers.GetOrDefault(entity, defaultSpriteLayer).Layer;
+						sortData.Material = chunk.Materials.GetOrDefault(entity, defaultMaterial).Material;
+					}
+				}
+			});
 		}
 
-		std::sort(m_SortedEntities.begin(), m_SortedEntities.end(), [](const EntityQueueElement& a, const EntityQueueElement& b) -> bool
+		BuildSortKeys();
+
 		{
-			if (a.SortingLayer == b.SortingLayer)
-				return (size_t)a.Material < (size_t)b.Material;
-			return a.SortingLayer < b.SortingLayer;
-		});
+			Grapple_PROFILE_SCOPE("Sort");
+			RadixSort(m_SortEntries, m_SortScratchBuffer);
+		}
 
-		AssetHandle currentMaterial = NULL_ASSET_HANDLE;
+		m_SortedInstances.resize(m_SortEntries.size());
 
-		for (const auto& [entity, layer, material] : m_SortedEntities)
 		{
-			const TransformComponent& transform = world.GetEntityComponent<TransformComponent>(entity);
-			const SpriteComponent& sprite = world.GetEntityComponent<SpriteComponent>(entity);
+			Grapple_PROFILE_SCOPE("GatherSortedInstances");
+			JobSystem::ParallelFor(m_SortEntries.size(), 4096, [this](size_t begin, size_t end, uint32_t threadIndex)
+			{
+				for (size_t i = begin; i < end; i++)
+					m_SortedInstances[i] = m_Instances[m_SortEntries[i].Index];
+			});
+		}
+
+		// Sprites sharing a material are drawn with a single call
+		size_t rangeStart = 0;
+		while (rangeStart < m_SortEntries.size())
+		{
+			AssetHandle material = m_SortData[m_SortEntries[rangeStart].Index].Material;
+
+			size_t rangeEnd = rangeStart + 1;
+			while (rangeEnd < m_SortEntries.size() && m_SortData[m_SortEntries[rangeEnd].Index].Material == material)
+				rangeEnd++;
+
+			// Materials were already resolved while building the keys
+			Renderer2D::SetMaterial(m_Materials[m_MaterialIndices[material]]);
+			Renderer2D::DrawSprites(Span<const SpriteInstance>(m_SortedInstances.data() + rangeStart, rangeEnd - rangeStart));
 
-			if (material != currentMaterial)
+			rangeStart = rangeEnd;
+		}
+	}
+
+	void SpriteRendererSystem::BuildSortKeys()
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		m_MaterialIndices.clear();
+		m_Materials.clear();
+		m_TextureIds.clear();
+
+		m_SortEntries.clear();
+		m_SortEntries.reserve(m_SortData.size());
+
+		AssetHandle lastMaterial = NULL_ASSET_HANDLE;
+		uint32_t lastMaterialIndex = GetMaterialIndex(NULL_ASSET_HANDLE);
+		const Texture* lastTexture = nullptr;
+		uint16_t lastTextureId = GetTextureSortId(nullptr);
+
+		for (size_t i = 0; i < m_SortData.size(); i++)
+		{
+			const SpriteSortData& sortData = m_SortData[i];
+			if (!sortData.IsValid)
+				continue;
+
+			const SpriteInstance& instance = m_Instances[i];
+			const Texture* texture = instance.Sprite != nullptr ? instance.Sprite->GetTexture().get() : nullptr;
+
+			// Consecutive sprites usually come from the same chunk and share their material and texture
+			if (sortData.Material != lastMaterial)
 			{
-				Ref<Material> materialInstance = AssetManager::GetAsset<Material>(material);
-				currentMaterial = material;
+				lastMaterial = sortData.Material;
+				lastMaterialIndex = GetMaterialIndex(sortData.Material);
+			}
 
-				if (materialInstance)
-				{
-					Renderer2D::SetMaterial(materialInstance);
-				}
-				else
-					Renderer2D::SetMaterial(nullptr);
+			if (texture != lastTexture)
+			{
+				lastTexture = texture;
+				lastTextureId = GetTextureSortId(texture);
 			}
 
-			Renderer2D::DrawSprite(sprite.Sprite, transform.GetTransformationMatrix(), sprite.Color, sprite.Tilling, sprite.Flags, entity.GetIndex());
+			// Signed layers are offset, so that their unsigned representations have the same order
+			int32_t layer = glm::clamp(sortData.SortingLayer, (int32_t)INT16_MIN, (int32_t)INT16_MAX);
+			uint64_t layerKey = (uint64_t)(layer - (int32_t)INT16_MIN);
+
+			// Flipping the sign bit of positive floats and all the bits of negative ones gives
+			// unsigned integers with the same order, the upper 16 bits are used as a quantized depth.
+			// Sprites further away from the camera, which looks along the negative Z axis, are drawn first
+			float depth = instance.Transform[3].z;
+			uint32_t depthBits = 0;
+			std::memcpy(&depthBits, &depth, sizeof(depthBits));
+			depthBits = (depthBits & 0x80000000) != 0 ? ~depthBits : depthBits | 0x80000000;
+			uint64_t depthKey = (uint64_t)(depthBits >> 16);
+
+			// Materials sharing an id are still drawn separately, because draw ranges are split by material handles
+			uint64_t materialKey = (uint64_t)glm::min(lastMaterialIndex, (uint32_t)UINT16_MAX);
+
+			SortEntry& entry = m_SortEntries.emplace_back();
+			entry.Key = (layerKey << 48) | (materialKey << 32) | ((uint64_t)lastTextureId << 16) | depthKey;
+			entry.Index = (uint32_t)i;
 		}
 	}
 
-	void SpriteRendererSystem::RenderText(SystemExecutionContext& context)
+	uint32_t SpriteRendererSystem::GetMaterialIndex(AssetHandle material)
+	{
+		auto it = m_MaterialIndices.find(material);
+		if (it != m_MaterialIndices.end())
+			return it->second;
+
+		uint32_t index = (uint32_t)m_Materials.size();
+		m_MaterialIndices.emplace(material, index);
+
+		// Sprites without a material are drawn using the default one
+		m_Materials.push_back(material != NULL_ASSET_HANDLE ? AssetManager::GetAsset<Material>(material) : nullptr);
+		return index;
+	}
+
+	uint16_t SpriteRendererSystem::GetTextureSortId(const Texture* texture)
 	{
+		auto it = m_TextureIds.find(texture);
+		if (it != m_TextureIds.end())
+			return it->second;
+
+		uint16_t id = (uint16_t)glm::min(m_TextureIds.size(), (size_t)UINT16_MAX);
+		m_TextureIds.emplace(texture, id);
+		return id;
+	}
+
+	void SpriteRendererSystem::RenderText(World& world, SystemExecutionContext& context)
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		m_FrameIndex++;
+
+		size_t maxEntityIndex = (size_t)world.Entities.GetEntityIndex().GetNextIndex();
+		if (m_TextCaches.size() < maxEntityIndex)
+			m_TextCaches.resize(maxEntityIndex);
+
+		Ref<Font> defaultFont = Font::GetDefault();
+		size_t seenCachesCount = 0;
+
 		for (EntityView view : m_TextQuery)
 		{
 			auto transforms = view.View<TransformComponent>();
@@ -371,17 +529,63 @@ namespace Grapple
 
 			for (EntityViewIterator entity = view.begin(); entity != view.end(); ++entity)
 			{
-				glm::mat4 transform = transforms[*entity].GetTransformationMatrix();
-
-				Entity entityId = view.GetEntity(entity.GetEntityIndex()).value_or(Entity());
+				const TransformComponent& transform = transforms[*entity];
 				const TextComponent& text = texts[*entity];
+				const Ref<Font>& font = text.Font ? text.Font : defaultFont;
+
+				std::optional<Entity> id = view.GetEntity(entity.GetEntityIndex());
+				if (!id || id->GetIndex() >= m_TextCaches.size())
+				{
+					Renderer2D::DrawString(text.Text, transform.GetTransformationMatrix(), font, text.Color, Entity().GetIndex());
+					continue;
+				}
+
+				TextCache& cache = m_TextCaches[id->GetIndex()];
+				if (!cache.IsAlive || cache.Id != *id)
+				{
+					if (!cache.IsAlive)
+						m_AliveTextCachesCount++;
+
+					cache = TextCache();
+					cache.Id = *id;
+					cache.IsAlive = true;
+					cache.Transform = transform.GetTransformationMatrix();
+					cache.Position = transform.Position;
+					cache.Rotation = transform.Rotation;
+					cache.Scale = transform.Scale;
+				}
+				else if (cache.Position != transform.Position || cache.Rotation != transform.Rotation || cache.Scale != transform.Scale)
+				{
+					cache.Transform = transform.GetTransformationMatrix();
+					cache.Position = transform.Position;
+					cache.Rotation = transform.Rotation;
+					cache.Scale = transform.Scale;
+				}
 
-				Renderer2D::DrawString(
-					text.Text, transform,
-					text.Font ? text.Font : Font::GetDefault(),
-					text.Color, entityId.GetIndex());
+				cache.LastSeenFrame = m_FrameIndex;
+				seenCachesCount++;
+
+				cache.Layout.Update(text.Text, font);
+				Renderer2D::DrawTextLayout(cache.Layout, cache.Transform, text.Color, id->GetIndex());
 			}
 		}
+
+		if (seenCachesCount != m_AliveTextCachesCount)
+			RemoveStaleTextCaches();
+	}
+
+	void SpriteRendererSystem::RemoveStaleTextCaches()
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		for (TextCache& cache : m_TextCaches)
+		{
+			if (!cache.IsAlive || cache.LastSeenFrame == m_FrameIndex)
+				continue;
+
+			cache = TextCache();
+			m_AliveTextCachesCount--;
+		}
 	}
 
 	// Mesh Renderer
@@ -399,68 +603,312 @@ namespace Grapple
 	{
 		Grapple_PROFILE_FUNCTION();
 
-		AssetHandle currentMaterialHandle = NULL_ASSET_HANDLE;
-		Ref<Material> currentMaterial = nullptr;
-		Ref<MaterialsTable> currentMaterialsTable = nullptr;
-		Ref<Material> errorMaterial = Renderer::GetErrorMaterial();
+		m_FrameIndex++;
+		m_Chunks.clear();
+		m_RemovedProxies.clear();
 
-		RendererSubmitionQueue& submitionQueue = Renderer::GetOpaqueSubmitionQueue();
+		// Chunks changed after this point get a greater version, so they are processed during the next update
+		uint64_t changeVersion = EntityStorage::AdvanceChangeVersion();
 
-		bool isMaterialTable = false;
+		size_t archetypesCount = world.Entities.GetArchetypes().Records.size();
+		if (m_ArchetypeChunks.size() < archetypesCount)
+			m_ArchetypeChunks.resize(archetypesCount);
 
 		for (EntityView view : m_Query)
 		{
-			auto transforms = view.View<TransformComponent>();
-			auto meshes = view.View<MeshComponent>();
+			ArchetypeId archetype = view.GetArchetype();
+			const EntityStorage& storage = world.Entities.GetEntityStorage(archetype);
+			size_t entitiesPerChunk = storage.GetEntitiesPerChunkCount();
 
-			for (EntityViewIterator entity = view.begin(); entity != view.end(); ++entity)
+			ArchetypeChunks& archetypeChunks = m_ArchetypeChunks[archetype];
+			archetypeChunks.LastSeenFrame = m_FrameIndex;
+
+			// Entities of the removed chunks were either deleted or moved into other chunks
+			for (size_t chunkIndex = storage.GetChunksCount(); chunkIndex < archetypeChunks.ObjectIds.size(); chunkIndex++)
 			{
-				const Ref<Mesh>& mesh = meshes[*entity].Mesh;
-				const TransformComponent& transform = transforms[*entity];
-				std::optional<Entity> id = view.GetEntity(entity.GetEntityIndex());
+				const std::vector<uint32_t>& objectIds = archetypeChunks.ObjectIds[chunkIndex];
+				m_RemovedProxies.insert(m_RemovedProxies.end(), objectIds.begin(), objectIds.end());
+			}
+
+			archetypeChunks.ObjectIds.resize(storage.GetChunksCount());
 
-				if (!mesh || !id)
+			for (size_t chunkIndex = 0; chunkIndex < storage.GetChunksCount(); chunkIndex++)
+			{
+				if (storage.GetChunkVersion(chunkIndex) <= m_ChangeVersion)
 					continue;
 
-				if (meshes[*entity].Material != currentMaterialHandle)
+				ChunkRange& chunk = m_Chunks.emplace_back();
+				chunk.Storage = &storage;
+				chunk.Transforms = view.View<const TransformComponent>();
+				chunk.Meshes = view.View<const MeshComponent>();
+				chunk.Archetype = archetype;
+				chunk.ChunkIndex = chunkIndex;
+				chunk.FirstEntity = chunkIndex * entitiesPerChunk;
+				chunk.EntitiesCount = storage.GetEntitiesCountInChunk(chunkIndex);
+			}
+		}
+
+		// Archetypes, which are no longer matched by the query
+		for (ArchetypeChunks& archetypeChunks : m_ArchetypeChunks)
+		{
+			if (archetypeChunks.LastSeenFrame == m_FrameIndex)
+				continue;
+
+			for (const std::vector<uint32_t>& objectIds : archetypeChunks.ObjectIds)
+				m_RemovedProxies.insert(m_RemovedProxies.end(), objectIds.begin(), objectIds.end());
+
+			archetypeChunks.ObjectIds.clear();
+		}
+
+		m_ChangeVersion = changeVersion;
+
+		// Proxies are indexed by entity index, so each entity is only accessed by the job processing its chunk
+		size_t maxEntityIndex = (size_t)world.Entities.GetEntityIndex().GetNextIndex();
+		if (m_Proxies.size() < maxEntityIndex)
+			m_Proxies.resize(maxEntityIndex);
+
+		m_ThreadChangedProxies.resize(JobSystem::GetThreadsCount());
+		m_ThreadRemovedProxies.resize(JobSystem::GetThreadsCount());
+		for (size_t threadIndex = 0; threadIndex < m_ThreadChangedProxies.size(); threadIndex++)
+		{
+			m_ThreadChangedProxies[threadIndex].clear();
+			m_ThreadRemovedProxies[threadIndex].clear();
+		}
+
+		// Compares entities of the changed chunks against their proxies and rebuilds transforms and bounds of the changed ones
+		{
+			Grapple_PROFILE_SCOPE("UpdateProxies");
+			JobSystem::ParallelFor(m_Chunks.size(), 4, [this, &world](size_t begin, size_t end, uint32_t threadIndex)
+			{
+				Grapple_PROFILE_SCOPE("UpdateChunks");
+				std::vector<uint32_t>& changedProxies = m_ThreadChangedProxies[threadIndex];
+				std::vector<uint32_t>& removedProxies = m_ThreadRemovedProxies[threadIndex];
+
+				for (size_t chunkIndex = begin; chunkIndex < end; chunkIndex++)
 				{
-					const AssetMetadata* meta = AssetManager::GetAssetMetadata(meshes[*entity].Material);
-					if (!meta)
-						continue;
+					const ChunkRange& chunk = m_Chunks[chunkIndex];
+					const std::vector<uint32_t>& registryIndices = chunk.Storage->GetEntityIndices();
 
-					if (meta->Type == AssetType::Material)
-					{
-						currentMaterial = AssetManager::GetAsset<Material>(meshes[*entity].Material);
-						isMaterialTable = false;
-					}
-					else if (meta->Type == AssetType::MaterialsTable)
+					std::vector<uint32_t>& objectIds = m_ArchetypeChunks[chunk.Archetype].ObjectIds[chunk.ChunkIndex];
+					removedProxies.insert(removedProxies.end(), objectIds.begin(), objectIds.end());
+					objectIds.clear();
+
+					for (size_t i = 0; i < chunk.EntitiesCount; i++)
 					{
-						currentMaterialsTable = AssetManager::GetAsset<MaterialsTable>(meshes[*entity].Material);
-						isMaterialTable = true;
+						size_t entityIndex = chunk.FirstEntity + i;
+						EntityViewElement entity(chunk.Storage->GetEntityData(entityIndex));
+
+						const MeshComponent& mesh = chunk.Meshes[entity];
+						std::optional<Entity> id = entityIndex < registryIndices.size()
+							? world.Entities.FindEntityByRegistryIndex(registryIndices[entityIndex])
+							: std::optional<Entity>{};
+
+						if (!mesh.Mesh || !id || id->GetIndex() >= m_Proxies.size())
+							continue;
+
+						uint32_t objectId = id->GetIndex();
+						objectIds.push_back(objectId);
+
+						MeshProxy& proxy = m_Proxies[objectId];
+						proxy.LastSeenFrame = m_FrameIndex;
+
+						const TransformComponent& transform = chunk.Transforms[entity];
+						bool transformChanged = !proxy.IsAlive
+							|| proxy.Id != *id
+							|| proxy.Position != transform.Position
+							|| proxy.Rotation != transform.Rotation
+							|| proxy.Scale != transform.Scale;
+
+						bool meshChanged = !proxy.IsAlive || proxy.Id != *id || proxy.Mesh.get() != mesh.Mesh.get();
+
+						if (!transformChanged
+							&& !meshChanged
+							&& proxy.MaterialHandle == mesh.Material
+							&& proxy.Flags == mesh.Flags)
+						{
+							continue;
+						}
+
+						proxy.Id = *id;
+						proxy.Mesh = mesh.Mesh;
+						proxy.MaterialHandle = mesh.Material;
+						proxy.Flags = mesh.Flags;
+
+						if (transformChanged)
+						{
+							proxy.Position = transform.Position;
+							proxy.Rotation = transform.Rotation;
+							proxy.Scale = transform.Scale;
+							proxy.Transform = Math::Compact3DTransform(transform.GetTransformationMatrix());
+						}
+
+						if (transformChanged || meshChanged)
+						{
+							const auto& subMeshes = proxy.Mesh->GetSubMeshes();
+							proxy.SubMeshBounds.resize(subMeshes.size());
+							for (size_t subMeshIndex = 0; subMeshIndex < subMeshes.size(); subMeshIndex++)
+								proxy.SubMeshBounds[subMeshIndex] = proxy.Transform.TransformAABB(subMeshes[subMeshIndex].Bounds);
+						}
+
+						changedProxies.push_back(objectId);
 					}
+				}
+			});
+		}
 
-					currentMaterialHandle = meshes[*entity].Material;
+		// AssetManager isn't thread safe, so materials are resolved on the calling thread.
+		// Slots are resolved when created, and only resolved again after assets have changed
+		{
+			Grapple_PROFILE_SCOPE("UpdateMaterials");
+
+			uint64_t assetsVersion = AssetManager::GetChangesVersion();
+			if (assetsVersion != m_AssetsVersion)
+			{
+				for (MaterialSlot& slot : m_MaterialSlots)
+				{
+					if (slot.ReferencesCount > 0)
+						ResolveMaterials(slot);
 				}
 
-				if (!isMaterialTable)
+				m_AssetsVersion = assetsVersion;
+			}
+
+			for (const auto& changedProxies : m_ThreadChangedProxies)
+			{
+				for (uint32_t objectId : changedProxies)
 				{
-					submitionQueue.Submit(mesh,
-						currentMaterial,
-						Math::Compact3DTransform(transform.GetTransformationMatrix()),
-						meshes[*entity].Flags);
+					MeshProxy& proxy = m_Proxies[objectId];
+					proxy.IsAlive = true;
+
+					UpdateProxyMaterial(proxy);
 				}
-				else
+			}
+		}
+
+		RemoveStaleProxies(m_RemovedProxies);
+		for (const auto& removedProxies : m_ThreadRemovedProxies)
+			RemoveStaleProxies(removedProxies);
+
+		Grapple_PROFILE_SCOPE("SubmitMeshes");
+
+		// The submition queue is rebuilt every frame, so the cached proxies are submitted without accessing the entities
+		RendererSubmitionQueue& submitionQueue = Renderer::GetOpaqueSubmitionQueue();
+		for (const ArchetypeChunks& archetypeChunks : m_ArchetypeChunks)
+		{
+			for (const std::vector<uint32_t>& objectIds : archetypeChunks.ObjectIds)
+			{
+				for (uint32_t objectId : objectIds)
 				{
-					submitionQueue.Submit(mesh,
-						Span<AssetHandle>::FromVector(currentMaterialsTable->Materials),
-						Math::Compact3DTransform(transform.GetTransformationMatrix()),
-						meshes[*entity].Flags);
+					const MeshProxy& proxy = m_Proxies[objectId];
+					const MaterialSlot& materials = m_MaterialSlots[proxy.MaterialSlot];
+					if (materials.Materials.size() == 0)
+						continue;
+
+					submitionQueue.Submit(proxy.Mesh,
+						Span<const Ref<const Material>>(materials.Materials.data(), materials.Materials.size()),
+						Span<const Math::AABB>(proxy.SubMeshBounds.data(), proxy.SubMeshBounds.size()),
+						proxy.Transform,
+						proxy.Flags,
+						objectId);
 				}
 			}
 		}
 	}
 
+	void MeshRendererSystem::UpdateProxyMaterial(MeshProxy& proxy)
+	{
+		if (proxy.MaterialSlot != InvalidIndex)
+		{
+			if (m_MaterialSlots[proxy.MaterialSlot].Handle == proxy.MaterialHandle)
+				return;
+
+			ReleaseMaterialSlot(proxy.MaterialSlot);
+			proxy.MaterialSlot = InvalidIndex;
+		}
+
+		auto it = m_MaterialSlotsByHandle.find(proxy.MaterialHandle);
+		if (it != m_MaterialSlotsByHandle.end())
+		{
+			proxy.MaterialSlot = it->second;
+			m_MaterialSlots[proxy.MaterialSlot].ReferencesCount++;
+			return;
+		}
+
+		uint32_t slotIndex = 0;
+		if (m_FreeMaterialSlots.size() > 0)
+		{
+			slotIndex = m_FreeMaterialSlots.back();
+			m_FreeMaterialSlots.pop_back();
+		}
+		else
+		{
+			slotIndex = (uint32_t)m_MaterialSlots.size();
+			m_MaterialSlots.emplace_back();
+		}
+
+		MaterialSlot& slot = m_MaterialSlots[slotIndex];
+		slot.Handle = proxy.MaterialHandle;
+		slot.ReferencesCount = 1;
+		ResolveMaterials(slot);
+
+		m_MaterialSlotsByHandle.emplace(proxy.MaterialHandle, slotIndex);
+		proxy.MaterialSlot = slotIndex;
+	}
+
+	void MeshRendererSystem::ReleaseMaterialSlot(uint32_t slotIndex)
+	{
+		MaterialSlot& slot = m_MaterialSlots[slotIndex];
+		Grapple_CORE_ASSERT(slot.ReferencesCount > 0);
+
+		slot.ReferencesCount--;
+		if (slot.ReferencesCount > 0)
+			return;
+
+		m_MaterialSlotsByHandle.erase(slot.Handle);
+		slot.Handle = NULL_ASSET_HANDLE;
+		slot.Materials.clear();
+		m_FreeMaterialSlots.push_back(slotIndex);
+	}
+
+	void MeshRendererSystem::ResolveMaterials(MaterialSlot& slot)
+	{
+		slot.Materials.clear();
+
+		const AssetMetadata* meta = AssetManager::GetAssetMetadata(slot.Handle);
+		if (!meta)
+			return;
+
+		if (meta->Type == AssetType::Material)
+		{
+			slot.Materials.push_back(AssetManager::GetAsset<Material>(slot.Handle));
+		}
+		else if (meta->Type == AssetType::MaterialsTable)
+		{
+			Ref<MaterialsTable> table = AssetManager::GetAsset<MaterialsTable>(slot.Handle);
+			if (table == nullptr)
+				return;
+
+			for (AssetHandle material : table->Materials)
+				slot.Materials.push_back(AssetManager::GetAsset<Material>(material));
+		}
+	}
+
+	void MeshRendererSystem::RemoveStaleProxies(const std::vector<uint32_t>& objectIds)
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		for (uint32_t objectId : objectIds)
+		{
+			MeshProxy& proxy = m_Proxies[objectId];
+			if (!proxy.IsAlive || proxy.LastSeenFrame == m_FrameIndex)
+				continue;
+
+			if (proxy.MaterialSlot != InvalidIndex)
+				ReleaseMaterialSlot(proxy.MaterialSlot);
 
+			proxy = MeshProxy();
+		}
+	}
 
 	void DecalRendererSystem::OnConfig(World& world, SystemConfig& config)
 	{
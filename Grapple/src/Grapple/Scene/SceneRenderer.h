@@ -1,14 +1,26 @@
 #pragma once
 
 #include "Grapple/Renderer/SceneSubmition.h"
+#include "Grapple/AssetManager/Asset.h"
+#include "Grapple/Renderer2D/Renderer2D.h"
+#include "Grapple/Renderer2D/TextLayout.h"
+#include "Grapple/Renderer/RadixSort.h"
 
 #include "GrappleECS/World.h"
+#include "GrappleECS/Query/ComponentView.h"
 #include "GrappleECS/System/SystemInitializer.h"
 
+#include <unordered_map>
+
 namespace Grapple
 {
 	class Viewport;
 	class Scene;
+	struct TransformComponent;
+	struct MeshComponent;
+	struct SpriteComponent;
+	struct SpriteLayer;
+	struct MaterialComponent;
 	class Grapple_API SceneRenderer
 	{
 	public:
@@ -44,27 +56,169 @@ namespace Grapple
 		virtual void OnUpdate(World& world, SystemExecutionContext& context) override;
 	private:
 		void RenderQuads(World& world, SystemExecutionContext& context);
-		void RenderText(SystemExecutionContext& context);
+		void RenderText(World& world, SystemExecutionContext& context);
+		void RemoveStaleTextCaches();
 	private:
-		struct EntityQueueElement
+		// Range of sprite entities in a single chunk, which is processed by one job
+		struct ChunkRange
+		{
+			const EntityStorage* Storage = nullptr;
+			ComponentView<const TransformComponent> Transforms;
+			ComponentView<const SpriteComponent> Sprites;
+			OptionalComponentView<const SpriteLayer> Layers;
+			OptionalComponentView<const MaterialComponent> Materials;
+
+			size_t FirstEntity = 0;
+			size_t EntitiesCount = 0;
+
+			// Index of the first entity in `m_Instances`
+			size_t FirstOutput = 0;
+		};
+
+		// Extracted per sprite data, which isn't needed for drawing, indexed the same way as `m_Instances`
+		struct SpriteSortData
+		{
+			int32_t SortingLayer = 0;
+			AssetHandle Material = NULL_ASSET_HANDLE;
+			bool IsValid = false;
+		};
+
+		// Layout of a text entity, which is laid out again only when the text or the font changes
+		struct TextCache
 		{
 			Entity Id;
-			int32_t SortingLayer;
-			AssetHandle Material;
+			TextLayout Layout;
+
+			// Values of the TransformComponent the transform was computed from
+			glm::vec3 Position = glm::vec3(0.0f);
+			glm::vec3 Rotation = glm::vec3(0.0f);
+			glm::vec3 Scale = glm::vec3(0.0f);
+			glm::mat4 Transform = glm::mat4(1.0f);
+
+			uint64_t LastSeenFrame = 0;
+			bool IsAlive = false;
 		};
 
+		void BuildSortKeys();
+		uint32_t GetMaterialIndex(AssetHandle material);
+		uint16_t GetTextureSortId(const Texture* texture);
+	private:
 		Query m_SpritesQuery;
 		Query m_TextQuery;
-		std::vector<EntityQueueElement> m_SortedEntities;
+		std::vector<ChunkRange> m_Chunks;
+
+		// Sprites extracted from the chunks, and then reordered by the sort entries
+		std::vector<SpriteInstance> m_Instances;
+		std::vector<SpriteSortData> m_SortData;
+		std::vector<SpriteInstance> m_SortedInstances;
+
+		// Keys are (sorting layer, material, texture, depth), each taking 16 bits
+		std::vector<SortEntry> m_SortEntries;
+		std::vector<SortEntry> m_SortScratchBuffer;
+
+		// Materials and texture ids are assigned every frame in the order of first use,
+		// so that each material asset is only resolved once per frame
+		std::unordered_map<AssetHandle, uint32_t> m_MaterialIndices;
+		std::vector<Ref<Material>> m_Materials;
+		std::unordered_map<const Texture*, uint16_t> m_TextureIds;
+
+		// Indexed by entity index
+		std::vector<TextCache> m_TextCaches;
+		size_t m_AliveTextCachesCount = 0;
+		uint64_t m_FrameIndex = 0;
 	};
 
+	// Keeps a persistent proxy for each mesh entity, which caches the entity's transform, world space
+	// sub mesh bounds and resolved materials. Proxies are only rebuilt when the transform, mesh, material or flags
+	// of an entity change, and are destroyed when the entity or its mesh disappears.
 	struct MeshRendererSystem : public System
 	{
 	public:
 		void OnConfig(World& world, SystemConfig& config) override;
 		void OnUpdate(World& world, SystemExecutionContext& context) override;
+	private:
+		static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+		// Range of entities in a single changed chunk, which is processed by one job
+		struct ChunkRange
+		{
+			const EntityStorage* Storage = nullptr;
+			ComponentView<const TransformComponent> Transforms;
+			ComponentView<const MeshComponent> Meshes;
+
+			ArchetypeId Archetype = INVALID_ARCHETYPE_ID;
+			size_t ChunkIndex = 0;
+			size_t FirstEntity = 0;
+			size_t EntitiesCount = 0;
+		};
+
+		// Object ids of the entities in each chunk of an archetype, as of the last time the chunk was processed
+		struct ArchetypeChunks
+		{
+			std::vector<std::vector<uint32_t>> ObjectIds;
+			uint64_t LastSeenFrame = 0;
+		};
+
+		struct MeshProxy
+		{
+			Entity Id;
+			Ref<const Mesh> Mesh = nullptr;
+			AssetHandle MaterialHandle = NULL_ASSET_HANDLE;
+			MeshRenderFlags Flags = MeshRenderFlags::None;
+
+			// Values of the TransformComponent the proxy was built from
+			glm::vec3 Position = glm::vec3(0.0f);
+			glm::vec3 Rotation = glm::vec3(0.0f);
+			glm::vec3 Scale = glm::vec3(0.0f);
+
+			Math::Compact3DTransform Transform;
+			std::vector<Math::AABB> SubMeshBounds;
+
+			// Index in `m_MaterialSlots`
+			uint32_t MaterialSlot = InvalidIndex;
+			uint64_t LastSeenFrame = 0;
+			bool IsAlive = false;
+		};
+
+		// Materials resolved from a material or materials table asset, shared by all the proxies using the asset
+		struct MaterialSlot
+		{
+			AssetHandle Handle = NULL_ASSET_HANDLE;
+			std::vector<Ref<const Material>> Materials;
+			uint32_t ReferencesCount = 0;
+		};
+
+		void UpdateProxyMaterial(MeshProxy& proxy);
+		void ReleaseMaterialSlot(uint32_t slot);
+		void ResolveMaterials(MaterialSlot& slot);
+		void RemoveStaleProxies(const std::vector<uint32_t>& objectIds);
 	private:
 		Query m_Query;
+		uint64_t m_FrameIndex = 0;
+
+		// Chunks with a greater version were changed since the last update
+		uint64_t m_ChangeVersion = 0;
+
+		// Value of `AssetManager::GetChangesVersion` when the material slots were last resolved
+		uint64_t m_AssetsVersion = 0;
+
+		std::vector<ChunkRange> m_Chunks;
+
+		// Indexed by archetype id
+		std::vector<ArchetypeChunks> m_ArchetypeChunks;
+
+		// Indexed by entity index
+		std::vector<MeshProxy> m_Proxies;
+
+		std::vector<std::vector<uint32_t>> m_ThreadChangedProxies;
+
+		// Object ids, which were previously stored in the changed chunks, and might no longer be rendered
+		std::vector<std::vector<uint32_t>> m_ThreadRemovedProxies;
+		std::vector<uint32_t> m_RemovedProxies;
+
+		std::vector<MaterialSlot> m_MaterialSlots;
+		std::vector<uint32_t> m_FreeMaterialSlots;
+		std::unordered_map<AssetHandle, uint32_t> m_MaterialSlotsByHandle;
 	};
 
 	struct DecalRendererSystem : public System
@@ -0,0 +1,234 @@
+#include "BinarySerialization.h"
+
+#include "Grapple/AssetManager/AssetManager.h"
+
+#include "GrappleECS/Entity/Entity.h"
+
+namespace Grapple
+{
+	// Single values are passed as one element spans, even for vector and int types wider than the span's element
+	template<typename T>
+	static size_t GetValueSize(const SerializationValue<T>& value, size_t singleValueSize)
+	{
+		return value.IsArray ? value.Values.GetSize() * sizeof(T) : singleValueSize;
+	}
+
+	BinarySerializer::BinarySerializer(std::vector<uint8_t>& output)
+		: m_Output(output) {}
+
+	void BinarySerializer::PropertyKey(std::string_view key)
+	{
+	}
+
+	SerializationStream::DynamicArrayAction BinarySerializer::SerializeDynamicArraySize(size_t& size)
+	{
+		uint64_t arraySize = (uint64_t)size;
+		Write(&arraySize, sizeof(arraySize));
+		return DynamicArrayAction::None;
+	}
+
+	void BinarySerializer::SerializeInt(SerializationValue<uint8_t> intValues, SerializableIntType type)
+	{
+		Write(intValues.Values.GetData(), GetValueSize(intValues, SizeOfSerializableIntType(type)));
+	}
+
+	void BinarySerializer::SerializeBool(SerializationValue<bool> value)
+	{
+		Write(value.Values.GetData(), GetValueSize(value, sizeof(bool)));
+	}
+
+	void BinarySerializer::SerializeFloat(SerializationValue<float> value)
+	{
+		Write(value.Values.GetData(), GetValueSize(value, sizeof(float)));
+	}
+
+	void BinarySerializer::SerializeUUID(SerializationValue<UUID> uuids)
+	{
+		Write(uuids.Values.GetData(), GetValueSize(uuids, sizeof(UUID)));
+	}
+
+	void BinarySerializer::SerializeFloatVector(SerializationValue<float> value, uint32_t componentsCount)
+	{
+		Write(value.Values.GetData(), GetValueSize(value, sizeof(float) * componentsCount));
+	}
+
+	void BinarySerializer::SerializeIntVector(SerializationValue<int32_t> value, uint32_t componentsCount)
+	{
+		Write(value.Values.GetData(), GetValueSize(value, sizeof(int32_t) * componentsCount));
+	}
+
+	void BinarySerializer::SerializeString(SerializationValue<std::string> value)
+	{
+		for (size_t i = 0; i < value.Values.GetSize(); i++)
+		{
+			const std::string& string = value.Values[i];
+			uint32_t length = (uint32_t)string.size();
+
+			Write(&length, sizeof(length));
+			Write(string.data(), string.size());
+		}
+	}
+
+	void BinarySerializer::SerializeObject(const SerializableObjectDescriptor& descriptor, void* objectData, bool isArray, size_t arraySize)
+	{
+		size_t count = isArray ? arraySize : 1;
+
+		if (&descriptor == &Grapple_SERIALIZATION_DESCRIPTOR_OF(AssetHandle)
+			|| &descriptor == &Grapple_SERIALIZATION_DESCRIPTOR_OF(Entity))
+		{
+			Write(objectData, descriptor.Size * count);
+			return;
+		}
+
+		for (size_t i = 0; i < count; i++)
+			descriptor.Callback((uint8_t*)objectData + i * descriptor.Size, *this);
+	}
+
+	void BinarySerializer::SerializeReference(const SerializableObjectDescriptor& valueDescriptor, void* referenceData, void* valueData)
+	{
+		const AssetDescriptor* assetDescriptor = AssetDescriptor::FindBySerializationDescriptor(valueDescriptor);
+		if (assetDescriptor)
+		{
+			Grapple_CORE_ASSERT(referenceData);
+			Ref<Asset>& asset = *(Ref<Asset>*)referenceData;
+
+			AssetHandle handle = NULL_ASSET_HANDLE;
+			if (asset != nullptr && AssetManager::IsAssetHandleValid(asset->Handle))
+				handle = asset->Handle;
+
+			Write(&handle, sizeof(handle));
+		}
+		else
+		{
+			Grapple_CORE_WARN("BinarySerializer: Reference serialization not supported");
+		}
+	}
+
+	void BinarySerializer::Write(const void* data, size_t size)
+	{
+		if (size == 0)
+			return;
+
+		size_t position = m_Output.size();
+		m_Output.resize(position + size);
+		std::memcpy(m_Output.data() + position, data, size);
+	}
+
+	// Binary Deserializer
+
+	BinaryDeserializer::BinaryDeserializer(const uint8_t* data, size_t size)
+		: m_Data(data), m_Size(size), m_Position(0), m_Failed(false) {}
+
+	void BinaryDeserializer::PropertyKey(std::string_view key)
+	{
+	}
+
+	SerializationStream::DynamicArrayAction BinaryDeserializer::SerializeDynamicArraySize(size_t& size)
+	{
+		uint64_t arraySize = 0;
+		Read(&arraySize, sizeof(arraySize));
+
+		size = (size_t)arraySize;
+		return DynamicArrayAction::Resize;
+	}
+
+	void BinaryDeserializer::SerializeInt(SerializationValue<uint8_t> intValues, SerializableIntType type)
+	{
+		Read(intValues.Values.GetData(), GetValueSize(intValues, SizeOfSerializableIntType(type)));
+	}
+
+	void BinaryDeserializer::SerializeBool(SerializationValue<bool> value)
+	{
+		Read(value.Values.GetData(), GetValueSize(value, sizeof(bool)));
+	}
+
+	void BinaryDeserializer::SerializeFloat(SerializationValue<float> value)
+	{
+		Read(value.Values.GetData(), GetValueSize(value, sizeof(float)));
+	}
+
+	void BinaryDeserializer::SerializeUUID(SerializationValue<UUID> uuids)
+	{
+		Read(uuids.Values.GetData(), GetValueSize(uuids, sizeof(UUID)));
+	}
+
+	void BinaryDeserializer::SerializeFloatVector(SerializationValue<float> value, uint32_t componentsCount)
+	{
+		Read(value.Values.GetData(), GetValueSize(value, sizeof(float) * componentsCount));
+	}
+
+	void BinaryDeserializer::SerializeIntVector(SerializationValue<int32_t> value, uint32_t componentsCount)
+	{
+		Read(value.Values.GetData(), GetValueSize(value, sizeof(int32_t) * componentsCount));
+	}
+
+	void BinaryDeserializer::SerializeString(SerializationValue<std::string> value)
+	{
+		for (size_t i = 0; i < value.Values.GetSize(); i++)
+		{
+			uint32_t length = 0;
+			Read(&length, sizeof(length));
+
+			if (m_Failed || m_Position + length > m_Size)
+			{
+				m_Failed = true;
+				return;
+			}
+
+			value.Values[i].assign((const char*)(m_Data + m_Position), (size_t)length);
+			m_Position += length;
+		}
+	}
+
+	void BinaryDeserializer::SerializeObject(const SerializableObjectDescriptor& descriptor, void* objectData, bool isArray, size_t arraySize)
+	{
+		size_t count = isArray ? arraySize : 1;
+
+		if (&descriptor == &Grapple_SERIALIZATION_DESCRIPTOR_OF(AssetHandle)
+			|| &descriptor == &Grapple_SERIALIZATION_DESCRIPTOR_OF(Entity))
+		{
+			Read(objectData, descriptor.Size * count);
+			return;
+		}
+
+		for (size_t i = 0; i < count && !m_Failed; i++)
+			descriptor.Callback((uint8_t*)objectData + i * descriptor.Size, *this);
+	}
+
+	void BinaryDeserializer::SerializeReference(const SerializableObjectDescriptor& valueDescriptor, void* referenceData, void* valueData)
+	{
+		const AssetDescriptor* assetDescriptor = AssetDescriptor::FindBySerializationDescriptor(valueDescriptor);
+		if (assetDescriptor)
+		{
+			Grapple_CORE_ASSERT(referenceData);
+			Ref<Asset>& asset = *(Ref<Asset>*)referenceData;
+
+			AssetHandle handle = NULL_ASSET_HANDLE;
+			Read(&handle, sizeof(handle));
+
+			asset = nullptr;
+			if (AssetManager::IsAssetHandleValid(handle))
+			{
+				Ref<Asset> deserializedAsset = AssetManager::GetRawAsset(handle);
+				if (deserializedAsset != nullptr && &deserializedAsset->GetDescriptor() == assetDescriptor)
+					asset = deserializedAsset;
+			}
+		}
+		else
+		{
+			Grapple_CORE_WARN("BinaryDeserializer: Reference deserialization not supported");
+		}
+	}
+
+	void BinaryDeserializer::Read(void* data, size_t size)
+	{
+		if (m_Failed || m_Position + size > m_Size)
+		{
+			m_Failed = true;
+			return;
+		}
+
+		std::memcpy(data, m_Data + m_Position, size);
+		m_Position += size;
+	}
+}
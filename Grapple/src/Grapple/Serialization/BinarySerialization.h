@@ -0,0 +1,70 @@
+#pragma once
+
+#include "GrappleCore/Core.h"
+#include "GrappleCore/Serialization/SerializationStream.h"
+
+#include <vector>
+
+namespace Grapple
+{
+	// Writes serializable objects as tightly packed binary data.
+	//
+	// Property keys are not stored, so the data can only be read back by
+	// the same serialization callbacks, which were used for writing it.
+	// Entity ids and asset handles are written as is.
+	class Grapple_API BinarySerializer : public SerializationStream
+	{
+	public:
+		BinarySerializer(std::vector<uint8_t>& output);
+	public:
+		void PropertyKey(std::string_view key) override;
+		DynamicArrayAction SerializeDynamicArraySize(size_t& size) override;
+		void SerializeInt(SerializationValue<uint8_t> intValues, SerializableIntType type) override;
+		void SerializeBool(SerializationValue<bool> value) override;
+		void SerializeFloat(SerializationValue<float> value) override;
+		void SerializeUUID(SerializationValue<UUID> uuids) override;
+		void SerializeFloatVector(SerializationValue<float> value, uint32_t componentsCount) override;
+		void SerializeIntVector(SerializationValue<int32_t> value, uint32_t componentsCount) override;
+		void SerializeString(SerializationValue<std::string> value) override;
+		void SerializeObject(const SerializableObjectDescriptor& descriptor, void* objectData, bool isArray, size_t arraySize) override;
+
+		void SerializeReference(const SerializableObjectDescriptor& valueDescriptor,
+			void* referenceData,
+			void* valueData) override;
+	private:
+		void Write(const void* data, size_t size);
+	private:
+		std::vector<uint8_t>& m_Output;
+	};
+
+	class Grapple_API BinaryDeserializer : public SerializationStream
+	{
+	public:
+		BinaryDeserializer(const uint8_t* data, size_t size);
+	public:
+		void PropertyKey(std::string_view key) override;
+		DynamicArrayAction SerializeDynamicArraySize(size_t& size) override;
+		void SerializeInt(SerializationValue<uint8_t> intValues, SerializableIntType type) override;
+		void SerializeBool(SerializationValue<bool> value) override;
+		void SerializeFloat(SerializationValue<float> value) override;
+		void SerializeUUID(SerializationValue<UUID> uuids) override;
+		void SerializeFloatVector(SerializationValue<float> value, uint32_t componentsCount) override;
+		void SerializeIntVector(SerializationValue<int32_t> value, uint32_t componentsCount) override;
+		void SerializeString(SerializationValue<std::string> value) override;
+		void SerializeObject(const SerializableObjectDescriptor& descriptor, void* objectData, bool isArray, size_t arraySize) override;
+
+		void SerializeReference(const SerializableObjectDescriptor& valueDescriptor,
+			void* referenceData,
+			void* valueData) override;
+
+		inline size_t GetPosition() const { return m_Position; }
+		inline bool HasFailed() const { return m_Failed; }
+	private:
+		void Read(void* data, size_t size);
+	private:
+		const uint8_t* m_Data;
+		size_t m_Size;
+		size_t m_Position;
+		bool m_Failed;
+	};
+}
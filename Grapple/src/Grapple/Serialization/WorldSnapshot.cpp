@@ -0,0 +1,539 @@
+#include "WorldSnapshot.h"
+
+#include "GrappleCore/Log.h"
+#include "GrappleCore/Profiler/Profiler.h"
+
+#include "GrapplePlatform/MappedFile.h"
+
+#include "Grapple/Serialization/BinarySerialization.h"
+
+#include <algorithm>
+#include <fstream>
+#include <unordered_map>
+
+namespace Grapple
+{
+	static constexpr uint32_t s_SnapshotMagic = 0x534e5747; // "GWNS"
+	static constexpr uint32_t s_SnapshotVersion = 1;
+
+	// Snapshot layout:
+	//
+	// SnapshotHeader
+	// SnapshotComponent[ComponentsCount], each followed by the component name
+	// Entity[DeletedIdsCount]
+	// For each archetype:
+	//     SnapshotArchetype
+	//     SnapshotComponentLayout[ComponentsCount]
+	//     Entity[EntitiesCount]
+	//     uint32_t[EntitiesCount] - Entity registry indices
+	//     Entity rows, EntitySize * EntitiesCount bytes
+	//     Serialized non trivially copyable components, FallbackDataSize bytes
+
+	struct SnapshotHeader
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		uint32_t ComponentsCount;
+		uint32_t ArchetypesCount;
+		uint64_t EntitiesCount;
+		uint32_t NextEntityIndex;
+		uint32_t DeletedIdsCount;
+	};
+
+	struct SnapshotComponent
+	{
+		uint64_t Size;
+		uint32_t NameLength;
+		uint32_t IsTriviallyCopyable;
+	};
+
+	struct SnapshotArchetype
+	{
+		uint32_t ComponentsCount;
+		uint32_t EntitySize;
+		uint64_t EntitiesCount;
+		uint64_t FallbackDataSize;
+	};
+
+	struct SnapshotComponentLayout
+	{
+		uint32_t ComponentIndex;
+		uint32_t Offset;
+	};
+
+	class SnapshotReader
+	{
+	public:
+		SnapshotReader(const uint8_t* data, size_t size)
+			: m_Data(data), m_Size(size), m_Position(0), m_Failed(false) {}
+
+		const uint8_t* ReadBytes(size_t size)
+		{
+			if (m_Failed || size > m_Size - m_Position)
+			{
+				m_Failed = true;
+				return nullptr;
+			}
+
+			const uint8_t* data = m_Data + m_Position;
+			m_Position += size;
+			return data;
+		}
+
+		template<typename T>
+		bool Read(T* values, size_t count)
+		{
+			if (count > GetRemainingSize() / sizeof(T))
+			{
+				m_Failed = true;
+				return false;
+			}
+
+			const uint8_t* data = ReadBytes(sizeof(T) * count);
+			if (data == nullptr)
+				return false;
+
+			std::memcpy(values, data, sizeof(T) * count);
+			return true;
+		}
+
+		template<typename T>
+		bool Read(T& value)
+		{
+			return Read(&value, 1);
+		}
+
+		inline size_t GetRemainingSize() const { return m_Size - m_Position; }
+		inline bool HasFailed() const { return m_Failed; }
+	private:
+		const uint8_t* m_Data;
+		size_t m_Size;
+		size_t m_Position;
+		bool m_Failed;
+	};
+
+	static void WriteBytes(std::vector<uint8_t>& output, const void* data, size_t size)
+	{
+		if (size == 0)
+			return;
+
+		size_t position = output.size();
+		output.resize(position + size);
+		std::memcpy(output.data() + position, data, size);
+	}
+
+	template<typename T>
+	static void WriteValue(std::vector<uint8_t>& output, const T& value)
+	{
+		WriteBytes(output, &value, sizeof(T));
+	}
+
+	static bool IsComponentTriviallyCopyable(const ComponentInfo& info)
+	{
+		return info.Initializer == nullptr || info.Initializer->Type.IsTriviallyCopyable;
+	}
+
+	void WorldSnapshot::Serialize(const World& world, std::vector<uint8_t>& output)
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		const Entities& entities = world.Entities;
+		const Archetypes& archetypes = world.GetArchetypes();
+		const Components& components = entities.GetComponents();
+		const std::vector<EntityRecord>& records = entities.GetEntityRecords();
+		const EntityIndex& idGenerator = entities.GetEntityIndex();
+
+		// Entity storages are created lazily, so only archetypes which are referenced by entities are guaranteed to have one
+		std::vector<bool> usedArchetypes(archetypes.Records.size(), false);
+		for (const EntityRecord& record : records)
+			usedArchetypes[record.Archetype] = true;
+
+		std::vector<ArchetypeId> snapshotArchetypes;
+		std::vector<ComponentId> snapshotComponents;
+		std::unordered_map<ComponentId, uint32_t> componentToSnapshotIndex;
+
+		for (ArchetypeId archetype = 0; archetype < (ArchetypeId)usedArchetypes.size(); archetype++)
+		{
+			if (!usedArchetypes[archetype])
+				continue;
+
+			snapshotArchetypes.push_back(archetype);
+			for (ComponentId component : archetypes[archetype].Components)
+			{
+				if (componentToSnapshotIndex.emplace(component, (uint32_t)snapshotComponents.size()).second)
+					snapshotComponents.push_back(component);
+			}
+		}
+
+		SnapshotHeader header{};
+		header.Magic = s_SnapshotMagic;
+		header.Version = s_SnapshotVersion;
+		header.ComponentsCount = (uint32_t)snapshotComponents.size();
+		header.ArchetypesCount = (uint32_t)snapshotArchetypes.size();
+		header.EntitiesCount = (uint64_t)records.size();
+		header.NextEntityIndex = idGenerator.GetNextIndex();
+		header.DeletedIdsCount = (uint32_t)idGenerator.GetDeletedIds().size();
+
+		WriteValue(output, header);
+
+		for (ComponentId id : snapshotComponents)
+		{
+			const ComponentInfo& info = components.GetComponentInfo(id);
+
+			SnapshotComponent component{};
+			component.Size = (uint64_t)info.Size;
+			component.NameLength = (uint32_t)info.Name.size();
+			component.IsTriviallyCopyable = IsComponentTriviallyCopyable(info) ? 1 : 0;
+
+			WriteValue(output, component);
+			WriteBytes(output, info.Name.data(), info.Name.size());
+		}
+
+		WriteBytes(output, idGenerator.GetDeletedIds().data(), sizeof(Entity) * idGenerator.GetDeletedIds().size());
+
+		std::vector<size_t> nonTrivialComponents;
+		std::vector<uint8_t> fallbackData;
+		for (ArchetypeId archetypeId : snapshotArchetypes)
+		{
+			const ArchetypeRecord& archetype = archetypes[archetypeId];
+			const EntityStorage& storage = entities.GetEntityStorage(archetypeId);
+			size_t entitiesCount = storage.GetEntitiesCount();
+
+			nonTrivialComponents.clear();
+			fallbackData.clear();
+
+			for (size_t i = 0; i < archetype.Components.size(); i++)
+			{
+				if (!IsComponentTriviallyCopyable(components.GetComponentInfo(archetype.Components[i])))
+					nonTrivialComponents.push_back(i);
+			}
+
+			if (nonTrivialComponents.size() > 0)
+			{
+				Grapple_PROFILE_SCOPE("SerializeNonTrivialComponents");
+
+				BinarySerializer serializer(fallbackData);
+				for (size_t entityIndex = 0; entityIndex < entitiesCount; entityIndex++)
+				{
+					uint8_t* entityData = storage.GetEntityData(entityIndex);
+					for (size_t componentIndex : nonTrivialComponents)
+					{
+						const TypeInitializer& type = components.GetComponentInfo(archetype.Components[componentIndex]).Initializer->Type;
+						type.SerializationDescriptor.Callback(entityData + archetype.ComponentOffsets[componentIndex], serializer);
+					}
+				}
+			}
+
+			SnapshotArchetype archetypeHeader{};
+			archetypeHeader.ComponentsCount = (uint32_t)archetype.Components.size();
+			archetypeHeader.EntitySize = (uint32_t)archetype.EntitySize;
+			archetypeHeader.EntitiesCount = (uint64_t)entitiesCount;
+			archetypeHeader.FallbackDataSize = (uint64_t)fallbackData.size();
+
+			WriteValue(output, archetypeHeader);
+
+			for (size_t i = 0; i < archetype.Components.size(); i++)
+			{
+				SnapshotComponentLayout layout{};
+				layout.ComponentIndex = componentToSnapshotIndex.at(archetype.Components[i]);
+				layout.Offset = (uint32_t)archetype.ComponentOffsets[i];
+
+				WriteValue(output, layout);
+			}
+
+			for (uint32_t registryIndex : storage.GetEntityIndices())
+				WriteValue(output, records[registryIndex].Id);
+
+			WriteBytes(output, storage.GetEntityIndices().data(), sizeof(uint32_t) * entitiesCount);
+
+			size_t rowsOffset = output.size();
+			for (size_t chunk = 0; chunk < storage.GetChunksCount(); chunk++)
+				WriteBytes(output, storage.GetChunkBuffer(chunk), storage.GetEntitiesCountInChunk(chunk) * archetype.EntitySize);
+
+			// Rows contain raw bytes of non trivially copyable components (pointers, etc.),
+			// which are cleared so that snapshots of the same world are identical
+			for (size_t componentIndex : nonTrivialComponents)
+			{
+				size_t componentSize = components.GetComponentInfo(archetype.Components[componentIndex]).Size;
+				for (size_t entityIndex = 0; entityIndex < entitiesCount; entityIndex++)
+				{
+					size_t offset = rowsOffset + entityIndex * archetype.EntitySize + archetype.ComponentOffsets[componentIndex];
+					std::memset(output.data() + offset, 0, componentSize);
+				}
+			}
+
+			WriteBytes(output, fallbackData.data(), fallbackData.size());
+		}
+	}
+
+	static bool DeserializeArchetype(SnapshotReader& reader,
+		Entities& entities,
+		const std::vector<const ComponentInfo*>& snapshotComponents,
+		std::vector<EntityRecord>& records)
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		SnapshotArchetype header{};
+		if (!reader.Read(header) || header.ComponentsCount == 0 || header.EntitySize == 0)
+			return false;
+
+		std::vector<SnapshotComponentLayout> layouts(header.ComponentsCount);
+		if (!reader.Read(layouts.data(), layouts.size()))
+			return false;
+
+		std::vector<const ComponentInfo*> componentInfos(header.ComponentsCount);
+		std::vector<ComponentId> sortedComponents(header.ComponentsCount);
+		for (size_t i = 0; i < layouts.size(); i++)
+		{
+			if (layouts[i].ComponentIndex >= snapshotComponents.size())
+				return false;
+
+			componentInfos[i] = snapshotComponents[layouts[i].ComponentIndex];
+			if ((size_t)layouts[i].Offset + componentInfos[i]->Size > (size_t)header.EntitySize)
+				return false;
+
+			sortedComponents[i] = componentInfos[i]->Id;
+		}
+
+		// Component ids are not stable between runs, so the order of components can differ from the one in the snapshot
+		std::sort(sortedComponents.begin(), sortedComponents.end());
+		if (std::adjacent_find(sortedComponents.begin(), sortedComponents.end()) != sortedComponents.end())
+			return false;
+
+		size_t entitiesCount = (size_t)header.EntitiesCount;
+		if (entitiesCount > reader.GetRemainingSize() / (sizeof(Entity) + sizeof(uint32_t) + (size_t)header.EntitySize))
+			return false;
+
+		const uint8_t* ids = reader.ReadBytes(sizeof(Entity) * entitiesCount);
+		std::vector<uint32_t> registryIndices(entitiesCount);
+		reader.Read(registryIndices.data(), entitiesCount);
+
+		const uint8_t* rows = reader.ReadBytes((size_t)header.EntitySize * entitiesCount);
+		const uint8_t* fallbackData = reader.ReadBytes((size_t)header.FallbackDataSize);
+
+		if (reader.HasFailed())
+			return false;
+
+		ArchetypeId archetypeId = entities.FindOrCreateArchetype(ComponentSet(sortedComponents.data(), sortedComponents.size()));
+		const ArchetypeRecord& archetype = entities.GetArchetypes()[archetypeId];
+		EntityStorage& storage = entities.GetEntityStorage(archetypeId);
+
+		size_t firstEntityIndex = storage.GetEntitiesCount();
+		for (size_t i = 0; i < entitiesCount; i++)
+		{
+			uint32_t registryIndex = registryIndices[i];
+			if (registryIndex >= records.size() || records[registryIndex].Archetype != INVALID_ARCHETYPE_ID)
+				return false;
+
+			EntityRecord& record = records[registryIndex];
+			std::memcpy(&record.Id, ids + i * sizeof(Entity), sizeof(Entity));
+			record.RegistryIndex = registryIndex;
+			record.Archetype = archetypeId;
+			record.BufferIndex = firstEntityIndex + i;
+		}
+
+		bool sameLayout = archetype.EntitySize == (size_t)header.EntitySize;
+		std::vector<size_t> destinationOffsets(layouts.size());
+		std::vector<size_t> nonTrivialComponents;
+
+		for (size_t i = 0; i < layouts.size(); i++)
+		{
+			std::optional<size_t> componentIndex = archetype.TryGetComponentIndex(componentInfos[i]->Id);
+			Grapple_CORE_ASSERT(componentIndex.has_value());
+
+			destinationOffsets[i] = archetype.ComponentOffsets[*componentIndex];
+			sameLayout &= destinationOffsets[i] == (size_t)layouts[i].Offset;
+
+			if (!IsComponentTriviallyCopyable(*componentInfos[i]))
+				nonTrivialComponents.push_back(i);
+		}
+
+		storage.AddEntities(registryIndices.data(), entitiesCount);
+
+		EntityDataStorage& dataStorage = storage.GetDataStorage();
+		if (sameLayout)
+		{
+			Grapple_PROFILE_SCOPE("CopyChunks");
+
+			size_t copiedEntities = 0;
+			while (copiedEntities < entitiesCount)
+			{
+				size_t entityIndex = firstEntityIndex + copiedEntities;
+				size_t chunkEntities = std::min(entitiesCount - copiedEntities, dataStorage.EntitiesPerChunk - entityIndex % dataStorage.EntitiesPerChunk);
+
+				std::memcpy(dataStorage.GetEntityData(entityIndex), rows + copiedEntities * archetype.EntitySize, chunkEntities * archetype.EntitySize);
+				copiedEntities += chunkEntities;
+			}
+		}
+		else
+		{
+			Grapple_PROFILE_SCOPE("CopyComponents");
+
+			for (size_t i = 0; i < entitiesCount; i++)
+			{
+				uint8_t* entityData = dataStorage.GetEntityData(firstEntityIndex + i);
+				const uint8_t* snapshotEntityData = rows + i * (size_t)header.EntitySize;
+
+				for (size_t component = 0; component < layouts.size(); component++)
+				{
+					std::memcpy(entityData + destinationOffsets[component],
+						snapshotEntityData + layouts[component].Offset,
+						componentInfos[component]->Size);
+				}
+			}
+		}
+
+		if (nonTrivialComponents.empty())
+			return true;
+
+		Grapple_PROFILE_SCOPE("DeserializeNonTrivialComponents");
+
+		// All of the components must be constructed before deserializing,
+		// so that the entities can be safely deleted in case of a failure
+		for (size_t i = 0; i < entitiesCount; i++)
+		{
+			uint8_t* entityData = dataStorage.GetEntityData(firstEntityIndex + i);
+			for (size_t component : nonTrivialComponents)
+				componentInfos[component]->Initializer->Type.DefaultConstructor(entityData + destinationOffsets[component]);
+		}
+
+		BinaryDeserializer deserializer(fallbackData, (size_t)header.FallbackDataSize);
+		for (size_t i = 0; i < entitiesCount && !deserializer.HasFailed(); i++)
+		{
+			uint8_t* entityData = dataStorage.GetEntityData(firstEntityIndex + i);
+			for (size_t component : nonTrivialComponents)
+			{
+				const TypeInitializer& type = componentInfos[component]->Initializer->Type;
+				type.SerializationDescriptor.Callback(entityData + destinationOffsets[component], deserializer);
+			}
+		}
+
+		return !deserializer.HasFailed();
+	}
+
+	bool WorldSnapshot::Deserialize(World& world, const uint8_t* data, size_t size)
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		SnapshotReader reader(data, size);
+		SnapshotHeader header{};
+
+		if (!reader.Read(header) || header.Magic != s_SnapshotMagic)
+		{
+			Grapple_CORE_ERROR("WorldSnapshot: Invalid snapshot data");
+			return false;
+		}
+
+		if (header.Version != s_SnapshotVersion)
+		{
+			Grapple_CORE_ERROR("WorldSnapshot: Unsupported snapshot version {}", header.Version);
+			return false;
+		}
+
+		Entities& entities = world.Entities;
+		const Components& components = entities.GetComponents();
+
+		std::vector<const ComponentInfo*> snapshotComponents(header.ComponentsCount);
+		for (uint32_t i = 0; i < header.ComponentsCount; i++)
+		{
+			SnapshotComponent component{};
+			reader.Read(component);
+
+			const char* name = (const char*)reader.ReadBytes(component.NameLength);
+			if (name == nullptr)
+			{
+				Grapple_CORE_ERROR("WorldSnapshot: Invalid snapshot data");
+				return false;
+			}
+
+			std::string_view componentName(name, component.NameLength);
+			std::optional<ComponentId> id = components.FindComponnet(componentName);
+			if (!id.has_value())
+			{
+				Grapple_CORE_ERROR("WorldSnapshot: Component '{}' is not registered", componentName);
+				return false;
+			}
+
+			const ComponentInfo& info = components.GetComponentInfo(*id);
+			if ((uint64_t)info.Size != component.Size || IsComponentTriviallyCopyable(info) != (component.IsTriviallyCopyable != 0))
+			{
+				Grapple_CORE_ERROR("WorldSnapshot: Layout of component '{}' has changed since the snapshot was created", componentName);
+				return false;
+			}
+
+			snapshotComponents[i] = &info;
+		}
+
+		std::vector<Entity> deletedIds(header.DeletedIdsCount);
+		if (!reader.Read(deletedIds.data(), deletedIds.size()) || header.EntitiesCount > reader.GetRemainingSize() / sizeof(Entity))
+		{
+			Grapple_CORE_ERROR("WorldSnapshot: Invalid snapshot data");
+			return false;
+		}
+
+		entities.Clear();
+
+		EntityRecord emptyRecord{};
+		emptyRecord.Archetype = INVALID_ARCHETYPE_ID;
+
+		std::vector<EntityRecord> records((size_t)header.EntitiesCount, emptyRecord);
+
+		bool succeeded = true;
+		for (uint32_t i = 0; i < header.ArchetypesCount && succeeded; i++)
+			succeeded = DeserializeArchetype(reader, entities, snapshotComponents, records);
+
+		for (size_t i = 0; i < records.size() && succeeded; i++)
+			succeeded = records[i].Archetype != INVALID_ARCHETYPE_ID;
+
+		if (!succeeded)
+		{
+			Grapple_CORE_ERROR("WorldSnapshot: Invalid snapshot data");
+			entities.Clear();
+			return false;
+		}
+
+		entities.RestoreEntityRecords(std::move(records), EntityIndex(header.NextEntityIndex, std::move(deletedIds)));
+		return true;
+	}
+
+	bool WorldSnapshot::Serialize(const World& world, const std::filesystem::path& path)
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		std::vector<uint8_t> data;
+		Serialize(world, data);
+
+		std::ofstream output(path, std::ios::out | std::ios::binary);
+		if (!output.is_open())
+		{
+			Grapple_CORE_ERROR("WorldSnapshot: Failed to open '{}'", path.generic_string());
+			return false;
+		}
+
+		output.write((const char*)data.data(), data.size());
+		return output.good();
+	}
+
+	bool WorldSnapshot::Deserialize(World& world, const std::filesystem::path& path)
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		Scope<MappedFile> file(MappedFile::Open(path));
+		if (file != nullptr)
+			return Deserialize(world, file->GetData(), file->GetSize());
+
+		// Memory mapping is not available, so the whole file is read at once instead
+		std::ifstream input(path, std::ios::in | std::ios::binary | std::ios::ate);
+		if (!input.is_open())
+		{
+			Grapple_CORE_ERROR("WorldSnapshot: Failed to open '{}'", path.generic_string());
+			return false;
+		}
+
+		std::vector<uint8_t> data((size_t)input.tellg());
+		input.seekg(0);
+		input.read((char*)data.data(), data.size());
+
+		return Deserialize(world, data.data(), data.size());
+	}
+}
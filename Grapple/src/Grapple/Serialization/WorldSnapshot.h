@@ -0,0 +1,29 @@
+#pragma once
+
+#include "GrappleCore/Core.h"
+
+#include "GrappleECS/World.h"
+
+#include <vector>
+#include <filesystem>
+
+namespace Grapple
+{
+	// Binary chunk level snapshot of all entities in a World.
+	//
+	// Stores archetype signatures, component layouts and raw entity rows, so that loading
+	// mostly consists of bulk copies into entity chunks. Components which are not trivially copyable
+	// are written separately using their serialization descriptors.
+	//
+	// Entity ids are preserved. Components are matched by name when loading, so a snapshot
+	// is only valid while the sizes of its components don't change.
+	class Grapple_API WorldSnapshot
+	{
+	public:
+		static void Serialize(const World& world, std::vector<uint8_t>& output);
+		static bool Deserialize(World& world, const uint8_t* data, size_t size);
+
+		static bool Serialize(const World& world, const std::filesystem::path& path);
+		static bool Deserialize(World& world, const std::filesystem::path& path);
+	};
+}
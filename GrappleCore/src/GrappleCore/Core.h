@@ -1,7 +1,7 @@
 #pragma once
 
 #include <memory>
-#include <xhash>
+#include <functional>
 
 #ifdef _WIN32
 	#ifdef _WIN64
@@ -23,13 +23,18 @@
 
 #define Grapple_NONE
 
-#define Grapple_API_EXPORT __declspec(dllexport)
-#define Grapple_API_IMPORT __declspec(dllimport)
+#ifdef Grapple_PLATFORM_WINDOWS
+	#define Grapple_API_EXPORT __declspec(dllexport)
+	#define Grapple_API_IMPORT __declspec(dllimport)
+#else
+	#define Grapple_API_EXPORT __attribute__((visibility("default")))
+	#define Grapple_API_IMPORT
+#endif
 
 #define Grapple_TYPE_OF_FIELD(typeName, fieldName) decltype(((typeName*)nullptr)->fieldName)
 
-#define Grapple_EXPORT extern "C" __declspec(dllexport)
-#define Grapple_IMPORT extern "C" __declspec(dllimport)
+#define Grapple_EXPORT extern "C" Grapple_API_EXPORT
+#define Grapple_IMPORT extern "C" Grapple_API_IMPORT
 
 #define Grapple_EXPEND_MACRO(a) a
 #define FALRE_STRINGIFY_MACRO(a) #a
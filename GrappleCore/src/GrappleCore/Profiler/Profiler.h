@@ -12,15 +12,28 @@
 
 #include <Tracy.hpp>
 
+#ifdef _MSC_VER
+	#define Grapple_FUNCTION_SIGNATURE __FUNCSIG__
+#else
+	#define Grapple_FUNCTION_SIGNATURE __PRETTY_FUNCTION__
+#endif
+
 #ifdef Grapple_PROFILING_ENABLED
 	#define Grapple_PROFILE_BEGIN_FRAME(name) FrameMarkStart(name)
 	#define Grapple_PROFILE_END_FRAME(name) FrameMarkEnd(name)
 
 	#define Grapple_PROFILE_SCOPE(name) ZoneScopedN(name)
-	#define Grapple_PROFILE_FUNCTION() Grapple_PROFILE_SCOPE(__FUNCSIG__)
+	#define Grapple_PROFILE_FUNCTION() Grapple_PROFILE_SCOPE(Grapple_FUNCTION_SIGNATURE)
+
+	// `name` must be a string literal, because Tracy identifies plots by pointer
+	#define Grapple_PROFILE_PLOT(name, value) TracyPlot(name, value)
+
+	#define Grapple_PROFILE_THREAD(name) tracy::SetThreadName(name)
 #else
     #define Grapple_PROFILE_BEGIN_FRAME(name)
     #define Grapple_PROFILE_END_FRAME(name)
     #define Grapple_PROFILE_SCOPE(name)
     #define Grapple_PROFILE_FUNCTION()
+    #define Grapple_PROFILE_PLOT(name, value)
+    #define Grapple_PROFILE_THREAD(name)
 #endif
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "GrappleCore/Core.h"
 #include "GrappleCore/Serialization/Serialization.h"
+#include "GrappleCore/Serialization/TypeSerializer.h"
 
 #define Grapple_SERIALIZABLE                                              \
     static Grapple::SerializableObjectDescriptor _SerializationDescriptor;
@@ -9,8 +9,9 @@ namespace Grapple
         DestructorFunction destructor,
         DefaultConstructorFunction constructor,
         MoveConstructorFunction moveConstructor,
-        CopyConstructorFunction copyConstructor)
-        : TypeName(typeName), Size(size), 
+        CopyConstructorFunction copyConstructor,
+        bool isTriviallyCopyable)
+        : TypeName(typeName), Size(size), IsTriviallyCopyable(isTriviallyCopyable),
           SerializationDescriptor(serializationDescriptor),
           Destructor(destructor),
           DefaultConstructor(constructor),
@@ -9,6 +9,7 @@
 
 #include <vector>
 #include <string_view>
+#include <type_traits>
 
 namespace Grapple
 {
@@ -26,7 +27,8 @@ namespace Grapple
             DestructorFunction destructor, 
             DefaultConstructorFunction constructor,
             MoveConstructorFunction moveConstructor,
-            CopyConstructorFunction copyConstructor);
+            CopyConstructorFunction copyConstructor,
+            bool isTriviallyCopyable = false);
         ~TypeInitializer();
 
         static std::vector<TypeInitializer*>& GetInitializers();
@@ -37,6 +39,7 @@ namespace Grapple
         const CopyConstructorFunction CopyConstructor;
         const MoveConstructorFunction MoveConstructor;
         const size_t Size;
+        const bool IsTriviallyCopyable;
         const SerializableObjectDescriptor& SerializationDescriptor;
     };
 }
@@ -50,5 +53,6 @@ namespace Grapple
     [](void* instance) { ((typeName*)instance)->~typeName(); },                                       \
     [](void* instance) { new(instance) typeName;},                                                    \
     [](void* instance, void* moveFrom) { (*(typeName*)instance) = std::move(*(typeName*)moveFrom); }, \
-    [](void* instance, const void* copyFrom) { (*(typeName*)instance) = *(typeName*)copyFrom; });     \
+    [](void* instance, const void* copyFrom) { (*(typeName*)instance) = *(typeName*)copyFrom; },      \
+    std::is_trivially_copyable_v<typeName>);                                                          \
     Grapple_SERIALIZABLE_IMPL(typeName)
\ No newline at end of file
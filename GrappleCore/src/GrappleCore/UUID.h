@@ -2,7 +2,7 @@
 
 #include "GrappleCore/Core.h"
 
-#include <xhash>
+#include <functional>
 
 namespace Grapple
 {
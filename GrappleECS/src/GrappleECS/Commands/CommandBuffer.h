@@ -20,28 +20,28 @@ namespace Grapple
 		template<typename T>
 		FutureEntityCommands& AddComponent(ComponentInitializationStrategy initStrategy = ComponentInitializationStrategy::DefaultConstructor)
 		{
-			m_CommandBuffer.AddCommand<AddComponentCommand>(AddComponentCommand(m_FutureEntity, COMPONENT_ID(T), initStrategy));
+			m_CommandBuffer.template AddCommand<AddComponentCommand>(AddComponentCommand(m_FutureEntity, COMPONENT_ID(T), initStrategy));
 			return *this;
 		}
 
 		template<typename T>
 		FutureEntityCommands& AddComponentWithData(const T& component)
 		{
-			m_CommandBuffer.AddCommand<AddComponentWithDataCommand<T>>(AddComponentWithDataCommand<T>(m_FutureEntity, component));
+			m_CommandBuffer.template AddCommand<AddComponentWithDataCommand<T>>(AddComponentWithDataCommand<T>(m_FutureEntity, component));
 			return *this;
 		}
 
 		template<typename T>
 		FutureEntityCommands& SetComponent(const T& component)
 		{
-			m_CommandBuffer.AddCommand<SetComponentCommand<T>>(SetComponentCommand<T>(m_FutureEntity, component));
+			m_CommandBuffer.template AddCommand<SetComponentCommand<T>>(SetComponentCommand<T>(m_FutureEntity, component));
 			return *this;
 		}
 
 		template<typename T>
 		FutureEntityCommands& RemoveComponent()
 		{
-			m_CommandBuffer.AddCommand<RemoveComponentCommand>(RemoveComponentCommand(m_FutureEntity, COMPONENT_ID(T)));
+			m_CommandBuffer.template AddCommand<RemoveComponentCommand>(RemoveComponentCommand(m_FutureEntity, COMPONENT_ID(T)));
 			return *this;
 		}
 	private:
@@ -118,6 +118,8 @@ namespace Grapple
 
 		void DeleteEntity(Entity entity);
 		void Execute();
+
+		inline CommandsStorageStatistics GetStatistics() const { return m_Storage.GetStatistics(); }
 	private:
 		World& m_World;
 		CommandsStorage m_Storage;
@@ -34,7 +34,7 @@ namespace Grapple
 		virtual void Apply(CommandContext& context, World& world) override
 		{
 			Grapple_CORE_ASSERT(world.IsEntityAlive(context.GetEntity(m_Entity)));
-			world.AddEntityComponent<T>(context.GetEntity(m_Entity), std::move(m_Data));
+			world.template AddEntityComponent<T>(context.GetEntity(m_Entity), std::move(m_Data));
 		}
 	private:
 		FutureEntity m_Entity;
@@ -51,7 +51,7 @@ namespace Grapple
 	public:
 		virtual void Apply(CommandContext& context, World& world) override
 		{
-			T* component = world.TryGetEntityComponent<T>(context.GetEntity(m_Entity));
+			T* component = world.template TryGetEntityComponent<T>(context.GetEntity(m_Entity));
 			if (component)
 				*component = m_Data;
 		}
@@ -81,7 +81,7 @@ namespace Grapple
 
 		virtual void Apply(CommandContext& context, World& world) override
 		{
-			context.SetEntity(m_OutputEntity, world.CreateEntity<T...>(m_InitStrategy));
+			context.SetEntity(m_OutputEntity, world.template CreateEntity<T...>(m_InitStrategy));
 		}
 
 		virtual void Initialize(FutureEntity entity) override
@@ -103,7 +103,7 @@ namespace Grapple
 
 		virtual void Apply(CommandContext& context, World& world) override
 		{
-			Entity entity = std::apply([&world](const T& ...components) -> Entity { return world.CreateEntity<T...>(components...); }, m_Components);
+			Entity entity = std::apply([&world](const T& ...components) -> Entity { return world.template CreateEntity<T...>(components...); }, m_Components);
 			context.SetEntity(m_OutputEntity, entity);
 		}
 
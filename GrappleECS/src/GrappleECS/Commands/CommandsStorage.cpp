@@ -3,6 +3,9 @@
 #include "GrappleCore/Assert.h"
 #include "GrappleCore/Profiler/Profiler.h"
 
+#include <algorithm>
+#include <cstring>
+
 namespace Grapple
 {
 	CommandsStorage::CommandsStorage(size_t capacity)
@@ -26,6 +29,7 @@ namespace Grapple
 		{
 			size_t offset = m_Size;
 			m_Size += size;
+			m_HighWaterMark = std::max(m_HighWaterMark, m_Size);
 			return offset;
 		}
 
@@ -44,6 +48,7 @@ namespace Grapple
 		{
 			size_t oldSize = m_Size;
 			m_Size = newSize;
+			m_HighWaterMark = std::max(m_HighWaterMark, m_Size);
 
 			return { { oldSize, oldSize + sizeof(CommandMetadata) } };
 		}
@@ -63,6 +68,15 @@ namespace Grapple
 		return { metadata, (Command*) command };
 	}
 
+	CommandsStorageStatistics CommandsStorage::GetStatistics() const
+	{
+		CommandsStorageStatistics statistics;
+		statistics.Capacity = m_Buffer == nullptr ? 0 : m_Capacity;
+		statistics.HighWaterMark = m_HighWaterMark;
+		statistics.ReallocationsCount = m_ReallocationsCount;
+		return statistics;
+	}
+
 	bool CommandsStorage::CanRead()
 	{
 		return m_ReadPosition < m_Size;
@@ -80,13 +94,16 @@ namespace Grapple
 	void CommandsStorage::Reallocate()
 	{
 		Grapple_PROFILE_FUNCTION();
+		if (m_Buffer != nullptr)
+			m_ReallocationsCount++;
+
 		m_Capacity *= 2;
 		uint8_t* newBuffer = new uint8_t[m_Capacity];
 
 		if (m_Buffer != nullptr)
 		{
-			errno_t error = memcpy_s(newBuffer, m_Capacity, m_Buffer, m_Size);
-			Grapple_CORE_ASSERT(error == 0);
+			Grapple_CORE_ASSERT(m_Size <= m_Capacity);
+			std::memcpy(newBuffer, m_Buffer, m_Size);
 			
 			delete[] m_Buffer;
 		}
@@ -14,6 +14,15 @@ namespace Grapple
 		size_t CommandLocation;
 	};
 
+	struct CommandsStorageStatistics
+	{
+		size_t Capacity = 0;
+
+		// Largest number of bytes used by commands since the storage was created
+		size_t HighWaterMark = 0;
+		size_t ReallocationsCount = 0;
+	};
+
 	class GrappleECS_API CommandsStorage
 	{
 	public:
@@ -55,6 +64,9 @@ namespace Grapple
 
 		inline size_t GetReadPosition() const { return m_ReadPosition; }
 		inline size_t GetSize() const { return m_Size; }
+		inline size_t GetHighWaterMark() const { return m_HighWaterMark; }
+
+		CommandsStorageStatistics GetStatistics() const;
 
 		bool CanRead();
 		void Clear();
@@ -66,5 +78,8 @@ namespace Grapple
 		size_t m_Capacity;
 
 		size_t m_ReadPosition;
+
+		size_t m_HighWaterMark = 0;
+		size_t m_ReallocationsCount = 0;
 	};
 }
\ No newline at end of file
@@ -16,7 +16,7 @@
 namespace Grapple
 {
 	Entities::Entities(Components& components, QueryCache& queries, Archetypes& archetypes)
-		: m_Components(components), m_Queries(queries), m_Archetypes(archetypes)
+		: m_Components(components), m_Queries(queries), m_Archetypes(archetypes), m_Singletons(archetypes, queries)
 	{
 		Grapple_PROFILE_FUNCTION();
 		EntityChunksPool::Initialize(16);
@@ -74,6 +74,63 @@ namespace Grapple
 		m_EntityRecords.clear();
 		m_EntityToRecord.clear();
 		m_TemporaryComponentSet.clear();
+		m_Singletons.Clear();
+	}
+
+	void Entities::CloneFrom(const Entities& other)
+	{
+		Grapple_PROFILE_FUNCTION();
+		Grapple_CORE_ASSERT(&m_Archetypes == &other.m_Archetypes, "Entities can only be cloned from a world that uses the same ECSContext");
+
+		Clear();
+		EnsureValidEntityStorages();
+
+		std::vector<size_t> nonTrivialComponents;
+		for (const ArchetypeRecord& archetype : m_Archetypes.Records)
+		{
+			if (archetype.Id >= other.m_EntityStorages.size())
+				break;
+
+			const EntityStorage& source = other.m_EntityStorages[archetype.Id];
+			if (source.GetEntitiesCount() == 0)
+				continue;
+
+			EntityStorage& destination = m_EntityStorages[archetype.Id];
+			destination.CopyFrom(source);
+
+			nonTrivialComponents.clear();
+			for (size_t i = 0; i < archetype.Components.size(); i++)
+			{
+				const ComponentInfo& info = m_Components.GetComponentInfo(archetype.Components[i]);
+				if (info.Initializer && !info.Initializer->Type.IsTriviallyCopyable)
+					nonTrivialComponents.push_back(i);
+			}
+
+			if (nonTrivialComponents.empty())
+				continue;
+
+			// Byte copies of non trivially copyable components don't own their resources,
+			// so they are overwritten with properly constructed copies
+			Grapple_PROFILE_SCOPE("CopyNonTrivialComponents");
+			for (size_t entityIndex = 0; entityIndex < source.GetEntitiesCount(); entityIndex++)
+			{
+				const uint8_t* sourceData = source.GetEntityData(entityIndex);
+				uint8_t* destinationData = destination.GetEntityData(entityIndex);
+
+				for (size_t componentIndex : nonTrivialComponents)
+				{
+					const TypeInitializer& type = m_Components.GetComponentInfo(archetype.Components[componentIndex]).Initializer->Type;
+					size_t offset = archetype.ComponentOffsets[componentIndex];
+
+					type.DefaultConstructor(destinationData + offset);
+					type.CopyConstructor(destinationData + offset, sourceData + offset);
+				}
+			}
+		}
+
+		m_EntityRecords = other.m_EntityRecords;
+		m_EntityToRecord = other.m_EntityToRecord;
+		m_EntityIndex = other.m_EntityIndex;
 	}
 
 	Entity Entities::CreateEntity(const ComponentSet& componentSet, ComponentInitializationStrategy initStrategy)
@@ -156,6 +213,7 @@ namespace Grapple
 		EntityStorage& storage = GetEntityStorage(archetype);
 
 		record.BufferIndex = storage.AddEntity(record.RegistryIndex);
+		m_Singletons.OnArchetypeChanged(archetype);
 
 		uint8_t* entityData = storage.GetEntityData(record.BufferIndex);
 		switch (initStrategy)
@@ -224,6 +282,7 @@ namespace Grapple
 		}
 
 		storage.RemoveEntityData(record.BufferIndex);
+		m_Singletons.OnArchetypeChanged(archetype.Id);
 
 		m_EntityIndex.AddDeletedId(record.Id);
 		m_EntityToRecord.erase(record.Id);
@@ -366,6 +425,9 @@ namespace Grapple
 
 		RemoveEntityData(entityRecord.Archetype, entityRecord.BufferIndex);
 
+		m_Singletons.OnArchetypeChanged(entityRecord.Archetype);
+		m_Singletons.OnArchetypeChanged(newArchetypeId);
+
 		entityRecord.Archetype = newArchetypeId;
 		entityRecord.BufferIndex = newEntityIndex;
 
@@ -468,6 +530,9 @@ namespace Grapple
 
 		RemoveEntityData(entityRecord.Archetype, entityRecord.BufferIndex);
 
+		m_Singletons.OnArchetypeChanged(entityRecord.Archetype);
+		m_Singletons.OnArchetypeChanged(newArchetypeId);
+
 		entityRecord.Archetype = newArchetypeId;
 		entityRecord.BufferIndex = newEntityIndex;
 
@@ -514,7 +579,9 @@ namespace Grapple
 			return {};
 
 		EntityRecord& record = m_EntityRecords[it->second];
-		return GetEntityStorage(record.Archetype).GetEntityData(record.BufferIndex);
+		EntityStorage& storage = GetEntityStorage(record.Archetype);
+		storage.MarkEntityChanged(record.BufferIndex);
+		return storage.GetEntityData(record.BufferIndex);
 	}
 
 	std::optional<const uint8_t*> Entities::GetEntityData(Entity entity) const
@@ -547,12 +614,13 @@ namespace Grapple
 
 		const EntityRecord& entityRecord = m_EntityRecords[it->second];
 		const ArchetypeRecord& archetype = m_Archetypes.Records[entityRecord.Archetype];
-		const EntityStorage& storage = GetEntityStorage(entityRecord.Archetype);
+		EntityStorage& storage = GetEntityStorage(entityRecord.Archetype);
 
 		std::optional<size_t> componentIndex = archetype.TryGetComponentIndex(component);
 		if (!componentIndex.has_value())
 			return {};
 
+		storage.MarkEntityChanged(entityRecord.BufferIndex);
 		uint8_t* entityData = storage.GetEntityData(entityRecord.BufferIndex);
 		return entityData + archetype.ComponentOffsets[componentIndex.value()];
 	}
@@ -578,6 +646,9 @@ namespace Grapple
 
 	void* Entities::GetSingletonComponent(ComponentId id) const
 	{
+		if (void* cachedComponent = m_Singletons.FindComponent(id))
+			return cachedComponent;
+
 		Grapple_PROFILE_FUNCTION();
 		Grapple_CORE_ASSERT(m_Components.IsComponentIdValid(id));
 
@@ -626,46 +697,118 @@ namespace Grapple
 		}
 
 		uint8_t* entityData = storage.GetEntityData(0);
-		return entityData + record.ComponentOffsets[componentIndex];
+		void* component = entityData + record.ComponentOffsets[componentIndex];
+
+		m_Singletons.CacheComponent(id, component);
+		return component;
 	}
 
 	std::optional<Entity> Entities::GetSingletonEntity(const Query& query) const
 	{
+		const CachedQueryEntity& entity = GetFirstEntity(query);
+		if (entity.EntitiesCount == 0)
+		{
+			Grapple_CORE_ERROR("Failed to get singleton entity: Zero entities matched the query");
+			return {};
+		}
+
+		if (entity.EntitiesCount != 1)
+		{
+			Grapple_CORE_ERROR("Failed to get singleton entity: Multiple entities matched the query");
+			return {};
+		}
+
+		return entity.Id;
+	}
+
+	const CachedQueryEntity& Entities::GetFirstEntity(const Query& query) const
+	{
+		if (const CachedQueryEntity* cachedEntity = m_Singletons.FindQueryEntity(query.GetId()))
+			return *cachedEntity;
+
 		Grapple_PROFILE_FUNCTION();
-		const auto& archetypes = query.GetMatchingArchetypes();
+		Grapple_CORE_ASSERT(m_Queries[query.GetId()].Target == QueryTarget::AllEntities);
 
-		ArchetypeId archetype = INVALID_ARCHETYPE_ID;
-		size_t componentIndex = SIZE_MAX;
-		for (const auto& pair : archetypes)
+		CachedQueryEntity entity;
+		for (ArchetypeId archetype : query.GetMatchingArchetypes())
 		{
-			const EntityStorage& storage = GetEntityStorage(pair);
-			if (storage.GetEntitiesCount() != 0)
+			const EntityStorage& storage = GetEntityStorage(archetype);
+			if (storage.GetEntitiesCount() == 0)
+				continue;
+
+			if (entity.Archetype == INVALID_ARCHETYPE_ID)
 			{
-				if (archetype == INVALID_ARCHETYPE_ID)
-					archetype = pair;
-				else
-				{
-					Grapple_CORE_ERROR("Failed to get singleton entity: Multiple entities matched the query");
-					return {};
-				}
+				entity.Id = m_EntityRecords[storage.GetEntityIndices()[0]].Id;
+				entity.Archetype = archetype;
+				entity.Data = storage.GetEntityData(0);
 			}
-		}
 
-		if (archetype == INVALID_ARCHETYPE_ID)
-		{
-			Grapple_CORE_ERROR("Failed to get singleton entity: Zero entities matched the query");
-			return {};
+			entity.EntitiesCount += storage.GetEntitiesCount();
 		}
 
+		return m_Singletons.CacheQueryEntity(query.GetId(), entity);
+	}
+
+	ArchetypeMemoryStatistics Entities::GetArchetypeMemoryStatistics(ArchetypeId archetype) const
+	{
+		Grapple_CORE_ASSERT(m_Archetypes.IsIdValid(archetype));
+
 		const ArchetypeRecord& record = m_Archetypes[archetype];
-		const EntityStorage& storage = GetEntityStorage(archetype);
-		if (storage.GetEntitiesCount() != 1)
+
+		ArchetypeMemoryStatistics statistics;
+		statistics.EntitySize = record.EntitySize;
+
+		size_t componentsSize = 0;
+		for (ComponentId component : record.Components)
+			componentsSize += m_Components.GetComponentInfo(component).Size;
+
+		statistics.PaddingPerEntity = record.EntitySize - componentsSize;
+
+		// Storages are created lazily, so the archetype might not have one yet
+		if (archetype >= m_EntityStorages.size())
+			return statistics;
+
+		const EntityStorage& storage = m_EntityStorages[archetype];
+		statistics.EntitiesCount = storage.GetEntitiesCount();
+		statistics.ChunksCount = storage.GetChunksCount();
+		statistics.EntitiesPerChunk = storage.GetEntitiesPerChunkCount();
+		statistics.ChunkTailSize = ENTITY_CHUNK_SIZE - statistics.EntitiesPerChunk * statistics.EntitySize;
+
+		statistics.UsedBytes = statistics.EntitiesCount * statistics.EntitySize;
+		statistics.AllocatedBytes = statistics.ChunksCount * ENTITY_CHUNK_SIZE;
+
+		size_t capacity = statistics.ChunksCount * statistics.EntitiesPerChunk;
+		if (capacity > 0)
+			statistics.FillRatio = (float)statistics.EntitiesCount / (float)capacity;
+
+		return statistics;
+	}
+
+	EntitiesMemoryStatistics Entities::GetMemoryStatistics() const
+	{
+		Grapple_PROFILE_FUNCTION();
+		EntitiesMemoryStatistics statistics;
+		statistics.ArchetypesCount = m_Archetypes.Records.size();
+
+		size_t capacity = 0;
+		for (const ArchetypeRecord& archetype : m_Archetypes.Records)
 		{
-			Grapple_CORE_ERROR("Failed to get singleton entity: Multiple entities matched the query");
-			return {};
+			ArchetypeMemoryStatistics archetypeStatistics = GetArchetypeMemoryStatistics(archetype.Id);
+
+			statistics.EntitiesCount += archetypeStatistics.EntitiesCount;
+			statistics.ChunksCount += archetypeStatistics.ChunksCount;
+			statistics.UsedBytes += archetypeStatistics.UsedBytes;
+			statistics.AllocatedBytes += archetypeStatistics.AllocatedBytes;
+			statistics.PaddingBytes += archetypeStatistics.EntitiesCount * archetypeStatistics.PaddingPerEntity;
+
+			capacity += archetypeStatistics.ChunksCount * archetypeStatistics.EntitiesPerChunk;
 		}
 
-		return m_EntityRecords[storage.GetEntityIndices()[0]].Id;
+		if (capacity > 0)
+			statistics.FillRatio = (float)statistics.EntitiesCount / (float)capacity;
+
+		statistics.ChunksPool = EntityChunksPool::GetInstance()->GetStatistics();
+		return statistics;
 	}
 
 	EntitiesIterator Entities::begin()
@@ -738,6 +881,37 @@ namespace Grapple
 		}
 	}
 
+	ArchetypeId Entities::FindOrCreateArchetype(const ComponentSet& components)
+	{
+		auto it = m_Archetypes.ComponentSetToArchetype.find(components);
+		if (it != m_Archetypes.ComponentSetToArchetype.end())
+			return it->second;
+
+		ArchetypeId newArchetypeId = m_Archetypes.CreateArchetype(Span<const ComponentId>(components.GetIds(), components.GetCount()));
+
+		GetEntityStorage(newArchetypeId).SetEntitySize(m_Archetypes[newArchetypeId].EntitySize);
+		m_Queries.OnArchetypeCreated(newArchetypeId);
+		return newArchetypeId;
+	}
+
+	void Entities::RestoreEntityRecords(std::vector<EntityRecord>&& records, EntityIndex&& entityIndex)
+	{
+		Grapple_PROFILE_FUNCTION();
+		Grapple_CORE_ASSERT(m_EntityRecords.empty(), "Entity records can only be restored into empty Entities");
+
+		m_EntityRecords = std::move(records);
+		m_EntityIndex = std::move(entityIndex);
+
+		m_EntityToRecord.reserve(m_EntityRecords.size());
+		for (const EntityRecord& record : m_EntityRecords)
+		{
+			Grapple_CORE_ASSERT(record.RegistryIndex < m_EntityRecords.size());
+			m_EntityToRecord.emplace(record.Id, record.RegistryIndex);
+		}
+
+		m_Singletons.Clear();
+	}
+
 	void Entities::CreateEntity(const ComponentSet& components, EntityCreationResult& result)
 	{
 		Grapple_PROFILE_FUNCTION();
@@ -746,21 +920,12 @@ namespace Grapple
 		record.RegistryIndex = (uint32_t)registryIndex;
 		record.Id = m_EntityIndex.CreateId();
 
-		auto it = m_Archetypes.ComponentSetToArchetype.find(components);
-		if (it != m_Archetypes.ComponentSetToArchetype.end())
-			record.Archetype = it->second;
-		else
-		{
-			ArchetypeId newArchetypeId = m_Archetypes.CreateArchetype(Span<const ComponentId>(components.GetIds(), components.GetCount()));
-			record.Archetype = newArchetypeId;
-
-			GetEntityStorage(newArchetypeId).SetEntitySize(m_Archetypes[newArchetypeId].EntitySize);
-			m_Queries.OnArchetypeCreated(newArchetypeId);
-		}
+		record.Archetype = FindOrCreateArchetype(components);
 
 		ArchetypeRecord& archetypeRecord = m_Archetypes.Records[record.Archetype];
 		EntityStorage& storage = GetEntityStorage(record.Archetype);
 		record.BufferIndex = storage.AddEntity(record.RegistryIndex);
+		m_Singletons.OnArchetypeChanged(record.Archetype);
 
 		m_EntityToRecord.emplace(record.Id, record.RegistryIndex);
 
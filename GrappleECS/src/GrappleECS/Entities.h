@@ -11,8 +11,10 @@
 #include "GrappleECS/Entity/Archetype.h"
 #include "GrappleECS/Entity/Archetypes.h"
 #include "GrappleECS/Entity/EntityIndex.h"
+#include "GrappleECS/Entity/SingletonsRegistry.h"
 
 #include "GrappleECS/EntityStorage/EntityStorage.h"
+#include "GrappleECS/EntityStorage/EntityChunksPool.h"
 #include "GrappleECS/EntityStorage/DeletedEntitiesStorage.h"
 
 #include "GrappleECS/Query/QueryCache.h"
@@ -34,6 +36,40 @@ namespace Grapple
 		DefaultConstructor,
 	};
 
+	struct ArchetypeMemoryStatistics
+	{
+		size_t EntitiesCount = 0;
+		size_t ChunksCount = 0;
+		size_t EntitiesPerChunk = 0;
+
+		size_t EntitySize = 0;
+		// Bytes per entity, which are not occupied by components, because of alignment in `ComponentOffsets`
+		size_t PaddingPerEntity = 0;
+		// Bytes at the end of each chunk, which can't fit another entity
+		size_t ChunkTailSize = 0;
+
+		size_t UsedBytes = 0;
+		size_t AllocatedBytes = 0;
+
+		// Ratio of stored entities to the number of entities that fit into allocated chunks
+		float FillRatio = 0.0f;
+	};
+
+	struct EntitiesMemoryStatistics
+	{
+		size_t ArchetypesCount = 0;
+		size_t EntitiesCount = 0;
+		size_t ChunksCount = 0;
+
+		size_t UsedBytes = 0;
+		size_t AllocatedBytes = 0;
+		size_t PaddingBytes = 0;
+
+		float FillRatio = 0.0f;
+
+		EntityChunksPoolStatistics ChunksPool;
+	};
+
 	class GrappleECS_API Entities
 	{
 	public:
@@ -45,6 +81,19 @@ namespace Grapple
 		~Entities();
 
 		void Clear();
+
+		// Replaces all entities with copies of the entities from `other`, preserving their ids.
+		// Both must share the same Archetypes and Components registry.
+		void CloneFrom(const Entities& other);
+
+		// Components must be sorted by [ComponentId]
+		ArchetypeId FindOrCreateArchetype(const ComponentSet& components);
+
+		// Used for restoring a world from a snapshot, after the entity storages were filled directly.
+		// Each record's RegistryIndex must match its position and the index stored in its entity storage
+		void RestoreEntityRecords(std::vector<EntityRecord>&& records, EntityIndex&& entityIndex);
+
+		inline const EntityIndex& GetEntityIndex() const { return m_EntityIndex; }
 	public:
 		// Entity operations
 
@@ -100,10 +149,19 @@ namespace Grapple
 		void* GetSingletonComponent(ComponentId id) const;
 		std::optional<Entity> GetSingletonEntity(const Query& query) const;
 
+		// Returns the first entity matched by the query.
+		// The result is cached until one of the matched archetypes is structurally changed
+		const CachedQueryEntity& GetFirstEntity(const Query& query) const;
+
 		// Archetypes
 
 		inline const Archetypes& GetArchetypes() const { return m_Archetypes; }
 		inline const Components& GetComponents() const { return m_Components; }
+
+		// Statistics
+
+		ArchetypeMemoryStatistics GetArchetypeMemoryStatistics(ArchetypeId archetype) const;
+		EntitiesMemoryStatistics GetMemoryStatistics() const;
 		
 		// Iterator
 
@@ -151,6 +209,8 @@ namespace Grapple
 
 		EntityIndex m_EntityIndex;
 
+		mutable SingletonsRegistry m_Singletons;
+
 		friend class EntitiesIterator;
 		friend class QueryCache;
 	};
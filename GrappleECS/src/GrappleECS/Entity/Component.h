@@ -5,7 +5,6 @@
 
 #include <string>
 #include <vector>
-#include <xhash>
 #include <functional>
 
 namespace Grapple
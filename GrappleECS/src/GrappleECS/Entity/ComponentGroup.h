@@ -35,12 +35,7 @@ namespace Grapple
 		FilteredComponentsGroup()
 		{
 			size_t index = 0;
-
-			([&]
-			{
-				T filter;
-				m_Components[index++] = filter.Component;
-			} (), ...);
+			((m_Components[index++] = T().Component), ...);
 		}
 	public:
 		constexpr const ComponentsArray& GetComponents() const { return m_Components; }
@@ -6,7 +6,7 @@
 #include "GrappleCore/Serialization/TypeSerializer.h"
 
 #include <stdint.h>
-#include <xhash>
+#include <functional>
 
 namespace Grapple
 {
@@ -16,11 +16,11 @@ namespace Grapple
 		Grapple_TYPE;
 
 		constexpr Entity()
-			: m_Packed(SIZE_MAX) {}
+			: m_Index(UINT32_MAX), m_Generation(UINT16_MAX) {}
 		constexpr Entity(uint32_t id)
-			: m_Packed(0), m_Index(id), m_Generation(0) {}
+			: m_Index(id), m_Generation(0) {}
 		constexpr Entity(uint32_t id, uint16_t generation)
-			: m_Packed(0), m_Index(id), m_Generation(generation) {}
+			: m_Index(id), m_Generation(generation) {}
 
 		constexpr uint32_t GetIndex() const { return m_Index; }
 		constexpr uint16_t GetGeneration() const { return m_Generation; }
@@ -20,6 +20,6 @@ namespace Grapple
 
 	void EntityIndex::AddDeletedId(Entity entity)
 	{
-		m_DeletedIds.emplace_back(entity.GetIndex(), entity.GetGeneration() + 1ui16);
+		m_DeletedIds.emplace_back(entity.GetIndex(), (uint16_t)(entity.GetGeneration() + 1));
 	}
 }
\ No newline at end of file
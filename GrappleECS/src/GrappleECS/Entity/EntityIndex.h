@@ -11,11 +11,16 @@ namespace Grapple
 	{
 	public:
 		EntityIndex(size_t reservedStackSize = 64);
+		EntityIndex(uint32_t nextIndex, std::vector<Entity>&& deletedIds)
+			: m_EntityNextIndex(nextIndex), m_DeletedIds(std::move(deletedIds)) {}
 	public:
 		Entity CreateId();
 
 		// Inserts an id into stack and increaments its generation count
 		void AddDeletedId(Entity entity);
+
+		inline uint32_t GetNextIndex() const { return m_EntityNextIndex; }
+		inline const std::vector<Entity>& GetDeletedIds() const { return m_DeletedIds; }
 	private:
 		uint32_t m_EntityNextIndex = 0;
 		std::vector<Entity> m_DeletedIds;
@@ -0,0 +1,80 @@
+#include "SingletonsRegistry.h"
+
+#include "GrappleCore/Profiler/Profiler.h"
+
+#include "GrappleECS/Entity/Archetypes.h"
+#include "GrappleECS/Query/QueryCache.h"
+
+namespace Grapple
+{
+	void SingletonsRegistry::CacheComponent(ComponentId id, void* data)
+	{
+		Grapple_CORE_ASSERT(data);
+
+		uint32_t index = id.GetIndex() & ComponentId::INDEX_MASK;
+		if (index >= (uint32_t)m_Components.size())
+			m_Components.resize((size_t)index + 1, nullptr);
+
+		if (m_Components[index] == nullptr)
+			m_CachedComponentsCount++;
+
+		m_Components[index] = data;
+	}
+
+	const CachedQueryEntity& SingletonsRegistry::CacheQueryEntity(QueryId id, const CachedQueryEntity& entity)
+	{
+		if (id >= m_QueryEntities.size())
+			m_QueryEntities.resize(id + 1);
+
+		CachedQueryEntity& cachedEntity = m_QueryEntities[id];
+		if (!cachedEntity.IsValid)
+			m_CachedQueries.push_back(id);
+
+		cachedEntity = entity;
+		cachedEntity.IsValid = true;
+		return cachedEntity;
+	}
+
+	void SingletonsRegistry::OnArchetypeChanged(ArchetypeId archetype)
+	{
+		if (m_CachedComponentsCount > 0)
+		{
+			for (ComponentId component : m_Archetypes[archetype].Components)
+			{
+				uint32_t index = component.GetIndex() & ComponentId::INDEX_MASK;
+				if (index < (uint32_t)m_Components.size() && m_Components[index] != nullptr)
+				{
+					m_Components[index] = nullptr;
+					m_CachedComponentsCount--;
+				}
+			}
+		}
+
+		for (size_t i = 0; i < m_CachedQueries.size();)
+		{
+			QueryId query = m_CachedQueries[i];
+			const auto& matchedArchetypes = m_Queries[query].MatchedArchetypes;
+
+			if (matchedArchetypes.find(archetype) == matchedArchetypes.end())
+			{
+				i++;
+				continue;
+			}
+
+			m_QueryEntities[query].IsValid = false;
+
+			m_CachedQueries[i] = m_CachedQueries.back();
+			m_CachedQueries.pop_back();
+		}
+	}
+
+	void SingletonsRegistry::Clear()
+	{
+		Grapple_PROFILE_FUNCTION();
+		m_Components.clear();
+		m_CachedComponentsCount = 0;
+
+		m_QueryEntities.clear();
+		m_CachedQueries.clear();
+	}
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "GrappleCore/Core.h"
+
+#include "GrappleECS/Entity/Entity.h"
+#include "GrappleECS/Entity/Component.h"
+#include "GrappleECS/Entity/Archetype.h"
+
+#include "GrappleECS/Query/QueryData.h"
+
+#include <vector>
+
+namespace Grapple
+{
+	struct Archetypes;
+	class QueryCache;
+
+	struct CachedQueryEntity
+	{
+		Entity Id;
+		ArchetypeId Archetype = INVALID_ARCHETYPE_ID;
+		uint8_t* Data = nullptr;
+
+		// Total number of entities matched by the query
+		size_t EntitiesCount = 0;
+		bool IsValid = false;
+	};
+
+	// Caches locations of singleton components and of the first entities matched by queries.
+	//
+	// An entry stays valid until an entity is added to or removed from an archetype,
+	// which contains the cached component or is matched by the cached query.
+	class GrappleECS_API SingletonsRegistry
+	{
+	public:
+		SingletonsRegistry(const Archetypes& archetypes, const QueryCache& queries)
+			: m_Archetypes(archetypes), m_Queries(queries) {}
+
+		SingletonsRegistry(const SingletonsRegistry&) = delete;
+		SingletonsRegistry& operator=(const SingletonsRegistry&) = delete;
+
+		inline void* FindComponent(ComponentId id) const
+		{
+			uint32_t index = id.GetIndex() & ComponentId::INDEX_MASK;
+			if (index < (uint32_t)m_Components.size())
+				return m_Components[index];
+			return nullptr;
+		}
+
+		inline const CachedQueryEntity* FindQueryEntity(QueryId id) const
+		{
+			if (id < m_QueryEntities.size() && m_QueryEntities[id].IsValid)
+				return &m_QueryEntities[id];
+			return nullptr;
+		}
+
+		void CacheComponent(ComponentId id, void* data);
+		const CachedQueryEntity& CacheQueryEntity(QueryId id, const CachedQueryEntity& entity);
+
+		// Must be called every time an entity is added to or removed from the archetype
+		void OnArchetypeChanged(ArchetypeId archetype);
+
+		void Clear();
+	private:
+		const Archetypes& m_Archetypes;
+		const QueryCache& m_Queries;
+
+		// Indexed by component index
+		std::vector<void*> m_Components;
+		size_t m_CachedComponentsCount = 0;
+
+		// Indexed by QueryId
+		std::vector<CachedQueryEntity> m_QueryEntities;
+		std::vector<QueryId> m_CachedQueries;
+	};
+}
@@ -19,11 +19,15 @@ namespace Grapple
 		Grapple_PROFILE_FUNCTION();
 		if (m_Count == 0)
 		{
+			m_MissesCount++;
+
 			EntityStorageChunk chunk = EntityStorageChunk();
 			chunk.Allocate();
 			return chunk;
 		}
 
+		m_HitsCount++;
+
 		EntityStorageChunk chunk = m_Chunks[m_Count - 1];
 		m_Count--;
 		return chunk;
@@ -34,6 +38,7 @@ namespace Grapple
 		Grapple_PROFILE_FUNCTION();
 		if (m_Count == m_Capacity)
 		{
+			m_ReleasedCount++;
 			chunk.~EntityStorageChunk();
 			return;
 		}
@@ -41,6 +46,17 @@ namespace Grapple
 		m_Chunks[m_Count++] = chunk;
 	}
 
+	EntityChunksPoolStatistics EntityChunksPool::GetStatistics() const
+	{
+		EntityChunksPoolStatistics statistics;
+		statistics.PooledChunks = m_Count;
+		statistics.Capacity = m_Capacity;
+		statistics.Hits = m_HitsCount;
+		statistics.Misses = m_MissesCount;
+		statistics.Released = m_ReleasedCount;
+		return statistics;
+	}
+
 	void EntityChunksPool::Initialize(size_t capacity)
 	{
 		Grapple_PROFILE_FUNCTION();
@@ -6,6 +6,19 @@
 
 namespace Grapple
 {
+	struct EntityChunksPoolStatistics
+	{
+		size_t PooledChunks = 0;
+		size_t Capacity = 0;
+
+		// Number of chunks taken from the pool
+		size_t Hits = 0;
+		// Number of chunks allocated, because the pool was empty
+		size_t Misses = 0;
+		// Number of chunks freed, because the pool was full
+		size_t Released = 0;
+	};
+
 	class EntityChunksPool
 	{
 	public:
@@ -16,6 +29,8 @@ namespace Grapple
 
 		inline size_t GetCount() const { return m_Count; }
 		inline size_t GetCapacity() const { return m_Capacity; }
+
+		EntityChunksPoolStatistics GetStatistics() const;
 	public:
 		static void Initialize(size_t capacity);
 		static Scope<EntityChunksPool>& GetInstance();
@@ -23,6 +38,10 @@ namespace Grapple
 		size_t m_Capacity;
 		size_t m_Count;
 
+		size_t m_HitsCount = 0;
+		size_t m_MissesCount = 0;
+		size_t m_ReleasedCount = 0;
+
 		EntityStorageChunk* m_Chunks;
 	private:
 		static Scope<EntityChunksPool> s_Instance;
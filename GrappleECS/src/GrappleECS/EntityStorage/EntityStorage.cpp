@@ -2,10 +2,14 @@
 
 #include "GrappleECS/EntityStorage/EntityChunksPool.h"
 
+#include <atomic>
+#include <algorithm>
 #include <cmath>
 
 namespace Grapple
 {
+	static std::atomic<uint64_t> s_ChangeVersion = 1;
+
 	EntityDataStorage::EntityDataStorage()
 		: EntitySize(0), EntitiesCount(0), EntitiesPerChunk(0) {}
 	
@@ -43,6 +47,21 @@ namespace Grapple
 		return EntitiesCount - 1;
 	}
 
+	size_t EntityDataStorage::AddEntities(size_t count)
+	{
+		Grapple_CORE_ASSERT(EntitySize > 0, "Entity has no size");
+
+		size_t firstIndex = EntitiesCount;
+		size_t requiredChunks = (EntitiesCount + count + EntitiesPerChunk - 1) / EntitiesPerChunk;
+
+		Chunks.reserve(requiredChunks);
+		while (Chunks.size() < requiredChunks)
+			Chunks.push_back(EntityChunksPool::GetInstance()->GetOrCreate());
+
+		EntitiesCount += count;
+		return firstIndex;
+	}
+
 	uint8_t* EntityDataStorage::GetEntityData(size_t index) const
 	{
 		size_t bytesOffset = (index % EntitiesPerChunk * EntitySize);
@@ -80,10 +99,26 @@ namespace Grapple
 	{
 		Grapple_CORE_ASSERT(index < Chunks.size());
 		if (index == Chunks.size() - 1)
-			return EntitiesCount % EntitiesPerChunk;
+			return EntitiesCount - index * EntitiesPerChunk;
 		return EntitiesPerChunk;
 	}
 
+	void EntityDataStorage::CopyFrom(const EntityDataStorage& other)
+	{
+		Clear();
+
+		EntitySize = other.EntitySize;
+		EntitiesPerChunk = other.EntitiesPerChunk;
+		EntitiesCount = other.EntitiesCount;
+
+		Chunks.reserve(other.Chunks.size());
+		for (size_t i = 0; i < other.Chunks.size(); i++)
+		{
+			EntityStorageChunk& chunk = Chunks.emplace_back(EntityChunksPool::GetInstance()->GetOrCreate());
+			std::memcpy(chunk.GetBuffer(), other.Chunks[i].GetBuffer(), other.GetEntitiesCountInChunk(i) * EntitySize);
+		}
+	}
+
 	void EntityDataStorage::Clear()
 	{
 		EntitiesCount = 0;
@@ -98,12 +133,13 @@ namespace Grapple
 	EntityStorage::EntityStorage() {}
 
 	EntityStorage::EntityStorage(EntityStorage&& other) noexcept
-		: m_EntityIndices(std::move(other.m_EntityIndices)), m_DataStorage(std::move(other.m_DataStorage)) {}
+		: m_EntityIndices(std::move(other.m_EntityIndices)), m_DataStorage(std::move(other.m_DataStorage)), m_ChunkVersions(std::move(other.m_ChunkVersions)) {}
 
 	EntityStorage& EntityStorage::operator=(EntityStorage&& other) noexcept
 	{
 		m_EntityIndices = std::move(other.m_EntityIndices);
 		m_DataStorage = std::move(other.m_DataStorage);
+		m_ChunkVersions = std::move(other.m_ChunkVersions);
 		
 		return *this;
 	}
@@ -112,9 +148,24 @@ namespace Grapple
 	{
 		size_t index = m_DataStorage.AddEntity();
 		m_EntityIndices.push_back(registryIndex);
+
+		UpdateChunkVersions();
+		MarkEntityChanged(index);
 		return index;
 	}
 
+	size_t EntityStorage::AddEntities(const uint32_t* registryIndices, size_t count)
+	{
+		size_t firstIndex = m_DataStorage.AddEntities(count);
+		m_EntityIndices.insert(m_EntityIndices.end(), registryIndices, registryIndices + count);
+
+		UpdateChunkVersions();
+		for (size_t chunkIndex = firstIndex / m_DataStorage.EntitiesPerChunk; chunkIndex < m_ChunkVersions.size(); chunkIndex++)
+			MarkChunkChanged(chunkIndex);
+
+		return firstIndex;
+	}
+
 	uint8_t* EntityStorage::GetEntityData(size_t entityIndex) const
 	{
 		return m_DataStorage.GetEntityData(entityIndex);
@@ -129,7 +180,15 @@ namespace Grapple
 		m_EntityIndices[entityIndex] = lastEntityIndex;
 		m_EntityIndices.erase(m_EntityIndices.end() - 1);
 
+		// The last entity is moved into place of the removed one, so both chunks are changed
+		size_t lastChunkIndex = (m_DataStorage.EntitiesCount - 1) / m_DataStorage.EntitiesPerChunk;
 		m_DataStorage.RemoveEntityData(entityIndex);
+
+		UpdateChunkVersions();
+		if (lastChunkIndex < m_ChunkVersions.size())
+			MarkChunkChanged(lastChunkIndex);
+		if (entityIndex < m_DataStorage.EntitiesCount)
+			MarkEntityChanged(entityIndex);
 	}
 
 	void EntityStorage::SetEntitySize(size_t entitySize)
@@ -141,6 +200,16 @@ namespace Grapple
 	{
 		Grapple_CORE_ASSERT(entityIndex < m_EntityIndices.size());
 		m_EntityIndices[entityIndex] = newRegistryIndex;
+		MarkEntityChanged(entityIndex);
+	}
+
+	void EntityStorage::CopyFrom(const EntityStorage& other)
+	{
+		m_DataStorage.CopyFrom(other.m_DataStorage);
+		m_EntityIndices = other.m_EntityIndices;
+
+		UpdateChunkVersions();
+		MarkChanged();
 	}
 
 	uint8_t* EntityStorage::GetChunkBuffer(size_t index)
@@ -154,4 +223,30 @@ namespace Grapple
 		Grapple_CORE_ASSERT(index < m_DataStorage.Chunks.size());
 		return m_DataStorage.Chunks[index].GetBuffer();
 	}
+
+	void EntityStorage::MarkChunkChanged(size_t index)
+	{
+		Grapple_CORE_ASSERT(index < m_ChunkVersions.size());
+		m_ChunkVersions[index] = s_ChangeVersion.load(std::memory_order_relaxed);
+	}
+
+	void EntityStorage::MarkEntityChanged(size_t entityIndex)
+	{
+		MarkChunkChanged(entityIndex / m_DataStorage.EntitiesPerChunk);
+	}
+
+	void EntityStorage::MarkChanged()
+	{
+		std::fill(m_ChunkVersions.begin(), m_ChunkVersions.end(), s_ChangeVersion.load(std::memory_order_relaxed));
+	}
+
+	uint64_t EntityStorage::AdvanceChangeVersion()
+	{
+		return s_ChangeVersion.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void EntityStorage::UpdateChunkVersions()
+	{
+		m_ChunkVersions.resize(m_DataStorage.Chunks.size(), s_ChangeVersion.load(std::memory_order_relaxed));
+	}
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "GrappleECS/EntityStorage/EntityStorageChunk.h"
 
 #include <stdint.h>
+#include <vector>
 
 namespace Grapple	
 {
@@ -19,12 +20,19 @@ namespace Grapple
 		EntityDataStorage& operator=(EntityDataStorage&& other) noexcept;
 
 		size_t AddEntity();
+
+		// Adds `count` uninitialized entities, returns the index of the first one
+		size_t AddEntities(size_t count);
 		uint8_t* GetEntityData(size_t index) const;
 		void RemoveEntityData(size_t index);
 
 		void SetEntitySize(size_t entitySize);
 		size_t GetEntitiesCountInChunk(size_t index) const;
 
+		// Copies the contents of the storage byte by byte.
+		// Components which are not trivially copyable must be copied by the caller afterwards
+		void CopyFrom(const EntityDataStorage& other);
+
 		void Clear();
 
 		std::vector<EntityStorageChunk> Chunks;
@@ -45,6 +53,7 @@ namespace Grapple
 		EntityStorage& operator=(EntityStorage&& other) noexcept;
 		
 		size_t AddEntity(uint32_t registryIndex);
+		size_t AddEntities(const uint32_t* registryIndices, size_t count);
 		uint8_t* GetEntityData(size_t entityIndex) const;
 
 		void RemoveEntityData(size_t entityIndex);
@@ -57,6 +66,8 @@ namespace Grapple
 		void SetEntitySize(size_t entitySize);
 		void UpdateEntityRegistryIndex(size_t entityIndex, uint32_t newRegistryIndex);
 
+		void CopyFrom(const EntityStorage& other);
+
 		inline size_t GetChunksCount() const { return m_DataStorage.Chunks.size(); }
 		inline size_t GetEntitiesPerChunkCount() const { return m_DataStorage.EntitiesPerChunk; }
 
@@ -66,8 +77,27 @@ namespace Grapple
 		const uint8_t* GetChunkBuffer(size_t index) const;
 
 		inline const std::vector<uint32_t>& GetEntityIndices() const { return m_EntityIndices; }
+
+		// Chunks are marked with the current change version when entities are added to or removed from them,
+		// and when their components are accessed for writing
+		inline uint64_t GetChunkVersion(size_t index) const
+		{
+			Grapple_CORE_ASSERT(index < m_ChunkVersions.size());
+			return m_ChunkVersions[index];
+		}
+
+		void MarkChunkChanged(size_t index);
+		void MarkEntityChanged(size_t entityIndex);
+		void MarkChanged();
+
+		// Returns the current change version and advances it,
+		// so that chunks changed after the call have a greater version than the returned one
+		static uint64_t AdvanceChangeVersion();
+	private:
+		void UpdateChunkVersions();
 	private:
 		EntityDataStorage m_DataStorage;
 		std::vector<uint32_t> m_EntityIndices;
+		std::vector<uint64_t> m_ChunkVersions;
 	};
 }
\ No newline at end of file
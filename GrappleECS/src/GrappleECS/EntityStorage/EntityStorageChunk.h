@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <stddef.h>
 
 namespace Grapple
 {
@@ -47,6 +48,16 @@ namespace Grapple
 			other.m_Buffer = nullptr;
 		}
 
+		EntityStorageChunk& operator=(EntityStorageChunk&& other) noexcept
+		{
+			if (m_Buffer != nullptr)
+				delete[] m_Buffer;
+
+			m_Buffer = other.m_Buffer;
+			other.m_Buffer = nullptr;
+			return *this;
+		}
+
 		void Allocate()
 		{
 			if (m_Buffer == nullptr)
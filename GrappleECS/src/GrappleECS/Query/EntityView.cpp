@@ -63,4 +63,10 @@ namespace Grapple
 	{
 		return m_Archetype;
 	}
+
+	void EntityView::MarkChanged()
+	{
+		if (m_QueryTarget == QueryTarget::AllEntities)
+			m_Entities.GetEntityStorage(m_Archetype).MarkChanged();
+	}
 }
\ No newline at end of file
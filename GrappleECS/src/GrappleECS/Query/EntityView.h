@@ -32,6 +32,9 @@ namespace Grapple
 
 			Grapple_CORE_ASSERT(index.has_value(), "Archetype doesn't have a component");
 
+			if constexpr (!std::is_const_v<ComponentT>)
+				MarkChanged();
+
 			return ComponentView<ComponentT>(archetypeRecord.ComponentOffsets[index.value()]);
 		}
 
@@ -42,9 +45,18 @@ namespace Grapple
 			std::optional<size_t> index = archetypeRecord.TryGetComponentIndex(COMPONENT_ID(T));
 
 			if (index.has_value())
+			{
+				if constexpr (!std::is_const_v<T>)
+					MarkChanged();
+
 				return OptionalComponentView<T>(archetypeRecord.ComponentOffsets[index.value()]);
+			}
+
 			return OptionalComponentView<T>();
 		}
+	private:
+		// Components can be written through views of non-const components, so the chunks are marked as changed
+		void MarkChanged();
 	private:
 		QueryTarget m_QueryTarget;
 		Entities& m_Entities;
@@ -21,20 +21,11 @@ namespace Grapple
 
 	std::optional<Entity> Query::TryGetFirstEntityId() const
 	{
-		for (ArchetypeId archetype : GetMatchingArchetypes())
-		{
-			const EntityStorage& storage = m_Entities->GetEntityStorage(archetype);
-			if (storage.GetEntitiesCount() == 0)
-				continue;
-
-			uint32_t firstEntityIndex = storage.GetEntityIndices()[0];
-			std::optional<Entity> entity = m_Entities->FindEntityByIndex(firstEntityIndex);
+		const CachedQueryEntity& entity = m_Entities->GetFirstEntity(*this);
+		if (entity.EntitiesCount == 0)
+			return {};
 
-			Grapple_CORE_ASSERT(entity);
-			return *entity;
-		}
-
-		return {};
+		return entity.Id;
 	}
 
 	size_t Query::GetEntitiesCount() const
@@ -114,6 +114,8 @@ namespace Grapple
 	template<typename T>
 	struct QueryIterationHelper
 	{
+		static constexpr bool HasMutableComponents = false;
+
 		static std::tuple<QueryChunk> Get(QueryChunk chunk, const size_t* componentOffset)
 		{
 			return std::make_tuple(chunk);
@@ -128,6 +130,8 @@ namespace Grapple
 	template<typename FirstArg, typename... Args>
 	struct QueryIterationHelper<ArgumentsList<FirstArg, Args...>>
 	{
+		static constexpr bool HasMutableComponents = (!std::is_const_v<std::remove_reference_t<typename ComponentViewUnderlyingType<Args>::Type>> || ...);
+
 		static std::tuple<QueryChunk, Args...> Get(QueryChunk chunk, const size_t* componentOffsets)
 		{
 			size_t componentIndex = 0;
@@ -175,6 +179,23 @@ namespace Grapple
 		virtual std::optional<Entity> TryGetFirstEntityId() const override;
 		virtual size_t GetEntitiesCount() const override;
 
+		// Returns a component of the first entity matched by the query,
+		// or nullptr if there are no matched entities or the entity doesn't have the component.
+		template<typename T>
+		T* TryGetFirstEntityComponent() const
+		{
+			const CachedQueryEntity& entity = m_Entities->GetFirstEntity(*this);
+			if (entity.Data == nullptr)
+				return nullptr;
+
+			const ArchetypeRecord& archetype = m_Entities->GetArchetypes()[entity.Archetype];
+			std::optional<size_t> componentIndex = archetype.TryGetComponentIndex(COMPONENT_ID(T));
+			if (!componentIndex)
+				return nullptr;
+
+			return (T*)(entity.Data + archetype.ComponentOffsets[*componentIndex]);
+		}
+
 		template<typename IteratorFunction>
 		inline void ForEachChunk(const IteratorFunction& function)
 		{
@@ -183,7 +204,7 @@ namespace Grapple
 
 			using IteratorArguments = typename IteratorTraits::Arguments;
 			using IterationHelper = QueryIterationHelper<IteratorArguments>;
-			using FirstArg = FirstArgument<IteratorArguments>::Type;
+			using FirstArg = typename FirstArgument<IteratorArguments>::Type;
 
 			using FirstArgType = std::remove_const_t<std::remove_reference_t<FirstArg>>;
 
@@ -200,6 +221,9 @@ namespace Grapple
 				IterationHelper::FillComponentOffsets(componentOffsets, archetype, archetypes);
 				for (size_t chunkIndex = 0; chunkIndex < storage.GetChunksCount(); chunkIndex++)
 				{
+					if constexpr (IterationHelper::HasMutableComponents)
+						storage.MarkChunkChanged(chunkIndex);
+
 					uint8_t* entityData = storage.GetChunkBuffer(chunkIndex);
 					auto arguments = IterationHelper::Get(
 						QueryChunk(entityData, storage.GetEntitiesCountInChunk(chunkIndex), storage.GetEntitySize()),
@@ -132,7 +132,11 @@ namespace Grapple
 				else if (i == archetypeComponents.size() - 1)
 					queryComponentIndex++;
 				else
+				{
+					// The excluded component can still be further in the archetype
+					++i;
 					continue;
+				}
 			}
 
 			if (match)
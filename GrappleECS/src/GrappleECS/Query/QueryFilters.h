@@ -10,6 +10,6 @@ namespace Grapple
 	enum class QueryFilterType : uint32_t
 	{
 		With = 0,
-		Without = 1ui32 << 31ui32,
+		Without = 1u << 31u,
 	};
 }
\ No newline at end of file
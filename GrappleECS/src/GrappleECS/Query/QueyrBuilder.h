@@ -18,33 +18,33 @@ namespace Grapple
 			m_Data.Target = target;
 		}
 
-		template<typename... T>
+		template<typename... ComponentsT>
 		QueryBuilder& With()
 		{
-			size_t count = sizeof...(T);
+			size_t count = sizeof...(ComponentsT);
 			m_Data.Components.reserve(m_Data.Components.size() + count);
 
 			size_t index = 0;
 
 			([&]
 			{
-				m_Data.Components.push_back(COMPONENT_ID(T));
+				m_Data.Components.push_back(COMPONENT_ID(ComponentsT));
 			} (), ...);
 
 			return *this;
 		}
 
-		template<typename... T>
+		template<typename... ComponentsT>
 		QueryBuilder& Without()
 		{
-			size_t count = sizeof...(T);
+			size_t count = sizeof...(ComponentsT);
 			m_Data.Components.reserve(m_Data.Components.size() + count);
 
 			size_t index = 0;
 
 			([&]
 			{
-				ComponentId id = COMPONENT_ID(T);
+				ComponentId id = COMPONENT_ID(ComponentsT);
 				m_Data.Components.push_back(ComponentId(
 					id.GetIndex() | (uint32_t)QueryFilterType::Without, 
 					id.GetGeneration()));
@@ -53,10 +53,8 @@ namespace Grapple
 			return *this;
 		}
 
-		T Build()
-		{
-			static_assert(false);
-		}
+		// Only implemented for `Query` and `CreatedEntitiesQuery`
+		T Build();
 	private:
 		Entities& m_Entities;
 		QueryCache& m_Queries;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "GrappleCore/Assert.h"
+
 #include "GrappleECS/System/SystemData.h"
 
 namespace Grapple
@@ -59,6 +59,8 @@ namespace Grapple
 		std::vector<SystemGroup>& GetGroups();
 
 		const std::vector<SystemData>& GetSystems() const;
+
+		inline const EntitiesCommandBuffer& GetCommandBuffer() const { return m_CommandBuffer; }
 	private:
 		SystemId AddSystem(std::string_view name, System* systemInstance);
 		void ConfigureSystem(SystemId id);
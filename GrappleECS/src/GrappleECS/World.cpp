@@ -27,6 +27,34 @@ namespace Grapple
 		s_CurrentWorld = this;
 	}
 
+	void World::CloneFrom(const World& other)
+	{
+		Grapple_PROFILE_FUNCTION();
+		Entities.CloneFrom(other.Entities);
+	}
+
+	void World::PlotMemoryStatistics() const
+	{
+#ifdef Grapple_PROFILING_ENABLED
+		Grapple_PROFILE_FUNCTION();
+		EntitiesMemoryStatistics statistics = Entities.GetMemoryStatistics();
+		CommandsStorageStatistics commands = m_SystemsManager.GetCommandBuffer().GetStatistics();
+
+		Grapple_PROFILE_PLOT("ECS Entities", (int64_t)statistics.EntitiesCount);
+		Grapple_PROFILE_PLOT("ECS Chunks", (int64_t)statistics.ChunksCount);
+		Grapple_PROFILE_PLOT("ECS Allocated Bytes", (int64_t)statistics.AllocatedBytes);
+		Grapple_PROFILE_PLOT("ECS Used Bytes", (int64_t)statistics.UsedBytes);
+		Grapple_PROFILE_PLOT("ECS Fill Ratio", statistics.FillRatio);
+
+		Grapple_PROFILE_PLOT("ECS Chunks Pool Hits", (int64_t)statistics.ChunksPool.Hits);
+		Grapple_PROFILE_PLOT("ECS Chunks Pool Misses", (int64_t)statistics.ChunksPool.Misses);
+		Grapple_PROFILE_PLOT("ECS Chunks Pool Released", (int64_t)statistics.ChunksPool.Released);
+
+		Grapple_PROFILE_PLOT("ECS Commands High Water Mark", (int64_t)commands.HighWaterMark);
+		Grapple_PROFILE_PLOT("ECS Commands Capacity", (int64_t)commands.Capacity);
+#endif
+	}
+
 	void World::DeleteEntity(Entity entity)
 	{
 		Entities.DeleteEntity(entity);
@@ -29,6 +29,13 @@ namespace Grapple
 
 		void MakeCurrent();
 
+		// Copies all entities and their components from another world, which uses the same ECSContext.
+		// Queries and systems of this world are kept and stay valid, because archetypes are shared through the context.
+		void CloneFrom(const World& other);
+
+		// Reports entity storage and command buffer usage as profiler plots. Does nothing when profiling is disabled
+		void PlotMemoryStatistics() const;
+
 		template<typename... T>
 		constexpr Entity CreateEntity(ComponentInitializationStrategy initStrategy = ComponentInitializationStrategy::DefaultConstructor)
 		{
@@ -0,0 +1,54 @@
+local build_tool = require("BuildTool")
+
+project "GrappleECSBenchmarks"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++17"
+	staticruntime "off"
+
+	build_tool.add_module_ref("GrappleCore")
+	build_tool.add_module_ref("GrappleECS")
+
+	files
+	{
+		"src/**.h",
+		"src/**.cpp",
+	}
+
+	includedirs
+	{
+		"src/",
+		"%{wks.location}/GrappleCore/src/",
+		"%{wks.location}/GrappleECS/src/",
+
+		INCLUDE_DIRS.spdlog,
+		INCLUDE_DIRS.glm,
+		INCLUDE_DIRS.tracy,
+	}
+
+	links
+	{
+		"GrappleCore",
+		"GrappleECS",
+	}
+
+	targetdir("%{wks.location}/bin/" .. OUTPUT_DIRECTORY)
+	objdir("%{wks.location}/bin-int/" .. OUTPUT_DIRECTORY .. "/%{prj.name}")
+
+	filter "system:windows"
+		systemversion "latest"
+
+	filter "configurations:Debug"
+		defines "Grapple_DEBUG"
+		runtime "Debug"
+		symbols "on"
+
+	filter "configurations:Release"
+		defines { "Grapple_RELEASE", "TRACY_ENABLE", "TRACY_IMPORTS" }
+		runtime "Release"
+		optimize "on"
+
+	filter "configurations:Dist"
+		defines "Grapple_DIST"
+		runtime "Release"
+		optimize "on"
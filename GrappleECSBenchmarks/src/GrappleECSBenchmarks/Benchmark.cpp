@@ -0,0 +1,92 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace Grapple
+{
+	void BenchmarkRunner::Add(std::string_view name, std::function<void(BenchmarkState&)>&& run)
+	{
+		Benchmark& benchmark = m_Benchmarks.emplace_back();
+		benchmark.Name = name;
+		benchmark.Run = std::move(run);
+	}
+
+	void BenchmarkRunner::Run()
+	{
+		std::vector<double> durations;
+		durations.reserve(m_Settings.Iterations);
+
+		for (const Benchmark& benchmark : m_Benchmarks)
+		{
+			if (!m_Settings.Filter.empty() && benchmark.Name.find(m_Settings.Filter) == std::string::npos)
+				continue;
+
+			for (size_t i = 0; i < m_Settings.WarmupIterations; i++)
+			{
+				BenchmarkState state;
+				benchmark.Run(state);
+			}
+
+			durations.clear();
+
+			BenchmarkResult& result = m_Results.emplace_back();
+			result.Name = benchmark.Name;
+			result.Iterations = m_Settings.Iterations;
+
+			for (size_t i = 0; i < m_Settings.Iterations; i++)
+			{
+				BenchmarkState state;
+				benchmark.Run(state);
+
+				durations.push_back((double)state.GetDuration().count());
+				result.OperationsCount = state.GetOperationsCount();
+			}
+
+			if (durations.empty())
+				continue;
+
+			std::sort(durations.begin(), durations.end());
+
+			double total = 0.0;
+			for (double duration : durations)
+				total += duration;
+
+			result.MinNanoseconds = durations.front();
+			result.MaxNanoseconds = durations.back();
+			result.MedianNanoseconds = durations[durations.size() / 2];
+			result.MeanNanoseconds = total / (double)durations.size();
+
+			std::cerr << benchmark.Name << ": median " << result.MedianNanoseconds / 1000000.0 << " ms, "
+				<< result.MedianNanoseconds / (double)std::max<size_t>(result.OperationsCount, 1) << " ns/op\n";
+		}
+	}
+
+	void BenchmarkRunner::WriteJSON(std::ostream& output) const
+	{
+		output.precision(12);
+		output << "{\n";
+		output << "\t\"iterations\": " << m_Settings.Iterations << ",\n";
+		output << "\t\"benchmarks\": [\n";
+
+		for (size_t i = 0; i < m_Results.size(); i++)
+		{
+			const BenchmarkResult& result = m_Results[i];
+			double operationsCount = (double)std::max<size_t>(result.OperationsCount, 1);
+
+			output << "\t\t{\n";
+			output << "\t\t\t\"name\": \"" << result.Name << "\",\n";
+			output << "\t\t\t\"iterations\": " << result.Iterations << ",\n";
+			output << "\t\t\t\"operations\": " << result.OperationsCount << ",\n";
+			output << "\t\t\t\"min_ns\": " << result.MinNanoseconds << ",\n";
+			output << "\t\t\t\"median_ns\": " << result.MedianNanoseconds << ",\n";
+			output << "\t\t\t\"mean_ns\": " << result.MeanNanoseconds << ",\n";
+			output << "\t\t\t\"max_ns\": " << result.MaxNanoseconds << ",\n";
+			output << "\t\t\t\"median_ns_per_operation\": " << result.MedianNanoseconds / operationsCount << "\n";
+			output << "\t\t}" << (i + 1 < m_Results.size() ? "," : "") << "\n";
+		}
+
+		output << "\t]\n";
+		output << "}\n";
+	}
+}
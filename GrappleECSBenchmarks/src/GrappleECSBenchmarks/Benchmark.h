@@ -0,0 +1,84 @@
+#pragma once
+
+#include <stdint.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <functional>
+#include <filesystem>
+
+namespace Grapple
+{
+	class BenchmarkState
+	{
+	public:
+		// Only the code between Start() and Stop() is measured, everything else is considered a setup
+		inline void Start() { m_StartTime = std::chrono::high_resolution_clock::now(); }
+		inline void Stop() { m_Duration = std::chrono::high_resolution_clock::now() - m_StartTime; }
+
+		// Number of operations performed by a single run, used for calculating time per operation
+		inline void SetOperationsCount(size_t count) { m_OperationsCount = count; }
+
+		inline std::chrono::nanoseconds GetDuration() const { return m_Duration; }
+		inline size_t GetOperationsCount() const { return m_OperationsCount; }
+	private:
+		std::chrono::high_resolution_clock::time_point m_StartTime;
+		std::chrono::nanoseconds m_Duration = std::chrono::nanoseconds(0);
+		size_t m_OperationsCount = 1;
+	};
+
+	struct Benchmark
+	{
+		std::string Name;
+		std::function<void(BenchmarkState&)> Run;
+	};
+
+	struct BenchmarkResult
+	{
+		std::string Name;
+		size_t Iterations = 0;
+		size_t OperationsCount = 0;
+
+		double MinNanoseconds = 0.0;
+		double MedianNanoseconds = 0.0;
+		double MeanNanoseconds = 0.0;
+		double MaxNanoseconds = 0.0;
+	};
+
+	struct BenchmarkSettings
+	{
+		size_t Iterations = 10;
+		size_t WarmupIterations = 1;
+		std::string Filter;
+		std::filesystem::path OutputPath;
+	};
+
+	class BenchmarkRunner
+	{
+	public:
+		BenchmarkRunner(const BenchmarkSettings& settings)
+			: m_Settings(settings) {}
+
+		void Add(std::string_view name, std::function<void(BenchmarkState&)>&& run);
+		void Run();
+
+		void WriteJSON(std::ostream& output) const;
+		inline const std::vector<BenchmarkResult>& GetResults() const { return m_Results; }
+	private:
+		BenchmarkSettings m_Settings;
+		std::vector<Benchmark> m_Benchmarks;
+		std::vector<BenchmarkResult> m_Results;
+	};
+
+	// Prevents the compiler from optimizing away the computation of a value
+	template<typename T>
+	inline void DoNotOptimize(const T& value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "g"(&value) : "memory");
+#else
+		static const void* volatile s_Sink = nullptr;
+		s_Sink = &value;
+#endif
+	}
+}
@@ -0,0 +1,17 @@
+#include "BenchmarkComponents.h"
+
+namespace Grapple
+{
+	Grapple_IMPL_COMPONENT(Position);
+	Grapple_IMPL_COMPONENT(Velocity);
+	Grapple_IMPL_COMPONENT(Health);
+
+	Grapple_IMPL_COMPONENT(Tag0);
+	Grapple_IMPL_COMPONENT(Tag1);
+	Grapple_IMPL_COMPONENT(Tag2);
+	Grapple_IMPL_COMPONENT(Tag3);
+	Grapple_IMPL_COMPONENT(Tag4);
+	Grapple_IMPL_COMPONENT(Tag5);
+	Grapple_IMPL_COMPONENT(Tag6);
+	Grapple_IMPL_COMPONENT(Tag7);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "GrappleECS/Entity/ComponentInitializer.h"
+
+#include <glm/glm.hpp>
+
+namespace Grapple
+{
+	struct Position
+	{
+		Grapple_COMPONENT;
+		glm::vec3 Value = glm::vec3(0.0f);
+	};
+
+	struct Velocity
+	{
+		Grapple_COMPONENT;
+		glm::vec3 Value = glm::vec3(1.0f);
+	};
+
+	struct Health
+	{
+		Grapple_COMPONENT;
+		float Value = 100.0f;
+	};
+
+	// Tag components are used for generating a large number of archetypes
+#define BENCHMARK_TAG_COMPONENT(name) \
+	struct name                       \
+	{                                 \
+		Grapple_COMPONENT;            \
+		uint32_t Value = 0;           \
+	};
+
+	BENCHMARK_TAG_COMPONENT(Tag0);
+	BENCHMARK_TAG_COMPONENT(Tag1);
+	BENCHMARK_TAG_COMPONENT(Tag2);
+	BENCHMARK_TAG_COMPONENT(Tag3);
+	BENCHMARK_TAG_COMPONENT(Tag4);
+	BENCHMARK_TAG_COMPONENT(Tag5);
+	BENCHMARK_TAG_COMPONENT(Tag6);
+	BENCHMARK_TAG_COMPONENT(Tag7);
+
+#undef BENCHMARK_TAG_COMPONENT
+
+	constexpr size_t BENCHMARK_TAGS_COUNT = 8;
+}
@@ -0,0 +1,352 @@
+#include "ECSBenchmarks.h"
+
+#include "GrappleECS/World.h"
+#include "GrappleECS/Query/EntityView.h"
+#include "GrappleECS/Commands/CommandBuffer.h"
+
+#include "GrappleECSBenchmarks/BenchmarkComponents.h"
+
+#include <algorithm>
+#include <random>
+
+namespace Grapple
+{
+	static constexpr uint32_t RANDOM_SEED = 42;
+
+	static std::vector<Entity> CreateEntities(World& world, size_t count)
+	{
+		std::vector<Entity> entities;
+		entities.reserve(count);
+
+		for (size_t i = 0; i < count; i++)
+			entities.push_back(world.CreateEntity<Position, Velocity>());
+
+		return entities;
+	}
+
+	// Creates entities evenly distributed between all combinations of tag components
+	static void CreateEntitiesInAllArchetypes(World& world, size_t count)
+	{
+		ComponentId tags[] =
+		{
+			COMPONENT_ID(Tag0), COMPONENT_ID(Tag1), COMPONENT_ID(Tag2), COMPONENT_ID(Tag3),
+			COMPONENT_ID(Tag4), COMPONENT_ID(Tag5), COMPONENT_ID(Tag6), COMPONENT_ID(Tag7),
+		};
+
+		static_assert(sizeof(tags) / sizeof(ComponentId) == BENCHMARK_TAGS_COUNT);
+
+		std::vector<ComponentId> components;
+		size_t archetypesCount = (size_t)1 << BENCHMARK_TAGS_COUNT;
+		for (size_t i = 0; i < count; i++)
+		{
+			size_t tagsMask = i % archetypesCount;
+
+			components.clear();
+			components.push_back(COMPONENT_ID(Position));
+
+			for (size_t tag = 0; tag < BENCHMARK_TAGS_COUNT; tag++)
+			{
+				if (tagsMask & ((size_t)1 << tag))
+					components.push_back(tags[tag]);
+			}
+
+			std::sort(components.begin(), components.end());
+			world.Entities.CreateEntity(ComponentSet(components));
+		}
+	}
+
+	class EmptySystem : public System
+	{
+	public:
+		void OnConfig(World& world, SystemConfig& config) override {}
+		void OnUpdate(World& world, SystemExecutionContext& context) override {}
+	};
+
+	class MovementSystem : public System
+	{
+	public:
+		void OnConfig(World& world, SystemConfig& config) override
+		{
+			m_Query = world.NewQuery().All().With<Position, Velocity>().Build();
+		}
+
+		void OnUpdate(World& world, SystemExecutionContext& context) override
+		{
+			m_Query.ForEachChunk([](QueryChunk chunk, ComponentView<Position> positions, ComponentView<Velocity> velocities)
+			{
+				for (EntityViewElement entity : chunk)
+					positions[entity].Value += velocities[entity].Value;
+			});
+		}
+	private:
+		Query m_Query;
+	};
+
+	void RegisterECSBenchmarks(BenchmarkRunner& runner, ECSContext& context, size_t entitiesCount)
+	{
+		// Entities
+
+		runner.Add("Entities/Create", [&context, entitiesCount](BenchmarkState& state)
+		{
+			World world(context);
+
+			state.SetOperationsCount(entitiesCount);
+			state.Start();
+
+			for (size_t i = 0; i < entitiesCount; i++)
+				world.CreateEntity<Position, Velocity>();
+
+			state.Stop();
+		});
+
+		runner.Add("Entities/Delete", [&context, entitiesCount](BenchmarkState& state)
+		{
+			World world(context);
+			std::vector<Entity> entities = CreateEntities(world, entitiesCount);
+
+			state.SetOperationsCount(entitiesCount);
+			state.Start();
+
+			for (Entity entity : entities)
+				world.DeleteEntity(entity);
+
+			state.Stop();
+		});
+
+		runner.Add("Entities/AddComponent", [&context, entitiesCount](BenchmarkState& state)
+		{
+			World world(context);
+			std::vector<Entity> entities = CreateEntities(world, entitiesCount);
+
+			state.SetOperationsCount(entitiesCount);
+			state.Start();
+
+			for (Entity entity : entities)
+				world.AddEntityComponent<Health>(entity, Health());
+
+			state.Stop();
+		});
+
+		runner.Add("Entities/RemoveComponent", [&context, entitiesCount](BenchmarkState& state)
+		{
+			World world(context);
+			std::vector<Entity> entities = CreateEntities(world, entitiesCount);
+
+			state.SetOperationsCount(entitiesCount);
+			state.Start();
+
+			for (Entity entity : entities)
+				world.RemoveEntityComponent<Velocity>(entity);
+
+			state.Stop();
+		});
+
+		runner.Add("Entities/RandomAccess", [&context, entitiesCount](BenchmarkState& state)
+		{
+			World world(context);
+			std::vector<Entity> entities = CreateEntities(world, entitiesCount);
+			std::shuffle(entities.begin(), entities.end(), std::mt19937(RANDOM_SEED));
+
+			glm::vec3 sum = glm::vec3(0.0f);
+
+			state.SetOperationsCount(entitiesCount);
+			state.Start();
+
+			for (Entity entity : entities)
+				sum += world.TryGetEntityComponent<Position>(entity)->Value;
+
+			state.Stop();
+			DoNotOptimize(sum);
+		});
+
+		// Queries
+
+		runner.Add("Query/ForEachChunk", [&context, entitiesCount](BenchmarkState& state)
+		{
+			World world(context);
+			CreateEntities(world, entitiesCount);
+
+			Query query = world.NewQuery().All().With<Position, Velocity>().Build();
+
+			state.SetOperationsCount(entitiesCount);
+			state.Start();
+
+			query.ForEachChunk([](QueryChunk chunk, ComponentView<Position> positions, ComponentView<Velocity> velocities)
+			{
+				for (EntityViewElement entity : chunk)
+					positions[entity].Value += velocities[entity].Value;
+			});
+
+			state.Stop();
+		});
+
+		runner.Add("Query/EntityView", [&context, entitiesCount](BenchmarkState& state)
+		{
+			World world(context);
+			CreateEntities(world, entitiesCount);
+
+			Query query = world.NewQuery().All().With<Position, Velocity>().Build();
+
+			state.SetOperationsCount(entitiesCount);
+			state.Start();
+
+			for (EntityView view : query)
+			{
+				auto positions = view.View<Position>();
+				auto velocities = view.View<Velocity>();
+
+				for (EntityViewElement entity : view)
+					positions[entity].Value += velocities[entity].Value;
+			}
+
+			state.Stop();
+		});
+
+		runner.Add("Query/ForEachChunkManyArchetypes", [&context, entitiesCount](BenchmarkState& state)
+		{
+			World world(context);
+			CreateEntitiesInAllArchetypes(world, entitiesCount);
+
+			Query query = world.NewQuery().All().With<Position>().Build();
+			glm::vec3 sum = glm::vec3(0.0f);
+
+			state.SetOperationsCount(entitiesCount);
+			state.Start();
+
+			query.ForEachChunk([&sum](QueryChunk chunk, ComponentView<Position> positions)
+			{
+				for (EntityViewElement entity : chunk)
+					sum += positions[entity].Value;
+			});
+
+			state.Stop();
+			DoNotOptimize(sum);
+		});
+
+		runner.Add("Query/MatchManyArchetypes", [&context, entitiesCount](BenchmarkState& state)
+		{
+			World world(context);
+			CreateEntitiesInAllArchetypes(world, entitiesCount);
+
+			constexpr size_t queriesCount = 64;
+			state.SetOperationsCount(queriesCount);
+			state.Start();
+
+			for (size_t i = 0; i < queriesCount / 8; i++)
+			{
+				DoNotOptimize(world.NewQuery().All().With<Position, Tag0>().Build());
+				DoNotOptimize(world.NewQuery().All().With<Position, Tag1>().Without<Tag2>().Build());
+				DoNotOptimize(world.NewQuery().All().With<Tag2, Tag3>().Build());
+				DoNotOptimize(world.NewQuery().All().With<Tag3>().Without<Tag4, Tag5>().Build());
+				DoNotOptimize(world.NewQuery().All().With<Tag4, Tag5, Tag6>().Build());
+				DoNotOptimize(world.NewQuery().All().With<Tag5>().Without<Tag7>().Build());
+				DoNotOptimize(world.NewQuery().All().With<Tag6, Tag7>().Build());
+				DoNotOptimize(world.NewQuery().All().With<Position>().Without<Tag0, Tag7>().Build());
+			}
+
+			state.Stop();
+		});
+
+		// Commands
+
+		runner.Add("Commands/CreateEntities", [&context, entitiesCount](BenchmarkState& state)
+		{
+			World world(context);
+			EntitiesCommandBuffer commands(world);
+
+			state.SetOperationsCount(entitiesCount);
+			state.Start();
+
+			for (size_t i = 0; i < entitiesCount; i++)
+				commands.CreateEntity<Position, Velocity>();
+
+			commands.Execute();
+
+			state.Stop();
+		});
+
+		runner.Add("Commands/AddAndRemoveComponents", [&context, entitiesCount](BenchmarkState& state)
+		{
+			World world(context);
+			EntitiesCommandBuffer commands(world);
+			std::vector<Entity> entities = CreateEntities(world, entitiesCount);
+
+			state.SetOperationsCount(entitiesCount * 2);
+			state.Start();
+
+			for (Entity entity : entities)
+				commands.GetEntity(entity).AddComponent<Health>();
+			for (Entity entity : entities)
+				commands.GetEntity(entity).RemoveComponent<Velocity>();
+
+			commands.Execute();
+
+			state.Stop();
+		});
+
+		runner.Add("Commands/DeleteEntities", [&context, entitiesCount](BenchmarkState& state)
+		{
+			World world(context);
+			EntitiesCommandBuffer commands(world);
+			std::vector<Entity> entities = CreateEntities(world, entitiesCount);
+
+			state.SetOperationsCount(entitiesCount);
+			state.Start();
+
+			for (Entity entity : entities)
+				commands.DeleteEntity(entity);
+
+			commands.Execute();
+
+			state.Stop();
+		});
+
+		// Systems
+
+		runner.Add("Systems/ExecuteEmptyGroup", [&context](BenchmarkState& state)
+		{
+			constexpr size_t systemsCount = 64;
+			constexpr size_t framesCount = 100;
+
+			World world(context);
+			SystemsManager& systems = world.GetSystemsManager();
+			SystemGroupId group = systems.CreateGroup("Update");
+
+			for (size_t i = 0; i < systemsCount; i++)
+				systems.RegisterSystem("Empty System", new EmptySystem());
+
+			systems.RebuildExecutionGraphs();
+
+			state.SetOperationsCount(systemsCount * framesCount);
+			state.Start();
+
+			for (size_t i = 0; i < framesCount; i++)
+				systems.ExecuteGroup(group);
+
+			state.Stop();
+		});
+
+		runner.Add("Systems/ExecuteMovementGroup", [&context, entitiesCount](BenchmarkState& state)
+		{
+			constexpr size_t systemsCount = 8;
+
+			World world(context);
+			CreateEntities(world, entitiesCount / systemsCount);
+
+			SystemsManager& systems = world.GetSystemsManager();
+			SystemGroupId group = systems.CreateGroup("Update");
+
+			for (size_t i = 0; i < systemsCount; i++)
+				systems.RegisterSystem("Movement System", new MovementSystem());
+
+			systems.RebuildExecutionGraphs();
+
+			state.SetOperationsCount(entitiesCount);
+			state.Start();
+
+			systems.ExecuteGroup(group);
+
+			state.Stop();
+		});
+	}
+}
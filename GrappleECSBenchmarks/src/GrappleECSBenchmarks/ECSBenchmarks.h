@@ -0,0 +1,9 @@
+#pragma once
+
+#include "GrappleECSBenchmarks/Benchmark.h"
+
+namespace Grapple
+{
+	struct ECSContext;
+	void RegisterECSBenchmarks(BenchmarkRunner& runner, ECSContext& context, size_t entitiesCount);
+}
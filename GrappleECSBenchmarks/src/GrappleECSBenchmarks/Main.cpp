@@ -0,0 +1,78 @@
+#include "GrappleCore/Log.h"
+
+#include "GrappleECS/ECSContext.h"
+
+#include "GrappleECSBenchmarks/Benchmark.h"
+#include "GrappleECSBenchmarks/ECSBenchmarks.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+using namespace Grapple;
+
+static void PrintUsage()
+{
+	std::cerr << "Usage: GrappleECSBenchmarks [--output=<path>] [--filter=<name>] [--iterations=<count>] [--entities=<count>]\n";
+}
+
+int main(int argc, const char* argv[])
+{
+	BenchmarkSettings settings;
+	size_t entitiesCount = 100000;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string_view argument = argv[i];
+		auto readValue = [argument](std::string_view name, std::string_view& value) -> bool
+		{
+			if (argument.substr(0, name.size()) != name)
+				return false;
+
+			value = argument.substr(name.size());
+			return true;
+		};
+
+		std::string_view value;
+		if (readValue("--output=", value))
+			settings.OutputPath = value;
+		else if (readValue("--filter=", value))
+			settings.Filter = value;
+		else if (readValue("--iterations=", value))
+			settings.Iterations = std::max<size_t>(1, (size_t)std::stoull(std::string(value)));
+		else if (readValue("--entities=", value))
+			entitiesCount = std::max<size_t>(1, (size_t)std::stoull(std::string(value)));
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	Log::Initialize();
+
+	ECSContext context;
+	context.Components.RegisterComponents();
+
+	BenchmarkRunner runner(settings);
+	RegisterECSBenchmarks(runner, context, entitiesCount);
+	runner.Run();
+
+	if (settings.OutputPath.empty())
+	{
+		runner.WriteJSON(std::cout);
+		return 0;
+	}
+
+	std::ofstream output(settings.OutputPath);
+	if (!output.is_open())
+	{
+		std::cerr << "Failed to open " << settings.OutputPath << '\n';
+		return 1;
+	}
+
+	runner.WriteJSON(output);
+	return 0;
+}
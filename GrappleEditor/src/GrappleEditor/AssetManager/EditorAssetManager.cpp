@@ -4,6 +4,7 @@
 #include "GrappleCore/Log.h"
 #include "GrappleCore/Profiler/Profiler.h"
 
+#include "Grapple/AssetManager/AssetManager.h"
 #include "Grapple/Serialization/Serialization.h"
 #include "Grapple/Project/Project.h"
 
@@ -211,6 +212,7 @@ namespace Grapple
             ShaderLibrary::AddShader(handle);
         }
 
+        AssetManager::NotifyAssetsChanged();
         return handle;
     }
 
@@ -243,6 +245,7 @@ namespace Grapple
         }
 
         m_LoadedAssets.emplace(asset->Handle, asset);
+        AssetManager::NotifyAssetsChanged();
         return handle;
     }
 
@@ -267,6 +270,7 @@ namespace Grapple
 		}
 
         m_LoadedAssets.emplace(asset->Handle, asset);
+        AssetManager::NotifyAssetsChanged();
         return handle;
     }
 
@@ -289,6 +293,7 @@ namespace Grapple
         }
 
         LoadAsset(entry->Metadata);
+        AssetManager::NotifyAssetsChanged();
     }
 
     void EditorAssetManager::UnloadAsset(AssetHandle handle)
@@ -299,6 +304,7 @@ namespace Grapple
             return;
 
         m_LoadedAssets.erase(it);
+        AssetManager::NotifyAssetsChanged();
     }
 
     void EditorAssetManager::ReloadPrefabs()
@@ -335,6 +341,7 @@ namespace Grapple
         m_FilepathToAssetHandle.erase(it);
 
         m_Registry.Remove(handle);
+        AssetManager::NotifyAssetsChanged();
     }
 
     void EditorAssetManager::SetLoadedAsset(AssetHandle handle, const Ref<Asset>& asset)
@@ -347,6 +354,7 @@ namespace Grapple
 
         m_LoadedAssets[handle] = asset;
         asset->Handle = handle;
+        AssetManager::NotifyAssetsChanged();
     }
 
     Ref<Asset> EditorAssetManager::LoadAsset(AssetHandle handle)
@@ -416,6 +424,7 @@ namespace Grapple
 
         asset->Handle = metadata.Handle;
         m_LoadedAssets[metadata.Handle] = asset;
+        AssetManager::NotifyAssetsChanged();
         return asset;
     }
 
@@ -7,12 +7,17 @@
 #include "Grapple/Renderer/Renderer.h"
 
 #include "GrappleEditor/AssetManager/EditorAssetManager.h"
+#include "GrappleEditor/AssetManager/MeshOptimizer.h"
+#include "GrappleEditor/AssetManager/MeshletBuilder.h"
+#include "GrappleEditor/AssetManager/MeshSimplifier.h"
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 #include <assimp/material.h>
 
+#include <unordered_map>
+
 namespace Grapple
 {
     struct SceneData
@@ -30,6 +35,9 @@ namespace Grapple
         size_t MaxSubMeshIndexCount = 0;
 
         std::vector<SubMesh> SubMeshes;
+        std::vector<uint32_t> SubMeshVertexCounts;
+        std::vector<MeshLOD> LODs;
+        std::vector<Meshlet> Meshlets;
         std::vector<uint32_t> UsedMaterials;
     };
 
@@ -75,6 +83,7 @@ namespace Grapple
             data.UVs.resize(vertexCount);
 
             data.SubMeshes.reserve(node->mNumMeshes);
+            data.SubMeshVertexCounts.reserve(node->mNumMeshes);
 
             size_t vertexOffset = 0;
             size_t indexOffset = 0;
@@ -142,6 +151,8 @@ namespace Grapple
 					}
                 }
 
+                data.SubMeshVertexCounts.push_back(nodeMesh->mNumVertices);
+
                 vertexOffset += nodeMesh->mNumVertices;
                 indexOffset += subMeshIndexCount;
             }
@@ -161,6 +172,269 @@ namespace Grapple
         return false;
     }
 
+    struct VertexKey
+    {
+        glm::vec3 Position;
+        glm::vec3 Normal;
+        glm::vec3 Tangent;
+        glm::vec2 UV;
+
+        bool operator==(const VertexKey& other) const
+        {
+            return std::memcmp(this, &other, sizeof(VertexKey)) == 0;
+        }
+    };
+
+    struct VertexKeyHash
+    {
+        size_t operator()(const VertexKey& key) const
+        {
+            // FNV-1a
+            const uint8_t* bytes = (const uint8_t*)&key;
+            uint64_t hash = 14695981039346656037ull;
+            for (size_t i = 0; i < sizeof(VertexKey); i++)
+            {
+                hash ^= (uint64_t)bytes[i];
+                hash *= 1099511628211ull;
+            }
+
+            return (size_t)hash;
+        }
+    };
+
+    // Merges identical vertices and reorders triangles and vertices of each sub mesh for the vertex cache, overdraw and vertex fetch.
+    // Sub meshes keep their index ranges, only the vertices inside of each sub mesh's range are removed or reordered
+    static void OptimizeMesh(SceneData& data, const AssetMetadata& metadata)
+    {
+        Grapple_PROFILE_FUNCTION();
+
+        std::vector<uint32_t> indices;
+        if (data.IndexFormat == IndexBuffer::IndexFormat::UInt16)
+            indices.assign(data.Indices16.begin(), data.Indices16.end());
+        else
+            indices = std::move(data.Indices32);
+
+        VertexCacheStatistics statisticsBefore = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), data.Vertices.size());
+        size_t verticesCountBefore = data.Vertices.size();
+
+        std::vector<glm::vec3> vertices;
+        std::vector<glm::vec3> normals;
+        std::vector<glm::vec3> tangents;
+        std::vector<glm::vec2> uvs;
+        vertices.reserve(data.Vertices.size());
+        normals.reserve(data.Vertices.size());
+        tangents.reserve(data.Vertices.size());
+        uvs.reserve(data.Vertices.size());
+
+        std::unordered_map<VertexKey, uint32_t, VertexKeyHash> uniqueVerticesMap;
+        std::vector<uint32_t> uniqueVertices;
+        std::vector<glm::vec3> uniquePositions;
+        std::vector<uint32_t> remap;
+
+        size_t vertexOffset = 0;
+        for (size_t subMeshIndex = 0; subMeshIndex < data.SubMeshes.size(); subMeshIndex++)
+        {
+            SubMesh& subMesh = data.SubMeshes[subMeshIndex];
+            size_t vertexCount = (size_t)data.SubMeshVertexCounts[subMeshIndex];
+
+            uint32_t* subMeshIndices = indices.data() + subMesh.BaseIndex;
+            size_t subMeshIndicesCount = (size_t)subMesh.IndicesCount;
+
+            uniqueVerticesMap.clear();
+            uniqueVerticesMap.reserve(vertexCount);
+            uniqueVertices.clear();
+            remap.resize(vertexCount);
+
+            for (size_t i = 0; i < vertexCount; i++)
+            {
+                size_t vertex = vertexOffset + i;
+
+                VertexKey key;
+                key.Position = data.Vertices[vertex];
+                key.Normal = data.Normals[vertex];
+                key.Tangent = data.Tangents[vertex];
+                key.UV = data.UVs[vertex];
+
+                auto [it, inserted] = uniqueVerticesMap.emplace(key, (uint32_t)uniqueVertices.size());
+                if (inserted)
+                    uniqueVertices.push_back((uint32_t)vertex);
+
+                remap[i] = it->second;
+            }
+
+            for (size_t i = 0; i < subMeshIndicesCount; i++)
+            {
+                Grapple_CORE_ASSERT(subMeshIndices[i] >= vertexOffset && subMeshIndices[i] < vertexOffset + vertexCount);
+                subMeshIndices[i] = remap[subMeshIndices[i] - vertexOffset];
+            }
+
+            uniquePositions.resize(uniqueVertices.size());
+            for (size_t i = 0; i < uniqueVertices.size(); i++)
+                uniquePositions[i] = data.Vertices[uniqueVertices[i]];
+
+            MeshOptimizer::OptimizeVertexCache(subMeshIndices, subMeshIndicesCount, uniqueVertices.size());
+            MeshOptimizer::OptimizeOverdraw(subMeshIndices, subMeshIndicesCount, uniquePositions.data(), uniquePositions.size());
+            size_t usedVerticesCount = MeshOptimizer::OptimizeVertexFetch(subMeshIndices, subMeshIndicesCount, uniqueVertices.size(), remap);
+
+            size_t baseVertex = vertices.size();
+            vertices.resize(baseVertex + usedVerticesCount);
+            normals.resize(baseVertex + usedVerticesCount);
+            tangents.resize(baseVertex + usedVerticesCount);
+            uvs.resize(baseVertex + usedVerticesCount);
+
+            for (size_t i = 0; i < uniqueVertices.size(); i++)
+            {
+                if (remap[i] == UINT32_MAX)
+                    continue;
+
+                size_t vertex = baseVertex + remap[i];
+                vertices[vertex] = data.Vertices[uniqueVertices[i]];
+                normals[vertex] = data.Normals[uniqueVertices[i]];
+                tangents[vertex] = data.Tangents[uniqueVertices[i]];
+                uvs[vertex] = data.UVs[uniqueVertices[i]];
+            }
+
+            for (size_t i = 0; i < subMeshIndicesCount; i++)
+                subMeshIndices[i] += (uint32_t)baseVertex;
+
+            vertexOffset += vertexCount;
+            data.SubMeshVertexCounts[subMeshIndex] = (uint32_t)usedVerticesCount;
+        }
+
+        data.Vertices = std::move(vertices);
+        data.Normals = std::move(normals);
+        data.Tangents = std::move(tangents);
+        data.UVs = std::move(uvs);
+
+        VertexCacheStatistics statisticsAfter = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), data.Vertices.size());
+
+        Grapple_CORE_INFO("Optimized mesh {}: vertices {} -> {}, ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}",
+            metadata.Path.generic_string(),
+            verticesCountBefore, data.Vertices.size(),
+            statisticsBefore.ACMR, statisticsAfter.ACMR,
+            statisticsBefore.ATVR, statisticsAfter.ATVR);
+
+        if (data.IndexFormat == IndexBuffer::IndexFormat::UInt16)
+        {
+            for (size_t i = 0; i < indices.size(); i++)
+                data.Indices16[i] = (uint16_t)indices[i];
+        }
+        else
+        {
+            data.Indices32 = std::move(indices);
+        }
+    }
+
+    // Splits sub meshes of the base LOD into meshlets, which are used for cluster culling.
+    // Meshlets follow the optimized triangle order, so the indices are left unchanged
+    static void BuildMeshlets(SceneData& data)
+    {
+        Grapple_PROFILE_FUNCTION();
+
+        std::vector<uint32_t> indices;
+        if (data.IndexFormat == IndexBuffer::IndexFormat::UInt16)
+            indices.assign(data.Indices16.begin(), data.Indices16.end());
+
+        const uint32_t* meshIndices = data.IndexFormat == IndexBuffer::IndexFormat::UInt16 ? indices.data() : data.Indices32.data();
+
+        for (SubMesh& subMesh : data.SubMeshes)
+        {
+            subMesh.FirstMeshlet = (uint32_t)data.Meshlets.size();
+
+            MeshletBuilder::Build(meshIndices + subMesh.BaseIndex,
+                (size_t)subMesh.IndicesCount,
+                subMesh.BaseIndex,
+                data.Vertices.data(),
+                data.Vertices.size(),
+                data.Meshlets);
+
+            subMesh.MeshletsCount = (uint32_t)data.Meshlets.size() - subMesh.FirstMeshlet;
+        }
+    }
+
+    // Builds a chain of LODs, each having half of the triangles of the previous one.
+    // Indices of the LODs are appended after the indices of the base mesh, so that all of them share the vertices
+    static void GenerateLODs(SceneData& data)
+    {
+        Grapple_PROFILE_FUNCTION();
+
+        constexpr uint32_t maxLODCount = 4;
+        constexpr float minReduction = 0.8f;
+
+        std::vector<uint32_t> baseIndices;
+        if (data.IndexFormat == IndexBuffer::IndexFormat::UInt16)
+            baseIndices.assign(data.Indices16.begin(), data.Indices16.end());
+        else
+            baseIndices = data.Indices32;
+
+        for (uint32_t lodIndex = 1; lodIndex < maxLODCount; lodIndex++)
+        {
+            const std::vector<SubMesh>& previousSubMeshes = lodIndex == 1 ? data.SubMeshes : data.LODs.back().SubMeshes;
+
+            MeshLOD lod;
+            lod.ScreenSize = 1.0f / (float)(1u << lodIndex);
+            lod.SubMeshes.reserve(data.SubMeshes.size());
+
+            bool simplified = false;
+            for (size_t subMeshIndex = 0; subMeshIndex < data.SubMeshes.size(); subMeshIndex++)
+            {
+                const SubMesh& baseSubMesh = data.SubMeshes[subMeshIndex];
+                const SubMesh& previousSubMesh = previousSubMeshes[subMeshIndex];
+
+                size_t targetIndexCount = ((size_t)baseSubMesh.IndicesCount >> lodIndex) / 3 * 3;
+                float maxError = 0.01f * (float)(1u << (lodIndex - 1));
+
+                std::vector<uint32_t> indices = MeshSimplifier::Simplify(data.Vertices.data(),
+                    data.Vertices.size(),
+                    baseIndices.data() + baseSubMesh.BaseIndex,
+                    (size_t)baseSubMesh.IndicesCount,
+                    targetIndexCount,
+                    maxError);
+
+                // Sub meshes, which can't be simplified any further, reuse indices of the previous LOD
+                if (indices.size() == 0 || (float)indices.size() > (float)previousSubMesh.IndicesCount * minReduction)
+                {
+                    lod.SubMeshes.push_back(previousSubMesh);
+                    continue;
+                }
+
+                MeshOptimizer::OptimizeVertexCache(indices.data(), indices.size(), data.Vertices.size());
+
+                SubMesh& subMesh = lod.SubMeshes.emplace_back();
+                subMesh.Bounds = baseSubMesh.Bounds;
+                subMesh.BaseVertex = baseSubMesh.BaseVertex;
+                subMesh.IndicesCount = (uint32_t)indices.size();
+
+                if (data.IndexFormat == IndexBuffer::IndexFormat::UInt16)
+                {
+                    subMesh.BaseIndex = (uint32_t)data.Indices16.size();
+                    for (uint32_t index : indices)
+                        data.Indices16.push_back((uint16_t)index);
+                }
+                else
+                {
+                    subMesh.BaseIndex = (uint32_t)data.Indices32.size();
+                    data.Indices32.insert(data.Indices32.end(), indices.begin(), indices.end());
+                }
+
+                simplified = true;
+            }
+
+            if (!simplified)
+                break;
+
+            data.LODs.push_back(std::move(lod));
+        }
+    }
+
+    // Small meshes are kept in the float format, because the memory savings are negligible,
+    // while drawing meshes with different formats requires switching between pipeline variants
+    static MeshVertexFormat SelectVertexFormat(const SceneData& data)
+    {
+        constexpr size_t minCompactVerticesCount = 1024;
+        return data.Vertices.size() >= minCompactVerticesCount ? MeshVertexFormat::Compact : MeshVertexFormat::Float;
+    }
+
     static AssetHandle FindTextureByPath(std::string_view path, const AssetMetadata& metadata, const Ref<EditorAssetManager>& assetManager)
     {
         Grapple_PROFILE_FUNCTION();
@@ -338,6 +612,10 @@ namespace Grapple
         bool result = ProcessMeshNode(scene->mRootNode, scene, data);
         Grapple_CORE_ASSERT(result);
 
+        OptimizeMesh(data, metadata);
+        BuildMeshlets(data);
+        GenerateLODs(data);
+
         MemorySpan indices = MemorySpan();
         if (data.IndexFormat == IndexBuffer::IndexFormat::UInt16)
         {
@@ -348,17 +626,26 @@ namespace Grapple
             indices = MemorySpan::FromVector(data.Indices32);
         }
 
+        MeshVertexFormat vertexFormat = SelectVertexFormat(data);
         Ref<Mesh> mesh = Mesh::Create(indices, data.IndexFormat,
             Span<glm::vec3>::FromVector(data.Vertices),
             Span<glm::vec3>::FromVector(data.Normals),
             Span<glm::vec3>::FromVector(data.Tangents),
-            Span<glm::vec2>::FromVector(data.UVs));
+            Span<glm::vec2>::FromVector(data.UVs),
+            vertexFormat);
 
         for (const auto& subMesh : data.SubMeshes)
         {
             mesh->AddSubMesh(subMesh);
         }
 
+        mesh->SetMeshlets(std::move(data.Meshlets));
+
+        for (auto& lod : data.LODs)
+        {
+            mesh->AddLOD(std::move(lod));
+        }
+
         ImportMaterials(metadata, scene, data.UsedMaterials);
 
         return mesh;
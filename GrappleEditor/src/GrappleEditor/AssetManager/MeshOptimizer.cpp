@@ -0,0 +1,351 @@
+#include "MeshOptimizer.h"
+
+#include "GrappleCore/Assert.h"
+#include "GrappleCore/Profiler/Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Grapple
+{
+	// Parameters of the Forsyth's vertex cache optimization
+	static constexpr uint32_t VertexCacheSize = 32;
+	static constexpr float CacheDecayPower = 1.5f;
+	static constexpr float LastTriangleScore = 0.75f;
+	static constexpr float ValenceBoostScale = 2.0f;
+	static constexpr float ValenceBoostPower = 0.5f;
+
+	static float ComputeVertexScore(int32_t cachePosition, uint32_t remainingTriangles)
+	{
+		if (remainingTriangles == 0)
+			return -1.0f;
+
+		float score = 0.0f;
+		if (cachePosition >= 0)
+		{
+			// Vertices of the last triangle get a fixed score, so that the triangles
+			// adjacent to it are not preferred over the ones further in the cache
+			if (cachePosition < 3)
+			{
+				score = LastTriangleScore;
+			}
+			else
+			{
+				const float scale = 1.0f / (float)(VertexCacheSize - 3);
+				score = std::pow(1.0f - (float)(cachePosition - 3) * scale, CacheDecayPower);
+			}
+		}
+
+		// Boosts vertices with few remaining triangles, so that they are finished off early
+		score += ValenceBoostScale * std::pow((float)remainingTriangles, -ValenceBoostPower);
+		return score;
+	}
+
+	void MeshOptimizer::OptimizeVertexCache(uint32_t* indices, size_t indicesCount, size_t verticesCount)
+	{
+		Grapple_PROFILE_FUNCTION();
+		Grapple_CORE_ASSERT(indicesCount % 3 == 0);
+
+		size_t trianglesCount = indicesCount / 3;
+		if (trianglesCount == 0)
+			return;
+
+		// Triangles adjacent to each vertex
+		std::vector<uint32_t> adjacencyOffsets(verticesCount + 1, 0);
+		std::vector<uint32_t> remainingTriangles(verticesCount, 0);
+		for (size_t i = 0; i < indicesCount; i++)
+		{
+			Grapple_CORE_ASSERT(indices[i] < verticesCount);
+			remainingTriangles[indices[i]]++;
+		}
+
+		for (size_t i = 0; i < verticesCount; i++)
+			adjacencyOffsets[i + 1] = adjacencyOffsets[i] + remainingTriangles[i];
+
+		std::vector<uint32_t> adjacency(indicesCount);
+		{
+			std::vector<uint32_t> writeOffsets(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (size_t i = 0; i < indicesCount; i++)
+				adjacency[writeOffsets[indices[i]]++] = (uint32_t)(i / 3);
+		}
+
+		std::vector<int32_t> cachePositions(verticesCount, -1);
+		std::vector<float> vertexScores(verticesCount);
+		for (size_t i = 0; i < verticesCount; i++)
+			vertexScores[i] = ComputeVertexScore(-1, remainingTriangles[i]);
+
+		std::vector<float> triangleScores(trianglesCount);
+		std::vector<bool> isEmitted(trianglesCount, false);
+		for (size_t i = 0; i < trianglesCount; i++)
+		{
+			triangleScores[i] = vertexScores[indices[i * 3 + 0]]
+				+ vertexScores[indices[i * 3 + 1]]
+				+ vertexScores[indices[i * 3 + 2]];
+		}
+
+		std::vector<uint32_t> result;
+		result.reserve(indicesCount);
+
+		uint32_t cache[VertexCacheSize + 3];
+		uint32_t newCache[VertexCacheSize + 3];
+		uint32_t cacheSize = 0;
+
+		size_t nextUnemittedTriangle = 0;
+		int64_t bestTriangle = -1;
+
+		for (size_t emitted = 0; emitted < trianglesCount; emitted++)
+		{
+			// Starts over from the next triangle in the original order, when there are
+			// no triangles left, which are adjacent to the vertices in the cache
+			if (bestTriangle < 0)
+			{
+				while (isEmitted[nextUnemittedTriangle])
+					nextUnemittedTriangle++;
+
+				bestTriangle = (int64_t)nextUnemittedTriangle;
+			}
+
+			const uint32_t* triangle = indices + bestTriangle * 3;
+			result.push_back(triangle[0]);
+			result.push_back(triangle[1]);
+			result.push_back(triangle[2]);
+			isEmitted[(size_t)bestTriangle] = true;
+
+			for (uint32_t vertex = 0; vertex < 3; vertex++)
+			{
+				uint32_t index = triangle[vertex];
+
+				// Removes the triangle from the list of adjacent triangles of the vertex
+				uint32_t* begin = adjacency.data() + adjacencyOffsets[index];
+				uint32_t* end = begin + remainingTriangles[index];
+				uint32_t* it = std::find(begin, end, (uint32_t)bestTriangle);
+				Grapple_CORE_ASSERT(it != end);
+
+				std::swap(*it, *(end - 1));
+				remainingTriangles[index]--;
+			}
+
+			// Vertices of the emitted triangle move to the front of the cache
+			uint32_t newCacheSize = 0;
+			for (uint32_t vertex = 0; vertex < 3; vertex++)
+				newCache[newCacheSize++] = triangle[vertex];
+
+			for (uint32_t i = 0; i < cacheSize; i++)
+			{
+				uint32_t index = cache[i];
+				if (index != triangle[0] && index != triangle[1] && index != triangle[2])
+					newCache[newCacheSize++] = index;
+			}
+
+			std::copy(newCache, newCache + newCacheSize, cache);
+			cacheSize = newCacheSize;
+
+			// Updates scores of the vertices in the cache, including the ones that were just evicted
+			for (uint32_t i = 0; i < cacheSize; i++)
+			{
+				uint32_t index = cache[i];
+				cachePositions[index] = i < VertexCacheSize ? (int32_t)i : -1;
+
+				float scoreDelta = ComputeVertexScore(cachePositions[index], remainingTriangles[index]) - vertexScores[index];
+				vertexScores[index] += scoreDelta;
+
+				for (uint32_t j = 0; j < remainingTriangles[index]; j++)
+					triangleScores[adjacency[adjacencyOffsets[index] + j]] += scoreDelta;
+			}
+
+			cacheSize = std::min(cacheSize, VertexCacheSize);
+
+			// Only triangles adjacent to the cached vertices have changed their score
+			bestTriangle = -1;
+			float bestScore = -1.0f;
+			for (uint32_t i = 0; i < cacheSize; i++)
+			{
+				uint32_t index = cache[i];
+				for (uint32_t j = 0; j < remainingTriangles[index]; j++)
+				{
+					uint32_t triangleIndex = adjacency[adjacencyOffsets[index] + j];
+					if (triangleScores[triangleIndex] > bestScore)
+					{
+						bestScore = triangleScores[triangleIndex];
+						bestTriangle = (int64_t)triangleIndex;
+					}
+				}
+			}
+		}
+
+		std::copy(result.begin(), result.end(), indices);
+	}
+
+	struct TriangleCluster
+	{
+		size_t FirstTriangle = 0;
+		size_t TrianglesCount = 0;
+		float SortKey = 0.0f;
+	};
+
+	void MeshOptimizer::OptimizeOverdraw(uint32_t* indices, size_t indicesCount, const glm::vec3* vertices, size_t verticesCount)
+	{
+		Grapple_PROFILE_FUNCTION();
+		Grapple_CORE_ASSERT(indicesCount % 3 == 0);
+
+		constexpr uint32_t cacheSize = 16;
+
+		size_t trianglesCount = indicesCount / 3;
+		if (trianglesCount == 0)
+			return;
+
+		// A new cluster starts at each triangle, which misses the cache for all of its vertices
+		std::vector<TriangleCluster> clusters;
+		std::vector<uint32_t> cacheTimestamps(verticesCount, 0);
+		uint32_t timestamp = cacheSize + 1;
+
+		for (size_t i = 0; i < trianglesCount; i++)
+		{
+			uint32_t misses = 0;
+			for (size_t vertex = 0; vertex < 3; vertex++)
+			{
+				uint32_t index = indices[i * 3 + vertex];
+				if (timestamp - cacheTimestamps[index] > cacheSize)
+				{
+					cacheTimestamps[index] = timestamp++;
+					misses++;
+				}
+			}
+
+			if (misses == 3 || clusters.empty())
+			{
+				TriangleCluster& cluster = clusters.emplace_back();
+				cluster.FirstTriangle = i;
+			}
+
+			clusters.back().TrianglesCount++;
+		}
+
+		if (clusters.size() <= 1)
+			return;
+
+		glm::vec3 meshCentroid = glm::vec3(0.0f);
+		float meshArea = 0.0f;
+
+		std::vector<glm::vec3> clusterCentroids(clusters.size());
+		std::vector<glm::vec3> clusterNormals(clusters.size());
+		for (size_t clusterIndex = 0; clusterIndex < clusters.size(); clusterIndex++)
+		{
+			const TriangleCluster& cluster = clusters[clusterIndex];
+
+			glm::vec3 centroid = glm::vec3(0.0f);
+			glm::vec3 normal = glm::vec3(0.0f);
+			float area = 0.0f;
+
+			for (size_t i = cluster.FirstTriangle; i < cluster.FirstTriangle + cluster.TrianglesCount; i++)
+			{
+				const glm::vec3& a = vertices[indices[i * 3 + 0]];
+				const glm::vec3& b = vertices[indices[i * 3 + 1]];
+				const glm::vec3& c = vertices[indices[i * 3 + 2]];
+
+				// Imported meshes have their winding flipped, so front faces are clockwise and (c - a) x (b - a) points outward
+				glm::vec3 triangleNormal = glm::cross(c - a, b - a);
+				float triangleArea = glm::length(triangleNormal);
+
+				centroid += (a + b + c) * (triangleArea / 3.0f);
+				normal += triangleNormal;
+				area += triangleArea;
+			}
+
+			meshCentroid += centroid;
+			meshArea += area;
+
+			clusterCentroids[clusterIndex] = area > 0.0f ? centroid / area : vertices[indices[cluster.FirstTriangle * 3]];
+			clusterNormals[clusterIndex] = normal;
+		}
+
+		if (meshArea > 0.0f)
+			meshCentroid /= meshArea;
+
+		// Clusters, which are further from the center in the direction they are facing,
+		// are more likely to occlude the rest of the mesh, so they are drawn first
+		for (size_t clusterIndex = 0; clusterIndex < clusters.size(); clusterIndex++)
+		{
+			float normalLength = glm::length(clusterNormals[clusterIndex]);
+			glm::vec3 normal = normalLength > 0.0f ? clusterNormals[clusterIndex] / normalLength : glm::vec3(0.0f);
+
+			clusters[clusterIndex].SortKey = glm::dot(clusterCentroids[clusterIndex] - meshCentroid, normal);
+		}
+
+		std::stable_sort(clusters.begin(), clusters.end(), [](const TriangleCluster& a, const TriangleCluster& b) -> bool
+		{
+			return a.SortKey > b.SortKey;
+		});
+
+		std::vector<uint32_t> result;
+		result.reserve(indicesCount);
+
+		for (const TriangleCluster& cluster : clusters)
+		{
+			result.insert(result.end(),
+				indices + cluster.FirstTriangle * 3,
+				indices + (cluster.FirstTriangle + cluster.TrianglesCount) * 3);
+		}
+
+		std::copy(result.begin(), result.end(), indices);
+	}
+
+	size_t MeshOptimizer::OptimizeVertexFetch(uint32_t* indices, size_t indicesCount, size_t verticesCount, std::vector<uint32_t>& remap)
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		remap.assign(verticesCount, UINT32_MAX);
+
+		uint32_t nextVertex = 0;
+		for (size_t i = 0; i < indicesCount; i++)
+		{
+			uint32_t& index = indices[i];
+			Grapple_CORE_ASSERT(index < verticesCount);
+
+			if (remap[index] == UINT32_MAX)
+				remap[index] = nextVertex++;
+
+			index = remap[index];
+		}
+
+		return (size_t)nextVertex;
+	}
+
+	VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache(const uint32_t* indices, size_t indicesCount, size_t verticesCount, uint32_t cacheSize)
+	{
+		Grapple_PROFILE_FUNCTION();
+
+		VertexCacheStatistics statistics;
+		if (indicesCount < 3)
+			return statistics;
+
+		std::vector<uint32_t> cacheTimestamps(verticesCount, 0);
+		std::vector<bool> isReferenced(verticesCount, false);
+		uint32_t timestamp = cacheSize + 1;
+
+		size_t misses = 0;
+		size_t referencedVertices = 0;
+
+		for (size_t i = 0; i < indicesCount; i++)
+		{
+			uint32_t index = indices[i];
+			Grapple_CORE_ASSERT(index < verticesCount);
+
+			if (timestamp - cacheTimestamps[index] > cacheSize)
+			{
+				cacheTimestamps[index] = timestamp++;
+				misses++;
+			}
+
+			if (!isReferenced[index])
+			{
+				isReferenced[index] = true;
+				referencedVertices++;
+			}
+		}
+
+		statistics.ACMR = (float)misses / (float)(indicesCount / 3);
+		statistics.ATVR = referencedVertices > 0 ? (float)misses / (float)referencedVertices : 0.0f;
+		return statistics;
+	}
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <stdint.h>
+#include <vector>
+
+namespace Grapple
+{
+	struct VertexCacheStatistics
+	{
+		// Average cache miss ratio, the number of transformed vertices per triangle
+		float ACMR = 0.0f;
+
+		// Average transform to vertex ratio, the number of transformed vertices per referenced vertex
+		float ATVR = 0.0f;
+	};
+
+	// Import time optimizations of indexed triangle lists.
+	//
+	// Should be applied in the order of the declaration: triangles are first ordered for the post transform
+	// vertex cache, then clusters of them are reordered to reduce overdraw and finally vertices are reordered
+	// in the order of their first use, so that vertex fetches are mostly sequential.
+	class MeshOptimizer
+	{
+	public:
+		// Reorders triangles to improve hit rate of the post transform vertex cache, using Tom Forsyth's linear speed algorithm
+		static void OptimizeVertexCache(uint32_t* indices, size_t indicesCount, size_t verticesCount);
+
+		// Splits triangles into clusters at vertex cache restarts and sorts the clusters, so that the outward facing ones are drawn first.
+		// Clusters start with all of their vertices missing from the cache, so the cache efficiency is mostly preserved
+		static void OptimizeOverdraw(uint32_t* indices, size_t indicesCount, const glm::vec3* vertices, size_t verticesCount);
+
+		// Fills `remap` with new vertex indices, ordered by the first use in the index buffer, and rewrites the indices.
+		// Unused vertices are remapped to `UINT32_MAX`. Returns the number of referenced vertices
+		static size_t OptimizeVertexFetch(uint32_t* indices, size_t indicesCount, size_t verticesCount, std::vector<uint32_t>& remap);
+
+		// Simulates a FIFO vertex cache of the given size
+		static VertexCacheStatistics AnalyzeVertexCache(const uint32_t* indices, size_t indicesCount, size_t verticesCount, uint32_t cacheSize = 16);
+	};
+}
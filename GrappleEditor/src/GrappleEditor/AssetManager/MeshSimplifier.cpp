@@ -0,0 +1,290 @@
+#include "MeshSimplifier.h"
+
+#include "GrappleCore/Assert.h"
+#include "GrappleCore/Profiler/Profiler.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <numeric>
+
+namespace Grapple
+{
+	// Sum of squared distances to a set of planes, weighted by the area of the triangles the planes were built from
+	struct Quadric
+	{
+		// Symmetric 3x3 matrix
+		float A00 = 0.0f, A11 = 0.0f, A22 = 0.0f;
+		float A01 = 0.0f, A02 = 0.0f, A12 = 0.0f;
+
+		glm::vec3 B = glm::vec3(0.0f);
+		float C = 0.0f;
+
+		float Weight = 0.0f;
+	};
+
+	struct Collapse
+	{
+		uint32_t From = 0;
+		uint32_t To = 0;
+		float Error = 0.0f;
+	};
+
+	static Quadric CreatePlaneQuadric(const glm::vec3& normal, float distance, float weight)
+	{
+		Quadric quadric;
+		quadric.A00 = normal.x * normal.x * weight;
+		quadric.A11 = normal.y * normal.y * weight;
+		quadric.A22 = normal.z * normal.z * weight;
+		quadric.A01 = normal.x * normal.y * weight;
+		quadric.A02 = normal.x * normal.z * weight;
+		quadric.A12 = normal.y * normal.z * weight;
+		quadric.B = normal * distance * weight;
+		quadric.C = distance * distance * weight;
+		quadric.Weight = weight;
+		return quadric;
+	}
+
+	static Quadric AddQuadrics(const Quadric& a, const Quadric& b)
+	{
+		Quadric result;
+		result.A00 = a.A00 + b.A00;
+		result.A11 = a.A11 + b.A11;
+		result.A22 = a.A22 + b.A22;
+		result.A01 = a.A01 + b.A01;
+		result.A02 = a.A02 + b.A02;
+		result.A12 = a.A12 + b.A12;
+		result.B = a.B + b.B;
+		result.C = a.C + b.C;
+		result.Weight = a.Weight + b.Weight;
+		return result;
+	}
+
+	// Returns the weighted average of squared distances from the point to the planes
+	static float EvaluateQuadric(const Quadric& quadric, const glm::vec3& point)
+	{
+		float x = point.x;
+		float y = point.y;
+		float z = point.z;
+
+		float error = quadric.A00 * x * x + quadric.A11 * y * y + quadric.A22 * z * z
+			+ 2.0f * (quadric.A01 * x * y + quadric.A02 * x * z + quadric.A12 * y * z)
+			+ 2.0f * glm::dot(quadric.B, point)
+			+ quadric.C;
+
+		return quadric.Weight > 0.0f ? glm::abs(error) / quadric.Weight : 0.0f;
+	}
+
+	static uint64_t PackEdge(uint32_t a, uint32_t b)
+	{
+		return a < b ? ((uint64_t)a << 32) | (uint64_t)b : ((uint64_t)b << 32) | (uint64_t)a;
+	}
+
+	std::vector<uint32_t> MeshSimplifier::Simplify(const glm::vec3* vertices,
+		size_t verticesCount,
+		const uint32_t* indices,
+		size_t indicesCount,
+		size_t targetIndexCount,
+		float maxError)
+	{
+		Grapple_PROFILE_FUNCTION();
+		Grapple_CORE_ASSERT(indicesCount % 3 == 0);
+
+		std::vector<uint32_t> result(indices, indices + indicesCount);
+		if (indicesCount <= targetIndexCount)
+			return result;
+
+		std::vector<uint64_t> edges;
+		edges.reserve(indicesCount);
+
+		glm::vec3 boundsMin = glm::vec3(FLT_MAX);
+		glm::vec3 boundsMax = glm::vec3(-FLT_MAX);
+
+		std::vector<Quadric> quadrics(verticesCount);
+		for (size_t i = 0; i < indicesCount; i += 3)
+		{
+			uint32_t a = indices[i + 0];
+			uint32_t b = indices[i + 1];
+			uint32_t c = indices[i + 2];
+
+			edges.push_back(PackEdge(a, b));
+			edges.push_back(PackEdge(b, c));
+			edges.push_back(PackEdge(c, a));
+
+			boundsMin = glm::min(boundsMin, glm::min(vertices[a], glm::min(vertices[b], vertices[c])));
+			boundsMax = glm::max(boundsMax, glm::max(vertices[a], glm::max(vertices[b], vertices[c])));
+
+			glm::vec3 normal = glm::cross(vertices[b] - vertices[a], vertices[c] - vertices[a]);
+			float doubleArea = glm::length(normal);
+			if (doubleArea == 0.0f)
+				continue;
+
+			normal /= doubleArea;
+
+			Quadric quadric = CreatePlaneQuadric(normal, -glm::dot(normal, vertices[a]), doubleArea * 0.5f);
+			quadrics[a] = AddQuadrics(quadrics[a], quadric);
+			quadrics[b] = AddQuadrics(quadrics[b], quadric);
+			quadrics[c] = AddQuadrics(quadrics[c], quadric);
+		}
+
+		// Edges, which aren't shared by exactly two triangles, are either on a border, a seam or are non manifold
+		std::vector<bool> isLocked(verticesCount, false);
+		std::sort(edges.begin(), edges.end());
+		for (size_t i = 0; i < edges.size();)
+		{
+			size_t count = 1;
+			while (i + count < edges.size() && edges[i + count] == edges[i])
+				count++;
+
+			if (count != 2)
+			{
+				isLocked[(uint32_t)(edges[i] >> 32)] = true;
+				isLocked[(uint32_t)(edges[i] & 0xffffffff)] = true;
+			}
+
+			i += count;
+		}
+
+		glm::vec3 size = boundsMax - boundsMin;
+		float errorLimit = maxError * glm::max(size.x, glm::max(size.y, size.z));
+		float squaredErrorLimit = errorLimit * errorLimit;
+
+		std::vector<uint32_t> remap(verticesCount);
+		std::vector<bool> isTouched(verticesCount);
+		std::vector<uint32_t> adjacencyOffsets(verticesCount + 1);
+		std::vector<uint32_t> adjacency;
+		std::vector<Collapse> collapses;
+
+		// Each pass collapses a set of edges, whose neighbourhoods don't overlap, so the flip test stays valid
+		while (result.size() > targetIndexCount)
+		{
+			Grapple_PROFILE_SCOPE("SimplificationPass");
+
+			// Triangles adjacent to each vertex
+			std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+			for (uint32_t index : result)
+				adjacencyOffsets[index + 1]++;
+
+			for (size_t i = 1; i < adjacencyOffsets.size(); i++)
+				adjacencyOffsets[i] += adjacencyOffsets[i - 1];
+
+			adjacency.resize(result.size());
+			{
+				std::vector<uint32_t> writeOffsets(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+				for (size_t i = 0; i < result.size(); i++)
+					adjacency[writeOffsets[result[i]]++] = (uint32_t)(i / 3);
+			}
+
+			edges.clear();
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				edges.push_back(PackEdge(result[i + 0], result[i + 1]));
+				edges.push_back(PackEdge(result[i + 1], result[i + 2]));
+				edges.push_back(PackEdge(result[i + 2], result[i + 0]));
+			}
+
+			std::sort(edges.begin(), edges.end());
+			edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+			collapses.clear();
+			for (uint64_t edge : edges)
+			{
+				uint32_t a = (uint32_t)(edge >> 32);
+				uint32_t b = (uint32_t)(edge & 0xffffffff);
+				if (isLocked[a] && isLocked[b])
+					continue;
+
+				Quadric quadric = AddQuadrics(quadrics[a], quadrics[b]);
+				float errorAToB = isLocked[a] ? FLT_MAX : EvaluateQuadric(quadric, vertices[b]);
+				float errorBToA = isLocked[b] ? FLT_MAX : EvaluateQuadric(quadric, vertices[a]);
+
+				Collapse& collapse = collapses.emplace_back();
+				collapse.From = errorAToB <= errorBToA ? a : b;
+				collapse.To = errorAToB <= errorBToA ? b : a;
+				collapse.Error = glm::min(errorAToB, errorBToA);
+			}
+
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) -> bool
+			{
+				return a.Error < b.Error;
+			});
+
+			std::iota(remap.begin(), remap.end(), 0);
+			std::fill(isTouched.begin(), isTouched.end(), false);
+
+			size_t trianglesToRemove = (result.size() - targetIndexCount + 2) / 3;
+			size_t removedTriangles = 0;
+			size_t appliedCollapses = 0;
+
+			for (const Collapse& collapse : collapses)
+			{
+				if (removedTriangles >= trianglesToRemove || collapse.Error > squaredErrorLimit)
+					break;
+
+				if (isTouched[collapse.From] || isTouched[collapse.To])
+					continue;
+
+				// Reject collapses, which flip any of the remaining triangles
+				bool flips = false;
+				for (uint32_t i = adjacencyOffsets[collapse.From]; i < adjacencyOffsets[collapse.From + 1] && !flips; i++)
+				{
+					const uint32_t* triangle = result.data() + (size_t)adjacency[i] * 3;
+					if (triangle[0] == collapse.To || triangle[1] == collapse.To || triangle[2] == collapse.To)
+						continue;
+
+					glm::vec3 oldPositions[3];
+					glm::vec3 newPositions[3];
+					for (size_t vertex = 0; vertex < 3; vertex++)
+					{
+						oldPositions[vertex] = vertices[triangle[vertex]];
+						newPositions[vertex] = triangle[vertex] == collapse.From ? vertices[collapse.To] : oldPositions[vertex];
+					}
+
+					glm::vec3 oldNormal = glm::cross(oldPositions[1] - oldPositions[0], oldPositions[2] - oldPositions[0]);
+					glm::vec3 newNormal = glm::cross(newPositions[1] - newPositions[0], newPositions[2] - newPositions[0]);
+					// Also rejects triangles, which rotate too much and become slivers
+					flips = glm::dot(oldNormal, newNormal) <= 0.25f * glm::length(oldNormal) * glm::length(newNormal);
+				}
+
+				if (flips)
+					continue;
+
+				remap[collapse.From] = collapse.To;
+				quadrics[collapse.To] = AddQuadrics(quadrics[collapse.To], quadrics[collapse.From]);
+				appliedCollapses++;
+
+				for (uint32_t i = adjacencyOffsets[collapse.From]; i < adjacencyOffsets[collapse.From + 1]; i++)
+				{
+					const uint32_t* triangle = result.data() + (size_t)adjacency[i] * 3;
+					if (triangle[0] == collapse.To || triangle[1] == collapse.To || triangle[2] == collapse.To)
+						removedTriangles++;
+
+					isTouched[triangle[0]] = true;
+					isTouched[triangle[1]] = true;
+					isTouched[triangle[2]] = true;
+				}
+			}
+
+			if (appliedCollapses == 0)
+				break;
+
+			size_t writeIndex = 0;
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				uint32_t a = remap[result[i + 0]];
+				uint32_t b = remap[result[i + 1]];
+				uint32_t c = remap[result[i + 2]];
+
+				if (a == b || b == c || c == a)
+					continue;
+
+				result[writeIndex++] = a;
+				result[writeIndex++] = b;
+				result[writeIndex++] = c;
+			}
+
+			result.resize(writeIndex);
+		}
+
+		return result;
+	}
+}
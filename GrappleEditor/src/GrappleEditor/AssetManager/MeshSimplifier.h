@@ -0,0 +1,27 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <stdint.h>
+#include <vector>
+
+namespace Grapple
+{
+	// Simplifies triangle lists by collapsing edges in the order of the quadric error metric.
+	//
+	// Vertices are only collapsed onto other existing vertices, so that the simplified indices can be used
+	// with the original vertex buffers. Border vertices are never moved, which also keeps attribute seams
+	// and boundaries between sub meshes intact, because their vertices are not shared between triangles.
+	class MeshSimplifier
+	{
+	public:
+		// Returns at most `targetIndexCount` indices, unless the error limit is reached first.
+		// `maxError` is a distance relative to the size of the simplified geometry
+		static std::vector<uint32_t> Simplify(const glm::vec3* vertices,
+			size_t verticesCount,
+			const uint32_t* indices,
+			size_t indicesCount,
+			size_t targetIndexCount,
+			float maxError);
+	};
+}
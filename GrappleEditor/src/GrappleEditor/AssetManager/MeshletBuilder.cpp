@@ -0,0 +1,160 @@
+#include "MeshletBuilder.h"
+
+#include "GrappleCore/Assert.h"
+#include "GrappleCore/Profiler/Profiler.h"
+
+#include "Grapple/Renderer/ClusterCuller.h"
+
+#include <cfloat>
+
+namespace Grapple
+{
+	void MeshletBuilder::Build(const uint32_t* indices,
+		size_t indicesCount,
+		uint32_t baseIndex,
+		const glm::vec3* vertices,
+		size_t verticesCount,
+		std::vector<Meshlet>& meshlets)
+	{
+		Grapple_PROFILE_FUNCTION();
+		Grapple_CORE_ASSERT(indicesCount % 3 == 0);
+
+#ifdef Grapple_DEBUG
+		static bool s_ConeOrientationChecked = CheckConeOrientation();
+#endif
+
+		// Index of the last meshlet, which used the vertex
+		std::vector<uint32_t> vertexMeshlets(verticesCount, UINT32_MAX);
+
+		uint32_t meshletIndex = 0;
+		uint32_t meshletVerticesCount = 0;
+		size_t meshletStart = 0;
+
+		for (size_t i = 0; i < indicesCount; i += 3)
+		{
+			uint32_t newVertices = 0;
+			for (size_t vertex = 0; vertex < 3; vertex++)
+			{
+				uint32_t index = indices[i + vertex];
+				Grapple_CORE_ASSERT(index < verticesCount);
+
+				// Repeated indices of degenerate triangles are only counted once
+				bool isRepeated = (vertex > 0 && index == indices[i]) || (vertex > 1 && index == indices[i + 1]);
+				if (vertexMeshlets[index] != meshletIndex && !isRepeated)
+					newVertices++;
+			}
+
+			size_t trianglesCount = (i - meshletStart) / 3;
+			if (meshletVerticesCount + newVertices > Meshlet::MaxVertices || trianglesCount + 1 > Meshlet::MaxTriangles)
+			{
+				Meshlet& meshlet = meshlets.emplace_back();
+				meshlet.BaseIndex = baseIndex + (uint32_t)meshletStart;
+				meshlet.IndicesCount = (uint32_t)(i - meshletStart);
+				ComputeBounds(indices + meshletStart, i - meshletStart, vertices, meshlet);
+
+				meshletIndex++;
+				meshletVerticesCount = 0;
+				meshletStart = i;
+			}
+
+			for (size_t vertex = 0; vertex < 3; vertex++)
+			{
+				uint32_t index = indices[i + vertex];
+				if (vertexMeshlets[index] != meshletIndex)
+				{
+					vertexMeshlets[index] = meshletIndex;
+					meshletVerticesCount++;
+				}
+			}
+		}
+
+		if (meshletStart < indicesCount)
+		{
+			Meshlet& meshlet = meshlets.emplace_back();
+			meshlet.BaseIndex = baseIndex + (uint32_t)meshletStart;
+			meshlet.IndicesCount = (uint32_t)(indicesCount - meshletStart);
+			ComputeBounds(indices + meshletStart, indicesCount - meshletStart, vertices, meshlet);
+		}
+	}
+
+	void MeshletBuilder::ComputeBounds(const uint32_t* indices,
+		size_t indicesCount,
+		const glm::vec3* vertices,
+		Meshlet& meshlet)
+	{
+		glm::vec3 boundsMin = glm::vec3(FLT_MAX);
+		glm::vec3 boundsMax = glm::vec3(-FLT_MAX);
+		for (size_t i = 0; i < indicesCount; i++)
+		{
+			boundsMin = glm::min(boundsMin, vertices[indices[i]]);
+			boundsMax = glm::max(boundsMax, vertices[indices[i]]);
+		}
+
+		meshlet.Center = (boundsMin + boundsMax) * 0.5f;
+		meshlet.Radius = 0.0f;
+		for (size_t i = 0; i < indicesCount; i++)
+			meshlet.Radius = glm::max(meshlet.Radius, glm::length(vertices[indices[i]] - meshlet.Center));
+
+		std::vector<glm::vec3> triangleNormals;
+		triangleNormals.reserve(indicesCount / 3);
+
+		glm::vec3 axis = glm::vec3(0.0f);
+		for (size_t i = 0; i < indicesCount; i += 3)
+		{
+			uint32_t a = indices[i + 0];
+			uint32_t b = indices[i + 1];
+			uint32_t c = indices[i + 2];
+
+			// Imported meshes have their winding flipped, so front faces are clockwise and the outward normal is (c - a) x (b - a)
+			glm::vec3 normal = glm::cross(vertices[c] - vertices[a], vertices[b] - vertices[a]);
+			float length = glm::length(normal);
+			if (length == 0.0f)
+				continue;
+
+			normal /= length;
+			triangleNormals.push_back(normal);
+			axis += normal;
+		}
+
+		// The cone is disabled for meshlets, whose normals span more than a hemisphere
+		meshlet.ConeAxis = glm::vec3(0.0f);
+		meshlet.ConeCutoff = 1.0f;
+
+		float axisLength = glm::length(axis);
+		if (triangleNormals.size() == 0 || axisLength == 0.0f)
+			return;
+
+		axis /= axisLength;
+
+		float minDot = 1.0f;
+		for (const glm::vec3& normal : triangleNormals)
+			minDot = glm::min(minDot, glm::dot(normal, axis));
+
+		meshlet.ConeAxis = axis;
+		if (minDot > 0.0f)
+			meshlet.ConeCutoff = glm::sqrt(1.0f - minDot * minDot);
+	}
+
+	bool MeshletBuilder::CheckConeOrientation()
+	{
+		// Quad facing +Z, stored the way the importer stores it after flipping the winding order
+		const glm::vec3 vertices[] =
+		{
+			glm::vec3(-1.0f, -1.0f, 0.0f),
+			glm::vec3(1.0f, -1.0f, 0.0f),
+			glm::vec3(1.0f, 1.0f, 0.0f),
+			glm::vec3(-1.0f, 1.0f, 0.0f),
+		};
+
+		const uint32_t indices[] = { 0, 2, 1, 0, 3, 2 };
+
+		Meshlet meshlet;
+		ComputeBounds(indices, 6, vertices, meshlet);
+
+		bool frontVisible = !ClusterCuller::IsBackFacing(meshlet, glm::vec3(0.0f, 0.0f, 5.0f));
+		bool backCulled = ClusterCuller::IsBackFacing(meshlet, glm::vec3(0.0f, 0.0f, -5.0f));
+
+		Grapple_CORE_ASSERT(frontVisible && backCulled, "Meshlet normal cones don't match the front face winding");
+		return frontVisible && backCulled;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Grapple/Renderer/Mesh.h"
+
+#include <glm/glm.hpp>
+
+#include <stdint.h>
+#include <vector>
+
+namespace Grapple
+{
+	// Splits triangle lists into meshlets for cluster culling.
+	//
+	// Triangles are grouped in the order they appear in the index buffer, so the indices don't have to be reordered
+	// and the vertex cache order is preserved. Should be used after optimizing the mesh for the vertex cache,
+	// because the optimized order keeps neighbouring triangles together, which results in compact meshlets.
+	class MeshletBuilder
+	{
+	public:
+		// Appends meshlets of at most `Meshlet::MaxVertices` unique vertices and `Meshlet::MaxTriangles` triangles.
+		// `baseIndex` is the offset of the `indices` in the mesh's index buffer
+		static void Build(const uint32_t* indices,
+			size_t indicesCount,
+			uint32_t baseIndex,
+			const glm::vec3* vertices,
+			size_t verticesCount,
+			std::vector<Meshlet>& meshlets);
+
+		// Computes the bounding sphere and the normal cone of the triangles.
+		// Triangle normals are derived from the clockwise winding, which imported meshes use for front faces
+		static void ComputeBounds(const uint32_t* indices,
+			size_t indicesCount,
+			const glm::vec3* vertices,
+			Meshlet& meshlet);
+
+		// Checks that a meshlet of a quad isn't culled from the front and is culled from behind. Run once by `Build` in debug builds
+		static bool CheckConeOrientation();
+	};
+}
@@ -17,6 +17,7 @@
 #include "Grapple/Project/Project.h"
 
 #include "Grapple/Scripting/ScriptingEngine.h"
+#include "Grapple/Serialization/WorldSnapshot.h"
 #include "Grapple/Input/InputManager.h"
 
 #include "GrapplePlatform/Platform.h"
@@ -235,7 +236,6 @@ namespace Grapple
         }
 
         Renderer2D::ResetStats();
-        Renderer::ClearStatistics();
 
         Renderer::SetMainViewport(m_GameWindow->GetViewport());
         InputManager::SetMousePositionOffset(-m_GameWindow->GetViewport().GetPosition());
@@ -412,7 +412,18 @@ namespace Grapple
                 ImGui::Text("Geometry Pass: %f ms", stats.GeometryPassTime);
                 ImGui::Text("Shadow Pass: %f ms", stats.ShadowPassTime);
                 ImGui::Text("Objects Submitted: %d Objects Visible: %d", stats.ObjectsSubmitted, stats.ObjectsVisible);
+
+                uint32_t objectsAfterFrustumCulling = stats.ObjectsVisible + stats.ObjectsOccluded;
+                float occludedRatio = objectsAfterFrustumCulling > 0 ? (float)stats.ObjectsOccluded / (float)objectsAfterFrustumCulling : 0.0f;
+                ImGui::Text("Objects Occluded: %d (%.1f%%) Occluders: %d", stats.ObjectsOccluded, occludedRatio * 100.0f, stats.OccludersRasterized);
+                ImGui::Text("Cluster culled objects: %d Triangles culled: %d", stats.ObjectsClusterCulled, stats.TrianglesCulledByClusters);
                 ImGui::Text("Draw calls (Saved by instancing: %d): %d", stats.DrawCallsSavedByInstancing, stats.DrawCallCount);
+                ImGui::Text("Indirect draw calls: %d", stats.IndirectDrawCallCount);
+                ImGui::Text("Skipped binds: Pipelines: %d Descriptor sets: %d Buffers: %d Push constants: %d",
+                    stats.PipelineBindsSkipped,
+                    stats.DescriptorSetBindsSkipped,
+                    stats.BufferBindsSkipped,
+                    stats.PushConstantsSkipped);
             }
 
             ImGui::SeparatorText("Renderer 2D");
@@ -552,6 +563,14 @@ namespace Grapple
 			{
                 CreateNewScene();
 			}
+			else if (ImGui::IsKeyPressed(ImGuiKey_F5) && m_Mode == EditorMode::Play)
+			{
+				QuickSave();
+			}
+			else if (ImGui::IsKeyPressed(ImGuiKey_F9) && m_Mode == EditorMode::Play)
+			{
+				QuickLoad();
+			}
         }
     }
 
@@ -660,23 +679,23 @@ namespace Grapple
 			m_GameWindow->RequestFocus();
 			m_UpdateCursorModeNextFrame = true;
 
-			Ref<Scene> active = Scene::GetActive();
-
-			Ref<EditorAssetManager> assetManager = As<EditorAssetManager>(AssetManager::GetInstance());
-			std::filesystem::path activeScenePath = assetManager->GetAssetMetadata(active->Handle)->Path;
-
+			// Unsaved edits shouldn't be lost in case something goes wrong during play mode
 			SaveActiveScene();
 
-			m_PlaymodePaused = false;
+			// The edited scene stays loaded while in play mode,
+			// so the play mode scene is cloned from it in memory instead of being read from disk
+			Ref<Scene> editorScene = Scene::GetActive();
 
-			Scene::SetActive(nullptr);
-			assetManager->UnloadAsset(active->Handle);
-			active = nullptr;
+			m_PlaymodePaused = false;
 
 			Ref<Scene> playModeScene = CreateRef<Scene>(m_ECSContext);
-			SceneSerializer::Deserialize(playModeScene, activeScenePath, m_Camera, m_SceneViewSettings);
+			playModeScene->GetECSWorld().CloneFrom(editorScene->GetECSWorld());
+			SceneSerializer::CopyPostProcessing(editorScene, playModeScene);
 
 			Scene::SetActive(playModeScene);
+			m_SceneRenderer.reset(new SceneRenderer(playModeScene));
+			m_PostProcessingWindow = PostProcessingWindow(playModeScene);
+
 			m_Mode = EditorMode::Play;
 
 			playModeScene->InitializeRuntime();
@@ -699,7 +718,6 @@ namespace Grapple
         Application::GetInstance().ExecuteAfterEndOfFrame([this]()
 		{
 			GraphicsContext::GetInstance().WaitForDevice();
-			Ref<EditorAssetManager> assetManager = As<EditorAssetManager>(AssetManager::GetInstance());
 
 			Scene::GetActive()->OnRuntimeEnd();
 
@@ -707,9 +725,14 @@ namespace Grapple
 
 			Scene::SetActive(nullptr);
 
+			// The edited scene was kept loaded and its runtime is already initialized
 			Ref<Scene> editorScene = AssetManager::GetAsset<Scene>(m_EditedSceneHandle);
-			editorScene->InitializeRuntime();
 
+			// Releases the last references to the play mode scene
+			m_SceneRenderer.reset(new SceneRenderer(editorScene));
+			m_PostProcessingWindow = PostProcessingWindow(editorScene);
+
+			editorScene->GetECSWorld().MakeCurrent();
 			Scene::SetActive(editorScene);
 			m_Mode = EditorMode::Edit;
 
@@ -718,6 +741,54 @@ namespace Grapple
 		});
     }
 
+    void EditorLayer::QuickSave()
+    {
+		Grapple_PROFILE_FUNCTION();
+        Grapple_CORE_ASSERT(m_Mode == EditorMode::Play);
+
+        Application::GetInstance().ExecuteAfterEndOfFrame([this]()
+		{
+			if (m_Mode != EditorMode::Play)
+				return;
+
+			std::filesystem::path path = GetQuickSavePath();
+			std::filesystem::create_directories(path.parent_path());
+
+			if (WorldSnapshot::Serialize(Scene::GetActive()->GetECSWorld(), path))
+				Grapple_CORE_INFO("Quick saved to '{}'", path.generic_string());
+		});
+    }
+
+    void EditorLayer::QuickLoad()
+    {
+		Grapple_PROFILE_FUNCTION();
+        Grapple_CORE_ASSERT(m_Mode == EditorMode::Play);
+
+        Application::GetInstance().ExecuteAfterEndOfFrame([this]()
+		{
+			if (m_Mode != EditorMode::Play)
+				return;
+
+			std::filesystem::path path = GetQuickSavePath();
+			if (!std::filesystem::exists(path))
+			{
+				Grapple_CORE_WARN("There is no quick save to load");
+				return;
+			}
+
+			// Rendering systems may still reference components of the current world
+			GraphicsContext::GetInstance().WaitForDevice();
+
+			if (!WorldSnapshot::Deserialize(Scene::GetActive()->GetECSWorld(), path))
+				Grapple_CORE_ERROR("Failed to load quick save '{}'", path.generic_string());
+		});
+    }
+
+    std::filesystem::path EditorLayer::GetQuickSavePath() const
+    {
+        return Project::GetActive()->Location / "Cache/QuickSave.snapshot";
+    }
+
     void EditorLayer::ReloadScriptingModules()
     {
 		Grapple_PROFILE_FUNCTION();
@@ -67,6 +67,13 @@ namespace Grapple
 		void EnterPlayMode();
 		void ExitPlayMode();
 
+		// Writes a binary snapshot of the play mode world to the project's cache, which is restored by `QuickLoad`.
+		// Only available in play mode.
+		//
+		// The operation is delayed until the end of the frame.
+		void QuickSave();
+		void QuickLoad();
+
 		void ReloadScriptingModules();
 
 		inline bool IsPlaymodePaused() const { return m_PlaymodePaused; }
@@ -96,6 +103,8 @@ namespace Grapple
 		void HandleKeyboardShortcuts();
 
 		void ResetViewportRenderGraphs();
+
+		std::filesystem::path GetQuickSavePath() const;
 	private:
 		bool m_UpdateCursorModeNextFrame = false;
 		bool m_EnterPlayModeScheduled = false;
@@ -270,6 +270,33 @@ namespace Grapple
 		return true;
 	}
 
+	void SceneSerializer::CopyPostProcessing(const Ref<Scene>& source, const Ref<Scene>& destination)
+	{
+		const PostProcessingManager& destinationManager = destination->GetPostProcessingManager();
+		for (const auto& entry : source->GetPostProcessingManager().GetEntries())
+		{
+			std::optional<Ref<PostProcessingEffect>> destinationEffect = destinationManager.FindEffect(*entry.Descriptor);
+			if (!destinationEffect)
+				continue;
+
+			YAML::Emitter emitter;
+			emitter << YAML::BeginMap;
+
+			YAMLSerializer serializer(emitter, &source->GetECSWorld());
+			serializer.PropertyKey("Data");
+			serializer.SerializeObject(*entry.Descriptor, entry.Effect.get(), false, 0);
+
+			emitter << YAML::EndMap;
+
+			YAML::Node node = YAML::Load(emitter.c_str());
+			YAMLDeserializer deserializer(node);
+			deserializer.PropertyKey("Data");
+			deserializer.SerializeObject(*entry.Descriptor, destinationEffect->get(), false, 0);
+
+			(*destinationEffect)->SetEnabled(entry.Effect->IsEnabled());
+		}
+	}
+
 	void SceneSerializer::Deserialize(const Ref<Scene>& scene, const std::filesystem::path& path, EditorCamera& editorCamera, SceneViewSettings& sceneViewSettings)
 	{
 		std::ifstream inputFile(path);
@@ -36,5 +36,7 @@ namespace Grapple
 			const std::filesystem::path& path,
 			EditorCamera& editorCamera,
 			SceneViewSettings& sceneViewSettings);
+
+		static void CopyPostProcessing(const Ref<Scene>& source, const Ref<Scene>& destination);
 	};
 }
\ No newline at end of file
@@ -483,14 +483,80 @@ namespace Grapple
 		}
 	}
 
+	// Material properties can be declared as an element of a runtime array in a storage buffer block named `MaterialTable`.
+	// Properties are named after the array and the struct members, the same way as the push constant properties,
+	// so that materials don't depend on where the shader stores their properties
+	static void ExtractMaterialTableProperties(spirv_cross::Compiler& compiler,
+		std::vector<ShaderProperty>& properties,
+		uint32_t descriptorSetMask,
+		size_t& lastPropertyOffset,
+		Ref<ShaderMetadata> metadata)
+	{
+		const spirv_cross::ShaderResources& resources = compiler.get_shader_resources();
+		for (const auto& resource : resources.storage_buffers)
+		{
+			if (compiler.get_name(resource.base_type_id) != "MaterialTable")
+				continue;
+
+			uint32_t binding = compiler.get_decoration(resource.id, spv::DecorationBinding);
+			uint32_t descriptorSet = compiler.get_decoration(resource.id, spv::DecorationDescriptorSet);
+
+			if (!HAS_BIT(descriptorSetMask, 1 << descriptorSet))
+				continue;
+
+			// Already reflected from another stage
+			if (metadata->MaterialTableBinding != UINT32_MAX)
+				continue;
+
+			const auto& bufferType = compiler.get_type(resource.base_type_id);
+			if (bufferType.member_types.size() != 1)
+			{
+				Grapple_CORE_ERROR("MaterialTable must contain a single array of material data");
+				continue;
+			}
+
+			const auto& entryType = compiler.get_type(bufferType.member_types[0]);
+			if (entryType.basetype != spirv_cross::SPIRType::Struct || entryType.array.size() != 1)
+			{
+				Grapple_CORE_ERROR("MaterialTable must contain a single array of material data");
+				continue;
+			}
+
+			metadata->MaterialDataSize = compiler.type_struct_member_array_stride(bufferType, 0);
+			metadata->MaterialTableBinding = binding;
+
+			const std::string& tableName = compiler.get_member_name(resource.base_type_id, 0);
+			for (uint32_t i = 0; i < (uint32_t)entryType.member_types.size(); i++)
+			{
+				std::optional<ShaderDataType> shaderDataType = SPIRVTypeToShaderDataType(compiler.get_type(entryType.member_types[i]));
+				if (!shaderDataType.has_value())
+					continue;
+
+				ShaderProperty& shaderProperty = properties.emplace_back();
+				shaderProperty.Binding = UINT32_MAX;
+				shaderProperty.Offset = compiler.type_struct_member_offset(entryType, i);
+				shaderProperty.Type = shaderDataType.value();
+				shaderProperty.Size = compiler.get_declared_struct_member_size(entryType, i);
+				shaderProperty.Hidden = true;
+				shaderProperty.Name = fmt::format("{}.{}", tableName, compiler.get_member_name(entryType.self, i));
+
+				lastPropertyOffset = shaderProperty.Offset;
+			}
+		}
+	}
+
 	static void ExtractShaderProperties(spirv_cross::Compiler& compiler,
 										std::vector<ShaderProperty>& properties,
 										ShaderPushConstantsRange& pushConstantsRange,
-										uint32_t descriptorSetMask)
+										uint32_t descriptorSetMask,
+										Ref<ShaderMetadata> metadata = nullptr)
 	{
 		const spirv_cross::ShaderResources& resources = compiler.get_shader_resources();
 
 		size_t lastPropertyOffset = 0;
+		if (metadata)
+			ExtractMaterialTableProperties(compiler, properties, descriptorSetMask, lastPropertyOffset, metadata);
+
 		for (const auto& resource : resources.push_constant_buffers)
 		{
 			const auto& bufferType = compiler.get_type(resource.base_type_id);
@@ -651,7 +717,7 @@ namespace Grapple
 		pushConstantsRange.Stage = stage;
 
 		uint32_t materialDescriptorSetIndex = GetMaterialDescriptorSetIndex(metadata->Type);
-		ExtractShaderProperties(compiler, metadata->Properties, pushConstantsRange, 1 << materialDescriptorSetIndex);
+		ExtractShaderProperties(compiler, metadata->Properties, pushConstantsRange, 1 << materialDescriptorSetIndex, metadata);
 
 		const auto& shaderResource = compiler.get_shader_resources();
 		ReflectDescriptorProperties(compiler, shaderResource.uniform_buffers, metadata->DescriptorProperties, ShaderDescriptorType::UniformBuffer);
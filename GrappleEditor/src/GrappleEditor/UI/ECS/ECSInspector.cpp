@@ -152,6 +152,12 @@ namespace Grapple
 					ImGui::EndTabItem();
 				}
 
+				if (ImGui::BeginTabItem("Memory"))
+				{
+					RenderMemoryStatistics();
+					ImGui::EndTabItem();
+				}
+
 				ImGui::EndTabBar();
 			}
 			ImGui::End();
@@ -193,6 +199,19 @@ namespace Grapple
 			uint32_t entitySize = (uint32_t)storage.GetEntitySize();
 			EditorGUI::UIntPropertyField("Entity Size", entitySize);
 
+			{
+				ArchetypeMemoryStatistics statistics = world.Entities.GetArchetypeMemoryStatistics(archetype);
+
+				float fillRatio = statistics.FillRatio;
+				EditorGUI::FloatPropertyField("Fill ratio", fillRatio);
+				uint32_t padding = (uint32_t)statistics.PaddingPerEntity;
+				EditorGUI::UIntPropertyField("Padding per entity", padding);
+				uint32_t chunkTail = (uint32_t)statistics.ChunkTailSize;
+				EditorGUI::UIntPropertyField("Unused bytes per chunk", chunkTail);
+				uint32_t allocatedBytes = (uint32_t)statistics.AllocatedBytes;
+				EditorGUI::UIntPropertyField("Allocated bytes", allocatedBytes);
+			}
+
 			{
 				int32_t references = record.DeletionQueryReferences;
 				EditorGUI::IntPropertyField("References in deletion queries", references);
@@ -238,6 +257,70 @@ namespace Grapple
 		}
 	}
 
+	void ECSInspector::RenderMemoryStatistics()
+	{
+		World& world = World::GetCurrent();
+		EntitiesMemoryStatistics statistics = world.Entities.GetMemoryStatistics();
+		CommandsStorageStatistics commands = world.GetSystemsManager().GetCommandBuffer().GetStatistics();
+
+		ImGui::SeparatorText("Entities");
+		if (EditorGUI::BeginPropertyGrid())
+		{
+			ImGui::BeginDisabled(true);
+			uint32_t archetypesCount = (uint32_t)statistics.ArchetypesCount;
+			EditorGUI::UIntPropertyField("Archetypes count", archetypesCount);
+			uint32_t entitiesCount = (uint32_t)statistics.EntitiesCount;
+			EditorGUI::UIntPropertyField("Entities count", entitiesCount);
+			uint32_t chunksCount = (uint32_t)statistics.ChunksCount;
+			EditorGUI::UIntPropertyField("Chunks count", chunksCount);
+			float fillRatio = statistics.FillRatio;
+			EditorGUI::FloatPropertyField("Fill ratio", fillRatio);
+			uint32_t usedBytes = (uint32_t)statistics.UsedBytes;
+			EditorGUI::UIntPropertyField("Used bytes", usedBytes);
+			uint32_t allocatedBytes = (uint32_t)statistics.AllocatedBytes;
+			EditorGUI::UIntPropertyField("Allocated bytes", allocatedBytes);
+			uint32_t paddingBytes = (uint32_t)statistics.PaddingBytes;
+			EditorGUI::UIntPropertyField("Padding bytes", paddingBytes);
+			ImGui::EndDisabled();
+
+			EditorGUI::EndPropertyGrid();
+		}
+
+		ImGui::SeparatorText("Chunks Pool");
+		if (EditorGUI::BeginPropertyGrid())
+		{
+			ImGui::BeginDisabled(true);
+			uint32_t pooled = (uint32_t)statistics.ChunksPool.PooledChunks;
+			EditorGUI::UIntPropertyField("Pooled chunks", pooled);
+			uint32_t capacity = (uint32_t)statistics.ChunksPool.Capacity;
+			EditorGUI::UIntPropertyField("Capacity", capacity);
+			uint32_t hits = (uint32_t)statistics.ChunksPool.Hits;
+			EditorGUI::UIntPropertyField("Hits", hits);
+			uint32_t misses = (uint32_t)statistics.ChunksPool.Misses;
+			EditorGUI::UIntPropertyField("Misses", misses);
+			uint32_t released = (uint32_t)statistics.ChunksPool.Released;
+			EditorGUI::UIntPropertyField("Released", released);
+			ImGui::EndDisabled();
+
+			EditorGUI::EndPropertyGrid();
+		}
+
+		ImGui::SeparatorText("Command Buffer");
+		if (EditorGUI::BeginPropertyGrid())
+		{
+			ImGui::BeginDisabled(true);
+			uint32_t capacity = (uint32_t)commands.Capacity;
+			EditorGUI::UIntPropertyField("Capacity", capacity);
+			uint32_t highWaterMark = (uint32_t)commands.HighWaterMark;
+			EditorGUI::UIntPropertyField("High water mark", highWaterMark);
+			uint32_t reallocations = (uint32_t)commands.ReallocationsCount;
+			EditorGUI::UIntPropertyField("Reallocations", reallocations);
+			ImGui::EndDisabled();
+
+			EditorGUI::EndPropertyGrid();
+		}
+	}
+
 	void ECSInspector::Show()
 	{
 		s_Instance.m_Shown = true;
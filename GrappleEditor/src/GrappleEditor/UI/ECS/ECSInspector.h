@@ -16,6 +16,7 @@ namespace Grapple
 		void RenderEntityInfo(Entity entity);
 		void RenderArchetypeInfo(ArchetypeId archetype);
 		void RenderSystem(uint32_t systemIndex);
+		void RenderMemoryStatistics();
 	private:
 		bool m_Shown;
 	};
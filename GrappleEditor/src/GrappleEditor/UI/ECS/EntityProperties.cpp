@@ -181,6 +181,36 @@ namespace Grapple
 						mesh.Flags &= ~MeshRenderFlags::DontCastShadows;
 				}
 
+				const char* staticPropertyName = "Static";
+				EditorGUI::PropertyName(staticPropertyName);
+				{
+					bool value = HAS_BIT(mesh.Flags, MeshRenderFlags::Static);
+
+					ImGui::PushID(staticPropertyName);
+					ImGui::Checkbox("", &value);
+					ImGui::PopID();
+
+					if (value)
+						mesh.Flags |= MeshRenderFlags::Static;
+					else
+						mesh.Flags &= ~MeshRenderFlags::Static;
+				}
+
+				const char* occluderPropertyName = "Occluder";
+				EditorGUI::PropertyName(occluderPropertyName);
+				{
+					bool value = HAS_BIT(mesh.Flags, MeshRenderFlags::Occluder);
+
+					ImGui::PushID(occluderPropertyName);
+					ImGui::Checkbox("", &value);
+					ImGui::PopID();
+
+					if (value)
+						mesh.Flags |= MeshRenderFlags::Occluder;
+					else
+						mesh.Flags &= ~MeshRenderFlags::Occluder;
+				}
+
 				EditorGUI::EndPropertyGrid();
 			}
 
@@ -170,7 +170,8 @@ namespace Grapple
 				for (size_t i = 0; i < table->Materials.size(); i++)
 				{
 					EditorGUI::PropertyIndex(i);
-					EditorGUI::AssetField(table->Materials[i]);
+					if (EditorGUI::AssetField(table->Materials[i]))
+						AssetManager::NotifyAssetsChanged();
 				}
 
 				EditorGUI::EndPropertyGrid();
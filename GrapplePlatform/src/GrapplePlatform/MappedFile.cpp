@@ -0,0 +1,18 @@
+#include "MappedFile.h"
+
+#include "GrapplePlatform/Windows/WindowsMappedFile.h"
+
+namespace Grapple
+{
+    MappedFile* MappedFile::Open(const std::filesystem::path& path)
+    {
+#ifdef Grapple_PLATFORM_WINDOWS
+        WindowsMappedFile* file = new WindowsMappedFile(path);
+        if (file->IsValid())
+            return file;
+
+        delete file;
+#endif
+        return nullptr;
+    }
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "GrappleCore/Core.h"
+
+#include <filesystem>
+
+namespace Grapple
+{
+    // Read-only view of a file mapped into memory
+    class MappedFile
+    {
+    public:
+        virtual ~MappedFile() {}
+
+        virtual const uint8_t* GetData() const = 0;
+        virtual size_t GetSize() const = 0;
+    public:
+        GrapplePLATFORM_API static MappedFile* Open(const std::filesystem::path& path);
+    };
+}
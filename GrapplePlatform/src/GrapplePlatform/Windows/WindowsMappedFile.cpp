@@ -0,0 +1,78 @@
+#include "WindowsMappedFile.h"
+
+#include "GrapplePlatform/Windows/WindowsPlatform.h"
+
+#include "GrappleCore/Log.h"
+
+namespace Grapple
+{
+    WindowsMappedFile::WindowsMappedFile(const std::filesystem::path& path)
+        : m_FileHandle(INVALID_HANDLE_VALUE),
+        m_MappingHandle(nullptr),
+        m_Data(nullptr),
+        m_Size(0),
+        m_IsValid(false)
+    {
+        m_FileHandle = CreateFileW(path.wstring().c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+            nullptr);
+
+        if (m_FileHandle == INVALID_HANDLE_VALUE)
+        {
+            Grapple_CORE_ERROR("MappedFile: Failed to open '{}'", path.generic_string());
+            LogError();
+            return;
+        }
+
+        LARGE_INTEGER fileSize{};
+        if (!GetFileSizeEx(m_FileHandle, &fileSize))
+        {
+            Grapple_CORE_ERROR("MappedFile: Failed to get size of '{}'", path.generic_string());
+            LogError();
+            return;
+        }
+
+        m_Size = (size_t)fileSize.QuadPart;
+
+        // Empty files can't be mapped
+        if (m_Size == 0)
+        {
+            m_IsValid = true;
+            return;
+        }
+
+        m_MappingHandle = CreateFileMappingW(m_FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_MappingHandle == nullptr)
+        {
+            Grapple_CORE_ERROR("MappedFile: Failed to create a file mapping for '{}'", path.generic_string());
+            LogError();
+            return;
+        }
+
+        m_Data = (const uint8_t*)MapViewOfFile(m_MappingHandle, FILE_MAP_READ, 0, 0, 0);
+        if (m_Data == nullptr)
+        {
+            Grapple_CORE_ERROR("MappedFile: Failed to map '{}'", path.generic_string());
+            LogError();
+            return;
+        }
+
+        m_IsValid = true;
+    }
+
+    WindowsMappedFile::~WindowsMappedFile()
+    {
+        if (m_Data != nullptr)
+            UnmapViewOfFile(m_Data);
+
+        if (m_MappingHandle != nullptr)
+            CloseHandle(m_MappingHandle);
+
+        if (m_FileHandle != INVALID_HANDLE_VALUE)
+            CloseHandle(m_FileHandle);
+    }
+}
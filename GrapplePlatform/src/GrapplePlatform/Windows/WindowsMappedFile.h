@@ -0,0 +1,28 @@
+#pragma once
+
+#include "GrapplePlatform/MappedFile.h"
+
+#include <filesystem>
+#include <windows.h>
+
+namespace Grapple
+{
+    class WindowsMappedFile : public MappedFile
+    {
+    public:
+        WindowsMappedFile(const std::filesystem::path& path);
+        virtual ~WindowsMappedFile();
+
+        const uint8_t* GetData() const override { return m_Data; }
+        size_t GetSize() const override { return m_Size; }
+
+        inline bool IsValid() const { return m_IsValid; }
+    private:
+        HANDLE m_FileHandle;
+        HANDLE m_MappingHandle;
+
+        const uint8_t* m_Data;
+        size_t m_Size;
+        bool m_IsValid;
+    };
+}
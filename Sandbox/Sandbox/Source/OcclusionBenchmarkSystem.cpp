@@ -0,0 +1,128 @@
+#include "OcclusionBenchmarkSystem.h"
+
+#include <GrappleECS/World.h>
+#include <GrappleECS/Commands/CommandBuffer.h>
+
+#include <Grapple/Core/Time.h>
+#include <Grapple/Renderer/Mesh.h>
+#include <Grapple/Renderer/Renderer.h>
+#include <Grapple/Scene/Components.h>
+#include <Grapple/Scene/Transform.h>
+
+#include <random>
+
+using namespace Grapple;
+
+Grapple_IMPL_COMPONENT(OcclusionBenchmark);
+
+void OcclusionBenchmarkSystem::OnConfig(Grapple::World& world, SystemConfig& config)
+{
+	m_Query = world.NewQuery()
+		.All()
+		.With<OcclusionBenchmark>()
+		.Build();
+}
+
+void OcclusionBenchmarkSystem::OnUpdate(Grapple::World& world, SystemExecutionContext& context)
+{
+	for (EntityView view : m_Query)
+	{
+		auto benchmarks = view.View<OcclusionBenchmark>();
+
+		for (EntityViewElement entity : view)
+		{
+			OcclusionBenchmark& benchmark = benchmarks[entity];
+
+			if (!benchmark.Enabled || benchmark.MeshHandle == NULL_ASSET_HANDLE)
+			{
+				continue;
+			}
+
+			if (!benchmark.Spawned)
+			{
+				if (!AssetManager::IsAssetHandleValid(benchmark.MeshHandle))
+				{
+					Grapple_WARN("Invalid mesh handle {}", (uint64_t)benchmark.MeshHandle);
+					continue;
+				}
+
+				Spawn(benchmark, context);
+				benchmark.Spawned = true;
+				benchmark.TimeLeft = benchmark.ReportPeriod;
+				continue;
+			}
+
+			benchmark.TimeLeft -= Time::GetDeltaTime();
+
+			if (benchmark.TimeLeft <= 0.0f)
+			{
+				const RendererStatistics& statistics = Renderer::GetStatistics();
+
+				uint32_t testedObjects = statistics.ObjectsVisible + statistics.ObjectsOccluded;
+				float occludedRatio = testedObjects > 0 ? (float)statistics.ObjectsOccluded / (float)testedObjects : 0.0f;
+
+				Grapple_INFO("Occlusion benchmark: submitted {} visible {} occluded {} ({:.1f}% of objects passing frustum culling), occluders {}",
+					statistics.ObjectsSubmitted,
+					statistics.ObjectsVisible,
+					statistics.ObjectsOccluded,
+					occludedRatio * 100.0f,
+					statistics.OccludersRasterized);
+
+				benchmark.TimeLeft = benchmark.ReportPeriod;
+			}
+		}
+	}
+}
+
+void OcclusionBenchmarkSystem::Spawn(const OcclusionBenchmark& benchmark, SystemExecutionContext& context)
+{
+	static std::mt19937_64 s_Engine(0);
+	std::uniform_real_distribution<float> heightDistribution(6.0f, 24.0f);
+	std::uniform_real_distribution<float> offsetDistribution(-0.5f, 0.5f);
+
+	Ref<Mesh> mesh = AssetManager::GetAsset<Mesh>(benchmark.MeshHandle);
+	glm::vec3 meshSize = glm::max(mesh->GetBounds().GetSize(), glm::vec3(0.001f));
+
+	float halfGridSize = (float)benchmark.GridSize * benchmark.Spacing / 2.0f;
+
+	// Blocks fill 3/4 of each cell, the rest is left for the streets with small objects
+	float blockSize = benchmark.Spacing * 0.75f;
+	float streetWidth = glm::max(benchmark.Spacing - blockSize - 1.0f, 0.0f);
+
+	for (int32_t x = 0; x < benchmark.GridSize; x++)
+	{
+		for (int32_t z = 0; z < benchmark.GridSize; z++)
+		{
+			glm::vec3 cellPosition = glm::vec3(
+				(float)x * benchmark.Spacing - halfGridSize,
+				0.0f,
+				(float)z * benchmark.Spacing - halfGridSize);
+
+			float height = heightDistribution(s_Engine);
+			context.Commands->CreateEntity(
+				TransformComponent(
+					cellPosition + glm::vec3(0.0f, height / 2.0f, 0.0f),
+					glm::vec3(0.0f),
+					glm::vec3(blockSize, height, blockSize) / meshSize),
+				MeshComponent(mesh, benchmark.MaterialHandle, MeshRenderFlags::Static | MeshRenderFlags::Occluder));
+
+			for (int32_t i = 0; i < benchmark.ObjectsPerCell; i++)
+			{
+				glm::vec3 position = cellPosition + glm::vec3(
+					benchmark.Spacing / 2.0f + offsetDistribution(s_Engine) * streetWidth,
+					0.5f,
+					offsetDistribution(s_Engine) * benchmark.Spacing);
+
+				context.Commands->CreateEntity(
+					TransformComponent(position, glm::vec3(0.0f), glm::vec3(1.0f) / meshSize),
+					MeshComponent(mesh, benchmark.MaterialHandle, MeshRenderFlags::Static));
+			}
+		}
+	}
+
+	Grapple_INFO("Occlusion benchmark: spawned {} blocks and {} objects",
+		benchmark.GridSize * benchmark.GridSize,
+		benchmark.GridSize * benchmark.GridSize * benchmark.ObjectsPerCell);
+}
+
+Grapple_IMPL_SYSTEM(OcclusionBenchmarkSystem);
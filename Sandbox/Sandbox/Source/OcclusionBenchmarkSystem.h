@@ -0,0 +1,71 @@
+#pragma once
+
+#include <GrappleCore/Serialization/TypeSerializer.h>
+#include <GrappleCore/Serialization/SerializationStream.h>
+
+#include <GrappleECS/World.h>
+#include <GrappleECS/System/SystemInitializer.h>
+#include <GrappleECS/Entity/ComponentInitializer.h>
+
+#include <Grapple/AssetManager/Asset.h>
+#include <Grapple/AssetManager/AssetManager.h>
+
+// Spawns a city-like grid of large occluding blocks with small objects hidden between them
+// and periodically logs how many of the objects were removed by occlusion culling
+struct OcclusionBenchmark
+{
+	Grapple_COMPONENT;
+
+	OcclusionBenchmark()
+		: Enabled(false),
+		MeshHandle(NULL_ASSET_HANDLE),
+		MaterialHandle(NULL_ASSET_HANDLE),
+		GridSize(16),
+		Spacing(12.0f),
+		ObjectsPerCell(16),
+		ReportPeriod(2.0f),
+		TimeLeft(0.0f),
+		Spawned(false) {}
+
+	bool Enabled;
+
+	// Mesh with unit bounds, which is used for both the blocks and the small objects
+	Grapple::AssetHandle MeshHandle;
+	Grapple::AssetHandle MaterialHandle;
+
+	int32_t GridSize;
+	float Spacing;
+	int32_t ObjectsPerCell;
+
+	float ReportPeriod;
+	float TimeLeft;
+
+	bool Spawned;
+};
+
+template<>
+struct Grapple::TypeSerializer<OcclusionBenchmark>
+{
+	void OnSerialize(OcclusionBenchmark& benchmark, Grapple::SerializationStream& stream)
+	{
+		stream.Serialize("Enabled", Grapple::SerializationValue(benchmark.Enabled));
+		stream.Serialize("MeshHandle", Grapple::SerializationValue(benchmark.MeshHandle));
+		stream.Serialize("MaterialHandle", Grapple::SerializationValue(benchmark.MaterialHandle));
+		stream.Serialize("GridSize", Grapple::SerializationValue(benchmark.GridSize));
+		stream.Serialize("Spacing", Grapple::SerializationValue(benchmark.Spacing));
+		stream.Serialize("ObjectsPerCell", Grapple::SerializationValue(benchmark.ObjectsPerCell));
+		stream.Serialize("ReportPeriod", Grapple::SerializationValue(benchmark.ReportPeriod));
+	}
+};
+
+struct OcclusionBenchmarkSystem : Grapple::System
+{
+	Grapple_SYSTEM;
+
+	virtual void OnConfig(Grapple::World& world, Grapple::SystemConfig& config) override;
+	virtual void OnUpdate(Grapple::World& world, Grapple::SystemExecutionContext& context) override;
+private:
+	void Spawn(const OcclusionBenchmark& benchmark, Grapple::SystemExecutionContext& context);
+private:
+	Grapple::Query m_Query;
+};
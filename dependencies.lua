@@ -4,8 +4,9 @@ if vulkan_sdk == nil then
 	print("Couldn't find Vulkan SDK")
 end
 
-local vulkan_include = vulkan_sdk .. "/include/"
-local vulkan_lib = vulkan_sdk .. "/lib/"
+-- Modules, which don't use Vulkan (e.g. the standalone ECS workspace), can still be generated without the SDK
+local vulkan_include = (vulkan_sdk or "") .. "/include/"
+local vulkan_lib = (vulkan_sdk or "") .. "/lib/"
 
 local assimp_path = "%{wks.location}/Grapple/vendor/assimp/assimp/"
 